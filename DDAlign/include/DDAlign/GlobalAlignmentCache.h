@@ -75,9 +75,11 @@ namespace dd4hep {
       GlobalAlignmentCache* subdetectorAlignments(const std::string& name);
 
       /// Population entry: Apply a complete stack of ordered alignments to the geometry structure
-      void apply(GlobalAlignmentStack& stack);
+      void apply(GlobalAlignmentStack& stack, bool batch=false);
       /// Apply a vector of SD entries of ordered alignments to the geometry structure
       void apply(const std::vector<Entry*> &changes);
+      /// Apply a vector of SD entries in one batch: parents first, one overlap check per mother
+      void applyBatch(const std::vector<Entry*> &changes);
       /// Add a new entry to the cache. The key is the placement path
       bool insert(GlobalAlignment alignment);
 
@@ -94,6 +96,15 @@ namespace dd4hep {
       const std::string& name() const   {   return m_sdPath;  }
       /// Close existing transaction stack and apply all alignments
       void commit(GlobalAlignmentStack& stack);
+      /// Close existing transaction stack and apply all alignments in one batch
+      /**
+       *  The entries are sorted by the depth of their placement path,
+       *  the physical nodes are looked up or created in one pass and
+       *  the matrices are applied without intermediate overlap checks.
+       *  Requested overlap checks are executed once per mother volume
+       *  after all matrices were applied, the TGeo caches are refreshed once.
+       */
+      void commitBatch(GlobalAlignmentStack& stack);
       /// Retrieve the cache section corresponding to the path of an entry.
       GlobalAlignmentCache* section(const std::string& path_name) const;
       /// Retrieve an alignment entry by its placement path
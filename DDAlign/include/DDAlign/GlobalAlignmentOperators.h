@@ -44,6 +44,8 @@ namespace dd4hep {
       GlobalAlignmentOperator(GlobalAlignmentCache& c, Nodes& n) : cache(c), nodes(n) {}
       /// Insert alignment entry
       void insert(GlobalAlignment alignment)  const;
+      /// Transformation corresponding to the delta of an alignment entry
+      static Transform3D deltaTransform(const Delta& delta);
     };
 
     /// Select alignment operations according to certain criteria
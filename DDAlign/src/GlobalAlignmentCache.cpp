@@ -16,11 +16,18 @@
 #include "DD4hep/Printout.h"
 #include "DDAlign/GlobalAlignmentCache.h"
 #include "DDAlign/GlobalAlignmentOperators.h"
+#include "DDAlign/GlobalDetectorAlignment.h"
 #include "DD4hep/detail/DetectorInterna.h"
+#include "DD4hep/MatrixHelpers.h"
 
 // ROOT include files
 #include "TGeoManager.h"
 
+// C/C++ include files
+#include <set>
+#include <algorithm>
+#include <unordered_map>
+
 using namespace std;
 using namespace dd4hep;
 using namespace dd4hep::align;
@@ -172,6 +179,14 @@ void GlobalAlignmentCache::commit(GlobalAlignmentStack& stack)   {
   mgr.LockGeometry();
 }
 
+/// Close existing transaction stack and apply all alignments in one batch
+void GlobalAlignmentCache::commitBatch(GlobalAlignmentStack& stack)   {
+  TGeoManager& mgr = m_detDesc.manager();
+  mgr.UnlockGeometry();
+  apply(stack, true);
+  mgr.LockGeometry();
+}
+
 /// Retrieve branch cache by name. If not present it will be created
 GlobalAlignmentCache* GlobalAlignmentCache::subdetectorAlignments(const string& nam)    {
   SubdetectorAlignments::const_iterator i = m_detectors.find(nam);
@@ -184,7 +199,7 @@ GlobalAlignmentCache* GlobalAlignmentCache::subdetectorAlignments(const string&
 }
 
 /// Apply a complete stack of ordered alignments to the geometry structure
-void GlobalAlignmentCache::apply(GlobalAlignmentStack& stack)    {
+void GlobalAlignmentCache::apply(GlobalAlignmentStack& stack, bool batch)    {
   typedef map<string,DetElement> DetElementUpdates;
   typedef map<DetElement,vector<Entry*> > sd_entries_t;
   TGeoManager& mgr = m_detDesc.manager();
@@ -202,7 +217,7 @@ void GlobalAlignmentCache::apply(GlobalAlignmentStack& stack)    {
   for(sd_entries_t::iterator i=all.begin(); i!=all.end(); ++i)  {
     DetElement det((*i).first);
     GlobalAlignmentCache* sd_cache = subdetectorAlignments(det.placement().name());
-    sd_cache->apply( (*i).second );
+    batch ? sd_cache->applyBatch( (*i).second ) : sd_cache->apply( (*i).second );
     (*i).second.clear();
   }
 
@@ -249,3 +264,116 @@ void GlobalAlignmentCache::apply(const vector<Entry*>& changes)   {
   for_each(nodes.begin(),nodes.end(),GlobalAlignmentActor<node_align>(*this,nodes));
   for_each(nodes.begin(),nodes.end(),GlobalAlignmentActor<node_delete>(*this,nodes));
 }
+
+/// Apply a vector of SD entries in one batch: parents first, one overlap check per mother
+void GlobalAlignmentCache::applyBatch(const vector<Entry*>& changes)   {
+  typedef GlobalAlignmentOperator::Nodes   Nodes;
+  typedef unordered_map<string,Entry*>     Selection;
+  typedef pair<TGeoPhysicalNode*,Entry*>   Node;
+  Selection         selection, children;
+  Nodes             nodes;
+  vector<pair<size_t,Entry*> > ordered;
+  vector<Node>      aligned;
+  map<TGeoNode*,double> checks;
+  set<TGeoVolume*>  mothers;
+
+  // Sort the entries by the depth of the placement path: parents are aligned first
+  ordered.reserve(changes.size());
+  for(Entry* e : changes)
+    ordered.emplace_back(std::count(e->path.begin(),e->path.end(),'/'),e);
+  std::stable_sort(ordered.begin(),ordered.end(),
+                   [](const pair<size_t,Entry*>& a, const pair<size_t,Entry*>& b) { return a.first < b.first; });
+
+  // Select the cached nodes to be reset with a single pass over the cache.
+  // Children are matched by the path components of the cached node.
+  for(const auto& o : ordered)  {
+    Entry* e = o.second;
+    if ( Stack::needsReset(*e) || Stack::hasMatrix(*e) )  {
+      selection.emplace(e->path,e);
+      if ( Stack::resetChildren(*e) ) children.emplace(e->path,e);
+    }
+  }
+  if ( !selection.empty() )  {
+    for(const auto& c : m_cache)  {
+      const string path = c.second->GetName();
+      Selection::const_iterator i = selection.find(path);
+      Entry* e = i == selection.end() ? 0 : (*i).second;
+      for(size_t idx=path.find('/',1); !e && !children.empty() && idx != string::npos; idx=path.find('/',idx+1))  {
+        Selection::const_iterator j = children.find(path.substr(0,idx));
+        if ( j != children.end() ) e = (*j).second;
+      }
+      if ( e ) nodes.insert(make_pair(path,make_pair(c.second,e)));
+    }
+    for_each(nodes.begin(),nodes.end(),GlobalAlignmentActor<node_reset>(*this,nodes));
+  }
+
+  // Look up or create all physical nodes in one pass
+  aligned.reserve(ordered.size());
+  for(const auto& o : ordered)  {
+    Entry&     e   = *o.second;
+    DetElement det = e.detector;
+    if ( !det->global_alignment.isValid() && !Stack::hasMatrix(e) )  {
+      printout(WARNING,"GlobalAlignmentCache","++++ SKIP Alignment %s DE:%s Valid:%s Matrix:%s",
+               e.path.c_str(),det.placementPath().c_str(),
+               yes_no(det->global_alignment.isValid()), yes_no(Stack::hasMatrix(e)));
+      continue;
+    }
+    GlobalDetectorAlignment ad(det);
+    GlobalAlignment a;
+    if ( e.path.empty() || e.path == det.placementPath() )  {
+      a = ad.alignment();
+    }
+    else  {
+      string path = e.path[0] == '/' ? e.path : det.placementPath()+'/'+e.path;
+      if ( !(a=get(path)).isValid() )  {
+        a = GlobalAlignment(path);
+        ad.volumeAlignments().push_back(a);
+      }
+    }
+    aligned.emplace_back(a.ptr(),&e);
+  }
+
+  // Apply all matrices. Overlap checks are deferred until the batch is complete.
+  size_t num_new = 0;
+  for(const Node& n : aligned)  {
+    TGeoPhysicalNode* pn = n.first;
+    const Entry&      e  = *n.second;
+    TGeoHMatrix* transform = detail::matrix::_transform(GlobalAlignmentOperator::deltaTransform(e.delta));
+    if ( GlobalDetectorAlignment::debug() )  {
+      printout(INFO,"GlobalAlignmentCache","++++ %s DE:%s Matrix:%s",
+               e.path.c_str(),e.detector.placementPath().c_str(),yes_no(Stack::hasMatrix(e)));
+    }
+    // The branch may contain nodes replaced by the alignment of a parent
+    pn->Refresh();
+    transform->MultiplyLeft(pn->GetNode()->GetMatrix()); // orig * delta
+    pn->Align(transform, 0, false);
+    if ( m_cache.insert(make_pair(detail::hash32(pn->GetName()+m_sdPathLen),pn)).second )
+      ++num_new;
+    if ( Stack::checkOverlap(e) && e.overlap != 0e0 && !pn->GetNode()->IsOverlapping() )  {
+      double precision = Stack::overlapDefined(e) ? e.overlap : 0.001;
+      // Check the first non-assembly parent node. Each of them only once.
+      TGeoNode* node = 0;
+      for(int lvl=pn->GetLevel()-1; lvl >= 0; --lvl)  {
+        node = pn->GetNode(lvl);
+        if ( !node->GetVolume()->IsAssembly() ) break;
+      }
+      // Nodes directly below the top volume have no mother node in the path
+      TGeoNode* mother = pn->GetMother(1);
+      mothers.insert(mother ? mother->GetVolume() : m_detDesc.manager().GetTopVolume());
+      if ( node && !node->IsOverlapping() )  {
+        auto r = checks.insert(make_pair(node,precision));
+        if ( !r.second ) (*r.first).second = std::min((*r.first).second,precision);
+      }
+    }
+  }
+  // Now the voxels of the mother volumes are rebuilt once and the overlaps checked
+  for(TGeoVolume* vol : mothers)  {
+    vol->Voxelize("");
+    vol->FindOverlaps();
+  }
+  for(const auto& c : checks)
+    c.first->CheckOverlaps(c.second);
+  printout(INFO,"GlobalAlignmentCache","Section: %s applied %ld alignments [%ld new entries, %ld overlap checks]",
+           name().c_str(),long(aligned.size()),long(num_new),long(checks.size()));
+  for(Entry* e : changes) delete e;
+}
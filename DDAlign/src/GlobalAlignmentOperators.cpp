@@ -31,6 +31,20 @@ void GlobalAlignmentOperator::insert(GlobalAlignment alignment)  const   {
   }
 }
 
+Transform3D GlobalAlignmentOperator::deltaTransform(const Delta& delta)   {
+  if ( delta.checkFlag(Delta::HAVE_ROTATION|Delta::HAVE_PIVOT|Delta::HAVE_TRANSLATION) )
+    return Transform3D(Translation3D(delta.translation)*delta.pivot*delta.rotation*(delta.pivot.Inverse()));
+  else if ( delta.checkFlag(Delta::HAVE_ROTATION|Delta::HAVE_TRANSLATION) )
+    return Transform3D(delta.rotation,delta.translation);
+  else if ( delta.checkFlag(Delta::HAVE_ROTATION|Delta::HAVE_PIVOT) )
+    return Transform3D(delta.pivot*delta.rotation*(delta.pivot.Inverse()));
+  else if ( delta.checkFlag(Delta::HAVE_ROTATION) )
+    return Transform3D(delta.rotation);
+  else if ( delta.checkFlag(Delta::HAVE_TRANSLATION) )
+    return Transform3D(delta.translation);
+  return Transform3D();
+}
+
 void GlobalAlignmentSelector::operator()(Entries::value_type e)  const {
   TGeoPhysicalNode* pn = 0;
   nodes.insert(make_pair(e->path,make_pair(pn,e)));
@@ -126,22 +140,10 @@ template <> void GlobalAlignmentActor<DDAlign_standard_operations::node_align>::
   // Need to care about optional arguments 'check_overlaps' and 'overlap'
   GlobalDetectorAlignment ad(det);
   GlobalAlignment   align;
-  Transform3D       trafo;
-  const Delta&      delta  = e.delta;
+  Transform3D       trafo  = deltaTransform(e.delta);
   bool              no_vol = e.path == det.placementPath();
   double            ovl_precision = e.overlap;
 
-  if ( delta.checkFlag(Delta::HAVE_ROTATION|Delta::HAVE_PIVOT|Delta::HAVE_TRANSLATION) )
-    trafo = Transform3D(Translation3D(delta.translation)*delta.pivot*delta.rotation*(delta.pivot.Inverse()));
-  else if ( delta.checkFlag(Delta::HAVE_ROTATION|Delta::HAVE_TRANSLATION) )
-    trafo = Transform3D(delta.rotation,delta.translation);
-  else if ( delta.checkFlag(Delta::HAVE_ROTATION|Delta::HAVE_PIVOT) )
-    trafo = Transform3D(delta.pivot*delta.rotation*(delta.pivot.Inverse()));
-  else if ( delta.checkFlag(Delta::HAVE_ROTATION) )
-    trafo = Transform3D(delta.rotation);
-  else if ( delta.checkFlag(Delta::HAVE_TRANSLATION) )
-    trafo = Transform3D(delta.translation);
-
   if ( GlobalAlignmentStack::checkOverlap(e) && overlap )
     align = no_vol ? ad.align(trafo,ovl_precision,e.overlap) : ad.align(e.path,trafo,ovl_precision,e.overlap);
   else if ( GlobalAlignmentStack::checkOverlap(e) )
@@ -0,0 +1,189 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_GlobalAlignmentBatchBenchmark -nodes 100000 -compare 100
+
+   Misalign up to <nodes> physical volumes of the geometry with global
+   alignments. The first <compare> nodes are committed one by one,
+   each in its own transaction. All others are committed with one
+   single batch transaction. Finally the local matrix of every
+   aligned node is compared to the original matrix times the delta.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/DD4hepUnits.h"
+#include "DD4hep/MatrixHelpers.h"
+#include "DDAlign/GlobalAlignmentCache.h"
+#include "DDAlign/GlobalAlignmentOperators.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::align;
+
+namespace {
+  typedef GlobalAlignmentStack::StackEntry   Entry;
+  typedef pair<DetElement,string>            Target;
+
+  /// Collect the placement paths of the daughter volumes of a subdetector
+  void collect(DetElement det, TGeoNode* node, const string& path, size_t max_nodes, vector<Target>& targets)  {
+    for(Int_t i=0, n=node->GetNdaughters(); i<n && targets.size() < max_nodes; ++i)  {
+      TGeoNode* dau = node->GetDaughter(i);
+      if ( dau->IsOffset() ) continue;
+      string    dau_path = path + '/' + dau->GetName();
+      targets.emplace_back(det, dau_path);
+      collect(det, dau, dau_path, max_nodes, targets);
+    }
+  }
+
+  /// Small, node dependent delta
+  Delta delta(size_t i)   {
+    Delta d(Position(1e-3*double(i%11)*dd4hep::mm, 1e-3*double(i%7)*dd4hep::mm, 1e-3*double(1+i%5)*dd4hep::mm),
+            RotationZYX(1e-5*double(i%3), 0e0, 1e-5*double(i%13)));
+    d.flags |= GlobalAlignmentStack::MATRIX_DEFINED;
+    return d;
+  }
+
+  /// Push alignment entries to the stack
+  void fill(GlobalAlignmentStack& stack, const vector<Target>& targets, size_t begin, size_t end)  {
+    for(size_t i=begin; i<end; ++i)  {
+      dd4hep_ptr<Entry> e(new Entry(targets[i].first, targets[i].second, delta(i), 0e0));
+      stack.insert(e);
+    }
+  }
+
+  /// Print a single line of the benchmark summary
+  void result(const char* what, size_t count, double seconds)  {
+    printout(ALWAYS,"AlignmentBenchmark","+  %-34s %8ld nodes %10.4f seconds %10.2f us/node",
+             what, long(count), seconds, count>0 ? 1e6*seconds/double(count) : 0e0);
+  }
+}
+
+/// Plugin function: Benchmark of the batched global alignment
+/**
+ *  Factory: DD4hep_GlobalAlignmentBatchBenchmark
+ *
+ *  \version 1.0
+ */
+static long global_alignment_batch_benchmark(Detector& description, int argc, char** argv)  {
+  long num_nodes = 100000, num_compare = 100;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-nodes",argv[i],4) && i+1 < argc )
+      num_nodes = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-compare",argv[i],4) && i+1 < argc )
+      num_compare = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || num_nodes < 1 || num_compare < 0 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_GlobalAlignmentBatchBenchmark            \n"
+      "     -nodes       <number>    Number of physical nodes to be aligned.         \n"
+      "     -compare     <number>    Number of nodes committed one by one before the \n"
+      "                              remaining nodes are committed in one batch.     \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  GlobalAlignmentCache* cache = GlobalAlignmentCache::install(description);
+  if ( GlobalAlignmentStack::exists() )  {
+    except("AlignmentBenchmark","+++ An alignment transaction is already open.");
+  }
+  vector<Target> targets;
+  for( const auto& c : description.world().children() )  {
+    DetElement   det = c.second;
+    PlacedVolume pv  = det.placement();
+    if ( pv.isValid() && targets.size() < size_t(num_nodes) )
+      collect(det, pv.ptr(), det.placementPath(), num_nodes, targets);
+  }
+  size_t num_single = std::min(targets.size(), size_t(num_compare));
+  size_t num_batch  = targets.size() - num_single;
+  TTimeStamp start, stop;
+
+  printout(ALWAYS,"AlignmentBenchmark","+=========================================================================");
+  printout(ALWAYS,"AlignmentBenchmark","+  Aligning %ld physical nodes.",long(targets.size()));
+  PrintLevel level = setPrintLevel(WARNING);
+  start = TTimeStamp();
+  for( size_t i=0; i<num_single; ++i )  {
+    GlobalAlignmentStack::create();
+    GlobalAlignmentStack& stack = GlobalAlignmentStack::get();
+    fill(stack, targets, i, i+1);
+    cache->commit(stack);
+    stack.release();
+  }
+  stop = TTimeStamp();
+  double t_single = stop.AsDouble()-start.AsDouble();
+
+  GlobalAlignmentStack::create();
+  GlobalAlignmentStack& stack = GlobalAlignmentStack::get();
+  start = TTimeStamp();
+  fill(stack, targets, num_single, targets.size());
+  stop = TTimeStamp();
+  double t_fill = stop.AsDouble()-start.AsDouble();
+  start = TTimeStamp();
+  cache->commitBatch(stack);
+  stop = TTimeStamp();
+  double t_batch = stop.AsDouble()-start.AsDouble();
+  stack.release();
+  setPrintLevel(level);
+
+  result("Single commits:", num_single, t_single);
+  result("Batch: filling the stack:", num_batch, t_fill);
+  result("Batch: commit:", num_batch, t_batch);
+
+  /// Every aligned node must carry the original matrix times the delta
+  size_t num_bad = 0;
+  for( size_t i=0; i<targets.size(); ++i )  {
+    GlobalAlignment a = cache->get(targets[i].second);
+    if ( !a.isValid() || !a->GetOriginalMatrix() )  {
+      ++num_bad;
+      continue;
+    }
+    TGeoHMatrix expected(*a->GetOriginalMatrix()), dm;
+    detail::matrix::_transform(dm, GlobalAlignmentOperator::deltaTransform(delta(i)));
+    expected.Multiply(&dm);
+    const TGeoMatrix* mat = a->GetNode()->GetMatrix();
+    const Double_t *t1 = expected.GetTranslation(), *t2 = mat->GetTranslation();
+    const Double_t *r1 = expected.GetRotationMatrix(), *r2 = mat->GetRotationMatrix();
+    bool ok = true;
+    for( int j=0; j<3; ++j ) ok = ok && std::fabs(t1[j]-t2[j]) < 1e-10;
+    for( int j=0; j<9; ++j ) ok = ok && std::fabs(r1[j]-r2[j]) < 1e-10;
+    if ( !ok ) ++num_bad;
+  }
+  printout(ALWAYS,"AlignmentBenchmark","+=========================================================================");
+  if ( num_bad > 0 )  {
+    except("AlignmentBenchmark","+++ %ld of %ld aligned nodes carry unexpected matrices.",
+           long(num_bad), long(targets.size()));
+  }
+  printout(ALWAYS,"AlignmentBenchmark","+  All %ld aligned nodes carry the expected matrices.",long(targets.size()));
+  return 1;
+}
+
+DECLARE_APPLY(DD4hep_GlobalAlignmentBatchBenchmark,global_alignment_batch_benchmark)
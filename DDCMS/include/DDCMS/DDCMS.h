@@ -24,6 +24,9 @@
 
 // C/C++ include files
 #include <map>
+#include <memory>
+#include <vector>
+#include <unordered_map>
 
 /// Namespace for the AIDA detector description toolkit
 namespace dd4hep {
@@ -65,17 +68,14 @@ namespace dd4hep {
       Namespace& operator=(const Namespace& copy) = delete;
       /// Prepend name with namespace
       std::string prepend(const std::string& n)  const;
-      /// Resolve namespace during XML parsing
+      /// Resolve namespace during XML parsing. Every reference is resolved in a single pass
       std::string real_name(const std::string& v)  const;
       /// Strip off the namespace part of a given name
       static std::string obj_name(const std::string& name);
       /// Return the namespace name of a component
       static std::string ns_name(const std::string& n);
-      template <typename T> T attr(xml_elt_t elt,const xml_tag_t& n) const   {
-        std::string val = real_name(elt.attr<std::string>(n));
-        elt.setAttr(n,val);
-        return elt.attr<T>(n);
-      }
+      /// Access namespace resolved attribute value
+      template <typename T> T attr(xml_elt_t elt,const xml_tag_t& n) const;
       /// Add a new constant to the namespace
       void addConstant(const std::string& name, const std::string& value, const std::string& type)  const;
       /// Add a new constant to the namespace as fully indicated by the name
@@ -109,12 +109,14 @@ namespace dd4hep {
      */
     class ParsingContext  {
     public:
-      Detector*                          description;
-      std::map<std::string, Rotation3D>  rotations;
-      std::map<std::string, Solid>       shapes;
-      std::map<std::string, Volume>      volumes;
-      std::vector<std::string>           namespaces;
+      Detector*                                    description;
+      std::unordered_map<std::string, Rotation3D>  rotations;
+      std::unordered_map<std::string, Solid>       shapes;
+      std::unordered_map<std::string, Volume>      volumes;
+      std::vector<std::string>                     namespaces;
       bool geo_inited = false;
+      /// Number of threads to parse independent include files (0: hardware concurrency)
+      size_t num_threads = 0;
 
       // Debug flags
       bool debug_includes     = false;
@@ -132,6 +134,10 @@ namespace dd4hep {
       ParsingContext(Detector* det) : description(det) { namespaces.push_back(""); }
       ~ParsingContext() = default;
       const std::string& ns() const  {  return namespaces.back(); }
+      /// Create an empty context to parse a single file with the same settings
+      std::unique_ptr<ParsingContext> fileContext()  const;
+      /// Merge the objects of a per-file context. Existing entries are overwritten
+      void merge(const ParsingContext& file_context);
     };
 
     /// Encapsulation of the CMS detector description algorithm arguments
@@ -33,6 +33,7 @@ namespace dd4hep {
     UNICODE(DDCMS);
 
     UNICODE(DDDefinition);
+    UNICODE(threads);
 
     UNICODE(ConstantsSection);
     UNICODE(Constant);
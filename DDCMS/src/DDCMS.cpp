@@ -119,22 +119,62 @@ string Namespace::prepend(const string& n)  const   {
 
 /// Resolve namespace during XML parsing
 string Namespace::real_name(const string& v)  const  {
-  size_t idx, idq, idp;
-  string val = v;
-  while ( (idx=val.find('[')) != string::npos )  {
-    val.erase(idx,1);
-    idp = val.find(':');
-    idq = val.find(']');
-    val.erase(idq,1);
-    if ( idp == string::npos || idp > idq )
-      val.insert(idx,name);
-    else if ( idp != string::npos && idp < idq )
-      val[idp] = NAMESPACE_SEP;
+  size_t len = v.length(), idq = string::npos;
+  string val;
+  val.reserve(len+name.length());
+  for( size_t idx=0; idx < len; ++idx )  {
+    char c = v[idx];
+    if ( c == '[' )  {
+      // References without explicit namespace [name] belong to the current namespace
+      idq = v.find(']',idx+1);
+      if ( idq == string::npos )
+        except("DDCMS","+++ Unbalanced '[' in the reference: %s",v.c_str());
+      size_t idp = v.find(':',idx+1);
+      if ( idp == string::npos || idp > idq ) val += name;
+    }
+    else if ( c == ']' && idx == idq )
+      idq = string::npos;
+    else if ( c == ':' )
+      val += NAMESPACE_SEP;
+    else
+      val += c;
   }
-  while ( (idx=val.find(':')) != string::npos ) val[idx]=NAMESPACE_SEP;
   return val;
 }
 
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace of DDCMS conversion namespace
+  namespace cms  {
+
+    /// Access namespace resolved attribute value
+    template <> string Namespace::attr<string>(xml_elt_t elt,const xml_tag_t& n)  const  {
+      return real_name(elt.attr<string>(n));
+    }
+
+    /// Access namespace resolved attribute value
+    template <> double Namespace::attr<double>(xml_elt_t elt,const xml_tag_t& n)  const  {
+      return _toDouble(real_name(elt.attr<string>(n)));
+    }
+
+    /// Access namespace resolved attribute value
+    template <> float Namespace::attr<float>(xml_elt_t elt,const xml_tag_t& n)  const  {
+      return _toFloat(real_name(elt.attr<string>(n)));
+    }
+
+    /// Access namespace resolved attribute value
+    template <> long Namespace::attr<long>(xml_elt_t elt,const xml_tag_t& n)  const  {
+      return _toLong(real_name(elt.attr<string>(n)));
+    }
+
+    /// Access namespace resolved attribute value
+    template <> int Namespace::attr<int>(xml_elt_t elt,const xml_tag_t& n)  const  {
+      return _toInt(real_name(elt.attr<string>(n)));
+    }
+  }
+}
+
 /// Return the namespace name of a component
 string Namespace::ns_name(const string& nam)    {
   size_t idx;
@@ -279,6 +319,31 @@ Solid Namespace::solid(const string& nam)  const   {
   throw runtime_error("Unknown shape identifier:"+nam);
 }
 
+/// Create an empty context to parse a single file with the same settings
+unique_ptr<ParsingContext> ParsingContext::fileContext()  const   {
+  unique_ptr<ParsingContext> ctx(new ParsingContext(description));
+  ctx->geo_inited       = geo_inited;
+  ctx->num_threads      = num_threads;
+  ctx->debug_includes   = debug_includes;
+  ctx->debug_constants  = debug_constants;
+  ctx->debug_materials  = debug_materials;
+  ctx->debug_rotations  = debug_rotations;
+  ctx->debug_shapes     = debug_shapes;
+  ctx->debug_volumes    = debug_volumes;
+  ctx->debug_placements = debug_placements;
+  ctx->debug_namespaces = debug_namespaces;
+  ctx->debug_visattr    = debug_visattr;
+  ctx->debug_algorithms = debug_algorithms;
+  return ctx;
+}
+
+/// Merge the objects of a per-file context. Existing entries are overwritten
+void ParsingContext::merge(const ParsingContext& file_context)   {
+  for( const auto& r : file_context.rotations ) rotations[r.first] = r.second;
+  for( const auto& s : file_context.shapes )    shapes[s.first]    = s.second;
+  for( const auto& v : file_context.volumes )   volumes[v.first]   = v.second;
+}
+
 AlgoArguments::AlgoArguments(ParsingContext& ctxt, xml_h elt)
   : context(ctxt), element(elt)
 {
@@ -34,8 +34,13 @@
 
 // C/C++ include files
 #include <climits>
+#include <cstring>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
+#include <atomic>
+#include <thread>
+#include <mutex>
 #include <set>
 #include <map>
 
@@ -58,6 +63,7 @@ namespace dd4hep {
     class constant;
     class resolve   {
     public:
+      std::vector<std::string>   include_paths;
       std::vector<xml::Document> includes;
       std::map<std::string,std::string>  unresolvedConst, allConst, originalConst;
     };
@@ -625,13 +631,16 @@ template <> void Converter<box>::operator()(xml_h element) const {
   _ns.addSolid(nam, Box(dx,dy,dz));
 }
 
-/// DD4hep specific Converter for <Include/> tags: process only the constants
+/// DD4hep specific Converter for <Include/> tags: register the file to be loaded
 template <> void Converter<include_load>::operator()(xml_h element) const   {
-  xml::Document doc = xml::DocumentHandler().load(element, element.attr_value(_U(ref)));
-  string fname = xml::DocumentHandler::system_path(doc.root());
-  printout(_param<ParsingContext>()->debug_includes ? ALWAYS : DEBUG,
-           "DDCMS","+++ Processing the CMS detector description %s",fname.c_str());
-  _option<resolve>()->includes.push_back(doc);
+  // The system path is resolved before the loader threads start. The threads then see no
+  // ${...} references and make no environment lookup: the lookup reports its result
+  // through the status of the shared evaluator, which another thread may overwrite.
+  string ref   = element.attr<string>(_U(ref));
+  string fname = xml::DocumentHandler::system_path(element, ref);
+  if ( fname.find("${") != string::npos )
+    except("DDCMS","+++ Cannot resolve the include file %s",ref.c_str());
+  _option<resolve>()->include_paths.push_back(fname);
 }
 
 /// DD4hep specific Converter for <Include/> tags: process only the constants
@@ -788,6 +797,63 @@ template <> void Converter<print_xml_doc>::operator()(xml_h element) const {
            "DDCMS","+++ Processing data from file:%s",fname.c_str());
 }
 
+/// Execute a task for each of <count> independent files using a pool of threads
+/** The calling thread takes part. The first exception thrown by a task is rethrown. */
+template <typename TASK>
+static void parse_concurrently(size_t num_threads, size_t count, TASK task)   {
+  size_t num = num_threads > 0 ? num_threads : thread::hardware_concurrency();
+  atomic<size_t> next(0);
+  exception_ptr  error;
+  mutex          error_lock;
+  auto worker = [&]()  {
+    for( size_t i = next++; i < count; i = next++ )  {
+      try  {
+        task(i);
+      }
+      catch(...)  {
+        lock_guard<mutex> guard(error_lock);
+        if ( !error ) error = current_exception();
+        next = count;
+      }
+    }
+  };
+  vector<thread> threads;
+  for( size_t i=1; i < min(num, count); ++i )
+    threads.emplace_back(worker);
+  worker();
+  for( auto& t : threads ) t.join();
+  if ( error ) rethrow_exception(error);
+}
+
+/// Load the include files concurrently. The documents are stored in the order of the paths
+static void load_includes(const ParsingContext& ctxt, resolve& res)   {
+  res.includes.resize(res.include_paths.size());
+  parse_concurrently(ctxt.num_threads, res.includes.size(), [&](size_t i)  {
+      const string& fname = res.include_paths[i];
+      res.includes[i] = xml::DocumentHandler().load(fname);
+      if ( !res.includes[i].ptr() )
+        except("DDCMS","+++ FAILED to load the CMS detector description %s",fname.c_str());
+      printout(ctxt.debug_includes ? ALWAYS : DEBUG,
+               "DDCMS","+++ Processing the CMS detector description %s",fname.c_str());
+    });
+}
+
+/// Parse the rotations of the include files concurrently
+/** Rotations do not touch the geometry: they are parsed into one context per file.
+ *  The contexts are merged in the order of the include files.
+ */
+static void parse_rotations(Detector& det, ParsingContext& ctxt, const resolve& res)   {
+  vector<unique_ptr<ParsingContext> > file_contexts(res.includes.size());
+  parse_concurrently(ctxt.num_threads, res.includes.size(), [&](size_t i)  {
+      unique_ptr<ParsingContext> c = ctxt.fileContext();
+      xml_h root = res.includes[i].root();
+      Converter<print_xml_doc>(det,c.get())(root);
+      xml_coll_t(root,_CMU(RotationSection)).for_each(Converter<rotationsection>(det,c.get()));
+      file_contexts[i] = move(c);
+    });
+  for( const auto& c : file_contexts ) ctxt.merge(*c);
+}
+
 /// Converter for <DDDefinition/> tags
 static long load_dddefinition(Detector& det, xml_h element) {
   static ParsingContext ctxt(&det);
@@ -797,6 +863,9 @@ static long load_dddefinition(Detector& det, xml_h element) {
   bool open_geometry  = dddef.hasChild(_CMU(open_geometry));
   bool close_geometry = dddef.hasChild(_CMU(close_geometry));
 
+  if ( dddef.hasAttr(_CMU(threads)) )
+    ctxt.num_threads = dddef.attr<int>(_CMU(threads));
+
   xml_coll_t(dddef, _U(debug)).for_each(Converter<debug>(det,&ctxt));
 
   // Here we define the order how XML elements are processed.
@@ -815,6 +884,7 @@ static long load_dddefinition(Detector& det, xml_h element) {
     xml_coll_t(dddef, _CMU(MaterialSection)).for_each(Converter<materialsection>(det,&ctxt));
 
     xml_coll_t(dddef, _CMU(IncludeSection)).for_each(_CMU(Include), Converter<include_load>(det,&ctxt,&res));
+    load_includes(ctxt, res);
 
     for(xml::Document d : res.includes ) Converter<include_constants>(det,&ctxt,&res)((doc=d).root());
     // Before we continue, we have to resolve all constants NOW!
@@ -829,10 +899,7 @@ static long load_dddefinition(Detector& det, xml_h element) {
       det.init();
       _ns.addVolume(det.worldVolume());
     }
-    for(xml::Document d : res.includes )  {
-      print_doc((doc=d).root());
-      xml_coll_t(d.root(),_CMU(RotationSection)).for_each(Converter<rotationsection>(det,&ctxt));
-    }
+    parse_rotations(det, ctxt, res);
     for(xml::Document d : res.includes )  {
       print_doc((doc=d).root());
       xml_coll_t(d.root(), _CMU(SolidSection)).for_each(Converter<solidsection>(det,&ctxt));
@@ -879,3 +946,80 @@ static long load_dddefinition(Detector& det, xml_h element) {
 
 // Now declare the factory entry for the plugin mechanism
 DECLARE_XML_DOC_READER(DDDefinition,load_dddefinition)
+
+/// Compare the concurrent parse of the include files with the sequential parse
+/**
+ *  Factory: DDCMS_ParallelParseTest
+ *
+ *  The include files of a <DDDefinition/> document are loaded and their rotations
+ *  parsed once in sequence and once concurrently. The rotation tables must agree.
+ *  The constants must be known: the document must be loaded before.
+ *
+ *  \author  M.Frank
+ *  \version 1.0
+ */
+static long check_parallel_parse(Detector& det, int argc, char** argv) {
+  string input;
+  size_t num_threads = 4;
+  for(int i = 0; i < argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-threads",argv[i],4) )
+      num_threads = ::atol(argv[++i]);
+  }
+  if ( input.empty() || num_threads == 0 )   {
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DDCMS_ParallelParseTest                           \n"
+      "     -input   <string>        <DDDefinition/> document to be checked.           \n"
+      "     -threads <number>        Number of threads (default: 4).                   \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+  xml::DocumentHolder doc(xml::DocumentHandler().load(input));
+  xml_h root = doc.root();
+  ParsingContext seq_ctxt(&det), par_ctxt(&det);
+  resolve seq, par;
+  par_ctxt.num_threads = num_threads;
+  xml_coll_t(root, _CMU(IncludeSection)).for_each(_CMU(Include), Converter<include_load>(det,&seq_ctxt,&seq));
+  par.include_paths = seq.include_paths;
+
+  // Sequential reference: one file after the other into a single context
+  for( const auto& fname : seq.include_paths )  {
+    seq.includes.push_back(xml::DocumentHandler().load(fname));
+    if ( !seq.includes.back().ptr() )
+      except("DDCMS","+++ FAILED to load the CMS detector description %s",fname.c_str());
+  }
+  for( xml::Document d : seq.includes )
+    xml_coll_t(d.root(),_CMU(RotationSection)).for_each(Converter<rotationsection>(det,&seq_ctxt));
+
+  load_includes(par_ctxt, par);
+  parse_rotations(det, par_ctxt, par);
+
+  size_t num_errors = 0;
+  if ( seq_ctxt.rotations.size() != par_ctxt.rotations.size() )   {
+    printout(ERROR,"DDCMS","+++ Number of rotations differ: sequential:%ld parallel:%ld",
+             long(seq_ctxt.rotations.size()), long(par_ctxt.rotations.size()));
+    ++num_errors;
+  }
+  for( const auto& r : seq_ctxt.rotations )  {
+    auto i = par_ctxt.rotations.find(r.first);
+    if ( i == par_ctxt.rotations.end() )   {
+      printout(ERROR,"DDCMS","+++ Rotation %s missing in the parallel parse",r.first.c_str());
+      ++num_errors;
+    }
+    else if ( !(i->second == r.second) )   {
+      printout(ERROR,"DDCMS","+++ Rotation %s differs in the parallel parse",r.first.c_str());
+      ++num_errors;
+    }
+  }
+  for( xml::Document d : seq.includes ) xml::DocumentHolder(d).assign(0);
+  for( xml::Document d : par.includes ) xml::DocumentHolder(d).assign(0);
+  if ( num_errors > 0 )
+    except("DDCMS","+++ Parallel parse of %s with %ld threads differs from the sequential parse",
+           input.c_str(), long(num_threads));
+  printout(ALWAYS,"DDCMS","+++ Parallel and sequential parse agree: %ld files, %ld rotations, %ld threads",
+           long(seq.include_paths.size()), long(seq_ctxt.rotations.size()), long(num_threads));
+  return 1;
+}
+DECLARE_APPLY(DDCMS_ParallelParseTest,check_parallel_parse)
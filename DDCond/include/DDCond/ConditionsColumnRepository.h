@@ -0,0 +1,181 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_CONDITIONS_CONDITIONSCOLUMNREPOSITORY_H
+#define DD4HEP_CONDITIONS_CONDITIONSCOLUMNREPOSITORY_H
+
+// Framework include files
+#include "DDCond/ConditionsManager.h"
+#include "DD4hep/Mutex.h"
+
+// C/C++ include files
+#include <map>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for implementation details of the AIDA detector description toolkit
+  namespace cond {
+
+    /// Columnar, memory mappable binary conditions repository
+    /**
+     *  The repository stores raw (non-derived) conditions in column order:
+     *  one column each for the condition key, the IOV type, the lower and upper
+     *  IOV bound, the flags, the payload grammar and the references to the
+     *  name, type and payload data. Rows are sorted by key and IOV, so that all
+     *  versions of one condition are adjacent and can be found by binary search.
+     *
+     *  Payloads of bound OpaqueDataBlocks are grouped in one blob per grammar.
+     *  Fundamental types (int, double, ...) are stored as raw bytes, all other
+     *  types in the string representation of their grammar. Conditions
+     *  without bound payload keep their value string.
+     *
+     *  When reading, the file is mapped into memory and only the header
+     *  is interpreted. A condition object is created on the first access to
+     *  its row and cached afterwards. Hence opening a repository costs the
+     *  same independent of its size and jobs only pay for the conditions they use.
+     *
+     *  The file format uses the native byte order and is not portable
+     *  between architectures of different endianness.
+     *
+     *  \version 1.0
+     *  \ingroup DD4HEP_CONDITIONS
+     */
+    class ConditionsColumnRepository  {
+    public:
+      typedef Condition::key_type key_type;
+
+      /// Payload encoding of a single row
+      enum Encoding  {
+        ENCODE_UNBOUND = 0,   //! Payload not bound: only the value string is stored
+        ENCODE_RAW     = 1,   //! Raw bytes of fundamental types
+        ENCODE_STRING  = 2    //! String representation of the payload grammar
+      };
+
+      /// File header. All column offsets are relative to the start of the file.
+      struct Header  {
+        char     magic[8];
+        uint32_t version;
+        uint32_t numIOVTypes;
+        uint64_t numRows;
+        uint64_t numGrammars;
+        uint64_t iovTypes, grammars;
+        uint64_t keys, iovType, iovLower, iovUpper, flags, grammar, encoding;
+        uint64_t names, types, payloads;
+        uint64_t strings, blobs, fileSize;
+      };
+      /// Record of the IOV type table
+      struct IOVTypeRecord  {
+        uint32_t type;
+        char     name[60];
+      };
+      /// Record of the grammar table: one payload blob per grammar
+      struct GrammarRecord  {
+        uint64_t hash, offset, length, count;
+      };
+      /// Reference to variable length data in the string or payload heap
+      struct DataRef  {
+        uint64_t offset, length;
+      };
+
+    protected:
+      /// Start of the mapped file
+      const char*          m_data     = 0;
+      /// Length of the mapped file
+      size_t               m_length   = 0;
+      /// File header
+      const Header*        m_header   = 0;
+      /// Column pointers into the mapped file
+      const uint64_t*      m_keys     = 0;
+      const uint32_t*      m_iovType  = 0;
+      const int64_t*       m_iovLower = 0;
+      const int64_t*       m_iovUpper = 0;
+      const uint32_t*      m_flags    = 0;
+      const uint64_t*      m_grammar  = 0;
+      const uint8_t*       m_encoding = 0;
+      const DataRef*       m_names    = 0;
+      const DataRef*       m_types    = 0;
+      const DataRef*       m_payloads = 0;
+      /// Table of the IOV types used
+      std::vector<IOVType> m_iovTypes;
+      /// IOV objects of the decoded conditions
+      mutable std::map<std::pair<uint32_t,IOV::Key>, std::unique_ptr<IOV> > m_iovs;
+      /// Lazily created condition objects, one per row
+      mutable std::vector<Condition::Object*> m_objects;
+      /// Number of rows already decoded
+      mutable size_t       m_numDecoded = 0;
+      /// Protection of the lazy decoding
+      mutable dd4hep_mutex_t m_lock;
+
+      /// Check all column and data ranges against the mapped length. Returns 0 or the error message
+      const char* checkRanges()  const;
+      /// Create the condition object of a given row
+      Condition::Object* decode(size_t row)  const;
+      /// Access the IOV object of a given row
+      const IOV* rowIOV(size_t row)  const;
+      /// Access the IOV type of a given row
+      const IOVType* rowIOVType(size_t row)  const;
+
+    public:
+      /// Default constructor
+      ConditionsColumnRepository();
+      /// Initializing constructor: opens the repository file
+      ConditionsColumnRepository(const std::string& input);
+      /// No copy constructor
+      ConditionsColumnRepository(const ConditionsColumnRepository& copy) = delete;
+      /// Default destructor
+      virtual ~ConditionsColumnRepository();
+      /// No assignment
+      ConditionsColumnRepository& operator=(const ConditionsColumnRepository& copy) = delete;
+
+      /// Save conditions to file. Dependent conditions shall not be saved! Returns number of rows
+      static size_t save(const std::vector<Condition>& conditions, const std::string& output);
+      /// Save all raw conditions of the conditions manager to file. Returns number of rows
+      static size_t save(ConditionsManager mgr, const std::string& output);
+
+      /// Map the repository file into memory. Throws on failure.
+      void open(const std::string& input);
+      /// Release all decoded conditions and unmap the file
+      void close();
+      /// Check if a repository file is mapped
+      bool isOpen()  const                 {  return 0 != m_header;  }
+      /// Number of rows in the repository
+      size_t size()  const;
+      /// Number of rows already decoded
+      size_t numDecoded()  const           {  return m_numDecoded;   }
+      /// The IOV types used by the repository
+      const std::vector<IOVType>& iovTypes()  const  {  return m_iovTypes;  }
+
+      /// Access the key of a given row without decoding the condition
+      key_type key(size_t row)  const      {  return m_keys[row];    }
+      /// Access the IOV range of a given row without decoding the condition
+      IOV::Key iovKey(size_t row)  const   {  return IOV::Key(m_iovLower[row],m_iovUpper[row]); }
+      /// Rows with the given condition key: [first,last)
+      std::pair<size_t,size_t> rows(key_type key)  const;
+      /// Row of the condition with the given key valid for the requested IOV. Returns size() if absent
+      size_t find(key_type key, const IOV& req_validity)  const;
+
+      /// Access the condition of a given row. Decoded on first access.
+      Condition get(size_t row)  const;
+      /// Access the condition with the given key valid for the requested IOV (may be invalid)
+      Condition get(key_type key, const IOV& req_validity)  const;
+
+      /// Decode all rows and add them to the conditions pools of the manager
+      size_t import(ConditionsManager mgr)  const;
+      /// Add the condition of a given row to the pool of its IOV in the conditions manager
+      bool registerCondition(ConditionsManager mgr, size_t row)  const;
+    };
+
+  }        /* End namespace cond                              */
+}          /* End namespace dd4hep                            */
+#endif     /* DD4HEP_CONDITIONS_CONDITIONSCOLUMNREPOSITORY_H  */
@@ -0,0 +1,517 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework include files
+#include "DDCond/ConditionsColumnRepository.h"
+#include "DDCond/ConditionsIOVPool.h"
+#include "DDCond/ConditionsPool.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/BasicGrammar.h"
+#include "DD4hep/detail/ConditionsInterna.h"
+
+// ROOT include files
+#include "TDataType.h"
+
+// C/C++ include files
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::cond;
+
+typedef ConditionsColumnRepository Repository;
+
+namespace {
+
+  const char     s_magic[8] = { 'D','D','4','C','O','N','D','C' };
+  const uint32_t s_version  = 1;
+
+  /// Round up to the next 8-byte boundary
+  inline uint64_t aligned(uint64_t len)   {
+    return (len+7) & ~uint64_t(7);
+  }
+
+  /// Check that a column of 'count' entries of type T at 'offset' lies within 'length' bytes
+  template <typename T> inline bool column_ok(uint64_t offset, uint64_t count, uint64_t length)   {
+    return offset % alignof(T) == 0 && offset <= length && count <= (length-offset) / sizeof(T);
+  }
+
+  /// Check that a data reference lies within a heap of 'length' bytes
+  inline bool data_ok(const Repository::DataRef& ref, uint64_t length)   {
+    return ref.offset <= length && ref.length <= length - ref.offset;
+  }
+
+  /// Payload encoding for a given grammar
+  inline uint8_t encoding(const BasicGrammar* g)   {
+    if ( !g )
+      return Repository::ENCODE_UNBOUND;
+    else if ( 0 == g->clazz() && g->data_type() != kCharStar )
+      return Repository::ENCODE_RAW;
+    return Repository::ENCODE_STRING;
+  }
+
+  /// Sequential writer of the column file
+  class Writer  {
+  public:
+    int      fd     = -1;
+    uint64_t offset = 0;
+    Writer(const string& output)   {
+      fd = ::open(output.c_str(),O_WRONLY|O_CREAT|O_TRUNC,S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+      if ( fd < 0 )   {
+        except("ConditionsColumnRepository","+++ Failed to open output file %s: %s",
+               output.c_str(), ::strerror(errno));
+      }
+    }
+    ~Writer()   {
+      if ( fd >= 0 ) ::close(fd);
+    }
+    /// Write data block and pad to 8 bytes. Returns the offset of the block.
+    uint64_t write(const void* data, uint64_t len)   {
+      static const char pad[8] = {0,0,0,0,0,0,0,0};
+      uint64_t   start = offset;
+      const char* ptr  = (const char*)data;
+      for( uint64_t done = 0; done < len; )   {
+        ssize_t n = ::write(fd, ptr+done, len-done);
+        if ( n <= 0 )   {
+          except("ConditionsColumnRepository","+++ Failed to write %ld bytes: %s",
+                 long(len-done), ::strerror(errno));
+        }
+        done += n;
+      }
+      offset += len;
+      if ( aligned(offset) != offset )   {
+        uint64_t npad = aligned(offset)-offset;
+        if ( ::write(fd, pad, npad) != ssize_t(npad) )   {
+          except("ConditionsColumnRepository","+++ Failed to write padding: %s",::strerror(errno));
+        }
+        offset += npad;
+      }
+      return start;
+    }
+    template <typename T> uint64_t write(const vector<T>& column)   {
+      return write(column.data(), column.size()*sizeof(T));
+    }
+  };
+}
+
+/// Default constructor
+ConditionsColumnRepository::ConditionsColumnRepository()  {
+}
+
+/// Initializing constructor: opens the repository file
+ConditionsColumnRepository::ConditionsColumnRepository(const string& input)  {
+  open(input);
+}
+
+/// Default destructor
+ConditionsColumnRepository::~ConditionsColumnRepository()   {
+  close();
+}
+
+/// Save conditions to file. Dependent conditions shall not be saved! Returns number of rows
+size_t ConditionsColumnRepository::save(const vector<Condition>& conditions, const string& output)   {
+  struct Row  {
+    Condition::Object* object;
+    const IOV*         iov;
+  };
+  struct Blob  {
+    uint64_t index = 0, count = 0;
+    string   data;
+  };
+  vector<Row> rows;
+  rows.reserve(conditions.size());
+  for( const auto& c : conditions )   {
+    Condition::Object* o = c.ptr();
+    if ( !o )
+      except("ConditionsColumnRepository","+++ Cannot save invalid condition handle.");
+    else if ( !o->iov || !o->iov->iovType )
+      except("ConditionsColumnRepository","+++ Cannot save condition %s without IOV.",o->GetName());
+    rows.push_back({o, o->iov});
+  }
+  sort(rows.begin(), rows.end(), [](const Row& a, const Row& b)  {
+      if ( a.object->hash != b.object->hash ) return a.object->hash < b.object->hash;
+      if ( a.iov->type     != b.iov->type   ) return a.iov->type     < b.iov->type;
+      return a.iov->keyData < b.iov->keyData;
+    });
+
+  size_t num_rows = rows.size();
+  vector<uint64_t> keys(num_rows), grammars(num_rows);
+  vector<uint32_t> iov_types(num_rows), flags(num_rows);
+  vector<int64_t>  iov_lower(num_rows), iov_upper(num_rows);
+  vector<uint8_t>  encodings(num_rows);
+  vector<DataRef>  names(num_rows), types(num_rows), payloads(num_rows);
+  vector<IOVTypeRecord> iov_records;
+  map<uint32_t,string>  iov_type_names;
+  map<uint64_t,Blob>    blobs;
+  map<string,DataRef>   type_strings;
+  string strings;
+
+  auto add_string = [&strings](const string& s)  {
+    DataRef r = { strings.length(), s.length() };
+    strings.append(s);
+    return r;
+  };
+  for( size_t i=0; i<num_rows; ++i )   {
+    const Row&          r = rows[i];
+    Condition::Object*  o = r.object;
+    const BasicGrammar* g = o->data.grammar;
+    uint8_t           enc = encoding(g);
+    Blob&            blob = blobs[g ? g->hash() : 0];
+    auto             type = type_strings.find(o->GetTitle());
+
+    keys[i]      = o->hash;
+    iov_types[i] = r.iov->iovType->type;
+    iov_lower[i] = r.iov->keyData.first;
+    iov_upper[i] = r.iov->keyData.second;
+    flags[i]     = o->flags;
+    grammars[i]  = g ? g->hash() : 0;
+    encodings[i] = enc;
+    names[i]     = add_string(o->GetName());
+    if ( type == type_strings.end() )
+      type = type_strings.insert(make_pair(string(o->GetTitle()),add_string(o->GetTitle()))).first;
+    types[i]     = type->second;
+    iov_type_names[r.iov->iovType->type] = r.iov->iovType->name;
+
+    // Payload offsets are local to the grammar blob. Made global once the blob sizes are known
+    if ( enc == ENCODE_RAW )   {
+      size_t len = g->sizeOf();
+      blob.data.append(aligned(blob.data.length())-blob.data.length(), '\0');
+      payloads[i] = { blob.data.length(), len };
+      blob.data.append((const char*)o->data.ptr(), len);
+    }
+    else   {
+      string val = enc == ENCODE_STRING ? o->data.str() : o->value;
+      payloads[i] = { blob.data.length(), val.length() };
+      blob.data.append(val);
+    }
+    ++blob.count;
+  }
+
+  // Global layout of the payload blobs: one contiguous, 8-byte aligned blob per grammar
+  vector<GrammarRecord> grammar_records;
+  uint64_t blob_offset = 0;
+  for( auto& b : blobs )   {
+    b.second.index = grammar_records.size();
+    grammar_records.push_back({ b.first, blob_offset, b.second.data.length(), b.second.count });
+    blob_offset += aligned(b.second.data.length());
+  }
+  for( size_t i=0; i<num_rows; ++i )
+    payloads[i].offset += grammar_records[blobs[grammars[i]].index].offset;
+  for( const auto& t : iov_type_names )   {
+    IOVTypeRecord rec;
+    ::memset(&rec, 0, sizeof(rec));
+    rec.type = t.first;
+    ::strncpy(rec.name, t.second.c_str(), sizeof(rec.name)-1);
+    iov_records.push_back(rec);
+  }
+
+  Header hdr;
+  Writer wr(output);
+  ::memset(&hdr, 0, sizeof(hdr));
+  wr.write(&hdr, sizeof(hdr));
+  hdr.iovTypes = wr.write(iov_records);
+  hdr.grammars = wr.write(grammar_records);
+  hdr.keys     = wr.write(keys);
+  hdr.iovType  = wr.write(iov_types);
+  hdr.iovLower = wr.write(iov_lower);
+  hdr.iovUpper = wr.write(iov_upper);
+  hdr.flags    = wr.write(flags);
+  hdr.grammar  = wr.write(grammars);
+  hdr.encoding = wr.write(encodings);
+  hdr.names    = wr.write(names);
+  hdr.types    = wr.write(types);
+  hdr.payloads = wr.write(payloads);
+  hdr.strings  = wr.write(strings.data(), strings.length());
+  hdr.blobs    = wr.offset;
+  for( const auto& b : blobs )
+    wr.write(b.second.data.data(), b.second.data.length());
+  ::memcpy(hdr.magic, s_magic, sizeof(hdr.magic));
+  hdr.version     = s_version;
+  hdr.numIOVTypes = iov_records.size();
+  hdr.numRows     = num_rows;
+  hdr.numGrammars = grammar_records.size();
+  hdr.fileSize    = wr.offset;
+  if ( ::pwrite(wr.fd, &hdr, sizeof(hdr), 0) != ssize_t(sizeof(hdr)) )   {
+    except("ConditionsColumnRepository","+++ Failed to write header to %s: %s",
+           output.c_str(), ::strerror(errno));
+  }
+  printout(INFO,"ConditionsColumnRepository",
+           "+++ Saved %ld conditions of %ld IOV types and %ld grammars to %s [%ld bytes].",
+           num_rows, iov_records.size(), grammar_records.size(), output.c_str(), long(wr.offset));
+  return num_rows;
+}
+
+/// Save all raw conditions of the conditions manager to file. Returns number of rows
+size_t ConditionsColumnRepository::save(ConditionsManager mgr, const string& output)   {
+  vector<Condition> conditions;
+  for( const IOVType* type : mgr.iovTypesUsed() )   {
+    ConditionsIOVPool* pool = mgr.iovPool(*type);
+    if ( pool )   {
+      for( const auto& p : pool->elements )
+        p.second->select_all(conditions);
+    }
+  }
+  return save(conditions, output);
+}
+
+/// Map the repository file into memory. Throws on failure.
+void ConditionsColumnRepository::open(const string& input)   {
+  struct stat buff;
+  close();
+  int fd = ::open(input.c_str(), O_RDONLY);
+  if ( fd < 0 || ::fstat(fd, &buff) != 0 )   {
+    if ( fd >= 0 ) ::close(fd);
+    except("ConditionsColumnRepository","+++ Failed to open repository %s: %s",
+           input.c_str(), ::strerror(errno));
+  }
+  if ( size_t(buff.st_size) < sizeof(Header) )   {
+    ::close(fd);
+    except("ConditionsColumnRepository","+++ File %s is no conditions repository [Too short]",
+           input.c_str());
+  }
+  void* ptr = ::mmap(0, buff.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if ( ptr == MAP_FAILED )   {
+    except("ConditionsColumnRepository","+++ Failed to map repository %s: %s",
+           input.c_str(), ::strerror(errno));
+  }
+  const Header* hdr = (const Header*)ptr;
+  if ( ::memcmp(hdr->magic, s_magic, sizeof(s_magic)) != 0 ||
+       hdr->version != s_version || hdr->fileSize != uint64_t(buff.st_size) )   {
+    ::munmap(ptr, buff.st_size);
+    except("ConditionsColumnRepository","+++ File %s is no conditions repository "
+           "or has an incompatible version.", input.c_str());
+  }
+  m_data     = (const char*)ptr;
+  m_length   = buff.st_size;
+  m_header   = hdr;
+  if ( const char* err = checkRanges() )   {
+    close();
+    except("ConditionsColumnRepository","+++ Corrupted conditions repository %s [%s]",
+           input.c_str(), err);
+  }
+  m_keys     = (const uint64_t*)(m_data + hdr->keys);
+  m_iovType  = (const uint32_t*)(m_data + hdr->iovType);
+  m_iovLower = (const int64_t*) (m_data + hdr->iovLower);
+  m_iovUpper = (const int64_t*) (m_data + hdr->iovUpper);
+  m_flags    = (const uint32_t*)(m_data + hdr->flags);
+  m_grammar  = (const uint64_t*)(m_data + hdr->grammar);
+  m_encoding = (const uint8_t*) (m_data + hdr->encoding);
+  m_names    = (const DataRef*) (m_data + hdr->names);
+  m_types    = (const DataRef*) (m_data + hdr->types);
+  m_payloads = (const DataRef*) (m_data + hdr->payloads);
+  m_objects.assign(hdr->numRows, 0);
+  m_numDecoded = 0;
+  const IOVTypeRecord* rec = (const IOVTypeRecord*)(m_data + hdr->iovTypes);
+  for( uint32_t i=0; i<hdr->numIOVTypes; ++i )   {
+    IOVType typ;
+    typ.type = rec[i].type;
+    typ.name = string(rec[i].name, ::strnlen(rec[i].name, sizeof(rec[i].name)));
+    m_iovTypes.push_back(typ);
+  }
+  printout(DEBUG,"ConditionsColumnRepository","+++ Mapped repository %s: %ld conditions [%ld bytes].",
+           input.c_str(), long(hdr->numRows), long(m_length));
+}
+
+/// Check all column and data ranges against the mapped length. Returns 0 or the error message
+const char* ConditionsColumnRepository::checkRanges()  const   {
+  // The counts and offsets come from the file: the checks must not overflow.
+  const Header*  hdr  = m_header;
+  const uint64_t len  = m_length;
+  const uint64_t rows = hdr->numRows;
+  if ( !column_ok<IOVTypeRecord>(hdr->iovTypes, hdr->numIOVTypes, len) )
+    return "IOV type table outside the file";
+  if ( !column_ok<GrammarRecord>(hdr->grammars, hdr->numGrammars, len) )
+    return "Grammar table outside the file";
+  if ( !column_ok<uint64_t>(hdr->keys,     rows, len) ) return "Key column outside the file";
+  if ( !column_ok<uint32_t>(hdr->iovType,  rows, len) ) return "IOV type column outside the file";
+  if ( !column_ok<int64_t> (hdr->iovLower, rows, len) ) return "IOV lower bound column outside the file";
+  if ( !column_ok<int64_t> (hdr->iovUpper, rows, len) ) return "IOV upper bound column outside the file";
+  if ( !column_ok<uint32_t>(hdr->flags,    rows, len) ) return "Flag column outside the file";
+  if ( !column_ok<uint64_t>(hdr->grammar,  rows, len) ) return "Grammar column outside the file";
+  if ( !column_ok<uint8_t> (hdr->encoding, rows, len) ) return "Encoding column outside the file";
+  if ( !column_ok<DataRef> (hdr->names,    rows, len) ) return "Name column outside the file";
+  if ( !column_ok<DataRef> (hdr->types,    rows, len) ) return "Type column outside the file";
+  if ( !column_ok<DataRef> (hdr->payloads, rows, len) ) return "Payload column outside the file";
+  if ( hdr->strings > hdr->blobs || hdr->blobs > len )
+    return "String or payload heap outside the file";
+
+  // Names and types point into the string heap, payloads into the payload heap
+  const uint64_t  str_len  = hdr->blobs - hdr->strings;
+  const uint64_t  blob_len = len - hdr->blobs;
+  const uint64_t* keys     = (const uint64_t*)(m_data + hdr->keys);
+  const DataRef*  names    = (const DataRef*) (m_data + hdr->names);
+  const DataRef*  types    = (const DataRef*) (m_data + hdr->types);
+  const DataRef*  payloads = (const DataRef*) (m_data + hdr->payloads);
+  for( uint64_t i=0; i < rows; ++i )   {
+    if ( !data_ok(names[i], str_len) || !data_ok(types[i], str_len) )
+      return "Condition name or type outside the string heap";
+    if ( !data_ok(payloads[i], blob_len) )
+      return "Condition payload outside the payload heap";
+    if ( i > 0 && keys[i] < keys[i-1] )
+      return "Condition keys are not sorted";
+  }
+  return 0;
+}
+
+/// Release all decoded conditions and unmap the file
+void ConditionsColumnRepository::close()   {
+  dd4hep_lock_t lock(m_lock);
+  for( Condition::Object* o : m_objects )
+    if ( o ) o->release();
+  m_objects.clear();
+  m_iovs.clear();
+  m_iovTypes.clear();
+  m_numDecoded = 0;
+  if ( m_data )   {
+    ::munmap((void*)m_data, m_length);
+  }
+  m_data     = 0;
+  m_length   = 0;
+  m_header   = 0;
+}
+
+/// Number of rows in the repository
+size_t ConditionsColumnRepository::size()  const   {
+  return m_header ? m_header->numRows : 0;
+}
+
+/// Access the IOV type of a given row
+const IOVType* ConditionsColumnRepository::rowIOVType(size_t row)  const   {
+  for( const auto& t : m_iovTypes )
+    if ( t.type == m_iovType[row] ) return &t;
+  except("ConditionsColumnRepository","+++ Unknown IOV type %d of row %ld.",m_iovType[row],long(row));
+  return 0;
+}
+
+/// Access the IOV object of a given row. Called with the lock held.
+const IOV* ConditionsColumnRepository::rowIOV(size_t row)  const   {
+  auto key = make_pair(m_iovType[row], iovKey(row));
+  auto i = m_iovs.find(key);
+  if ( i == m_iovs.end() )   {
+    i = m_iovs.insert(make_pair(key, unique_ptr<IOV>(new IOV(rowIOVType(row), key.second)))).first;
+  }
+  return i->second.get();
+}
+
+/// Create the condition object of a given row
+Condition::Object* ConditionsColumnRepository::decode(size_t row)  const   {
+  const DataRef& nam = m_names[row];
+  const DataRef& typ = m_types[row];
+  const DataRef& pay = m_payloads[row];
+  const char*    str = m_data + m_header->strings;
+  const char*    ptr = m_data + m_header->blobs + pay.offset;
+  Condition      cond(string(str+nam.offset, nam.length), string(str+typ.offset, typ.length));
+  Condition::Object* o = cond.ptr();
+
+  o->hash  = m_keys[row];
+  o->flags = m_flags[row];
+  o->iov   = rowIOV(row);
+  switch( m_encoding[row] )   {
+  case ENCODE_RAW:   {
+    const BasicGrammar& g = BasicGrammar::get(m_grammar[row]);
+    if ( pay.length != g.sizeOf() )   {
+      except("ConditionsColumnRepository","+++ Condition %s: payload size %ld does not match type %s.",
+             o->GetName(), long(pay.length), g.type_name().c_str());
+    }
+    void* p = o->data.bind(&g);
+    g.copy(p, ptr);
+    break;
+  }
+  case ENCODE_STRING:   {
+    const BasicGrammar& g = BasicGrammar::get(m_grammar[row]);
+    void* p = o->data.bind(&g);
+    g.bind(p);
+    if ( !g.fromString(p, string(ptr, pay.length)) )   {
+      except("ConditionsColumnRepository","+++ Condition %s: failed to convert payload to type %s.",
+             o->GetName(), g.type_name().c_str());
+    }
+    break;
+  }
+  default:
+    o->value = string(ptr, pay.length);
+    break;
+  }
+  return o;
+}
+
+/// Rows with the given condition key: [first,last)
+pair<size_t,size_t> ConditionsColumnRepository::rows(key_type key)  const   {
+  const uint64_t* first = lower_bound(m_keys, m_keys+size(), key);
+  const uint64_t* last  = upper_bound(first,  m_keys+size(), key);
+  return make_pair(first-m_keys, last-m_keys);
+}
+
+/// Row of the condition with the given key valid for the requested IOV. Returns size() if absent
+size_t ConditionsColumnRepository::find(key_type key, const IOV& req_validity)  const   {
+  unsigned int req_type = req_validity.iovType ? req_validity.iovType->type : req_validity.type;
+  pair<size_t,size_t> r = rows(key);
+  for( size_t row = r.first; row < r.second; ++row )   {
+    if ( m_iovType[row] == req_type && IOV::key_contains_range(iovKey(row), req_validity.keyData) )
+      return row;
+  }
+  return size();
+}
+
+/// Access the condition of a given row. Decoded on first access.
+Condition ConditionsColumnRepository::get(size_t row)  const   {
+  if ( row >= size() )   {
+    except("ConditionsColumnRepository","+++ Invalid row %ld [Repository size: %ld].",
+           long(row), long(size()));
+  }
+  dd4hep_lock_t lock(m_lock);
+  Condition::Object*& o = m_objects[row];
+  if ( !o )   {
+    o = decode(row);
+    ++m_numDecoded;
+  }
+  return o;
+}
+
+/// Access the condition with the given key valid for the requested IOV (may be invalid)
+Condition ConditionsColumnRepository::get(key_type key, const IOV& req_validity)  const   {
+  size_t row = find(key, req_validity);
+  return row < size() ? get(row) : Condition();
+}
+
+/// Add the condition of a given row to the pool of its IOV in the conditions manager
+bool ConditionsColumnRepository::registerCondition(ConditionsManager mgr, size_t row)  const   {
+  Condition cond = get(row);
+  const IOVType* row_type = rowIOVType(row);
+  pair<bool,const IOVType*> typ = mgr.registerIOVType(row_type->type, row_type->name);
+  if ( typ.second )   {
+    Condition::Object* o = cond.ptr();
+    ConditionsPool* pool = mgr.registerIOV(*typ.second, iovKey(row));
+    o->iov = pool->iov;
+    if ( pool->insert(o->addRef()) )
+      return true;
+    o->release();
+    printout(WARNING,"ConditionsColumnRepository",
+             "+++ Ignore condition %s iov:%s [Already present]",
+             cond.name(), pool->iov->str().c_str());
+  }
+  return false;
+}
+
+/// Decode all rows and add them to the conditions pools of the manager
+size_t ConditionsColumnRepository::import(ConditionsManager mgr)  const   {
+  size_t count = 0;
+  for( size_t row=0, n=size(); row < n; ++row )   {
+    if ( registerCondition(mgr, row) ) ++count;
+  }
+  return count;
+}
@@ -0,0 +1,125 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_CONDITIONS_COLUMNCONDITONSLOADER_H
+#define DD4HEP_CONDITIONS_COLUMNCONDITONSLOADER_H
+
+// Framework include files
+#include "DDCond/ConditionsDataLoader.h"
+#include "DDCond/ConditionsColumnRepository.h"
+
+// C/C++ include files
+#include <memory>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for implementation details of the AIDA detector description toolkit
+  namespace cond  {
+
+    /// Conditions loader reading lazily from columnar conditions repositories
+    /**
+     *  All data sources are mapped on first use. Only the conditions
+     *  requested by the user pools are decoded and registered to the
+     *  conditions manager.
+     *
+     *  Usage:
+     *  manager["LoaderType"] = "column";
+     *  manager.initialize();
+     *  manager.loader()->addSource("conditions.dd4col");
+     *
+     *  \version  1.0
+     *  \ingroup  DD4HEP_CONDITIONS
+     */
+    class ConditionsColumnLoader : public ConditionsDataLoader   {
+      typedef std::vector<std::unique_ptr<ConditionsColumnRepository> > Repositories;
+      /// Opened repositories
+      Repositories m_repositories;
+      /// Map all data sources not yet opened
+      void open_sources();
+
+    public:
+      /// Default constructor
+      ConditionsColumnLoader(Detector& description, ConditionsManager mgr, const std::string& nam);
+      /// Default destructor
+      virtual ~ConditionsColumnLoader();
+      /// Optimized update using conditions slice data
+      virtual size_t load_many(  const IOV&      req_validity,
+                                 RequiredItems&  work,
+                                 LoadedItems&    loaded,
+                                 IOV&            conditions_validity)  override;
+    };
+  }    /* End namespace cond                         */
+}      /* End namespace dd4hep                       */
+#endif /* DD4HEP_CONDITIONS_COLUMNCONDITONSLOADER_H  */
+
+//#include "ConditionsColumnLoader.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/Factories.h"
+
+// Forward declartions
+using std::string;
+using namespace dd4hep;
+using namespace dd4hep::cond;
+
+namespace {
+  void* create_loader(Detector& description, int argc, char** argv)   {
+    const char* name = argc>0 ? argv[0] : "ColumnLoader";
+    ConditionsManagerObject* mgr = (ConditionsManagerObject*)(argc>0 ? argv[1] : 0);
+    return new ConditionsColumnLoader(description,ConditionsManager(mgr),name);
+  }
+}
+DECLARE_DD4HEP_CONSTRUCTOR(DD4hep_Conditions_column_Loader,create_loader)
+
+/// Standard constructor, initializes variables
+ConditionsColumnLoader::ConditionsColumnLoader(Detector& description, ConditionsManager mgr, const string& nam)
+: ConditionsDataLoader(description, mgr, nam)
+{
+}
+
+/// Default Destructor
+ConditionsColumnLoader::~ConditionsColumnLoader() {
+}
+
+/// Map all data sources not yet opened
+void ConditionsColumnLoader::open_sources()   {
+  for( const auto& s : m_sources )   {
+    m_repositories.emplace_back(new ConditionsColumnRepository(s.first));
+    printout(INFO,"ColumnLoader","++ Mapped conditions repository %s with %ld conditions.",
+             s.first.c_str(), m_repositories.back()->size());
+  }
+  m_sources.clear();
+}
+
+/// Optimized update using conditions slice data
+size_t ConditionsColumnLoader::load_many(const IOV&      req_validity,
+                                         RequiredItems&  work,
+                                         LoadedItems&    loaded,
+                                         IOV&            conditions_validity)
+{
+  size_t len = loaded.size();
+  if ( !m_sources.empty() ) open_sources();
+  for( const auto& w : work )   {
+    for( const auto& r : m_repositories )   {
+      size_t row = r->find(w.first, req_validity);
+      if ( row < r->size() )   {
+        Condition cond = r->get(row);
+        if ( r->registerCondition(m_mgr, row) )   {
+          conditions_validity.iov_intersection(cond.iov());
+          loaded[w.first] = cond;
+        }
+        break;
+      }
+    }
+  }
+  printout(DEBUG,"ColumnLoader","++ Loaded %ld out of %ld conditions for IOV %s.",
+           loaded.size()-len, work.size(), req_validity.str().c_str());
+  return loaded.size()-len;
+}
@@ -0,0 +1,83 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_DDCORE_DETELEMENTREGISTRY_H
+#define DD4HEP_DDCORE_DETELEMENTREGISTRY_H
+
+// Framework include files
+#include "DD4hep/DetElement.h"
+
+// C/C++ include files
+#include <string>
+#include <unordered_map>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Hash indexed registry of all detector elements of a detector element tree
+  /**
+   *  The registry maps the hash key (DetElement::key()) and the full path
+   *  (DetElement::path()) of every detector element to the element itself.
+   *  It is created for the world element once the geometry is closed
+   *  and is kept up to date by DetElement::add() afterwards.
+   *  Use World::elementRegistry() to access it.
+   *
+   *  Lookups do not descend the detector element tree and do not split
+   *  the path. Concurrent lookups are safe, concurrent modifications are not.
+   *
+   *  \version 1.0
+   *  \ingroup DD4HEP_CORE
+   */
+  class DetElementRegistry  {
+  public:
+    typedef std::unordered_map<unsigned int, DetElement> KeyMap;
+    typedef std::unordered_map<std::string,  DetElement> PathMap;
+
+  protected:
+    /// Map of detector elements by hash key
+    KeyMap  m_keys;
+    /// Map of detector elements by full path
+    PathMap m_paths;
+
+  public:
+    /// Default constructor
+    DetElementRegistry() = default;
+    /// Initializing constructor: register the full tree below (and including) top
+    DetElementRegistry(DetElement top);
+    /// No copy constructor
+    DetElementRegistry(const DetElementRegistry& copy) = delete;
+    /// Default destructor
+    ~DetElementRegistry() = default;
+    /// No assignment
+    DetElementRegistry& operator=(const DetElementRegistry& copy) = delete;
+
+    /// Clear the registry and register the full tree below (and including) top
+    void build(DetElement top);
+    /// Register a detector element and all its children
+    void add(DetElement element);
+    /// Remove all entries
+    void clear();
+    /// Number of registered detector elements
+    size_t size()  const                  {  return m_paths.size();  }
+    /// Access to the key map
+    const KeyMap&  keys()  const          {  return m_keys;          }
+    /// Access to the path map
+    const PathMap& paths()  const         {  return m_paths;         }
+
+    /// Find a detector element by its hash key. Returns an invalid handle if absent
+    DetElement find(unsigned int key)  const;
+    /// Find a detector element by its full path. Returns an invalid handle if absent
+    DetElement find(const std::string& path)  const;
+
+    /// Access the registry of the tree containing the element. Returns 0 if it was not built
+    static DetElementRegistry* registry(DetElement element);
+  };
+}         /* End namespace dd4hep                    */
+#endif    /* DD4HEP_DDCORE_DETELEMENTREGISTRY_H      */
@@ -18,6 +18,8 @@
 
 // C/C++ include files
 #include <memory>
+#include <vector>
+#include <functional>
 
 /// Namespace for the AIDA detector description toolkit
 namespace dd4hep {
@@ -163,5 +165,96 @@ namespace dd4hep {
       return proc.process(start, level, recursive);
     }
   };
+
+  /// Parallel detector element tree scanner using a work stealing thread pool
+  /**
+   *   Subtrees are distributed as tasks over a pool of threads. Every thread
+   *   processes its own task queue depth-first and steals tasks from the
+   *   other threads when its own queue runs empty. Threads without work
+   *   sleep until new tasks are queued. The calling thread takes part in
+   *   the processing.
+   *
+   *   Only thread safe processors may be used: the processor object is
+   *   shared by all threads and its
+   *   int operator()(DetElement de, int level) const
+   *   is called concurrently for different detector elements.
+   *   The order of the calls is not defined. Processors, which collect
+   *   results should use collect(), which returns the results in the
+   *   order of the sequential DetectorScanner.
+   *
+   *   The first exception thrown by a processor stops the scan and is
+   *   rethrown to the caller.
+   *
+   *   \version 1.0
+   *   \ingroup DD4HEP_CORE
+   */
+  class DetectorParallelScanner  {
+  public:
+    /// Unit of work: detector element with its level and the user context of its result slot
+    struct Task  {
+      DetElement element;
+      int        level;
+      void*      context;
+    };
+    /// Task callback. May set one context for each child (in the order of DetElement::children())
+    typedef std::function<int(const Task& task, std::vector<void*>& child_contexts)> Callback;
+
+  protected:
+    /// Number of threads used (including the calling thread)
+    size_t m_numThreads;
+
+    /// Result slot for ordered collection: results of one element and the slots of its children
+    template <typename T> struct Slot  {
+      std::vector<T>                     items;
+      std::vector<std::unique_ptr<Slot> > children;
+      /// Append the results of this subtree in the order of the sequential scan
+      void merge(std::vector<T>& result)  {
+        for( auto& i : items ) result.emplace_back(std::move(i));
+        for( auto& c : children ) c->merge(result);
+      }
+    };
+
+  public:
+    /// Default constructor. 0 threads: use the hardware concurrency
+    explicit DetectorParallelScanner(size_t num_threads = 0);
+    /// Copy constructor
+    DetectorParallelScanner(const DetectorParallelScanner& copy) = default;
+    /// Assignment operator
+    DetectorParallelScanner& operator=(const DetectorParallelScanner& copy) = default;
+    /// Number of threads used
+    size_t numThreads()  const   {  return m_numThreads;  }
+
+    /// Execute the task callback for the tree below start using the thread pool
+    int execute(const Callback& call, DetElement start, int level=0, bool recursive=true, void* context=0)  const;
+
+    /// Detector element tree scan using a thread safe processor
+    template <typename Q>
+    int scan(const Q& p, DetElement start, int level=0, bool recursive=true)  const  {
+      return execute([&p](const Task& t, std::vector<void*>&)  { return p(t.element, t.level); },
+                     start, level, recursive);
+    }
+
+    /// Ordered collection of results
+    /** The processor signature is:
+     *  int operator()(DetElement de, int level, std::vector<T>& results) const
+     *  The results are returned in the order of the sequential scan.
+     */
+    template <typename T, typename Q>
+    std::vector<T> collect(const Q& p, DetElement start, int level=0, bool recursive=true)  const  {
+      Slot<T> top;
+      std::vector<T> result;
+      execute([&p](const Task& t, std::vector<void*>& children)  {
+          Slot<T>* s = (Slot<T>*)t.context;
+          s->children.resize(children.size());
+          for( size_t i=0; i<children.size(); ++i )  {
+            s->children[i].reset(new Slot<T>());
+            children[i] = s->children[i].get();
+          }
+          return p(t.element, t.level, s->items);
+        }, start, level, recursive, &top);
+      top.merge(result);
+      return result;
+    }
+  };
 }      /* End namespace dd4hep               */
 #endif /* DD4HEP_DDCORE_DETECTORPROCESSOR_H  */
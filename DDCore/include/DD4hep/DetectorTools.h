@@ -50,6 +50,8 @@ namespace dd4hep {
       void elementPath(DetElement elt, ElementPath& detectors);
       /// Find DetElement as child of the top level volume by it's absolute path
       DetElement findElement(Detector& description, const std::string& path);
+      /// Find DetElement by it's hash key (DetElement::key()). Requires the geometry to be closed.
+      DetElement findElement(Detector& description, unsigned int key);
       /// Find DetElement as child of a parent by it's relative or absolute path
       DetElement findDaughterElement(DetElement parent, const std::string& subpath);
       /// Find path between the child element and the parent element
@@ -79,6 +81,8 @@ namespace dd4hep {
       std::string toString(const PlacedVolume::VolIDs& ids);
       /// Convert VolumeID to string
       std::string toString(const IDDescriptor& dsc, const PlacedVolume::VolIDs& ids, VolumeID code);
+      /// Convert VolumeID to string
+      std::string toString(const IDDescriptor& dsc, const PlacedVolume::VolIDCodes& ids, VolumeID code);
     }
   }
 }         /* End namespace dd4hep                   */
@@ -60,9 +60,13 @@ namespace dd4hep {
     size_t fieldID(const std::string& field_name) const;
     /// Get the field descriptor of one field by its identifier
     const BitFieldValue* field(size_t identifier) const;
+    /// Get the field descriptor of one field by its interned volume ID field index (0 if not present)
+    const BitFieldValue* volIDField(unsigned short field_index) const;
 #ifndef __MAKECINT__
     /// Encode a set of volume identifiers (corresponding to this description of course!) to a volumeID.
     VolumeID encode(const std::vector<std::pair<std::string, int> >& ids) const;
+    /// Encode a set of volume identifiers with interned field names (see PlacedVolume::volIDCodes)
+    VolumeID encode(const std::vector<std::pair<unsigned short, int> >& codes) const;
 #endif
     /// Decode volume IDs and return filled descriptor with all fields
     void decodeFields(VolumeID vid, std::vector<std::pair<const BitFieldValue*, VolumeID> >& fields)  const;
@@ -16,6 +16,8 @@
 // Framework include files
 #include <typeinfo>
 #include <string>
+#include <atomic>
+#include <cstddef>
 
 /// Namespace for the AIDA detector description toolkit
 namespace dd4hep {
@@ -42,49 +44,101 @@ namespace dd4hep {
     /// Internal class to could object constructions and destructions
     /**
      * Small class to enable object construction/destruction tracing.
+     * The counter values are relaxed atomics: counting is thread-safe
+     * without imposing any ordering on the counted objects.
+     *
+     * Counters of heavily contended types may be sharded: every thread
+     * then counts in its own cache line and the values are summed when
+     * they are accessed. In sharded mode the maximum is the sum of the
+     * per-shard maxima and hence only an upper limit.
      *
      *  \author  M.Frank
      *  \version 1.0
      *  \ingroup DD4HEP
      */
     class Counter {
+    public:
+      /// Number of shards of a sharded counter
+      enum { NUM_SHARDS = 16 };
+      /// Counter values. Shards are allocated aligned to cache lines
+      struct Slot {
+        /// Reference counter value
+        std::atomic<counter_t> count {0};
+        /// Increment counter value
+        std::atomic<counter_t> tot   {0};
+        /// Maximum number of simultaneous instances
+        std::atomic<counter_t> max   {0};
+        /// Padding to the size of a cache line
+        char pad[64-3*sizeof(std::atomic<counter_t>)];
+        /// Increment counter
+        void increment()  {
+          counter_t cnt = count.fetch_add(1, std::memory_order_relaxed) + 1;
+          counter_t mx  = max.load(std::memory_order_relaxed);
+          tot.fetch_add(1, std::memory_order_relaxed);
+          while ( cnt > mx && !max.compare_exchange_weak(mx, cnt, std::memory_order_relaxed) ) {}
+        }
+        /// Decrement counter
+        void decrement()  {
+          count.fetch_sub(1, std::memory_order_relaxed);
+        }
+      };
     private:
-      /// Reference counter value
-      counter_t m_count = 0;
-      /// Increment counter value
-      counter_t m_tot = 0;
-      /// Maximum number of simultaneous instances
-      counter_t m_max = 0;
+      /// Counter values of the unsharded counter
+      Slot                m_slot;
+      /// Per-thread counter values of the sharded counter
+      std::atomic<Slot*>  m_shards {nullptr};
+      /// Access the counter values of the calling thread
+      Slot& slot()  {
+        Slot* shards = m_shards.load(std::memory_order_acquire);
+        return shards ? shards[shard()] : m_slot;
+      }
+      /// Sum of a counter value over all shards
+      counter_t sum(std::atomic<counter_t> Slot::*value)  const;
     public:
       /// Default constructor
       Counter() = default;
       /// Copy constructor
-      Counter(const Counter& c) = default;
+      Counter(const Counter& c);
       /// Destructor
-      ~Counter() = default;
+      ~Counter();
+      /// Shard index of the calling thread
+      static std::size_t shard();
+      /// Enable sharding of the counter. Sharding cannot be disabled again
+      void setSharded();
+      /// Check if the counter is sharded
+      bool sharded() const {
+        return m_shards.load(std::memory_order_relaxed) != nullptr;
+      }
       /// Increment counter
       void increment() {
-        ++m_count;
-        ++m_tot;
-        m_max = std::max(m_max,m_count);
+        slot().increment();
       }
       /// Decrement counter
       void decrement() {
-        --m_count;
+        slot().decrement();
       }
       /// Access counter value
       counter_t value() const {
-        return m_count;
+        return sum(&Slot::count);
       }
       /// Access counter value
       counter_t total() const {
-        return m_tot;
+        return sum(&Slot::tot);
       }
       /// Access maximum counter value
       counter_t maximum() const {
-        return m_max;
+        return sum(&Slot::max);
       }
     };
+
+  private:
+    /// Flag if counting is active: tracing is enabled and no static destructors are running
+    static std::atomic<bool> s_active;
+    /// Register a counter object (created on first call)
+    static Counter* registerCounter(const std::type_info& typ);
+    /// Handle counts while counting is inactive
+    static void inactive();
+
   public:
     /// Standard Constructor - No need to call explicitly
     InstanceCount();
@@ -94,13 +148,28 @@ namespace dd4hep {
     static Counter* getCounter(const std::type_info& typ);
     /// Access counter object for local caching on optimizations
     static Counter* getCounter(const std::string& typ);
+    /// Access the counter object of a type. It is resolved once per type
+    template <class T> static Counter* counter()  {
+      static Counter* cnt = registerCounter(typeid(T));
+      return cnt;
+    }
+    /// Shard the counter of a heavily contended type
+    template <class T> static void shard()  {
+      counter<T>()->setSharded();
+    }
     /// Increment count according to type information
     template <class T> static void increment(T*) {
-      increment(typeid(T));
+      if ( s_active.load(std::memory_order_relaxed) )
+        counter<T>()->increment();
+      else
+        inactive();
     }
     /// Decrement count according to type information
     template <class T> static void decrement(T*) {
-      decrement(typeid(T));
+      if ( s_active.load(std::memory_order_relaxed) )
+        counter<T>()->decrement();
+      else
+        inactive();
     }
     /// Access current counter
     template <class T> static counter_t get(T*) {
@@ -110,6 +179,8 @@ namespace dd4hep {
     static void increment(const std::type_info& typ);
     /// Decrement count according to type information
     static void decrement(const std::type_info& typ);
+    /// Shard the counter of a heavily contended type
+    static void shard(const std::type_info& typ);
     /// Access current counter
     static counter_t get(const std::type_info& typ) {
       return getCounter(typ)->value();
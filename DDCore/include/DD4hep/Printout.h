@@ -228,6 +228,29 @@ namespace dd4hep {
   /// Customize printer function
   void setPrinter2(void* print_arg, output_function2_t fcn);
 
+  /// Enable or disable the asynchronous printer
+  /**
+   *  Messages are formatted by the calling thread into a lock-free ring buffer
+   *  owned by the thread. A background thread writes them using the printout
+   *  format or the printer function set with setPrinter. Messages of one thread
+   *  are written in order, messages of different threads in the order they were
+   *  issued. Consecutive identical messages of a thread are coalesced.
+   *  Messages of level ERROR and above are never dropped and the caller waits
+   *  until they are written. Other messages are dropped if the ring buffer of
+   *  the thread is full or if the thread exceeds max_rate messages per second
+   *  (0: no limit). The number of dropped messages is reported.
+   *  The background thread is not inherited by forked child processes: the child
+   *  prints synchronously. Call flushPrinter() before fork() to not lose messages.
+   *
+   *  @arg enable       [bool,read-only]     Start (true) or stop (false) the background thread.
+   *  @arg buffer_size  [size_t,read-only]   Size of the ring buffer of each thread in bytes.
+   *  @arg max_rate     [size_t,read-only]   Maximal number of messages per second and thread.
+   */
+  void setAsyncPrinter(bool enable, std::size_t buffer_size = 1024*1024, std::size_t max_rate = 0);
+
+  /// Wait until all messages issued so far by the asynchronous printer are written
+  void flushPrinter();
+
 #endif // __CINT__
 
   /// Set new printout format for the 3 fields: source-level-message. All 3 are strings
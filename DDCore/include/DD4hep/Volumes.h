@@ -20,6 +20,7 @@
 
 // C/C++ include files
 #include <map>
+#include <atomic>
 
 // ROOT include file (includes TGeoVolume + TGeoShape)
 #include "TGeoNode.h"
@@ -69,6 +70,10 @@ namespace dd4hep {
   class PlacedVolumeExtension : public TGeoExtension  {
   public:
     typedef std::pair<std::string, int> VolID;
+    /// Compact volume identifier: index of the interned field name and field value
+    typedef std::pair<unsigned short, int> VolIDCode;
+    /// Compact volume ID container
+    typedef std::vector<VolIDCode> VolIDCodes;
     /// Volume ID container
     /**
      *   \author  M.Frank
@@ -98,15 +103,58 @@ namespace dd4hep {
       template< class InputIt>
       iterator insert(std::vector<VolID>::const_iterator pos, InputIt first, InputIt last)
       {  return this->Base::insert(pos, first, last);    }
+      /// Append compact IDs with their field names (no copy of the placement's view is kept)
+      void append(const VolIDCodes& codes);
       /// String representation for debugging
       std::string str()  const;
     };
+    /// Parameters of a replicated placement
+    /**
+     *   All copies of a replicated placement are ordinary placements in the
+     *   mother volume sharing one parameter object. The copies are numbered
+     *   from 0 with the index of the first dimension running fastest:
+     *   copy = i0 + n0*(i1 + n1*i2). The transformation of a copy is
+     *   inc2^i2 * inc1^i1 * inc0^i0 * start.
+     *
+     *   \version 1.0
+     *   \ingroup DD4HEP_CORE
+     */
+    class Parameterisation  {
+    public:
+      /// Replication dimension
+      struct Dimension  {
+        /// Transformation applied to the previous copy
+        Transform3D increment;
+        /// Number of copies
+        size_t      count = 1;
+        /// Volume ID field set to the copy index (ignored if empty)
+        std::string field;
+      };
+      /// Transformation of the first copy
+      Transform3D            start;
+      /// Replication dimensions (at most 3)
+      std::vector<Dimension> dimensions;
+      /// Placement number of the first copy in the mother volume
+      int                    first    = 0;
+      /// Reference count: one per copy
+      long                   refCount = 0;
+    public:
+      /// Total number of copies
+      size_t count()  const;
+      /// Index of a copy within one dimension
+      size_t index(size_t copy, size_t dim)  const;
+    };
+
     /// Magic word to detect memory corruptions
     unsigned long magic;
     /// Reference count on object (used to implement Grab/Release)
     long   refCount;
-    /// ID container
-    VolIDs volIDs;
+    /// ID container with interned field names
+    VolIDCodes codes;                  //! Streamed as VolIDs
+    /// String representation of the IDs. Created on demand
+    mutable std::atomic<VolIDs*> view; //! not ROOT-persistent
+    /// Parameters of replicated placements (shared by all copies)
+    Parameterisation* params;          //! not ROOT-persistent
     /// Default constructor
     PlacedVolumeExtension();
     /// Copy constructor
@@ -114,17 +162,21 @@ namespace dd4hep {
     /// Default destructor
     virtual ~PlacedVolumeExtension();
     /// Assignment operator
-    PlacedVolumeExtension& operator=(const PlacedVolumeExtension& c) {
-      magic = c.magic;
-      volIDs = c.volIDs;
-      return *this;
-    }
+    PlacedVolumeExtension& operator=(const PlacedVolumeExtension& c);
+    /// Add identifier
+    void addID(const std::string& name, int value);
+    /// Access the IDs with field names. The container is created on first access
+    const VolIDs& ids()  const;
+    /// Intern a volume ID field name: the index is unique within the process
+    static unsigned short fieldIndex(const std::string& name);
+    /// Access the name of an interned volume ID field
+    static const std::string& fieldName(unsigned short index);
     /// TGeoExtension overload: Method called whenever requiring a pointer to the extension
     virtual TGeoExtension *Grab()  override;
     /// TGeoExtension overload: Method called always when the pointer to the extension is not needed anymore
     virtual void Release() const  override;
     /// Enable ROOT persistency
-    ClassDefOverride(PlacedVolumeExtension,1);
+    ClassDefOverride(PlacedVolumeExtension,2);
   };
 
   /// Handle class holding a placed volume (also called physical volume)
@@ -140,6 +192,7 @@ namespace dd4hep {
   public:
     typedef PlacedVolumeExtension         Object;
     typedef PlacedVolumeExtension::VolIDs VolIDs;
+    typedef PlacedVolumeExtension::VolIDCodes VolIDCodes;
 
     /// Default constructor
     PlacedVolume() = default;
@@ -161,8 +214,16 @@ namespace dd4hep {
     Volume volume() const;
     /// Parent volume (envelope)
     Volume motherVol() const;
-    /// Access to the volume IDs
+    /// Access to the volume IDs with field names
+    /** The container is built on the first call and kept by the placement until
+     *  it is deleted: roughly 40 bytes per ID plus the vector. Code iterating over
+     *  many placements should use volIDCodes() or VolIDs::append() instead.
+     */
     const PlacedVolumeExtension::VolIDs& volIDs() const;
+    /// Access to the volume IDs with interned field names
+    const PlacedVolumeExtension::VolIDCodes& volIDCodes() const;
+    /// Access the parameters if the placement is a copy of a replicated placement (0 otherwise)
+    const PlacedVolumeExtension::Parameterisation* parameterisation() const;
     /// String dump
     std::string toString() const;
   };
@@ -262,6 +323,21 @@ namespace dd4hep {
     /// Place rotated daughter volume. The position is automatically the identity position
     PlacedVolume placeVolume(const Volume& vol, const Rotation3D& rot) const;
 
+    /// Replicate a daughter volume according to the parameters. Returns the first copy
+    PlacedVolume replicate(const Volume& vol, const PlacedVolumeExtension::Parameterisation& params) const;
+    /// Replicate a daughter volume along a line: each copy is the previous one transformed by inc
+    PlacedVolume replicate(const Volume& vol, const Transform3D& start, size_t count,
+                           const Transform3D& inc, const std::string& field = "") const;
+    /// Replicate a daughter volume in phi: each copy is the previous one rotated by dphi around the z-axis
+    PlacedVolume replicatePhi(const Volume& vol, const Transform3D& start, size_t count,
+                              double dphi, const std::string& field = "") const;
+    /// Replicate a daughter volume on a regular 2D or 3D grid
+    PlacedVolume replicateGrid(const Volume& vol, const Transform3D& start,
+                               size_t count1, const Position& inc1, const std::string& field1,
+                               size_t count2, const Position& inc2, const std::string& field2,
+                               size_t count3 = 1, const Position& inc3 = Position(),
+                               const std::string& field3 = "") const;
+
     /// Attach attributes to the volume
     const Volume& setAttributes(const Detector& description, const std::string& region, const std::string& limits,
                                 const std::string& vis) const;
@@ -21,6 +21,7 @@ namespace dd4hep {
 
   // Forward declarations
   class WorldObject;
+  class DetElementRegistry;
 
   /// Handle class to hold the information of the top DetElement object 'world'
   /**
@@ -46,6 +47,8 @@ namespace dd4hep {
 #ifndef __CINT__
     Detector& detectorDescription() const;
 #endif
+    /// Access the hash indexed registry of all detector elements (0 before the geometry is closed)
+    DetElementRegistry* elementRegistry() const;
   };
 } /* End namespace dd4hep            */
 #endif    /* DD4HEP_WORLD_H          */
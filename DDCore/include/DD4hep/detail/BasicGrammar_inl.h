@@ -237,11 +237,11 @@ namespace dd4hep {
       val.erase(idx, 5);
     while (val[0] == ' ')
       val.erase(0, 1);
-    double result = s__eval.evaluate(val.c_str());
-    if (s__eval.status() != XmlTools::Evaluator::OK) {
+    auto result = s__eval.evaluate(val);
+    if (result.first != XmlTools::Evaluator::OK) {
       return 0;
     }
-    *ptr = (T)result;
+    *ptr = (T)result.second;
     return 1;
   }
 
@@ -40,6 +40,7 @@ namespace dd4hep {
 
   class WorldObject;
   class DetElementObject;
+  class DetElementRegistry;
   class SensitiveDetectorObject;
   class VolumeManager_Populator;
     
@@ -192,6 +193,8 @@ namespace dd4hep {
   public:
     /// Reference to the Detector instance object
     Detector* description; //! Not persistent in ROOT
+    /// Hash indexed registry of all detector elements. Created once the geometry is closed.
+    DetElementRegistry* registry; //! Not persistent in ROOT
 
   public:
     //@{ Public methods to ease the usage of the data. */
@@ -206,7 +209,7 @@ namespace dd4hep {
   };
 
   /// Default constructor
-  inline WorldObject::WorldObject() : DetElementObject(), description(0)      {
+  inline WorldObject::WorldObject() : DetElementObject(), description(0), registry(0)  {
   }
 
 }         /* End namespace dd4hep                   */
@@ -200,6 +200,8 @@ namespace dd4hep {
     FieldIDs fieldIDs;  //! not ROOT-persistent
     /// Decoder object
     BitField64 decoder; //! not ROOT-persistent
+    /// Fields by interned volume ID field index (see PlacedVolumeExtension::fieldIndex)
+    std::vector<const BitFieldValue*> volIDFields; //! not ROOT-persistent
     
     /// The description string to build the bit-field descriptors.
     std::string description;
@@ -16,6 +16,9 @@
 
 #include "DDSegmentation/Segmentation.h"
 
+// C/C++ include files
+#include <cstdint>
+
 /// Main handle class to hold a TGeo alignment object of type TGeoPhysicalNode
 namespace dd4hep {
 
@@ -46,9 +49,41 @@ namespace dd4hep {
       /// Bitfield corresponding to dicriminator identifier
       BitFieldValue* m_discriminator;
 
+      /// Dense lookup table from discriminator value - m_keyMin to sub-segmentation
+      std::vector<Segmentation*> m_lookup;
+
+      /// Discriminator value of the first entry of the lookup table
+      long m_keyMin;
+
+      /// Decoding of the discriminator copied from the bitfield: mask, offset, width and sign
+      CellID m_keyMask;
+      unsigned m_keyOffset, m_keyWidth;
+      bool m_keySigned;
+
       /// Debug flags
       int m_debug;
 
+      /// Rebuild the lookup table from the sub-segmentation container
+      void buildLookup();
+      /// Decode the discriminator value of a cell identifier
+      /** The sign is extended in unsigned arithmetic: a field of 64 bits is already complete. */
+      long key(const CellID& cellID) const  {
+        uint64_t val = (cellID & m_keyMask) >> m_keyOffset;
+        if ( m_keySigned && m_keyWidth < 64 && (val & (uint64_t(1) << (m_keyWidth-1))) != 0 )
+          val |= ~uint64_t(0) << m_keyWidth;
+        return long(val);
+      }
+      /// Sub-segmentation of a discriminator value (0 if unknown)
+      Segmentation* lookup(long key) const  {
+        if ( !m_lookup.empty() )  {
+          unsigned long idx = (unsigned long)key - (unsigned long)m_keyMin;
+          return idx < m_lookup.size() ? m_lookup[idx] : 0;
+        }
+        for( const Entry& e : m_segmentations )
+          if ( e.key_min <= key && e.key_max >= key ) return e.segmentation;
+        return 0;
+      }
+
     public:
       /// Default constructor passing the encoding string
       MultiSegmentation(const std::string& cellEncoding = "");
@@ -65,6 +100,12 @@ namespace dd4hep {
       /// Access subsegmentation by cell identifier
       const Segmentation& subsegmentation(const CellID& cellID) const;
 
+      /// Access the subsegmentations of a set of cell identifiers
+      void subsegmentations(const std::vector<CellID>& cellIDs, std::vector<const Segmentation*>& segmentations) const;
+
+      /// determine the positions of a set of cell identifiers
+      void positions(const std::vector<CellID>& cellIDs, std::vector<Vector3D>& positions) const;
+
       /// determine the position based on the cell ID
       virtual Vector3D position(const CellID& cellID) const;
 
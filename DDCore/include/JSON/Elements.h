@@ -88,6 +88,17 @@ namespace dd4hep {
     /// Conversion function from raw unicode string to double  \ingroup DD4HEP_JSON
     double _toDouble(const char* value);
 
+    /// Conversion function from attribute to bool. Typed values are not evaluated  \ingroup DD4HEP_JSON
+    bool   _toBool(Attribute attr);
+    /// Conversion function from attribute to int. Typed values are not evaluated  \ingroup DD4HEP_JSON
+    int    _toInt(Attribute attr);
+    /// Conversion function from attribute to long. Typed values are not evaluated  \ingroup DD4HEP_JSON
+    long   _toLong(Attribute attr);
+    /// Conversion function from attribute to float. Typed values are not evaluated  \ingroup DD4HEP_JSON
+    float  _toFloat(Attribute attr);
+    /// Conversion function from attribute to double. Typed values are not evaluated  \ingroup DD4HEP_JSON
+    double _toDouble(Attribute attr);
+
     /// Class describing a list of JSON nodes
     /**
      *  Definition of a "list" of json elements hanging of the parent.
@@ -102,7 +113,12 @@ namespace dd4hep {
      */
     class NodeList {
     public:
+#ifdef DD4HEP_USE_FASTJSON
+      /// Current element and element, which ends the iteration
+      typedef std::pair<JsonElement*,JsonElement*> iter_t;
+#else
       typedef std::pair<JsonElement::second_type::assoc_iterator,JsonElement::second_type::assoc_iterator> iter_t;
+#endif
       std::string    m_tag;
       JsonElement*   m_node;
       mutable iter_t m_ptr;
@@ -207,23 +223,23 @@ namespace dd4hep {
     }
 
     template <> INLINE bool Handle_t::attr<bool>(const char* tag_value) const {
-      return _toBool(attr_value(tag_value));
+      return _toBool(attr_ptr(tag_value));
     }
 
     template <> INLINE int Handle_t::attr<int>(const char* tag_value) const {
-      return _toInt(attr_value(tag_value));
+      return _toInt(attr_ptr(tag_value));
     }
     
     template <> INLINE long Handle_t::attr<long>(const char* tag_value) const {
-      return _toLong(attr_value(tag_value));
+      return _toLong(attr_ptr(tag_value));
     }
 
     template <> INLINE float Handle_t::attr<float>(const char* tag_value) const {
-      return _toFloat(attr_value(tag_value));
+      return _toFloat(attr_ptr(tag_value));
     }
 
     template <> INLINE double Handle_t::attr<double>(const char* tag_value) const {
-      return _toDouble(attr_value(tag_value));
+      return _toDouble(attr_ptr(tag_value));
     }
 
     template <> INLINE std::string Handle_t::attr<std::string>(const char* tag_value) const {
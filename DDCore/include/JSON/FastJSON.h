@@ -0,0 +1,166 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_JSON_FASTJSON_H
+#define DD4HEP_JSON_FASTJSON_H
+
+// C/C++ include files
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the AIDA detector description toolkit supporting JSON utilities
+  namespace json {
+
+    /// Namespace of the in-situ JSON DOM parser
+    /**
+     *  The parser reads the document from a private memory mapping of the
+     *  file (or a private copy of a memory buffer) and parses it in place:
+     *  member names and string values are null-terminated and unescaped
+     *  inside the buffer. Values are allocated from an arena owned by the
+     *  document. Numbers are converted once while parsing; their literal
+     *  text stays available for the expression evaluator.
+     *
+     *  Like the boost property tree, duplicate member names are kept in
+     *  document order and array items have an empty key.
+     *
+     *  Enable it as JSON backend of dd4hep with DD4HEP_USE_FASTJSON.
+     *
+     *  \version 1.0
+     *  \ingroup DD4HEP_JSON
+     */
+    namespace fast {
+
+      /// Value of the in-situ JSON DOM tree: object, array or scalar
+      /**
+       *  \version 1.0
+       *  \ingroup DD4HEP_JSON
+       */
+      class Value  {
+      public:
+        /// Value types
+        enum Type  {
+          NULL_VALUE   = 0,
+          FALSE_VALUE  = 1,
+          TRUE_VALUE   = 2,
+          NUMBER_VALUE = 3,
+          STRING_VALUE = 4,
+          OBJECT_VALUE = 5,
+          ARRAY_VALUE  = 6
+        };
+        /// Value type
+        Type        type;
+        /// Member name (empty for array items)
+        const char* key    = "";
+        /// Scalar text: string content, number literal, "true", "false" or "null"
+        const char* text   = "";
+        /// Converted value of numbers and booleans
+        double      number = 0e0;
+        /// Parent value
+        Value*      parent = 0;
+        /// First child of objects and arrays
+        Value*      first  = 0;
+        /// Next sibling
+        Value*      next   = 0;
+
+      public:
+        /// Initializing constructor
+        Value(Type typ, const char* k) : type(typ), key(k)  {}
+
+        /// Check for numbers
+        bool   isNumber()  const    {  return type == NUMBER_VALUE;                            }
+        /// Check for booleans
+        bool   isBool()  const      {  return type == TRUE_VALUE || type == FALSE_VALUE;       }
+        /// Check for objects and arrays
+        bool   isContainer()  const {  return type == OBJECT_VALUE || type == ARRAY_VALUE;     }
+        /// Access the first child with a given key (0 if absent)
+        Value* find(const char* k)  const;
+        /// Access the next sibling with the same key as this value (0 if absent)
+        Value* findNext()  const;
+        /// Access the previous sibling with the same key as this value (0 if absent)
+        Value* findPrevious()  const;
+        /// Access the previous sibling (0 if absent). Siblings are singly linked: avoid this call
+        Value* previous()  const;
+        /// Number of children with a given key (0: all children)
+        std::size_t count(const char* k=0)  const;
+      };
+
+      /// In-situ JSON DOM document. The document is the top level value
+      /**
+       *  \version 1.0
+       *  \ingroup DD4HEP_JSON
+       */
+      class Document : public Value  {
+      protected:
+        /// Document URI
+        std::string        m_uri;
+        /// Document buffer, which is parsed in place
+        char*              m_buffer    = 0;
+        /// Length of the document buffer
+        std::size_t        m_length    = 0;
+        /// Flag if the buffer is a memory mapping of a file
+        bool               m_mapped    = false;
+        /// Arena blocks for values and number literals
+        std::vector<char*> m_blocks;
+        /// Free space in the current arena block
+        std::size_t        m_free      = 0;
+        /// Allocated arena memory
+        std::size_t        m_allocated = 0;
+        /// Error message of the last parse
+        std::string        m_error;
+        /// Line of the parse error
+        int                m_errorLine = 0;
+        /// Column of the parse error
+        int                m_errorCol  = 0;
+
+        /// Release buffer and arena
+        void release();
+        /// Parse the document buffer in place
+        bool parseBuffer();
+
+      public:
+        /// Initializing constructor
+        Document(const std::string& uri = "");
+        /// No copy constructor
+        Document(const Document& copy) = delete;
+        /// Default destructor
+        ~Document();
+        /// No assignment
+        Document& operator=(const Document& copy) = delete;
+
+        /// Load and parse a file using a private memory mapping
+        bool load(const std::string& file_name);
+        /// Parse a memory buffer. The buffer is copied
+        bool parse(const char* bytes, std::size_t length);
+        /// Error message of the last parse
+        const std::string& errorMessage()  const     {  return m_error;        }
+        /// Line of the parse error
+        int errorLine()  const                        {  return m_errorLine;    }
+        /// Column of the parse error
+        int errorColumn()  const                      {  return m_errorCol;     }
+        /// Size of the document buffer
+        std::size_t bufferSize()  const               {  return m_length;       }
+        /// Memory allocated for values and number literals
+        std::size_t arenaSize()  const                {  return m_allocated;    }
+        /// Access the document URI
+        const char* uri()  const                      {  return m_uri.c_str();  }
+
+        /// Allocate memory from the document arena
+        void*       allocate(std::size_t len);
+        /// Copy a string to the document arena
+        const char* copy(const char* str, std::size_t len);
+      };
+    }       /* End namespace fast                   */
+  }         /* End namespace json                   */
+}           /* End namespace dd4hep                 */
+#endif      /* DD4HEP_JSON_FASTJSON_H               */
@@ -13,6 +13,26 @@
 #ifndef DD4HEP_DDCORE_JSON_CONFIG_H
 #define DD4HEP_DDCORE_JSON_CONFIG_H
 
+#ifdef DD4HEP_USE_FASTJSON
+
+#include "JSON/FastJSON.h"
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the AIDA detector description toolkit supporting JSON utilities
+  namespace json {
+
+    typedef char                                    XmlChar;
+    typedef fast::Document                          JsonDocument;
+    typedef fast::Value                             JsonAttr;
+    typedef fast::Value                             JsonElement;
+
+  }       /* End namespace json              */
+}         /* End namespace dd4hep            */
+
+#else
+
 #define DD4HEP_USE_BOOST_JSON 1
 
 #include "boost/property_tree/ptree.hpp"
@@ -31,4 +51,5 @@ namespace dd4hep {
 
   }       /* End namespace json              */
 }         /* End namespace dd4hep            */
+#endif
 #endif    /* DD4HEP_DDCORE_JSON_CONFIG_H  */
@@ -0,0 +1,227 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_XML_FASTXML_H
+#define DD4HEP_XML_FASTXML_H
+
+// C/C++ include files
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the AIDA detector description toolkit supporting XML utilities
+  namespace xml {
+
+    /// Namespace of the in-situ XML DOM parser
+    /**
+     *  The parser reads the document from a private memory mapping of the
+     *  file (or a private copy of a memory buffer) and parses it in place:
+     *  tag names, attribute names, attribute values and texts are
+     *  null-terminated and entity-decoded inside the buffer.
+     *  Nodes and attributes are allocated from an arena owned by the document.
+     *  Parsing a document therefore does not allocate any string.
+     *
+     *  Nodes may only be appended to the document, which allocated them.
+     *  Use Node::clone to copy nodes between documents.
+     *  The names of the accessors follow the DOM conventions of XercesC.
+     *
+     *  Enable it as XML backend of dd4hep with DD4HEP_USE_FASTXML.
+     *
+     *  \version 1.0
+     *  \ingroup DD4HEP_XML
+     */
+    namespace fast {
+
+      class Document;
+
+      /// Attribute of an XML element
+      /**
+       *  \version 1.0
+       *  \ingroup DD4HEP_XML
+       */
+      class Attr  {
+      public:
+        /// Attribute name
+        const char* name  = 0;
+        /// Attribute value (entity decoded)
+        const char* value = 0;
+        /// Next attribute of the element
+        Attr*       next  = 0;
+
+        /// Access the attribute name
+        const char* getName()  const   {  return name;   }
+        /// Access the attribute value
+        const char* getValue() const   {  return value;  }
+      };
+
+      /// Node of the in-situ XML DOM tree
+      /**
+       *  \version 1.0
+       *  \ingroup DD4HEP_XML
+       */
+      class Node  {
+      public:
+        /// Node types. Values are identical to the XercesC node types
+        enum NodeType  {
+          ELEMENT_NODE                = 1,
+          TEXT_NODE                   = 3,
+          CDATA_SECTION_NODE          = 4,
+          PROCESSING_INSTRUCTION_NODE = 7,
+          COMMENT_NODE                = 8,
+          DOCUMENT_NODE               = 9
+        };
+        /// Node type
+        NodeType    type;
+        /// Element tag, text, comment or instruction content
+        const char* value    = 0;
+        /// Owning document
+        Document*   document = 0;
+        /// Parent node
+        Node*       parent   = 0;
+        /// First child node
+        Node*       first    = 0;
+        /// Last child node
+        Node*       last     = 0;
+        /// Previous sibling
+        Node*       prev     = 0;
+        /// Next sibling
+        Node*       next     = 0;
+        /// First attribute of an element
+        Attr*       attrs    = 0;
+
+      public:
+        /// Initializing constructor
+        Node(NodeType typ, Document* doc, const char* val) : type(typ), value(val), document(doc) {}
+
+        /// Access the node type
+        NodeType    getNodeType()  const             {  return type;      }
+        /// Access the tag name of an element
+        const char* getTagName()  const              {  return value;     }
+        /// Access the value of the node
+        const char* getNodeValue()  const            {  return value;     }
+        /// Access the owning document
+        Document*   getOwnerDocument()  const        {  return document;  }
+        /// Access the parent element. The document node is not returned
+        Node*       getParentNode()  const;
+        /// Access the content of the first text child of an element (0 if absent)
+        const char* getTextContent()  const;
+        /// Access the first attribute of an element
+        Attr*       getFirstAttribute()  const       {  return attrs;     }
+        /// Access attribute by name (0 if absent)
+        Attr*       getAttributeNode(const char* name)  const;
+        /// Access the first child element with a given tag (0 or "*": any tag)
+        Node*       firstChildElement(const char* tag=0)  const;
+        /// Access the next sibling element with a given tag (0 or "*": any tag)
+        Node*       nextSiblingElement(const char* tag=0)  const;
+        /// Access the previous sibling element with a given tag (0 or "*": any tag)
+        Node*       previousSiblingElement(const char* tag=0)  const;
+
+        /// Append a child node. The node is unlinked from its previous parent
+        Node*       appendChild(Node* child);
+        /// Unlink a child node. The memory is released with the document
+        bool        removeChild(Node* child);
+        /// Set the value of the node (the string is copied)
+        void        setNodeValue(const char* val);
+        /// Set or add an attribute (the strings are copied)
+        Attr*       setAttribute(const char* name, const char* val);
+        /// Remove all attributes
+        void        clearAttributes()                {  attrs = 0;        }
+        /// Deep copy of the node tree into a (possibly different) document
+        Node*       clone(Document* doc)  const;
+        /// Print the node tree
+        void        print(std::ostream& os, int depth=0)  const;
+      };
+
+      /// In-situ XML DOM document
+      /**
+       *  \version 1.0
+       *  \ingroup DD4HEP_XML
+       */
+      class Document : public Node  {
+      protected:
+        /// Document URI
+        std::string        m_uri;
+        /// Document buffer, which is parsed in place
+        char*              m_buffer    = 0;
+        /// Length of the document buffer
+        std::size_t        m_length    = 0;
+        /// Flag if the buffer is a memory mapping of a file
+        bool               m_mapped    = false;
+        /// Arena blocks for nodes, attributes and modified strings
+        std::vector<char*> m_blocks;
+        /// Free space in the current arena block
+        std::size_t        m_free      = 0;
+        /// Allocated arena memory
+        std::size_t        m_allocated = 0;
+        /// Error message of the last parse
+        std::string        m_error;
+        /// Line of the parse error
+        int                m_errorLine = 0;
+        /// Column of the parse error
+        int                m_errorCol  = 0;
+
+        /// Release buffer and arena
+        void release();
+        /// Parse the document buffer in place
+        bool parseBuffer();
+
+      public:
+        /// Initializing constructor
+        Document(const std::string& uri = "");
+        /// No copy constructor
+        Document(const Document& copy) = delete;
+        /// Default destructor
+        ~Document();
+        /// No assignment
+        Document& operator=(const Document& copy) = delete;
+
+        /// Load and parse a file using a private memory mapping
+        bool load(const std::string& file_name);
+        /// Parse a memory buffer. The buffer is copied
+        bool parse(const char* bytes, std::size_t length);
+        /// Error message of the last parse
+        const std::string& errorMessage()  const     {  return m_error;        }
+        /// Line of the parse error
+        int errorLine()  const                        {  return m_errorLine;    }
+        /// Column of the parse error
+        int errorColumn()  const                      {  return m_errorCol;     }
+        /// Size of the document buffer
+        std::size_t bufferSize()  const               {  return m_length;       }
+        /// Memory allocated for nodes, attributes and modified strings
+        std::size_t arenaSize()  const                {  return m_allocated;    }
+
+        /// Access the document URI
+        const char* getDocumentURI()  const           {  return m_uri.c_str();  }
+        /// Access the root element
+        Node*       getDocumentElement()  const       {  return firstChildElement(); }
+
+        /// Allocate memory from the document arena
+        void*       allocate(std::size_t len);
+        /// Copy a string to the document arena
+        const char* copy(const char* str);
+        /// Create a new element owned by this document
+        Node*       createElement(const char* tag);
+        /// Create a new text node owned by this document
+        Node*       createTextNode(const char* text);
+        /// Create a new comment owned by this document
+        Node*       createComment(const char* text);
+        /// Create a new processing instruction owned by this document
+        Node*       createProcessingInstruction(const char* text);
+        /// Create a new attribute owned by this document
+        Attr*       createAttribute(const char* name, const char* val);
+      };
+    }       /* End namespace fast                   */
+  }         /* End namespace xml                    */
+}           /* End namespace dd4hep                 */
+#endif      /* DD4HEP_XML_FASTXML_H                 */
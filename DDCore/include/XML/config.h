@@ -13,14 +13,15 @@
 #ifndef DD4HEP_XML_CONFIG_H
 #define DD4HEP_XML_CONFIG_H
 
-#if      defined(DD4HEP_USE_TINYXML)
+#if      defined(DD4HEP_USE_TINYXML) || defined(DD4HEP_USE_FASTXML)
+// Character based interface as used by TinyXML
 #define  __TIXML__
 #endif
 
 // C/C++ include files
 #include <cstdlib>
 
-/* Setup XML parsing for the use of Apache Xerces-C and TiXml
+/* Setup XML parsing for the use of Apache Xerces-C, TiXml and the in-situ parser
  *
  */
 
@@ -44,7 +45,9 @@ namespace dd4hep {
   }
 }
 
-#ifdef  __TIXML__
+#if     defined(DD4HEP_USE_FASTXML)
+#define XML_IMPLEMENTATION_TYPE " In-situ DOM parser        "
+#elif   defined(__TIXML__)
 #define XML_IMPLEMENTATION_TYPE " TinyXML DOM mini-parser   "
 #else   // Xerces-C
 #define XML_IMPLEMENTATION_TYPE " Apache Xerces-C DOM Parser"
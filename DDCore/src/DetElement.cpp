@@ -17,6 +17,7 @@
 #include "DD4hep/detail/AlignmentsInterna.h"
 #include "DD4hep/AlignmentTools.h"
 #include "DD4hep/DetectorTools.h"
+#include "DD4hep/DetElementRegistry.h"
 #include "DD4hep/Printout.h"
 #include "DD4hep/World.h"
 #include "DD4hep/Detector.h"
@@ -244,6 +245,9 @@ DetElement& DetElement::add(DetElement sdet) {
     pair<Children::iterator, bool> r = object<Object>().children.insert(make_pair(sdet.name(), sdet));
     if (r.second) {
       sdet.access()->parent = *this;
+      // Once the geometry is closed the element registry must follow
+      DetElementRegistry* reg = DetElementRegistry::registry(*this);
+      if ( reg ) reg->add(sdet);
       return *this;
     }
     throw runtime_error("dd4hep: DetElement::add: Element " + string(sdet.name()) + 
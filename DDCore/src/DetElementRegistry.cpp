@@ -0,0 +1,75 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework include files
+#include "DD4hep/DetElementRegistry.h"
+#include "DD4hep/detail/DetectorInterna.h"
+#include "DD4hep/Printout.h"
+
+using namespace std;
+using namespace dd4hep;
+
+/// Initializing constructor: register the full tree below (and including) top
+DetElementRegistry::DetElementRegistry(DetElement top)   {
+  build(top);
+}
+
+/// Clear the registry and register the full tree below (and including) top
+void DetElementRegistry::build(DetElement top)   {
+  clear();
+  add(top);
+  printout(DEBUG,"DetElementRegistry","+++ Registered %ld detector elements below %s.",
+           long(m_paths.size()), top.path().c_str());
+}
+
+/// Register a detector element and all its children
+void DetElementRegistry::add(DetElement element)   {
+  if ( element.isValid() )   {
+    auto r = m_keys.emplace(element.key(), element);
+    if ( !r.second && r.first->second.ptr() != element.ptr() )   {
+      printout(ERROR,"DetElementRegistry","+++ Hash key collision: %08X is used by %s and %s. "
+               "Lookup by key will return the first.", element.key(),
+               r.first->second.path().c_str(), element.path().c_str());
+    }
+    m_paths[element.path()] = element;
+    for( const auto& c : element.children() )
+      add(c.second);
+  }
+}
+
+/// Remove all entries
+void DetElementRegistry::clear()   {
+  m_keys.clear();
+  m_paths.clear();
+}
+
+/// Find a detector element by its hash key. Returns an invalid handle if absent
+DetElement DetElementRegistry::find(unsigned int key)  const   {
+  KeyMap::const_iterator i = m_keys.find(key);
+  return i == m_keys.end() ? DetElement() : i->second;
+}
+
+/// Find a detector element by its full path. Returns an invalid handle if absent
+DetElement DetElementRegistry::find(const string& path)  const   {
+  PathMap::const_iterator i = m_paths.find(path);
+  return i == m_paths.end() ? DetElement() : i->second;
+}
+
+/// Access the registry of the tree containing the element. Returns 0 if it was not built
+DetElementRegistry* DetElementRegistry::registry(DetElement element)   {
+  DetElement::Object* o = element.ptr();
+  if ( o )   {
+    while ( o->parent.isValid() ) o = o->parent.ptr();
+    WorldObject* w = dynamic_cast<WorldObject*>(o);
+    return w ? w->registry : 0;
+  }
+  return 0;
+}
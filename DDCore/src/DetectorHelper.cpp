@@ -29,9 +29,9 @@ SensitiveDetector DetectorHelper::sensitiveDetector(DetElement detector) const
     if ( par.ptr() != ptr()->world().ptr() )  {
       PlacedVolume pv = par.placement();
       if ( pv.isValid() )   {
-        const auto& ids = pv.volIDs();
+        const auto& ids = pv.volIDCodes();
         for(const auto& i : ids )  {
-          if ( i.first == "system" )   {
+          if ( PlacedVolumeExtension::fieldName(i.first) == "system" )   {
             return sensitiveDetector(par.name());
           }
         }
@@ -16,6 +16,7 @@
 #include "DD4hep/Printout.h"
 #include "DD4hep/GeoHandler.h"
 #include "DD4hep/DetectorHelper.h"
+#include "DD4hep/DetElementRegistry.h"
 #include "DD4hep/InstanceCount.h"
 #include "DD4hep/detail/ObjectsInterna.h"
 #include "DD4hep/detail/DetectorInterna.h"
@@ -503,6 +504,10 @@ void DetectorImp::endDocument() {
     ShapePatcher patcher(m_volManager, m_world);
     patcher.patchShapes();
     mapDetectorTypes();
+    /// Index all detector elements by key and path for fast lookup
+    World world(m_world);
+    if ( !world->registry ) world->registry = new DetElementRegistry();
+    world->registry->build(m_world);
   }
 }
 
@@ -18,6 +18,7 @@
 #include "DD4hep/detail/AlignmentsInterna.h"
 #include "DD4hep/InstanceCount.h"
 #include "DD4hep/DetectorTools.h"
+#include "DD4hep/DetElementRegistry.h"
 #include "DD4hep/Printout.h"
 #include "TGeoVolume.h"
 #include "TGeoMatrix.h"
@@ -208,10 +209,11 @@ void DetElementObject::update(unsigned int tags, void* param)   {
 
 /// Initializing constructor
 WorldObject::WorldObject(Detector& _description, const string& nam) 
-  : DetElementObject(nam,0), description(&_description)
+  : DetElementObject(nam,0), description(&_description), registry(0)
 {
 }
 
 /// Internal object destructor: release extension object(s)
 WorldObject::~WorldObject()  {
+  detail::deletePtr(registry);
 }
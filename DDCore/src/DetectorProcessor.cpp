@@ -15,8 +15,123 @@
 #include "DD4hep/Printout.h"
 #include "DD4hep/DetectorProcessor.h"
 
+// C/C++ include files
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+
 using namespace dd4hep;
 
+namespace {
+  typedef DetectorParallelScanner::Task     Task;
+  typedef DetectorParallelScanner::Callback Callback;
+
+  /// Task queue of one worker thread
+  struct WorkQueue  {
+    std::mutex       lock;
+    std::deque<Task> tasks;
+  };
+
+  /// Shared state of a parallel detector element tree scan
+  class ParallelScan  {
+  public:
+    const Callback&        call;
+    bool                   recursive;
+    std::vector<WorkQueue> queues;
+    std::atomic<size_t>    pending    {0};
+    std::atomic<size_t>    queued     {0};
+    std::atomic<long>      result     {0};
+    std::atomic<bool>      failed     {false};
+    std::exception_ptr     error;
+    std::mutex             error_lock;
+    std::mutex             wait_lock;
+    std::condition_variable wake;
+
+    ParallelScan(const Callback& c, bool rec, size_t num_threads)
+      : call(c), recursive(rec), queues(num_threads)  {}
+
+    /// Own tasks are taken from the back (depth first), stolen tasks from the front (large subtrees)
+    bool next(size_t id, Task& task)  {
+      {
+        WorkQueue& q = queues[id];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if ( !q.tasks.empty() )  {
+          task = std::move(q.tasks.back());
+          q.tasks.pop_back();
+          --queued;
+          return true;
+        }
+      }
+      for( size_t i=1; i<queues.size(); ++i )  {
+        WorkQueue& q = queues[(id+i)%queues.size()];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if ( !q.tasks.empty() )  {
+          task = std::move(q.tasks.front());
+          q.tasks.pop_front();
+          --queued;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// Wake up the waiting threads. The lock orders the change before their predicate check
+    void notify()  {
+      { std::lock_guard<std::mutex> guard(wait_lock); }
+      wake.notify_all();
+    }
+
+    /// Sleep until tasks are queued or the scan is finished
+    void wait()  {
+      std::unique_lock<std::mutex> guard(wait_lock);
+      wake.wait(guard, [this]  {  return queued.load() > 0 || pending.load() == 0 || failed.load();  });
+    }
+
+    /// Worker thread body: process tasks until the tree is exhausted
+    void run(size_t id)  {
+      std::vector<void*> contexts;
+      long sum = 0;
+      Task task;
+      while ( pending.load() > 0 && !failed.load() )  {
+        if ( !next(id, task) )  {
+          wait();
+          continue;
+        }
+        try  {
+          const DetElement::Children& children = task.element.children();
+          contexts.assign(children.size(), nullptr);
+          sum += call(task, contexts);
+          if ( recursive && !children.empty() )  {
+            size_t i = 0;
+            pending += children.size();
+            {
+              WorkQueue& q = queues[id];
+              std::lock_guard<std::mutex> guard(q.lock);
+              for( const auto& c : children )
+                q.tasks.emplace_back(Task{c.second, task.level+1, contexts[i++]});
+              queued += children.size();
+            }
+            if ( children.size() > 1 ) notify();
+          }
+        }
+        catch(...)  {
+          {
+            std::lock_guard<std::mutex> guard(error_lock);
+            if ( !error ) error = std::current_exception();
+            failed = true;
+          }
+          notify();
+        }
+        if ( --pending == 0 ) notify();
+      }
+      result += sum;
+    }
+  };
+}
+
 /// Default destructor
 DetectorProcessor::~DetectorProcessor()   {
 }
@@ -34,3 +149,31 @@ int DetectorProcessor::process(DetElement de, int level, bool recursive)  const
   except("Detector","Cannot process an invalid detector element");
   return 0;
 }
+
+/// Default constructor. 0 threads: use the hardware concurrency
+DetectorParallelScanner::DetectorParallelScanner(size_t num_threads)
+  : m_numThreads(num_threads)
+{
+  if ( 0 == m_numThreads ) m_numThreads = std::thread::hardware_concurrency();
+  if ( 0 == m_numThreads ) m_numThreads = 1;
+}
+
+/// Execute the task callback for the tree below start using the thread pool
+int DetectorParallelScanner::execute(const Callback& call, DetElement start, int level, bool recursive, void* context)  const  {
+  if ( !start.isValid() )  {
+    except("Detector","Cannot process an invalid detector element");
+  }
+  ParallelScan scan(call, recursive, m_numThreads);
+  std::vector<std::thread> threads;
+  scan.queues[0].tasks.emplace_back(Task{start, level, context});
+  scan.pending = 1;
+  scan.queued  = 1;
+  for( size_t i=1; i<m_numThreads; ++i )
+    threads.emplace_back([&scan, i]()  {  scan.run(i);  });
+  scan.run(0);
+  for( auto& t : threads ) t.join();
+  if ( scan.error )  {
+    std::rethrow_exception(scan.error);
+  }
+  return int(scan.result.load());
+}
@@ -14,6 +14,7 @@
 // Framework include files
 #define DETECTORTOOLS_CPP
 #include "DD4hep/DetectorTools.h"
+#include "DD4hep/DetElementRegistry.h"
 #include "DD4hep/Printout.h"
 #include "DD4hep/Detector.h"
 #include "DD4hep/detail/DetectorInterna.h"
@@ -216,9 +217,22 @@ DetElement detail::tools::findElement(Detector& description, const std::string&
   return findDaughterElement(description.world(),path);
 }
 
+/// Find DetElement by it's hash key (DetElement::key()). Requires the geometry to be closed.
+DetElement detail::tools::findElement(Detector& description, unsigned int key)   {
+  const DetElementRegistry* reg = DetElementRegistry::registry(description.world());
+  if ( reg ) return reg->find(key);
+  throw runtime_error("dd4hep: Cannot find DetElement by key before the geometry is closed [no registry]");
+}
+
 /// Find DetElement as child of a parent by it's relative or absolute path
 DetElement detail::tools::findDaughterElement(DetElement parent, const std::string& subpath)  {
   if ( parent.isValid() )   {
+    // Fast path: hash lookup once the geometry is closed. Otherwise descend the tree.
+    const DetElementRegistry* reg = DetElementRegistry::registry(parent);
+    if ( reg && !subpath.empty() )   {
+      DetElement elt = subpath[0] == '/' ? reg->find(subpath) : reg->find(parent.path()+"/"+subpath);
+      if ( elt.isValid() ) return elt;
+    }
     size_t idx = subpath.find('/',1);
     if ( subpath[0] == '/' )   {
       DetElement top = topElement(parent);
@@ -395,4 +409,16 @@ std::string detail::tools::toString(const IDDescriptor& dsc, const PlacedVolume:
   return log.str();
 }
 
+/// Convert VolumeID to string
+std::string detail::tools::toString(const IDDescriptor& dsc, const PlacedVolume::VolIDCodes& ids, VolumeID code)   {
+  stringstream log;
+  for( const auto& id : ids )  {
+    const string& nam = PlacedVolumeExtension::fieldName(id.first);
+    const BitFieldValue* f = dsc.field(nam);
+    VolumeID value = f->value(code);
+    log << nam << "=" << id.second << "," << value << " [" << f->offset() << "," << f->width() << "] ";
+  }
+  return log.str();
+}
+
 
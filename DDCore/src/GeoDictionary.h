@@ -51,7 +51,7 @@ template vector<pair<string, int> >::iterator;
 #pragma link C++ class vector<pair<string, int> >+;
 #pragma link C++ class vector<pair<string, int> >::iterator;
 #pragma link C++ class dd4hep::PlacedVolumeExtension::VolIDs+;
-#pragma link C++ class dd4hep::PlacedVolumeExtension+;
+#pragma link C++ class dd4hep::PlacedVolumeExtension-;
 #pragma link C++ class vector<dd4hep::PlacedVolume>+;
 #pragma link C++ class dd4hep::Handle<TGeoNode>+;
 #pragma link C++ class vector<TGeoNode*>+;
@@ -44,13 +44,13 @@ short dd4hep::_toShort(const string& value) {
     s.erase(idx, 5);
   while (s[0] == ' ')
     s.erase(0, 1);
-  double result = eval.evaluate(s.c_str());
-  if (eval.status() != XmlTools::Evaluator::OK) {
+  auto result = eval.evaluate(s);
+  if (result.first != XmlTools::Evaluator::OK) {
     cerr << value << ": ";
-    eval.print_error();
+    eval.evaluate(s, cerr);
     throw runtime_error("dd4hep: Severe error during expression evaluation of " + value);
   }
-  return (short) result;
+  return (short) result.second;
 }
 
 int dd4hep::_toInt(const string& value) {
@@ -60,13 +60,13 @@ int dd4hep::_toInt(const string& value) {
     s.erase(idx, 5);
   while (s[0] == ' ')
     s.erase(0, 1);
-  double result = eval.evaluate(s.c_str());
-  if (eval.status() != XmlTools::Evaluator::OK) {
+  auto result = eval.evaluate(s);
+  if (result.first != XmlTools::Evaluator::OK) {
     cerr << value << ": ";
-    eval.print_error();
+    eval.evaluate(s, cerr);
     throw runtime_error("dd4hep: Severe error during expression evaluation of " + value);
   }
-  return (int) result;
+  return (int) result.second;
 }
 
 long dd4hep::_toLong(const string& value) {
@@ -76,13 +76,13 @@ long dd4hep::_toLong(const string& value) {
     s.erase(idx, 5);
   while (s[0] == ' ')
     s.erase(0, 1);
-  double result = eval.evaluate(s.c_str());
-  if (eval.status() != XmlTools::Evaluator::OK) {
+  auto result = eval.evaluate(s);
+  if (result.first != XmlTools::Evaluator::OK) {
     cerr << value << ": ";
-    eval.print_error();
+    eval.evaluate(s, cerr);
     throw runtime_error("dd4hep: Severe error during expression evaluation of " + value);
   }
-  return (long) result;
+  return (long) result.second;
 }
 
 bool dd4hep::_toBool(const string& value) {
@@ -90,23 +90,23 @@ bool dd4hep::_toBool(const string& value) {
 }
 
 float dd4hep::_toFloat(const string& value) {
-  double result = eval.evaluate(value.c_str());
-  if (eval.status() != XmlTools::Evaluator::OK) {
+  auto result = eval.evaluate(value);
+  if (result.first != XmlTools::Evaluator::OK) {
     cerr << value << ": ";
-    eval.print_error();
+    eval.evaluate(value, cerr);
     throw runtime_error("dd4hep: Severe error during expression evaluation of " + value);
   }
-  return (float) result;
+  return (float) result.second;
 }
 
 double dd4hep::_toDouble(const string& value) {
-  double result = eval.evaluate(value.c_str());
-  if (eval.status() != XmlTools::Evaluator::OK) {
+  auto result = eval.evaluate(value);
+  if (result.first != XmlTools::Evaluator::OK) {
     cerr << value << ": ";
-    eval.print_error();
+    eval.evaluate(value, cerr);
     throw runtime_error("dd4hep: Severe error during expression evaluation of " + value);
   }
-  return result;
+  return result.second;
 }
 
 template <> char dd4hep::_multiply<char>(const string& left, const string& right) {
@@ -193,13 +193,13 @@ void dd4hep::_toDictionary(const std::string& name, const std::string& value, co
       v.erase(idx, 7);
     while (v[0] == ' ')
       v.erase(0, 1);
-    double result = eval.evaluate(v.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(v);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << value << ": ";
-      eval.print_error();
+      eval.evaluate(v, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation " + name + "=" + value);
     }
-    eval.setVariable(n.c_str(), result);
+    eval.setVariable(n.c_str(), result.second);
   }
 }
 
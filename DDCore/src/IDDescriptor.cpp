@@ -29,11 +29,15 @@ namespace {
     BitField64& bf = o->decoder;
     o->fieldIDs.clear();
     o->fieldMap.clear();
+    o->volIDFields.clear();
     o->description = dsc;
     for (size_t i = 0; i < bf.size(); ++i) {
       BitFieldValue* f = &bf[i];
+      unsigned short idx = PlacedVolumeExtension::fieldIndex(f->name());
       o->fieldIDs.push_back(make_pair(i, f->name()));
       o->fieldMap.push_back(make_pair(f->name(), f));
+      if ( idx >= o->volIDFields.size() ) o->volIDFields.resize(idx+1, 0);
+      o->volIDFields[idx] = f;
     }
   }
 }
@@ -105,6 +109,12 @@ const BitFieldValue* IDDescriptor::field(size_t identifier) const {
   return m[identifier].second;
 }
 
+/// Get the field descriptor of one field by its interned volume ID field index (0 if not present)
+const BitFieldValue* IDDescriptor::volIDField(unsigned short field_index) const  {
+  const vector<const BitFieldValue*>& f = data<Object>()->volIDFields;
+  return field_index < f.size() ? f[field_index] : 0;
+}
+
 /// Get the field identifier of one field by name
 size_t IDDescriptor::fieldID(const string& field_name) const {
   const FieldIDs& m = ids();   // This already checks the object validity
@@ -131,6 +141,20 @@ VolumeID IDDescriptor::encode(const std::vector<std::pair<std::string, int> >& i
   return id;
 }
 
+/// Encode a set of volume identifiers with interned field names (see PlacedVolume::volIDCodes)
+VolumeID IDDescriptor::encode(const std::vector<std::pair<unsigned short, int> >& codes) const
+{
+  VolumeID id = 0;
+  for (const auto& i : codes )  {
+    const BitFieldValue* fld = volIDField(i.first);
+    if ( !fld ) fld = field(PlacedVolumeExtension::fieldName(i.first));  // Throws exception
+    int      off = fld->offset();
+    VolumeID val = i.second;
+    id |= ((fld->value(val<<off) << off)&fld->mask());
+  }
+  return id;
+}
+
 /// Decode volume IDs and return filled descriptor with all fields
 void IDDescriptor::decodeFields(VolumeID vid,
                                 vector<pair<const BitFieldValue*, VolumeID> >& flds)  const
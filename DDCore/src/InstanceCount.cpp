@@ -21,6 +21,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <new>
 #include <map>
 
 using namespace std;
@@ -32,6 +34,8 @@ namespace {
   typedef std::map<const std::type_info*, COUNT*> TypeCounter;
   typedef std::map<const std::string*, COUNT*> StringCounter;
   static bool s_trace_instances = ::getenv("DD4HEP_TRACE") != 0;
+  /// Defined first: destroyed after s_counter, whose destructor still locks it
+  static std::mutex s_lock;
   static dd4hep_ptr<TypeCounter> s_typCounts(new TypeCounter());
   static dd4hep_ptr<StringCounter> s_strCounts(new StringCounter());
   static InstanceCount::Counter s_nullCount;
@@ -46,7 +50,7 @@ namespace {
   int s_global = 1;
   struct _Global {
     _Global() {}
-    ~_Global() { s_global = 0; }
+    ~_Global() { s_global = 0; InstanceCount::doTracing(s_trace_instances); }
   } s_globalObj;
   int on_exit_destructors()  {
     static bool first = true;
@@ -58,6 +62,49 @@ namespace {
   }
 }
 
+/// Flag if counting is active: tracing is enabled and no static destructors are running
+std::atomic<bool> InstanceCount::s_active(s_trace_instances);
+
+/// Copy constructor
+InstanceCount::Counter::Counter(const Counter& c)  {
+  m_slot.count = c.value();
+  m_slot.tot   = c.total();
+  m_slot.max   = c.maximum();
+}
+
+/// Destructor
+InstanceCount::Counter::~Counter()  {
+  ::free(m_shards.load());
+}
+
+/// Shard index of the calling thread
+std::size_t InstanceCount::Counter::shard()  {
+  static std::atomic<std::size_t> s_threads(0);
+  static thread_local std::size_t s_shard = s_threads++ % NUM_SHARDS;
+  return s_shard;
+}
+
+/// Enable sharding of the counter. Sharding cannot be disabled again
+void InstanceCount::Counter::setSharded()  {
+  void* mem = 0;
+  if ( sharded() ) return;
+  if ( 0 != ::posix_memalign(&mem, sizeof(Slot), NUM_SHARDS*sizeof(Slot)) )
+    throw std::bad_alloc();
+  Slot* shards = (Slot*)mem, *expected = nullptr;
+  for( std::size_t i=0; i<NUM_SHARDS; ++i ) new(shards+i) Slot();
+  if ( !m_shards.compare_exchange_strong(expected, shards) )
+    ::free(mem);
+}
+
+/// Sum of a counter value over all shards
+InstanceCount::counter_t InstanceCount::Counter::sum(std::atomic<counter_t> Slot::*value)  const  {
+  const Slot* shards = m_shards.load(std::memory_order_acquire);
+  counter_t result = (m_slot.*value).load(std::memory_order_relaxed);
+  for( std::size_t i=0; shards && i<NUM_SHARDS; ++i )
+    result += (shards[i].*value).load(std::memory_order_relaxed);
+  return result;
+}
+
 /// Standard Constructor
 InstanceCount::InstanceCount() {
   s_thisCount.increment();
@@ -66,9 +113,10 @@ InstanceCount::InstanceCount() {
 InstanceCount::~InstanceCount() {
   s_thisCount.decrement();
   if (0 == s_thisCount.value()) {
+    dump(s_trace_instances ? ALL : NONE);
+    std::lock_guard<std::mutex> guard(s_lock);
     StringCounter::iterator i;
     TypeCounter::iterator j;
-    dump(s_trace_instances ? ALL : NONE);
     for (i = s_strCounts->begin(); i != s_strCounts->end(); ++i)
       delete (*i).second;
     for (j = s_typCounts->begin(); j != s_typCounts->end(); ++j)
@@ -84,17 +132,34 @@ bool InstanceCount::doTrace() {
 /// Enable/Disable tracing
 void InstanceCount::doTracing(bool value) {
   s_trace_instances = value;
+  s_active = value && s_global;
+}
+
+/// Handle counts while counting is inactive
+void InstanceCount::inactive()  {
+  if ( !s_global ) on_exit_destructors();
+}
+
+/// Register a counter object (created on first call)
+InstanceCount::Counter* InstanceCount::registerCounter(const std::type_info& typ)  {
+  std::lock_guard<std::mutex> guard(s_lock);
+  Counter*& cnt = types()[&typ];
+  return (0 != cnt) ? cnt : cnt = new Counter();
 }
+
 /// Access counter object for local caching on optimizations
 InstanceCount::Counter* InstanceCount::getCounter(const std::type_info& typ) {
-  Counter* cnt = s_trace_instances ? types()[&typ] : &s_nullCount;
-  return (0 != cnt) ? cnt : types()[&typ] = new Counter();
+  return s_trace_instances ? registerCounter(typ) : &s_nullCount;
 }
 
 /// Access counter object for local caching on optimizations
 InstanceCount::Counter* InstanceCount::getCounter(const std::string& typ) {
-  Counter* cnt = s_trace_instances ? strings()[&typ] : &s_nullCount;
-  return (0 != cnt) ? cnt : strings()[&typ] = new Counter();
+  if ( s_trace_instances )  {
+    std::lock_guard<std::mutex> guard(s_lock);
+    Counter*& cnt = strings()[&typ];
+    return (0 != cnt) ? cnt : cnt = new Counter();
+  }
+  return &s_nullCount;
 }
 
 /// Increment count according to string information
@@ -129,8 +194,14 @@ void InstanceCount::decrement(const std::type_info& typ) {
     on_exit_destructors();
 }
 
+/// Shard the counter of a heavily contended type
+void InstanceCount::shard(const std::type_info& typ)  {
+  registerCounter(typ)->setSharded();
+}
+
 /// Force dump of counter
 void InstanceCount::dump(int typ) {
+  std::lock_guard<std::mutex> guard(s_lock);
   bool need_footer = false;
   if ((typ & STRING) && s_strCounts.get()) {
     if ( !s_strCounts->empty() )  {
@@ -15,7 +15,9 @@
 #include "JSON/DocumentHandler.h"
 
 // C/C++ include files
+#ifndef DD4HEP_USE_FASTJSON
 #include "boost/property_tree/json_parser.hpp"
+#endif
 #include <memory>
 #include <stdexcept>
 
@@ -37,13 +39,28 @@ Document DocumentHandler::load(const string& fname) const   {
   //string cmd = "cat "+fn;
   //::printf("\n\n+++++ Dump json file: %s\n\n\n",fn.c_str());
   //::system(cmd.c_str());
+#ifdef DD4HEP_USE_FASTJSON
+  unique_ptr<JsonDocument> doc(new JsonDocument(fn));
+  if ( !doc->load(fn) )  {
+    throw runtime_error(fn + "(" + to_string(doc->errorLine()) + "): " + doc->errorMessage());
+  }
+#else
   unique_ptr<JsonElement> doc(new JsonElement(fn, ptree()));
   boost::property_tree::read_json(fn,doc->second);
+#endif
   return doc.release();
 }
 
 /// Parse a standalong XML string into a document.
 Document DocumentHandler::parse(const char* doc_string, size_t length) const   {
+#ifdef DD4HEP_USE_FASTJSON
+  unique_ptr<JsonDocument> doc(new JsonDocument("json-memory-buffer"));
+  if ( !doc->parse(doc_string, length) )  {
+    throw runtime_error("json-memory-buffer(" + to_string(doc->errorLine()) + "): " + doc->errorMessage());
+  }
+  return doc.release();
+#else
   if ( doc_string && length ) {}
   throw runtime_error("Bla");
+#endif
 }
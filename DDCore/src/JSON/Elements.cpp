@@ -42,6 +42,44 @@ namespace {
 
 namespace {
 
+#ifdef DD4HEP_USE_FASTJSON
+  bool any_tag(const char* tag)  {
+    return tag[0] == '*' && tag[1] == 0;
+  }
+
+  JsonElement* node_first(JsonElement* e, const char* tag) {
+    return e ? (any_tag(tag) ? e->first : e->find(tag)) : 0;
+  }
+
+  size_t node_count(JsonElement* e, const string& t) {
+    return e ? e->count(t=="*" ? 0 : t.c_str()) : 0;
+  }
+
+  Attribute attribute_node(JsonElement* n, const char* t)  {
+    return n ? n->find(t) : 0;
+  }
+
+  const char* attribute_value(Attribute a) {
+    return a->text;
+  }
+
+  const char* attribute_name(Attribute a) {
+    return a->key;
+  }
+
+  bool has_children(const JsonElement* e)  {
+    return e->first != 0;
+  }
+
+  /// Typed number or boolean, which needs no expression evaluation
+  bool typed_value(Attribute a, double& value)  {
+    if ( a && (a->isNumber() || a->isBool()) )   {
+      value = a->number;
+      return true;
+    }
+    return false;
+  }
+#else
   // This should ensure we are not passing temporaries of std::string and then
   // returning the "const char*" content calling .c_str()
   const ptree::data_type& value_data(const ptree& entry)  {
@@ -76,6 +114,20 @@ namespace {
   const char* attribute_value(Attribute a) {
     return value_data(a->second).c_str();
   }
+
+  const char* attribute_name(Attribute a) {
+    return a->first.c_str();
+  }
+
+  bool has_children(const JsonElement* e)  {
+    return e->second.size() > 0;
+  }
+
+  /// The property tree only stores strings: all values must be evaluated
+  bool typed_value(Attribute, double&)  {
+    return false;
+  }
+#endif
 }
 
 string dd4hep::json::_toString(Attribute attr) {
@@ -150,13 +202,13 @@ long dd4hep::json::_toLong(const char* value) {
       s.erase(idx, 6);
     while (s[0] == ' ')
       s.erase(0, 1);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(s);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << s << ": ";
-      eval.print_error();
+      eval.evaluate(s, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation of " + s);
     }
-    return (long) result;
+    return (long) result.second;
   }
   return -1;
 }
@@ -169,13 +221,13 @@ int dd4hep::json::_toInt(const char* value) {
       s.erase(idx, 5);
     while (s[0] == ' ')
       s.erase(0, 1);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(s);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << s << ": ";
-      eval.print_error();
+      eval.evaluate(s, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation of " + s);
     }
-    return (int) result;
+    return (int) result.second;
   }
   return -1;
 }
@@ -191,14 +243,13 @@ bool dd4hep::json::_toBool(const char* value) {
 float dd4hep::json::_toFloat(const char* value) {
   if (value) {
     string s = _toString(value);
-    double result = eval.evaluate(s.c_str());
-
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(s);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << s << ": ";
-      eval.print_error();
+      eval.evaluate(s, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation of " + s);
     }
-    return (float) result;
+    return (float) result.second;
   }
   return 0.0;
 }
@@ -206,17 +257,52 @@ float dd4hep::json::_toFloat(const char* value) {
 double dd4hep::json::_toDouble(const char* value) {
   if (value) {
     string s = _toString(value);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(s);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << s << ": ";
-      eval.print_error();
+      eval.evaluate(s, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation of " + s);
     }
-    return result;
+    return result.second;
   }
   return 0.0;
 }
 
+/// Conversion function from attribute to bool. Typed values are not evaluated
+bool dd4hep::json::_toBool(Attribute attr)   {
+  double value = 0e0;
+  if ( typed_value(attr, value) ) return value != 0e0;
+  return _toBool(attr ? attribute_value(attr) : 0);
+}
+
+/// Conversion function from attribute to int. Typed values are not evaluated
+int dd4hep::json::_toInt(Attribute attr)   {
+  double value = 0e0;
+  if ( typed_value(attr, value) ) return (int) value;
+  return _toInt(attr ? attribute_value(attr) : 0);
+}
+
+/// Conversion function from attribute to long. Typed values are not evaluated
+long dd4hep::json::_toLong(Attribute attr)   {
+  double value = 0e0;
+  if ( typed_value(attr, value) ) return (long) value;
+  return _toLong(attr ? attribute_value(attr) : 0);
+}
+
+/// Conversion function from attribute to float. Typed values are not evaluated
+float dd4hep::json::_toFloat(Attribute attr)   {
+  double value = 0e0;
+  if ( typed_value(attr, value) ) return (float) value;
+  return _toFloat(attr ? attribute_value(attr) : 0);
+}
+
+/// Conversion function from attribute to double. Typed values are not evaluated
+double dd4hep::json::_toDouble(Attribute attr)   {
+  double value = 0e0;
+  if ( typed_value(attr, value) ) return value;
+  return _toDouble(attr ? attribute_value(attr) : 0);
+}
+
 void dd4hep::json::_toDictionary(const char* name, const char* value) {
   string n = _toString(name).c_str(), v = _toString(value);
   size_t idx = v.find("(int)");
@@ -224,13 +310,13 @@ void dd4hep::json::_toDictionary(const char* name, const char* value) {
     v.erase(idx, 5);
   while (v[0] == ' ')
     v.erase(0, 1);
-  double result = eval.evaluate(v.c_str());
-  if (eval.status() != XmlTools::Evaluator::OK) {
+  auto result = eval.evaluate(v);
+  if (result.first != XmlTools::Evaluator::OK) {
     cerr << v << ": ";
-    eval.print_error();
+    eval.evaluate(v, cerr);
     throw runtime_error("dd4hep: Severe error during expression evaluation of " + v);
   }
-  eval.setVariable(n.c_str(), result);
+  eval.setVariable(n.c_str(), result.second);
 }
 
 template <typename T>
@@ -289,6 +375,27 @@ NodeList::NodeList(JsonElement* node, const string& tag_value)
 NodeList::~NodeList() {
 }
 
+#ifdef DD4HEP_USE_FASTJSON
+/// Reset the nodelist
+JsonElement* NodeList::reset() {
+  m_ptr = make_pair(node_first(m_node, m_tag.c_str()), (JsonElement*)0);
+  return m_ptr.first;
+}
+
+/// Advance to next element
+JsonElement* NodeList::next() const {
+  if ( m_ptr.first )
+    m_ptr.first = m_tag == "*" ? m_ptr.first->next : m_ptr.first->findNext();
+  return m_ptr.first;
+}
+
+/// Go back to previous element
+JsonElement* NodeList::previous() const {
+  if ( m_ptr.first )
+    m_ptr.first = m_tag == "*" ? m_ptr.first->previous() : m_ptr.first->findPrevious();
+  return m_ptr.first;
+}
+#else
 /// Reset the nodelist
 JsonElement* NodeList::reset() {
   if ( m_tag == "*" )
@@ -317,6 +424,7 @@ JsonElement* NodeList::previous() const {
   }
   return 0;
 }
+#endif
 
 /// Assignment operator
 NodeList& NodeList::operator=(const NodeList& l) {
@@ -330,17 +438,17 @@ NodeList& NodeList::operator=(const NodeList& l) {
 
 /// Unicode text access to the element's tag. This must be wrong ....
 const char* Handle_t::rawTag() const {
-  return m_node->first.c_str();
+  return attribute_name(m_node);
 }
 
 /// Unicode text access to the element's text
 const char* Handle_t::rawText() const {
-  return value_data(m_node->second).c_str();
+  return attribute_value(m_node);
 }
 
 /// Unicode text access to the element's value
 const char* Handle_t::rawValue() const {
-  return value_data(m_node->second).c_str();
+  return attribute_value(m_node);
 }
 
 /// Access attribute pointer by the attribute's unicode name (no exception thrown if not present)
@@ -357,10 +465,15 @@ bool Handle_t::hasAttr(const char* tag_value) const {
 vector<Attribute> Handle_t::attributes() const {
   vector < Attribute > attrs;
   if (m_node) {
+#ifdef DD4HEP_USE_FASTJSON
+    for(Attribute a=m_node->first; a; a=a->next)
+      attrs.push_back(a);
+#else
     for(ptree::iterator i=m_node->second.begin(); i!=m_node->second.end(); ++i)  {
       Attribute a = &(*i);
       attrs.push_back(a);
     }
+#endif
   }
   return attrs;
 }
@@ -416,7 +529,7 @@ Attribute Handle_t::attr_ptr(const char* t) const {
 /// Access attribute name (throws exception if not present)
 const char* Handle_t::attr_name(const Attribute a) const {
   if (a) {
-    return a->first.c_str();
+    return attribute_name(a);
   }
   throw runtime_error("Attempt to access invalid XML attribute object!");
 }
@@ -450,7 +563,12 @@ Handle_t Document::root() const   {
 DocumentHolder& DocumentHolder::assign(DOC d)   {
   if ( m_doc )   {
     printout(DEBUG,"DocumentHolder","+++ Release JSON document....");
+#ifdef DD4HEP_USE_FASTJSON
+    // The root element of the in-situ parser is the document itself
+    delete static_cast<JsonDocument*>(m_doc);
+#else
     delete m_doc;
+#endif
   }
   m_doc = d;
   return *this;
@@ -498,7 +616,7 @@ void Collection_t::throw_loop_exception(const exception& e) const {
 void Collection_t::operator++() const {
   while (m_node) {
     m_node = m_children.next();
-    if (m_node && m_node->second.size() > 0 )
+    if (m_node && has_children(m_node) )
       return;
   }
 }
@@ -506,7 +624,7 @@ void Collection_t::operator++() const {
 void Collection_t::operator--() const {
   while (m_node) {
     m_node = m_children.previous();
-    if (m_node && m_node->second.size() > 0 )
+    if (m_node && has_children(m_node) )
       return;
   }
 }
@@ -531,9 +649,14 @@ void dd4hep::json::dumpTree(const JsonElement* elt)   {
   struct Dump {
     void operator()(const JsonElement* e, const string& tag)   const  {
       string t = tag+"   ";
-      printout(INFO,"DumpTree","+++ %s %s: %s",tag.c_str(), e->first.c_str(), e->second.data().c_str());
+      printout(INFO,"DumpTree","+++ %s %s: %s",tag.c_str(), attribute_name(e), attribute_value(e));
+#ifdef DD4HEP_USE_FASTJSON
+      for(const JsonElement* c=e->first; c; c=c->next)
+        (*this)(c, t);
+#else
       for(auto i=e->second.begin(); i!=e->second.end(); ++i)
         (*this)(&(*i), t);
+#endif
     }
   } _dmp;
   _dmp(elt," ");
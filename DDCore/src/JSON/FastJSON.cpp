@@ -0,0 +1,471 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework include files
+#include "JSON/FastJSON.h"
+
+// C/C++ include files
+#include <new>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace dd4hep::json::fast;
+
+namespace {
+
+  /// Size of one arena block
+  const size_t BLOCK_SIZE = 64*1024;
+
+  inline bool is_space(char c)   {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  inline bool is_digit(char c)   {
+    return c >= '0' && c <= '9';
+  }
+
+  /// Write the UTF-8 representation of a code point. Returns the new write position
+  char* utf8(char* w, unsigned long cp)   {
+    if ( cp < 0x80 )   {
+      *w++ = char(cp);
+    }
+    else if ( cp < 0x800 )   {
+      *w++ = char(0xC0 | (cp >> 6));
+      *w++ = char(0x80 | (cp & 0x3F));
+    }
+    else if ( cp < 0x10000 )   {
+      *w++ = char(0xE0 | (cp >> 12));
+      *w++ = char(0x80 | ((cp >> 6) & 0x3F));
+      *w++ = char(0x80 | (cp & 0x3F));
+    }
+    else   {
+      *w++ = char(0xF0 | (cp >> 18));
+      *w++ = char(0x80 | ((cp >> 12) & 0x3F));
+      *w++ = char(0x80 | ((cp >> 6) & 0x3F));
+      *w++ = char(0x80 | (cp & 0x3F));
+    }
+    return w;
+  }
+
+  /// In-situ parser of a document buffer
+  /**
+   *  Strings are unescaped and null-terminated inside the buffer.
+   *  The terminator overwrites the closing quote, which is consumed.
+   *  Number literals are not followed by a consumed character and
+   *  are therefore copied to the document arena.
+   */
+  class Parser   {
+  public:
+    Document*   doc;
+    char*       p;
+    char*       end;
+    const char* error = 0;
+    char*       where = 0;
+
+    Parser(Document* d, char* b, char* e) : doc(d), p(b), end(e)  {}
+
+    bool fail(const char* msg, char* pos)   {
+      error = msg;
+      where = pos;
+      return false;
+    }
+    void skip_space()   {
+      while ( p < end && is_space(*p) ) ++p;
+    }
+    bool literal(const char* lit, size_t len)   {
+      if ( size_t(end-p) < len || 0 != ::strncmp(p, lit, len) ) return false;
+      p += len;
+      return true;
+    }
+    Value* create(Value* parent, Value*& last, const char* key)   {
+      Value* v = new(doc->allocate(sizeof(Value))) Value(Value::NULL_VALUE, key);
+      v->parent = parent;
+      if ( last ) last->next = v;
+      else parent->first = v;
+      last = v;
+      return v;
+    }
+    /// Read 4 hex digits of a unicode escape
+    bool hex4(char* s, unsigned long& cp)   {
+      cp = 0;
+      if ( end-s < 4 ) return false;
+      for( int i=0; i<4; ++i )   {
+        char c = s[i];
+        cp <<= 4;
+        if      ( c >= '0' && c <= '9' ) cp |= c-'0';
+        else if ( c >= 'a' && c <= 'f' ) cp |= c-'a'+10;
+        else if ( c >= 'A' && c <= 'F' ) cp |= c-'A'+10;
+        else return false;
+      }
+      return true;
+    }
+    /// Parse string. p points to the opening quote
+    bool string(const char*& result);
+    /// Parse number. p points to the first character
+    bool number(Value* v);
+    /// Parse any value
+    bool value(Value* v);
+    /// Parse object. p points to '{'
+    bool object(Value* v);
+    /// Parse array. p points to '['
+    bool array(Value* v);
+  };
+
+  bool Parser::string(const char*& result)   {
+    char* start = ++p;
+    char* r = start;
+    // Fast path: no escape sequence, nothing to move
+    while ( r < end && *r != '"' && *r != '\\' && (unsigned char)*r >= 0x20 ) ++r;
+    char* w = r;
+    while ( r < end )   {
+      char c = *r;
+      if ( c == '"' )   {
+        *w = 0;
+        p = r+1;
+        result = start;
+        return true;
+      }
+      else if ( (unsigned char)c < 0x20 )   {
+        return fail("Control character in string", r);
+      }
+      else if ( c != '\\' )   {
+        *w++ = *r++;
+        continue;
+      }
+      if ( ++r >= end ) break;
+      switch( *r )   {
+      case '"':  *w++ = '"';  break;
+      case '\\': *w++ = '\\'; break;
+      case '/':  *w++ = '/';  break;
+      case 'b':  *w++ = '\b'; break;
+      case 'f':  *w++ = '\f'; break;
+      case 'n':  *w++ = '\n'; break;
+      case 'r':  *w++ = '\r'; break;
+      case 't':  *w++ = '\t'; break;
+      case 'u':  {
+        unsigned long cp = 0, lo = 0;
+        if ( !hex4(r+1, cp) ) return fail("Invalid unicode escape", r-1);
+        r += 4;
+        if ( cp >= 0xD800 && cp < 0xDC00 )   {
+          if ( end-r < 7 || r[1] != '\\' || r[2] != 'u' || !hex4(r+3, lo) || lo < 0xDC00 || lo >= 0xE000 )
+            return fail("Invalid unicode surrogate pair", r-5);
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+          r += 6;
+        }
+        w = utf8(w, cp);
+        break;
+      }
+      default:
+        return fail("Invalid escape sequence", r-1);
+      }
+      ++r;
+    }
+    return fail("Unterminated string", start-1);
+  }
+
+  bool Parser::number(Value* v)   {
+    char* start = p;
+    unsigned long long mantissa = 0;
+    int  digits = 0;
+    bool integer = true;
+    if ( *p == '-' ) ++p;
+    if ( p >= end || !is_digit(*p) ) return fail("Invalid number", start);
+    if ( *p == '0' )   {
+      ++p;
+      digits = 1;
+    }
+    else   {
+      for( ; p < end && is_digit(*p); ++p, ++digits )
+        mantissa = 10*mantissa + (*p - '0');
+    }
+    if ( p < end && *p == '.' )   {
+      integer = false;
+      if ( ++p >= end || !is_digit(*p) ) return fail("Invalid number", start);
+      while ( p < end && is_digit(*p) ) ++p;
+    }
+    if ( p < end && (*p == 'e' || *p == 'E') )   {
+      integer = false;
+      if ( ++p < end && (*p == '+' || *p == '-') ) ++p;
+      if ( p >= end || !is_digit(*p) ) return fail("Invalid number", start);
+      while ( p < end && is_digit(*p) ) ++p;
+    }
+    v->type = Value::NUMBER_VALUE;
+    v->text = doc->copy(start, p-start);
+    if ( integer && digits <= 18 )
+      v->number = *start == '-' ? -double(mantissa) : double(mantissa);
+    else
+      v->number = ::strtod(v->text, 0);
+    return true;
+  }
+
+  bool Parser::value(Value* v)   {
+    skip_space();
+    if ( p >= end ) return fail("Unexpected end of document", p);
+    switch( *p )   {
+    case '{':
+      return object(v);
+    case '[':
+      return array(v);
+    case '"':
+      v->type = Value::STRING_VALUE;
+      return string(v->text);
+    case 't':
+      if ( !literal("true",4) ) break;
+      v->type   = Value::TRUE_VALUE;
+      v->text   = "true";
+      v->number = 1e0;
+      return true;
+    case 'f':
+      if ( !literal("false",5) ) break;
+      v->type   = Value::FALSE_VALUE;
+      v->text   = "false";
+      return true;
+    case 'n':
+      if ( !literal("null",4) ) break;
+      v->type   = Value::NULL_VALUE;
+      v->text   = "null";
+      return true;
+    default:
+      if ( *p == '-' || is_digit(*p) ) return number(v);
+      break;
+    }
+    return fail("Unexpected character", p);
+  }
+
+  bool Parser::object(Value* v)   {
+    Value* last = 0;
+    char* start = p++;
+    v->type = Value::OBJECT_VALUE;
+    skip_space();
+    if ( p < end && *p == '}' )  {
+      ++p;
+      return true;
+    }
+    while ( p < end )   {
+      const char* key = 0;
+      skip_space();
+      if ( p >= end || *p != '"' ) return fail("Expected member name", p);
+      if ( !string(key) ) return false;
+      skip_space();
+      if ( p >= end || *p != ':' ) return fail("Expected ':'", p);
+      ++p;
+      if ( !value(create(v, last, key)) ) return false;
+      skip_space();
+      if ( p < end && *p == ',' )  {
+        ++p;
+        continue;
+      }
+      else if ( p < end && *p == '}' )  {
+        ++p;
+        return true;
+      }
+      return fail(p < end ? "Expected ',' or '}'" : "Unterminated object", p < end ? p : start);
+    }
+    return fail("Unterminated object", start);
+  }
+
+  bool Parser::array(Value* v)   {
+    Value* last = 0;
+    char* start = p++;
+    v->type = Value::ARRAY_VALUE;
+    skip_space();
+    if ( p < end && *p == ']' )  {
+      ++p;
+      return true;
+    }
+    while ( p < end )   {
+      if ( !value(create(v, last, "")) ) return false;
+      skip_space();
+      if ( p < end && *p == ',' )  {
+        ++p;
+        continue;
+      }
+      else if ( p < end && *p == ']' )  {
+        ++p;
+        return true;
+      }
+      return fail(p < end ? "Expected ',' or ']'" : "Unterminated array", p < end ? p : start);
+    }
+    return fail("Unterminated array", start);
+  }
+}
+
+/// Access the first child with a given key (0 if absent)
+Value* Value::find(const char* k)  const   {
+  for( Value* c = first; c; c = c->next )
+    if ( 0 == ::strcmp(c->key, k) ) return c;
+  return 0;
+}
+
+/// Access the next sibling with the same key as this value (0 if absent)
+Value* Value::findNext()  const   {
+  for( Value* c = next; c; c = c->next )
+    if ( 0 == ::strcmp(c->key, key) ) return c;
+  return 0;
+}
+
+/// Access the previous sibling with the same key as this value (0 if absent)
+Value* Value::findPrevious()  const   {
+  Value* found = 0;
+  for( Value* c = parent ? parent->first : 0; c && c != this; c = c->next )
+    if ( 0 == ::strcmp(c->key, key) ) found = c;
+  return found;
+}
+
+/// Access the previous sibling (0 if absent)
+Value* Value::previous()  const   {
+  Value* found = 0;
+  for( Value* c = parent ? parent->first : 0; c && c != this; c = c->next )
+    found = c;
+  return found;
+}
+
+/// Number of children with a given key (0: all children)
+size_t Value::count(const char* k)  const   {
+  size_t cnt = 0;
+  for( const Value* c = first; c; c = c->next )
+    if ( !k || 0 == ::strcmp(c->key, k) ) ++cnt;
+  return cnt;
+}
+
+/// Initializing constructor
+Document::Document(const string& uri)
+  : Value(OBJECT_VALUE, 0), m_uri(uri)
+{
+  key = m_uri.c_str();
+}
+
+/// Default destructor
+Document::~Document()   {
+  release();
+}
+
+/// Release buffer and arena
+void Document::release()   {
+  if ( m_buffer )   {
+    if ( m_mapped ) ::munmap(m_buffer, m_length);
+    else ::free(m_buffer);
+  }
+  for( char* b : m_blocks ) ::free(b);
+  m_blocks.clear();
+  m_buffer = 0;
+  m_length = m_free = m_allocated = 0;
+  m_mapped = false;
+  first = 0;
+  type  = OBJECT_VALUE;
+  text = "";
+}
+
+/// Allocate memory from the document arena
+void* Document::allocate(size_t len)   {
+  len = (len + 7) & ~size_t(7);
+  if ( len > BLOCK_SIZE/4 )   {
+    char* b = (char*)::malloc(len);
+    if ( !b ) throw bad_alloc();
+    // Keep the current block at the end of the list
+    m_blocks.insert(m_blocks.empty() ? m_blocks.end() : m_blocks.end()-1, b);
+    m_allocated += len;
+    return b;
+  }
+  if ( len > m_free )   {
+    char* b = (char*)::malloc(BLOCK_SIZE);
+    if ( !b ) throw bad_alloc();
+    m_blocks.push_back(b);
+    m_free = BLOCK_SIZE;
+    m_allocated += BLOCK_SIZE;
+  }
+  void* ptr = m_blocks.back() + (BLOCK_SIZE - m_free);
+  m_free -= len;
+  return ptr;
+}
+
+/// Copy a string to the document arena
+const char* Document::copy(const char* str, size_t len)   {
+  char* s = (char*)::memcpy(allocate(len+1), str, len);
+  s[len] = 0;
+  return s;
+}
+
+/// Load and parse a file using a private memory mapping
+bool Document::load(const string& file_name)   {
+  struct stat st;
+  release();
+  m_error.clear();
+  if ( m_uri.empty() )   {
+    m_uri = file_name;
+    key = m_uri.c_str();
+  }
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if ( fd < 0 )   {
+    m_error = "Cannot open file: " + std::string(::strerror(errno));
+    return false;
+  }
+  if ( ::fstat(fd, &st) != 0 || st.st_size == 0 )   {
+    m_error = "Cannot access file or file is empty";
+    ::close(fd);
+    return false;
+  }
+  // Private, writable mapping: the in-situ terminators never reach the file
+  void* ptr = ::mmap(0, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if ( ptr == MAP_FAILED )   {
+    m_error = "Cannot map file: " + std::string(::strerror(errno));
+    return false;
+  }
+  ::madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+  m_buffer = (char*)ptr;
+  m_length = st.st_size;
+  m_mapped = true;
+  return parseBuffer();
+}
+
+/// Parse a memory buffer. The buffer is copied
+bool Document::parse(const char* bytes, size_t length)   {
+  release();
+  m_error.clear();
+  length = ::strnlen(bytes, length);
+  m_buffer = (char*)::malloc(length+1);
+  if ( !m_buffer ) throw bad_alloc();
+  ::memcpy(m_buffer, bytes, length);
+  m_buffer[length] = 0;
+  m_length = length;
+  return parseBuffer();
+}
+
+/// Parse the document buffer in place
+bool Document::parseBuffer()   {
+  char* begin = m_buffer;
+  if ( m_length >= 3 && 0 == ::strncmp(begin, "\xEF\xBB\xBF", 3) ) begin += 3;
+  Parser parser(this, begin, m_buffer+m_length);
+  m_errorLine = m_errorCol = 0;
+  bool result = parser.value(this);
+  if ( result )   {
+    parser.skip_space();
+    if ( parser.p < parser.end )
+      result = parser.fail("Unexpected data after the top level value", parser.p);
+  }
+  if ( !result )   {
+    m_errorLine = 1;
+    m_errorCol  = 1;
+    for( const char* c = m_buffer; c < parser.where; ++c, ++m_errorCol )   {
+      if ( *c == '\n' ) { ++m_errorLine; m_errorCol = 0; }
+    }
+    m_error = parser.error;
+    return false;
+  }
+  return true;
+}
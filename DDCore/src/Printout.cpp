@@ -15,10 +15,18 @@
 #include "DD4hep/Printout.h"
 
 // C/C++ include files
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
 #include <cstring>
 #include <cstdarg>
 #include <sstream>
 #include <stdexcept>
+#include <pthread.h>
 // Disable some diagnostics for ROOT dictionaries
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wvarargs"
@@ -85,6 +93,338 @@ namespace {
     ::vsnprintf(str, sizeof(str), fmt, args);
     return string(str);
   }
+
+  /// Lock-free single producer, single consumer ring buffer of printout messages
+  /**
+   *  Every thread owns one ring buffer. Records are 8-byte aligned and never
+   *  wrap: if the free space at the end of the buffer is too small, it is
+   *  filled with a padding record and the message starts at the beginning.
+   */
+  class PrintRing  {
+  public:
+    /// Record header. The source and the text follow the header
+    struct Record  {
+      uint32_t length;
+      uint16_t level;
+      uint16_t src_len;
+      uint32_t text_len;
+      uint32_t reserved;
+      uint64_t sequence;
+    };
+    enum  { PADDING = 0xFFFF };
+
+    vector<char>          buffer;
+    size_t                mask;
+    /// Write position: modified by the producer only
+    atomic<uint64_t>      head      {0};
+    /// Read position: modified by the consumer only
+    atomic<uint64_t>      tail      {0};
+    /// Sequence number of the last message handled by the consumer
+    atomic<uint64_t>      written   {0};
+    /// Number of messages dropped since the last report
+    atomic<size_t>        dropped   {0};
+    /// Flag set when the owning thread exits
+    atomic<bool>          closed    {false};
+    /// Rate limit: current time window and number of messages in the window
+    int64_t               window    = 0;
+    size_t                in_window = 0;
+    /// Consumer side: last message for coalescing and its repetition count
+    string                last_src, last_text;
+    int                   last_level = -1;
+    size_t                repeated   = 0;
+
+    /// Initializing constructor. The size is rounded up to a power of 2
+    explicit PrintRing(size_t size)  {
+      size_t len = 4096;
+      while ( len < size ) len <<= 1;
+      buffer.resize(len);
+      mask = len-1;
+    }
+    /// Producer: add a message. Returns false if the buffer is full
+    bool push(dd4hep::PrintLevel lvl, const char* src, const char* text, size_t text_len, uint64_t seq)  {
+      size_t   src_len = ::strnlen(src, 255);
+      size_t   cap     = buffer.size();
+      if ( sizeof(Record)+src_len+text_len > cap/2 ) text_len = cap/2 - sizeof(Record) - src_len;
+      size_t   need    = (sizeof(Record)+src_len+text_len+7) & ~size_t(7);
+      uint64_t h       = head.load(memory_order_relaxed);
+      uint64_t t       = tail.load(memory_order_acquire);
+      size_t   off     = h & mask;
+      size_t   pad     = cap-off < need ? cap-off : 0;
+      if ( cap - (h-t) < need+pad ) return false;
+      if ( pad > 0 )  {
+        Record* r = (Record*)&buffer[off];
+        r->length = uint32_t(pad);
+        r->level  = PADDING;
+        h  += pad;
+        off = 0;
+      }
+      Record* r   = (Record*)&buffer[off];
+      r->length   = uint32_t(need);
+      r->level    = uint16_t(lvl);
+      r->src_len  = uint16_t(src_len);
+      r->text_len = uint32_t(text_len);
+      r->sequence = seq;
+      ::memcpy(&buffer[off+sizeof(Record)], src, src_len);
+      ::memcpy(&buffer[off+sizeof(Record)+src_len], text, text_len);
+      head.store(h+need, memory_order_release);
+      return true;
+    }
+    /// Consumer: access the oldest message (0 if empty)
+    const Record* front()  {
+      uint64_t t = tail.load(memory_order_relaxed);
+      uint64_t h = head.load(memory_order_acquire);
+      while ( t != h )  {
+        const Record* r = (const Record*)&buffer[t & mask];
+        if ( r->level != PADDING ) return r;
+        t += r->length;
+        tail.store(t, memory_order_release);
+      }
+      return 0;
+    }
+    /// Consumer: release the oldest message. It is marked written once it is printed
+    void pop(const Record* r)  {
+      tail.store(tail.load(memory_order_relaxed) + r->length, memory_order_release);
+    }
+  };
+
+  /// Background printer writing the messages of all thread ring buffers
+  class AsyncPrinter  {
+  public:
+    /// Message copied out of a ring buffer. Printed after the ring lock is released
+    struct Message  {
+      PrintRing* ring;
+      uint64_t   sequence;
+      int        level;
+      bool       print;
+      string     src, text;
+    };
+    /// Protects the list of rings. Never held while the output function runs
+    mutex                        lock;
+    vector<PrintRing*>           rings;
+    unique_ptr<thread>           worker;
+    atomic<bool>                 running   {false};
+    atomic<uint64_t>             sequence  {0};
+    atomic<uint64_t>             passes    {0};
+    size_t                       ring_size = 1024*1024;
+    size_t                       max_rate  = 0;
+    dd4hep::output_function2_t   previous  = 0;
+
+    ~AsyncPrinter()   {
+      stop();
+      for( PrintRing* r : rings ) delete r;
+    }
+    /// Start the background thread
+    void start(size_t size, size_t rate);
+    /// Stop the background thread after writing all pending messages
+    void stop();
+    /// Access the ring buffer of the calling thread
+    PrintRing* ring();
+    /// Write one message
+    void write(int lvl, const char* src, const char* text);
+    /// Queue the repetition count of the last message of a ring
+    void queue_repeated(PrintRing* r, vector<Message>& batch);
+    /// Queue the number of messages of a ring dropped since the last report
+    void queue_dropped(PrintRing* r, vector<Message>& batch);
+    /// Write all messages issued before the call in sequence order. Returns the number of messages
+    size_t drain();
+    /// Body of the background thread
+    void run();
+  };
+  AsyncPrinter async_printer;
+
+  /// Owner of the ring buffer of a thread: marks it closed when the thread exits
+  struct PrintRingOwner  {
+    PrintRing* ring = 0;
+    ~PrintRingOwner()  {  if ( ring ) ring->closed = true;  }
+  };
+  thread_local PrintRingOwner print_ring_owner;
+  /// Set in the background thread, where the output function runs
+  thread_local bool           print_ring_consumer = false;
+
+  PrintRing* AsyncPrinter::ring()   {
+    PrintRing* r = print_ring_owner.ring;
+    if ( !r )  {
+      r = new PrintRing(ring_size);
+      lock_guard<mutex> guard(lock);
+      rings.push_back(r);
+      print_ring_owner.ring = r;
+    }
+    return r;
+  }
+
+  void AsyncPrinter::write(int lvl, const char* src, const char* text)   {
+    if ( print_func_1 )   {
+      print_func_1(print_arg, dd4hep::PrintLevel(lvl), src, text);
+      return;
+    }
+    ::fprintf(stdout, print_fmt.c_str(), src, print_level(dd4hep::PrintLevel(lvl)), text);
+    ::fputc('\n',stdout);
+  }
+
+  void AsyncPrinter::queue_repeated(PrintRing* r, vector<Message>& batch)   {
+    if ( r->repeated > 0 )  {
+      string text = "+++ Last message repeated " + to_string(r->repeated) + " times";
+      batch.push_back({0, 0, r->last_level, true, r->last_src, move(text)});
+      r->repeated = 0;
+    }
+  }
+
+  void AsyncPrinter::queue_dropped(PrintRing* r, vector<Message>& batch)   {
+    size_t dropped = r->dropped.exchange(0);
+    if ( dropped > 0 )  {
+      string text = "+++ " + to_string(dropped) + " messages were dropped by the asynchronous printer";
+      batch.push_back({0, 0, dd4hep::WARNING, true, "Printout", move(text)});
+    }
+  }
+
+  /// Only the background thread drains. The messages are copied out under the lock
+  /// and printed after it is released: the output function may itself print.
+  size_t AsyncPrinter::drain()   {
+    vector<Message>    batch;
+    vector<PrintRing*> finished;
+    unique_lock<mutex> guard(lock);
+    uint64_t limit = sequence.load();
+    size_t   count = 0;
+    vector<const PrintRing::Record*> fronts(rings.size());
+    for( size_t i=0; i<rings.size(); ++i ) fronts[i] = rings[i]->front();
+    for(;;)  {
+      // Select the oldest message of all threads
+      size_t idx = rings.size();
+      for( size_t i=0; i<rings.size(); ++i )  {
+        if ( fronts[i] && fronts[i]->sequence <= limit &&
+             (idx == rings.size() || fronts[i]->sequence < fronts[idx]->sequence) )
+          idx = i;
+      }
+      if ( idx == rings.size() ) break;
+      PrintRing* r = rings[idx];
+      const PrintRing::Record* rec = fronts[idx];
+      const char* data = (const char*)(rec+1);
+      string src(data, rec->src_len), text(data+rec->src_len, rec->text_len);
+      if ( rec->level == r->last_level && src == r->last_src && text == r->last_text )  {
+        ++r->repeated;
+        batch.push_back({r, rec->sequence, rec->level, false, string(), string()});
+      }
+      else  {
+        queue_repeated(r, batch);
+        r->last_level = rec->level;
+        r->last_src   = src;
+        r->last_text  = text;
+        batch.push_back({r, rec->sequence, rec->level, true, move(src), move(text)});
+      }
+      r->pop(rec);
+      fronts[idx] = r->front();
+      ++count;
+    }
+    for( auto i=rings.begin(); i != rings.end(); )  {
+      PrintRing* r = *i;
+      queue_repeated(r, batch);
+      queue_dropped(r, batch);
+      if ( r->closed && !r->front() )  {
+        i = rings.erase(i);
+        finished.push_back(r);
+        continue;
+      }
+      ++i;
+    }
+    guard.unlock();
+    for( const Message& m : batch )  {
+      if ( m.print ) write(m.level, m.src.c_str(), m.text.c_str());
+      if ( m.ring ) m.ring->written.store(m.sequence, memory_order_release);
+    }
+    for( PrintRing* r : finished ) delete r;
+    ::fflush(stdout);
+    ++passes;
+    return count;
+  }
+
+  void AsyncPrinter::run()   {
+    print_ring_consumer = true;
+    while ( running )  {
+      if ( 0 == drain() )
+        this_thread::sleep_for(chrono::microseconds(500));
+    }
+    drain();
+  }
+
+  /// Output function of the asynchronous printer
+  size_t _the_async_printer(void* par, dd4hep::PrintLevel lvl, const char* src, const char* fmt, va_list& args) {
+    thread_local char text[4096];
+    if ( !async_printer.running )   {
+      return _the_printer_2(par, lvl, src, fmt, args);
+    }
+    PrintRing* r = async_printer.ring();
+    if ( lvl < dd4hep::ERROR && async_printer.max_rate > 0 )  {
+      int64_t now = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now().time_since_epoch()).count();
+      if ( now != r->window )  {
+        r->window = now;
+        r->in_window = 0;
+      }
+      if ( ++r->in_window > async_printer.max_rate )  {
+        ++r->dropped;
+        return 0;
+      }
+    }
+    int len = ::vsnprintf(text, sizeof(text), fmt, args);
+    if ( len < 0 ) return 0;
+    if ( size_t(len) >= sizeof(text) ) len = sizeof(text)-1;
+    uint64_t seq = ++async_printer.sequence;
+    while ( !r->push(lvl, src, text, len, seq) )  {
+      if ( lvl < dd4hep::ERROR || !async_printer.running || print_ring_consumer )  {
+        ++r->dropped;
+        return 0;
+      }
+      this_thread::yield();
+    }
+    // Errors must be visible before e.g. an exception terminates the process.
+    // The output function may print from the background thread: it cannot wait for itself.
+    if ( lvl >= dd4hep::ERROR && !print_ring_consumer )   {
+      while ( async_printer.running && r->written.load(memory_order_acquire) < seq )
+        this_thread::yield();
+    }
+    return len;
+  }
+
+  /// Fork handlers: the background thread is not duplicated into the child process
+  void async_printer_prepare()   {
+    async_printer.lock.lock();
+  }
+  void async_printer_parent()   {
+    async_printer.lock.unlock();
+  }
+  void async_printer_child()   {
+    async_printer.lock.unlock();
+    if ( async_printer.running )  {
+      // The child prints synchronously. The thread object refers to the parent's thread
+      // and may neither be joined nor destroyed.
+      if ( print_func_2 == _the_async_printer ) print_func_2 = async_printer.previous;
+      async_printer.running = false;
+      async_printer.worker.release();
+    }
+  }
+  once_flag async_printer_atfork;
+
+  void AsyncPrinter::start(size_t size, size_t rate)   {
+    call_once(async_printer_atfork, []() {
+        ::pthread_atfork(async_printer_prepare, async_printer_parent, async_printer_child);
+      });
+    if ( !running )  {
+      ring_size = size;
+      max_rate  = rate;
+      previous  = print_func_2;
+      running   = true;
+      worker.reset(new thread([this]() { this->run(); }));
+      print_func_2 = _the_async_printer;
+    }
+  }
+
+  void AsyncPrinter::stop()   {
+    if ( running )  {
+      if ( print_func_2 == _the_async_printer ) print_func_2 = previous;
+      running = false;
+      worker->join();
+      worker.reset();
+    }
+  }
 }
 
 /// Helper function to serialize argument list to a single string
@@ -411,3 +751,21 @@ void dd4hep::setPrinter2(void* arg, output_function2_t fcn) {
   print_arg = arg;
   print_func_2 = fcn ? fcn : _the_printer_2;
 }
+
+/// Enable or disable the asynchronous printer
+void dd4hep::setAsyncPrinter(bool enable, size_t buffer_size, size_t max_rate)   {
+  if ( enable )
+    async_printer.start(buffer_size, max_rate);
+  else
+    async_printer.stop();
+}
+
+/// Wait until all messages issued so far by the asynchronous printer are written
+void dd4hep::flushPrinter()   {
+  // Called by the output function: the background thread cannot wait for itself
+  if ( print_ring_consumer ) return;
+  // The second pass of the background thread starts after this call
+  uint64_t pass = async_printer.passes.load() + 2;
+  while ( async_printer.running && async_printer.passes.load() < pass )
+    this_thread::yield();
+}
@@ -97,9 +97,9 @@ void SurfaceInstaller::install(DetElement component, PlacedVolume pv)   {
       PlacedVolume placed = *i;
       log << (void*)(placed->GetMatrix()) << " ";
       if ( placed->GetUserExtension() )  {
-        const PlacedVolume::VolIDs& vid = placed.volIDs();
-        for(PlacedVolume::VolIDs::const_iterator j=vid.begin(); j!=vid.end(); ++j)  {
-          log << (*j).first << ":" << (*j).second << " ";
+        const PlacedVolume::VolIDCodes& vid = placed.volIDCodes();
+        for(PlacedVolume::VolIDCodes::const_iterator j=vid.begin(); j!=vid.end(); ++j)  {
+          log << PlacedVolumeExtension::fieldName((*j).first) << ":" << (*j).second << " ";
         }
       }
       log << " ";
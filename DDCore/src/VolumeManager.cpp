@@ -20,6 +20,9 @@
 #include "DD4hep/detail/DetectorInterna.h"
 #include "DD4hep/detail/VolumeManagerInterna.h"
 
+// ROOT include files
+#include "TTimeStamp.h"
+
 // C/C++ includes
 #include <set>
 #include <cmath>
@@ -166,7 +169,7 @@ namespace dd4hep {
      *  \version 1.0
      */
     class VolumeManager_Populator {
-      typedef PlacedVolume::VolIDs VolIDs;
+      typedef PlacedVolume::VolIDCodes VolIDCodes;
       typedef vector<TGeoNode*> Chain;
       typedef pair<VolumeID, VolumeID> Encoding;
       /// Reference to the Detector instance
@@ -224,7 +227,7 @@ namespace dd4hep {
         size_t count = 0;
         if (node) {
           Volume vol = pv.volume();
-          const VolIDs& pv_ids   = pv.volIDs();
+          const VolIDCodes& pv_ids   = pv.volIDCodes();
           Encoding vol_encoding  = parent_encoding;
           bool     is_sensitive  = vol.isSensitive();
           bool     have_encoding = pv_ids.empty();
@@ -321,7 +324,7 @@ namespace dd4hep {
                          e.path().c_str(), e.volumeID(), id.str(vol_encoding.first,vol_encoding.second).c_str());
                 printout(INFO, "VolumeManager", "%s SD:%s VolIDs:%s id:%016llx mask:%016llx",
                          node == e.placement().ptr() ? "DETELEMENT PLACEMENT" : "VOLUME PLACEMENT    ",
-                         sd.name(), pv_ids.str().c_str(), vol_encoding.first, vol_encoding.second);
+                         sd.name(), pv.volIDs().str().c_str(), vol_encoding.first, vol_encoding.second);
               }
             }
           }
@@ -330,12 +333,17 @@ namespace dd4hep {
         return count;
       }
 
+      /// Access the field of an interned volume ID field name
+      static const BitFieldValue* field(const IDDescriptor& iddesc, unsigned short index)  {
+        const BitFieldValue* f = iddesc.volIDField(index);
+        return f ? f : iddesc.field(PlacedVolumeExtension::fieldName(index)); // Throws exception
+      }
       /// Compute the encoding for a set of VolIDs within a readout descriptor
-      static Encoding update_encoding(const IDDescriptor iddesc, const VolIDs& ids, const Encoding& initial)  {
+      static Encoding update_encoding(const IDDescriptor iddesc, const VolIDCodes& ids, const Encoding& initial)  {
         VolumeID volume_id = initial.first, mask = initial.second;
-        for (VolIDs::const_iterator i = ids.begin(); i != ids.end(); ++i) {
+        for (VolIDCodes::const_iterator i = ids.begin(); i != ids.end(); ++i) {
           const auto& id = (*i);
-          const BitFieldValue* f = iddesc.field(id.first);
+          const BitFieldValue* f = field(iddesc, id.first);
           VolumeID msk = f->mask();
           int      off = f->offset();
           VolumeID val = id.second;    // Necessary to extend volume IDs > 32 bit
@@ -345,11 +353,11 @@ namespace dd4hep {
         return make_pair(volume_id, mask);
       }
       /// Compute the encoding for a set of VolIDs within a readout descriptor
-      static Encoding encoding(const IDDescriptor iddesc, const VolIDs& ids)  {
+      static Encoding encoding(const IDDescriptor iddesc, const VolIDCodes& ids)  {
         VolumeID volume_id = 0, mask = 0;
-        for (VolIDs::const_iterator i = ids.begin(); i != ids.end(); ++i) {
+        for (VolIDCodes::const_iterator i = ids.begin(); i != ids.end(); ++i) {
           const auto& id = (*i);
-          const BitFieldValue* f = iddesc.field(id.first);
+          const BitFieldValue* f = field(iddesc, id.first);
           VolumeID msk = f->mask();
           int      off = f->offset();
           VolumeID val = id.second;    // Necessary to extend volume IDs > 32 bit
@@ -448,6 +456,7 @@ const TGeoHMatrix& VolumeManagerContext::toElement()  const   {
 /// Initializing constructor to create a new object
 VolumeManager::VolumeManager(Detector& description, const string& nam, DetElement elt, Readout ro, int flags) {
   printout(INFO, "VolumeManager", " - populating volume ids - be patient ..."  );
+  TTimeStamp start;
   size_t node_count = 0;
   Object* obj_ptr = new Object();
   assign(obj_ptr, nam, "VolumeManager");
@@ -460,7 +469,9 @@ VolumeManager::VolumeManager(Detector& description, const string& nam, DetElemen
     p.populate(elt);
     node_count = p.numNodes();
   }
-  printout(INFO, "VolumeManager", " - populating volume ids - done. %ld nodes.",node_count);
+  TTimeStamp stop;
+  printout(INFO, "VolumeManager", " - populating volume ids - done. %ld nodes in %.3f seconds.",
+           node_count, stop.AsDouble()-start.AsDouble());
 }
 
 /// Initializing constructor to create a new object
@@ -499,8 +510,10 @@ VolumeManager VolumeManager::addSubdetector(DetElement det, Readout ro) {
         throw runtime_error("dd4hep: VolumeManager::addSubdetector: Only subdetectors with a "
                             "valid placement are allowed. [Invalid DetElement:" + det_name + "]");
       }
-      auto vit = pv.volIDs().find("system");
-      if (vit == pv.volIDs().end()) {
+      PlacedVolume::VolIDs ids;
+      ids.append(pv.volIDCodes());
+      auto vit = ids.find("system");
+      if (vit == ids.end()) {
         throw runtime_error("dd4hep: VolumeManager::addSubdetector: Only subdetectors with "
                             "valid placement VolIDs are allowed. [Invalid DetElement:" + det_name + "]");
       }
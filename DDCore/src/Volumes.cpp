@@ -28,10 +28,14 @@
 
 #include "TGeoVoxelFinder.h"
 #include "TGeoShapeAssembly.h"
+#include "TBuffer.h"
 
 // C/C++ include files
 #include <climits>
 #include <iostream>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
 #include <stdexcept>
 #include <sstream>
 
@@ -303,24 +307,148 @@ static TGeoVolume* _createTGeoVolumeAssembly(const string& name)  {
   return e;
 }
 
+namespace {
+  /// Process wide table of the interned volume ID field names
+  struct VolIDFieldNames  {
+    /// Lock protecting the table
+    mutex lock;
+    /// Field names by index. The deque keeps references valid
+    deque<string> names;
+    /// Field indices by name
+    unordered_map<string, unsigned short> indices;
+  };
+  VolIDFieldNames& _fieldNames()  {
+    static VolIDFieldNames s_names;
+    return s_names;
+  }
+}
+
+/// Total number of copies
+size_t PlacedVolumeExtension::Parameterisation::count()  const   {
+  size_t n = 1;
+  for( const auto& d : dimensions ) n *= d.count;
+  return n;
+}
+
+/// Index of a copy within one dimension
+size_t PlacedVolumeExtension::Parameterisation::index(size_t copy, size_t dim)  const   {
+  for( size_t i = 0; i < dim; ++i ) copy /= dimensions[i].count;
+  return copy % dimensions[dim].count;
+}
+
 /// Default constructor
 PlacedVolumeExtension::PlacedVolumeExtension()
-  : TGeoExtension(), magic(0), refCount(0), volIDs() {
+  : TGeoExtension(), magic(0), refCount(0), codes(), view(0), params(0) {
   magic = magic_word();
   INCREMENT_COUNTER;
 }
 
 /// Copy constructor
 PlacedVolumeExtension::PlacedVolumeExtension(const PlacedVolumeExtension& c)
-  : TGeoExtension(), magic(c.magic), refCount(0), volIDs(c.volIDs) {
+  : TGeoExtension(), magic(c.magic), refCount(0), codes(c.codes), view(0), params(c.params) {
+  if ( params ) ++params->refCount;
   INCREMENT_COUNTER;
 }
 
 /// Default destructor
 PlacedVolumeExtension::~PlacedVolumeExtension() {
+  delete view.load();
+  if ( params && 0 == --params->refCount ) delete params;
   DECREMENT_COUNTER;
 }
 
+/// Assignment operator
+PlacedVolumeExtension& PlacedVolumeExtension::operator=(const PlacedVolumeExtension& c)   {
+  if ( this != &c )  {
+    magic = c.magic;
+    codes = c.codes;
+    delete view.exchange(0);
+    if ( c.params ) ++c.params->refCount;
+    if ( params && 0 == --params->refCount ) delete params;
+    params = c.params;
+  }
+  return *this;
+}
+
+/// Add identifier
+void PlacedVolumeExtension::addID(const string& name, int value)   {
+  codes.push_back(make_pair(fieldIndex(name), value));
+  VolIDs* v = view.load();
+  if ( v ) v->Base::push_back(make_pair(fieldName(codes.back().first), value));
+}
+
+/// Access the IDs with field names. The container is created on first access
+const PlacedVolumeExtension::VolIDs& PlacedVolumeExtension::ids()  const   {
+  VolIDs* v = view.load(memory_order_acquire);
+  if ( !v )  {
+    VolIDs* expected = 0;
+    v = new VolIDs();
+    v->append(codes);
+    if ( !view.compare_exchange_strong(expected, v, memory_order_acq_rel) )  {
+      delete v;
+      v = expected;
+    }
+  }
+  return *v;
+}
+
+/// Intern a volume ID field name: the index is unique within the process
+unsigned short PlacedVolumeExtension::fieldIndex(const string& name)   {
+  VolIDFieldNames& t = _fieldNames();
+  lock_guard<mutex> guard(t.lock);
+  auto i = t.indices.find(name);
+  if ( i != t.indices.end() )
+    return i->second;
+  if ( t.names.size() > USHRT_MAX )
+    except("PlacedVolume","dd4hep: Too many different volume ID field names. Cannot add: %s",name.c_str());
+  t.names.push_back(name);
+  return t.indices[name] = (unsigned short)(t.names.size()-1);
+}
+
+/// Access the name of an interned volume ID field
+const string& PlacedVolumeExtension::fieldName(unsigned short index)   {
+  VolIDFieldNames& t = _fieldNames();
+  lock_guard<mutex> guard(t.lock);
+  if ( index >= t.names.size() )
+    except("PlacedVolume","dd4hep: Invalid volume ID field index: %d",int(index));
+  return t.names[index];
+}
+
+/// ROOT persistency: the IDs are streamed with their field names like in version 1
+void PlacedVolumeExtension::Streamer(TBuffer& buff)   {
+  if ( buff.IsReading() )  {
+    UInt_t start = 0, count = 0;
+    VolIDs volids;
+    buff.ReadVersion(&start, &count);
+#ifdef DD4HEP_EMULATE_TGEOEXTENSIONS
+    TObject::Streamer(buff);
+#else
+    TGeoExtension::Streamer(buff);
+#endif
+    buff >> magic;
+    buff >> refCount;
+    buff.StreamObject(&volids, typeid(VolIDs));
+    codes.clear();
+    for( const auto& i : volids )
+      codes.push_back(make_pair(fieldIndex(i.first), i.second));
+    delete view.exchange(0);
+    buff.CheckByteCount(start, count, PlacedVolumeExtension::Class());
+    return;
+  }
+  UInt_t pos = buff.WriteVersion(PlacedVolumeExtension::Class(), kTRUE);
+#ifdef DD4HEP_EMULATE_TGEOEXTENSIONS
+  TObject::Streamer(buff);
+#else
+  TGeoExtension::Streamer(buff);
+#endif
+  buff << magic;
+  buff << refCount;
+  VolIDs volids;
+  volids.append(codes);
+  buff.StreamObject(&volids, typeid(VolIDs));
+  buff.SetByteCount(pos, kTRUE);
+}
+
 /// TGeoExtension overload: Method called whenever requiring a pointer to the extension
 TGeoExtension* PlacedVolumeExtension::Grab()   {
   ++this->refCount;
@@ -361,6 +489,13 @@ PlacedVolumeExtension::VolIDs::insert(const string& name, int value) {
   return make_pair(i, true);
 }
 
+/// Append compact IDs with their field names (no copy of the placement's view is kept)
+void PlacedVolumeExtension::VolIDs::append(const VolIDCodes& ids)   {
+  this->Base::reserve(this->Base::size()+ids.size());
+  for( const auto& c : ids )
+    this->Base::push_back(make_pair(fieldName(c.first), c.second));
+}
+
 /// String representation for debugging
 string PlacedVolumeExtension::VolIDs::str()  const   {
   stringstream str;
@@ -386,11 +521,15 @@ PlacedVolume::Object* PlacedVolume::data() const   {
 
 /// Add identifier
 PlacedVolume& PlacedVolume::addPhysVolID(const string& nam, int value) {
-  Object* obj = _data(*this);
-  obj->volIDs.push_back(make_pair(nam, value));
+  _data(*this)->addID(nam, value);
   return *this;
 }
 
+/// Access the parameters if the placement is a copy of a replicated placement (0 otherwise)
+const PlacedVolumeExtension::Parameterisation* PlacedVolume::parameterisation() const {
+  return _data(*this)->params;
+}
+
 /// Volume material
 Material PlacedVolume::material() const {
   return Material(m_element ? m_element->GetMedium() : 0);
@@ -408,7 +547,12 @@ Volume PlacedVolume::motherVol() const {
 
 /// Access to the volume IDs
 const PlacedVolume::VolIDs& PlacedVolume::volIDs() const {
-  return _data(*this)->volIDs;
+  return _data(*this)->ids();
+}
+
+/// Access to the volume IDs with interned field names
+const PlacedVolume::VolIDCodes& PlacedVolume::volIDCodes() const {
+  return _data(*this)->codes;
 }
 
 /// String dump
@@ -416,9 +560,9 @@ string PlacedVolume::toString() const {
   stringstream s;
   Object* obj = _data(*this);
   s << m_element->GetName() << ":  vol='" << m_element->GetVolume()->GetName() << "' mat:'" << m_element->GetMatrix()->GetName()
-    << "' volID[" << obj->volIDs.size() << "] ";
-  for (VolIDs::const_iterator i = obj->volIDs.begin(); i != obj->volIDs.end(); ++i)
-    s << (*i).first << "=" << (*i).second << "  ";
+    << "' volID[" << obj->codes.size() << "] ";
+  for (const auto& i : obj->codes )
+    s << PlacedVolumeExtension::fieldName(i.first) << "=" << i.second << "  ";
   s << ends;
   return s.str();
 }
@@ -551,6 +695,88 @@ PlacedVolume Volume::placeVolume(const Volume& volume, const Rotation3D& rot) co
   return _addNode(m_element, volume, detail::matrix::_rotation3D(rot));
 }
 
+/// Replicate a daughter volume according to the parameters. Returns the first copy
+PlacedVolume Volume::replicate(const Volume& volume, const PlacedVolumeExtension::Parameterisation& params) const  {
+  typedef PlacedVolumeExtension::Parameterisation Parameterisation;
+  const Parameterisation::Dimension unit;
+  const auto& dims = params.dimensions;
+  if ( dims.empty() || dims.size() > 3 )
+    except("Volume","dd4hep: %s: Replicated placements need 1 to 3 dimensions (got %ld).",
+           name(), long(dims.size()));
+  for( const auto& d : dims )  {
+    if ( d.count == 0 )
+      except("Volume","dd4hep: %s: Replicated placements need at least one copy per dimension.",name());
+  }
+  const Parameterisation::Dimension& d0 = dims[0];
+  const Parameterisation::Dimension& d1 = dims.size() > 1 ? dims[1] : unit;
+  const Parameterisation::Dimension& d2 = dims.size() > 2 ? dims[2] : unit;
+  Parameterisation* p = new Parameterisation(params);
+  PlacedVolume first;
+  p->refCount = 0;
+  p->first = m_element->GetNdaughters();
+  Transform3D t2 = params.start;
+  for( size_t k = 0; k < d2.count; ++k )  {
+    Transform3D t1 = t2;
+    for( size_t j = 0; j < d1.count; ++j )  {
+      Transform3D t0 = t1;
+      for( size_t i = 0; i < d0.count; ++i )  {
+        PlacedVolume pv = placeVolume(volume, t0);
+        PlacedVolume::Object* obj = _data(pv);
+        if ( !d0.field.empty() ) obj->addID(d0.field, int(i));
+        if ( !d1.field.empty() ) obj->addID(d1.field, int(j));
+        if ( !d2.field.empty() ) obj->addID(d2.field, int(k));
+        obj->params = p;
+        ++p->refCount;
+        if ( !first.isValid() ) first = pv;
+        t0 = d0.increment * t0;
+      }
+      t1 = d1.increment * t1;
+    }
+    t2 = d2.increment * t2;
+  }
+  return first;
+}
+
+/// Replicate a daughter volume along a line: each copy is the previous one transformed by inc
+PlacedVolume Volume::replicate(const Volume& volume, const Transform3D& start, size_t count,
+                               const Transform3D& inc, const string& field) const  {
+  PlacedVolumeExtension::Parameterisation params;
+  params.start = start;
+  params.dimensions.resize(1);
+  params.dimensions[0].increment = inc;
+  params.dimensions[0].count = count;
+  params.dimensions[0].field = field;
+  return replicate(volume, params);
+}
+
+/// Replicate a daughter volume in phi: each copy is the previous one rotated by dphi around the z-axis
+PlacedVolume Volume::replicatePhi(const Volume& volume, const Transform3D& start, size_t count,
+                                  double dphi, const string& field) const  {
+  return replicate(volume, start, count, Transform3D(RotationZ(dphi)), field);
+}
+
+/// Replicate a daughter volume on a regular 2D or 3D grid
+PlacedVolume Volume::replicateGrid(const Volume& volume, const Transform3D& start,
+                                   size_t count1, const Position& inc1, const string& field1,
+                                   size_t count2, const Position& inc2, const string& field2,
+                                   size_t count3, const Position& inc3, const string& field3) const  {
+  PlacedVolumeExtension::Parameterisation params;
+  params.start = start;
+  params.dimensions.resize(count3 > 1 ? 3 : 2);
+  params.dimensions[0].increment = Transform3D(inc1);
+  params.dimensions[0].count = count1;
+  params.dimensions[0].field = field1;
+  params.dimensions[1].increment = Transform3D(inc2);
+  params.dimensions[1].count = count2;
+  params.dimensions[1].field = field2;
+  if ( count3 > 1 )  {
+    params.dimensions[2].increment = Transform3D(inc3);
+    params.dimensions[2].count = count3;
+    params.dimensions[2].field = field3;
+  }
+  return replicate(volume, params);
+}
+
 /// Set the volume's material
 const Volume& Volume::setMaterial(const Material& m) const {
   if (m.isValid()) {
@@ -19,3 +19,8 @@
 dd4hep::Detector& dd4hep::World::detectorDescription() const   {
   return *(access()->description);
 }
+
+/// Access the hash indexed registry of all detector elements (0 before the geometry is closed)
+dd4hep::DetElementRegistry* dd4hep::World::elementRegistry() const   {
+  return access()->registry;
+}
@@ -378,6 +378,152 @@ int DocumentHandler::output(Document doc, const string& fname) const {
   return 1;
 }
 
+#elif defined(DD4HEP_USE_FASTXML)
+
+#include "XML/FastXML.h"
+#include <fstream>
+#include <cstring>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+  /// Namespace containing utilities to parse XML files using XercesC or TinyXML
+  namespace xml {
+
+    /// XML-DOM ERror handler class for the in-situ document parser (Compatibility class)
+    class DocumentErrorHandler {};
+
+    union Xml {
+      Xml(void* ptr) : p(ptr) {}
+      Xml(const void* ptr) : cp(ptr) {}
+      void* p;
+      const void* cp;
+      fast::Node* e;
+      XmlElement* xe;
+      fast::Attr* a;
+      Attribute attr;
+      fast::Node* n;
+      fast::Document* d;
+      XmlDocument* xd;
+    };
+  }}
+
+namespace {
+  static string _clean_fname(const string& s) {
+    std::string const& temp = getEnviron(s);
+    std::string temp2 = temp.empty() ? s : temp;
+    if ( strncmp(temp2.c_str(),"file:",5)==0 ) return temp2.substr(5);
+    return temp2;
+  }
+}
+
+/// System ID of a given XML entity
+string DocumentHandler::system_path(Handle_t base, const string& fname)   {
+  string fn, clean = _clean_fname(fname);
+  struct stat st;
+  Element elt(base);
+  // Poor man's URI handling. Xerces is much much better here
+  if ( elt ) {
+    string bn = Xml(elt.document()).d->getDocumentURI();
+    fn = ::dirname((char*)bn.c_str());
+    fn += "/";
+    fn += clean;
+  }
+  if ( ::stat(fn.c_str(),&st)==0 )
+    return fn;
+  else if ( ::stat(clean.c_str(),&st)==0 )
+    return clean;
+  return fname;
+}
+
+/// System ID of a given XML entity
+string DocumentHandler::system_path(Handle_t base)   {
+  string fn;
+  Element elt(base);
+  // Poor man's URI handling. Xerces is much much better here
+  if ( elt ) {
+    fn = Xml(elt.document()).d->getDocumentURI();
+  }
+  return fn;
+}
+
+/// Load XML file and parse it using URI resolver to read data.
+Document DocumentHandler::load(const std::string& fname, UriReader* reader) const  {
+  string clean = _clean_fname(fname);
+  if ( reader )   {
+    printout(WARNING,"DocumentHandler","+++ Loading document URI: %s %s",
+             fname.c_str(),"[URI Resolution is not supported by the in-situ parser]");
+  }
+  else  {
+    printout(INFO,"DocumentHandler","+++ Loading document URI: %s [Resolved:'%s']",
+             fname.c_str(),clean.c_str());
+  }
+  fast::Document* doc = new fast::Document(clean);
+  if ( doc->load(clean) )  {
+    printout(INFO,"DocumentHandler","+++ Document %s succesfully parsed with the in-situ parser .....",
+             fname.c_str());
+    return (XmlDocument*)doc;
+  }
+  printout(FATAL,"DocumentHandler","+++ Error (FastXML) parsing XML document:%s [%s]",
+           fname.c_str(), clean.c_str());
+  printout(FATAL,"DocumentHandler","+++ Error (FastXML) XML parsing error:%s",
+           doc->errorMessage().c_str());
+  printout(FATAL,"DocumentHandler","+++ Document:%s Location Line:%d Column:%d",
+           clean.c_str(), doc->errorLine(), doc->errorColumn());
+  delete doc;
+  return 0;
+}
+
+/// Load XML file and parse it using URI resolver to read data.
+Document DocumentHandler::load(Handle_t base, const XmlChar* fname, UriReader* reader) const  {
+  string path = system_path(base, fname);
+  return load(path,reader);
+}
+
+/// Parse a standalong XML string into a document.
+Document DocumentHandler::parse(const char* bytes, size_t length, const char* sys_id, UriReader* reader) const {
+  if ( reader )   {
+    printout(WARNING,"DocumentHandler","+++ Parsing memory document %s",
+             "[URI Resolution is not supported by the in-situ parser]");
+  }
+  fast::Document* doc = new fast::Document(sys_id ? sys_id : "");
+  if ( doc->parse(bytes, length) )  {
+    return (XmlDocument*)doc;
+  }
+  printout(FATAL,"DocumentHandler",
+           "+++ Error (FastXML) while parsing XML string [%s]",
+           doc->errorMessage().c_str());
+  printout(FATAL,"DocumentHandler",
+           "+++ XML Document error: %s Location Line:%d Column:%d",
+           doc->getDocumentURI(), doc->errorLine(), doc->errorColumn());
+  delete doc;
+  return 0;
+}
+
+/// Write xml document to output file (stdout if file name empty)
+int DocumentHandler::output(Document doc, const string& fname) const {
+  if ( fname.empty() )  {
+    Xml(doc.ptr()).d->print(cout);
+    return 1;
+  }
+  ofstream out(fname);
+  if ( !out.is_open() ) {
+    printout(ERROR,"DocumentHandler","+++ Failed to open output file: %s",fname.c_str());
+    return 0;
+  }
+  Xml(doc.ptr()).d->print(out);
+  return 1;
+}
+
+/// Dump partial or full XML trees
+void dd4hep::xml::dump_tree(Handle_t elt, ostream& os) {
+  Xml(elt.ptr()).n->print(os);
+}
+
+/// Dump partial or full XML documents
+void dd4hep::xml::dump_tree(Document doc, ostream& os) {
+  Xml(doc.ptr()).d->print(os);
+}
+
 #else
 
 #include "XML/tinyxml.h"
@@ -0,0 +1,617 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework include files
+#include "XML/FastXML.h"
+
+// C/C++ include files
+#include <new>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace dd4hep::xml::fast;
+
+namespace {
+
+  /// Size of one arena block
+  const size_t BLOCK_SIZE = 64*1024;
+
+  inline bool is_space(char c)   {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  inline bool is_name_char(char c)   {
+    return !(c == 0 || is_space(c) || c == '/' || c == '>' || c == '<' ||
+             c == '=' || c == '?' || c == '"' || c == '\'');
+  }
+
+  inline bool any_tag(const char* tag)   {
+    return !tag || (tag[0] == '*' && tag[1] == 0);
+  }
+
+  /// Write the UTF-8 representation of a code point. Returns the new write position
+  char* utf8(char* w, unsigned long cp)   {
+    if ( cp < 0x80 )   {
+      *w++ = char(cp);
+    }
+    else if ( cp < 0x800 )   {
+      *w++ = char(0xC0 | (cp >> 6));
+      *w++ = char(0x80 | (cp & 0x3F));
+    }
+    else if ( cp < 0x10000 )   {
+      *w++ = char(0xE0 | (cp >> 12));
+      *w++ = char(0x80 | ((cp >> 6) & 0x3F));
+      *w++ = char(0x80 | (cp & 0x3F));
+    }
+    else   {
+      *w++ = char(0xF0 | (cp >> 18));
+      *w++ = char(0x80 | ((cp >> 12) & 0x3F));
+      *w++ = char(0x80 | ((cp >> 6) & 0x3F));
+      *w++ = char(0x80 | (cp & 0x3F));
+    }
+    return w;
+  }
+
+  /// Print string with XML escapes
+  void escape(ostream& os, const char* s)   {
+    for( ; s && *s; ++s )   {
+      switch(*s)   {
+      case '&':  os << "&amp;";  break;
+      case '<':  os << "&lt;";   break;
+      case '>':  os << "&gt;";   break;
+      case '"':  os << "&quot;"; break;
+      default:   os << *s;       break;
+      }
+    }
+  }
+
+  /// In-situ parser of a document buffer
+  /**
+   *  All strings are null-terminated inside the buffer. A terminator
+   *  only overwrites characters, which were already consumed.
+   */
+  class Parser   {
+  public:
+    Document*   doc;
+    char*       p;
+    char*       end;
+    const char* error = 0;
+    char*       where = 0;
+
+    Parser(Document* d, char* b, char* e) : doc(d), p(b), end(e)  {}
+
+    bool fail(const char* msg, char* pos)   {
+      error = msg;
+      where = pos;
+      return false;
+    }
+    void skip_space()   {
+      while ( p < end && is_space(*p) ) ++p;
+    }
+    char* find(char* s, const char* pattern)   {
+      size_t len = ::strlen(pattern);
+      while ( s+len <= end )   {
+        char* c = (char*)::memchr(s, pattern[0], end-s-len+1);
+        if ( !c ) return 0;
+        if ( 0 == ::memcmp(c, pattern, len) ) return c;
+        s = c+1;
+      }
+      return 0;
+    }
+    void link(Node* parent, Node* n)   {
+      n->parent = parent;
+      n->prev   = parent->last;
+      if ( parent->last ) parent->last->next = n;
+      else parent->first = n;
+      parent->last = n;
+    }
+    /// Decode entities (and optionally condense white space) in place. Returns the new end
+    char* decode(char* s, char* e, bool condense);
+    /// Parse element content until the end tag of the parent (or the end of the document)
+    bool content(Node* parent);
+    /// Parse element. p points to the first character of the name
+    bool element(Node* parent);
+    /// Parse markup starting with '<!'. p points to '!'
+    bool declaration(Node* parent);
+  };
+
+  char* Parser::decode(char* s, char* e, bool condense)   {
+    char* w = s;
+    bool space = false;
+    for( char* r = s; r < e; )   {
+      char c = *r;
+      if ( condense && is_space(c) )   {
+        space = (w != s);
+        ++r;
+        continue;
+      }
+      if ( space )   {
+        *w++ = ' ';
+        space = false;
+      }
+      if ( c == '&' )   {
+        char* semi = (char*)::memchr(r, ';', std::min(e-r, ptrdiff_t(12)));
+        if ( semi )   {
+          size_t len = semi-r-1;
+          const char* ent = r+1;
+          if      ( len == 2 && 0 == ::strncmp(ent,"lt",2)   ) { *w++ = '<';  r = semi+1; continue; }
+          else if ( len == 2 && 0 == ::strncmp(ent,"gt",2)   ) { *w++ = '>';  r = semi+1; continue; }
+          else if ( len == 3 && 0 == ::strncmp(ent,"amp",3)  ) { *w++ = '&';  r = semi+1; continue; }
+          else if ( len == 4 && 0 == ::strncmp(ent,"quot",4) ) { *w++ = '"';  r = semi+1; continue; }
+          else if ( len == 4 && 0 == ::strncmp(ent,"apos",4) ) { *w++ = '\''; r = semi+1; continue; }
+          else if ( len > 1 && ent[0] == '#' )   {
+            char* last = 0;
+            bool  hex  = ent[1] == 'x' || ent[1] == 'X';
+            unsigned long cp = ::strtoul(ent + (hex ? 2 : 1), &last, hex ? 16 : 10);
+            if ( last == semi && cp > 0 && cp <= 0x10FFFF )   {
+              w = utf8(w, cp);
+              r = semi+1;
+              continue;
+            }
+          }
+        }
+      }
+      *w++ = *r++;
+    }
+    return w;
+  }
+
+  bool Parser::content(Node* parent)   {
+    bool is_element = parent->type == Node::ELEMENT_NODE;
+    while ( p < end )   {
+      char* text = p;
+      char* lt = (char*)::memchr(p, '<', end-p);
+      if ( !lt ) lt = end;
+      if ( is_element && lt > text )   {
+        char* e = decode(text, lt, true);
+        if ( e > text )   {
+          if ( e == end ) return fail("Unterminated element", text);
+          *e = 0;      // May overwrite the '<', which is consumed here
+          link(parent, new(doc->allocate(sizeof(Node))) Node(Node::TEXT_NODE, doc, text));
+        }
+      }
+      if ( lt == end )   {
+        return is_element ? fail("Unterminated element", text) : true;
+      }
+      p = lt+1;
+      if ( p >= end ) return fail("Unterminated markup", lt);
+      if ( *p == '/' )   {
+        char* name = ++p;
+        while ( p < end && is_name_char(*p) ) ++p;
+        size_t len = p-name;
+        if ( !is_element )
+          return fail("Unexpected end tag", lt);
+        else if ( 0 != ::strncmp(parent->value, name, len) || parent->value[len] != 0 )
+          return fail("End tag does not match the element", lt);
+        skip_space();
+        if ( p >= end || *p != '>' ) return fail("Expected '>'", p);
+        ++p;
+        return true;
+      }
+      else if ( *p == '!' )   {
+        if ( !declaration(parent) ) return false;
+      }
+      else if ( *p == '?' )   {
+        char* val = p+1;
+        char* e = find(val, "?>");
+        if ( !e ) return fail("Unterminated processing instruction", lt);
+        *e = 0;
+        link(parent, new(doc->allocate(sizeof(Node))) Node(Node::PROCESSING_INSTRUCTION_NODE, doc, val));
+        p = e+2;
+      }
+      else if ( !element(parent) )   {
+        return false;
+      }
+    }
+    return is_element ? fail("Unterminated element", end) : true;
+  }
+
+  bool Parser::declaration(Node* parent)   {
+    char* start = p-1;
+    if ( end-p > 3 && 0 == ::strncmp(p, "!--", 3) )   {
+      char* val = p+3;
+      char* e = find(val, "-->");
+      if ( !e ) return fail("Unterminated comment", start);
+      *e = 0;
+      link(parent, new(doc->allocate(sizeof(Node))) Node(Node::COMMENT_NODE, doc, val));
+      p = e+3;
+      return true;
+    }
+    else if ( end-p > 8 && 0 == ::strncmp(p, "![CDATA[", 8) )   {
+      char* val = p+8;
+      char* e = find(val, "]]>");
+      if ( !e ) return fail("Unterminated CDATA section", start);
+      *e = 0;
+      if ( parent->type == Node::ELEMENT_NODE )
+        link(parent, new(doc->allocate(sizeof(Node))) Node(Node::CDATA_SECTION_NODE, doc, val));
+      p = e+3;
+      return true;
+    }
+    // DOCTYPE and friends: skip including an internal subset
+    int depth = 0;
+    for( ++p; p < end; ++p )   {
+      if ( *p == '[' ) ++depth;
+      else if ( *p == ']' ) --depth;
+      else if ( *p == '>' && depth <= 0 )  {
+        ++p;
+        return true;
+      }
+    }
+    return fail("Unterminated declaration", start);
+  }
+
+  bool Parser::element(Node* parent)   {
+    char* name = p;
+    while ( p < end && is_name_char(*p) ) ++p;
+    if ( p == name ) return fail("Invalid element name", name);
+    if ( p >= end  ) return fail("Unterminated element", name);
+    Node* elt = new(doc->allocate(sizeof(Node))) Node(Node::ELEMENT_NODE, doc, name);
+    Attr* last = 0;
+    link(parent, elt);
+    char c = *p;
+    *p++ = 0;
+    for(;;)   {
+      while ( is_space(c) )   {
+        if ( p >= end ) return fail("Unterminated element", name);
+        c = *p++;
+      }
+      if ( c == '>' )   {
+        return content(elt);
+      }
+      else if ( c == '/' )   {
+        if ( p >= end || *p != '>' ) return fail("Expected '>'", p);
+        ++p;
+        return true;
+      }
+      char* attr = p-1;
+      if ( !is_name_char(c) ) return fail("Invalid attribute name", attr);
+      while ( p < end && is_name_char(*p) ) ++p;
+      if ( p >= end ) return fail("Unterminated element", name);
+      c = *p;
+      *p++ = 0;
+      while ( is_space(c) && p < end ) c = *p++;
+      if ( c != '=' ) return fail("Expected '=' after attribute name", attr);
+      skip_space();
+      if ( p >= end || (*p != '"' && *p != '\'') ) return fail("Expected quoted attribute value", attr);
+      char  quote = *p++;
+      char* val   = p;
+      char* e     = (char*)::memchr(p, quote, end-p);
+      if ( !e ) return fail("Unterminated attribute value", attr);
+      *decode(val, e, false) = 0;   // May overwrite the closing quote
+      p = e+1;
+      Attr* a = new(doc->allocate(sizeof(Attr))) Attr();
+      a->name  = attr;
+      a->value = val;
+      if ( last ) last->next = a;
+      else elt->attrs = a;
+      last = a;
+      if ( p >= end ) return fail("Unterminated element", name);
+      c = *p++;
+    }
+  }
+}
+
+/// Access the parent element. The document node is not returned
+Node* Node::getParentNode()  const   {
+  return parent && parent->type == ELEMENT_NODE ? parent : 0;
+}
+
+/// Access the content of the first text child of an element (0 if absent)
+const char* Node::getTextContent()  const   {
+  for( const Node* c = first; c; c = c->next )
+    if ( c->type == TEXT_NODE || c->type == CDATA_SECTION_NODE ) return c->value;
+  return 0;
+}
+
+/// Access attribute by name (0 if absent)
+Attr* Node::getAttributeNode(const char* nam)  const   {
+  for( Attr* a = attrs; a; a = a->next )
+    if ( 0 == ::strcmp(a->name, nam) ) return a;
+  return 0;
+}
+
+/// Access the first child element with a given tag (0 or "*": any tag)
+Node* Node::firstChildElement(const char* tag)  const   {
+  bool any = any_tag(tag);
+  for( Node* c = first; c; c = c->next )
+    if ( c->type == ELEMENT_NODE && (any || 0 == ::strcmp(c->value, tag)) ) return c;
+  return 0;
+}
+
+/// Access the next sibling element with a given tag (0 or "*": any tag)
+Node* Node::nextSiblingElement(const char* tag)  const   {
+  bool any = any_tag(tag);
+  for( Node* c = next; c; c = c->next )
+    if ( c->type == ELEMENT_NODE && (any || 0 == ::strcmp(c->value, tag)) ) return c;
+  return 0;
+}
+
+/// Access the previous sibling element with a given tag (0 or "*": any tag)
+Node* Node::previousSiblingElement(const char* tag)  const   {
+  bool any = any_tag(tag);
+  for( Node* c = prev; c; c = c->prev )
+    if ( c->type == ELEMENT_NODE && (any || 0 == ::strcmp(c->value, tag)) ) return c;
+  return 0;
+}
+
+/// Append a child node. The node is unlinked from its previous parent
+Node* Node::appendChild(Node* child)   {
+  if ( child )   {
+    if ( child->parent ) child->parent->removeChild(child);
+    child->parent = this;
+    child->prev   = last;
+    child->next   = 0;
+    if ( last ) last->next = child;
+    else first = child;
+    last = child;
+  }
+  return child;
+}
+
+/// Unlink a child node. The memory is released with the document
+bool Node::removeChild(Node* child)   {
+  if ( child && child->parent == this )   {
+    if ( child->prev ) child->prev->next = child->next;
+    else first = child->next;
+    if ( child->next ) child->next->prev = child->prev;
+    else last = child->prev;
+    child->parent = child->prev = child->next = 0;
+    return true;
+  }
+  return false;
+}
+
+/// Set the value of the node (the string is copied)
+void Node::setNodeValue(const char* val)   {
+  value = document->copy(val);
+}
+
+/// Set or add an attribute (the strings are copied)
+Attr* Node::setAttribute(const char* nam, const char* val)   {
+  Attr* a = attrs, *prev_attr = 0;
+  for( ; a; prev_attr = a, a = a->next )   {
+    if ( 0 == ::strcmp(a->name, nam) )   {
+      a->value = document->copy(val);
+      return a;
+    }
+  }
+  a = document->createAttribute(nam, val);
+  if ( prev_attr ) prev_attr->next = a;
+  else attrs = a;
+  return a;
+}
+
+/// Deep copy of the node tree into a (possibly different) document
+Node* Node::clone(Document* doc)  const   {
+  if ( type == DOCUMENT_NODE ) return 0;
+  // Strings are never modified in place: the same document may share them
+  bool  share = doc == document;
+  Node* n = new(doc->allocate(sizeof(Node))) Node(type, doc, share ? value : doc->copy(value));
+  Attr* last_attr = 0;
+  for( const Attr* a = attrs; a; a = a->next )   {
+    Attr* c = new(doc->allocate(sizeof(Attr))) Attr();
+    c->name  = share ? a->name  : doc->copy(a->name);
+    c->value = share ? a->value : doc->copy(a->value);
+    if ( last_attr ) last_attr->next = c;
+    else n->attrs = c;
+    last_attr = c;
+  }
+  for( const Node* c = first; c; c = c->next )
+    n->appendChild(c->clone(doc));
+  return n;
+}
+
+/// Print the node tree
+void Node::print(ostream& os, int depth)  const   {
+  string indent(4*depth, ' ');
+  switch(type)   {
+  case DOCUMENT_NODE:
+    for( const Node* c = first; c; c = c->next ) c->print(os, depth);
+    break;
+  case ELEMENT_NODE:
+    os << indent << '<' << value;
+    for( const Attr* a = attrs; a; a = a->next )   {
+      os << ' ' << a->name << "=\"";
+      escape(os, a->value);
+      os << '"';
+    }
+    if ( !first )   {
+      os << " />\n";
+    }
+    else if ( first == last && first->type == TEXT_NODE )   {
+      os << '>';
+      escape(os, first->value);
+      os << "</" << value << ">\n";
+    }
+    else   {
+      os << ">\n";
+      for( const Node* c = first; c; c = c->next ) c->print(os, depth+1);
+      os << indent << "</" << value << ">\n";
+    }
+    break;
+  case TEXT_NODE:
+    os << indent;
+    escape(os, value);
+    os << '\n';
+    break;
+  case CDATA_SECTION_NODE:
+    os << indent << "<![CDATA[" << value << "]]>\n";
+    break;
+  case COMMENT_NODE:
+    os << indent << "<!--" << value << "-->\n";
+    break;
+  case PROCESSING_INSTRUCTION_NODE:
+    os << indent << "<?" << value << "?>\n";
+    break;
+  default:
+    break;
+  }
+}
+
+/// Initializing constructor
+Document::Document(const string& uri)
+  : Node(DOCUMENT_NODE, this, 0), m_uri(uri)
+{
+  value = m_uri.c_str();
+}
+
+/// Default destructor
+Document::~Document()   {
+  release();
+}
+
+/// Release buffer and arena
+void Document::release()   {
+  if ( m_buffer )   {
+    if ( m_mapped ) ::munmap(m_buffer, m_length);
+    else ::free(m_buffer);
+  }
+  for( char* b : m_blocks ) ::free(b);
+  m_blocks.clear();
+  m_buffer = 0;
+  m_length = m_free = m_allocated = 0;
+  m_mapped = false;
+  first = last = 0;
+  attrs = 0;
+}
+
+/// Allocate memory from the document arena
+void* Document::allocate(size_t len)   {
+  len = (len + 7) & ~size_t(7);
+  if ( len > BLOCK_SIZE/4 )   {
+    char* b = (char*)::malloc(len);
+    if ( !b ) throw bad_alloc();
+    // Keep the current block at the end of the list
+    m_blocks.insert(m_blocks.empty() ? m_blocks.end() : m_blocks.end()-1, b);
+    m_allocated += len;
+    return b;
+  }
+  if ( len > m_free )   {
+    char* b = (char*)::malloc(BLOCK_SIZE);
+    if ( !b ) throw bad_alloc();
+    m_blocks.push_back(b);
+    m_free = BLOCK_SIZE;
+    m_allocated += BLOCK_SIZE;
+  }
+  void* ptr = m_blocks.back() + (BLOCK_SIZE - m_free);
+  m_free -= len;
+  return ptr;
+}
+
+/// Copy a string to the document arena
+const char* Document::copy(const char* str)   {
+  if ( !str ) return 0;
+  size_t len = ::strlen(str)+1;
+  return (const char*)::memcpy(allocate(len), str, len);
+}
+
+/// Create a new element owned by this document
+Node* Document::createElement(const char* tag)   {
+  return new(allocate(sizeof(Node))) Node(ELEMENT_NODE, this, copy(tag));
+}
+
+/// Create a new text node owned by this document
+Node* Document::createTextNode(const char* text)   {
+  return new(allocate(sizeof(Node))) Node(TEXT_NODE, this, copy(text));
+}
+
+/// Create a new comment owned by this document
+Node* Document::createComment(const char* text)   {
+  return new(allocate(sizeof(Node))) Node(COMMENT_NODE, this, copy(text));
+}
+
+/// Create a new processing instruction owned by this document
+Node* Document::createProcessingInstruction(const char* text)   {
+  return new(allocate(sizeof(Node))) Node(PROCESSING_INSTRUCTION_NODE, this, copy(text));
+}
+
+/// Create a new attribute owned by this document
+Attr* Document::createAttribute(const char* nam, const char* val)   {
+  Attr* a = new(allocate(sizeof(Attr))) Attr();
+  a->name  = copy(nam);
+  a->value = copy(val);
+  return a;
+}
+
+/// Load and parse a file using a private memory mapping
+bool Document::load(const string& file_name)   {
+  struct stat st;
+  release();
+  m_error.clear();
+  if ( m_uri.empty() )   {
+    m_uri = file_name;
+    value = m_uri.c_str();
+  }
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if ( fd < 0 )   {
+    m_error = "Cannot open file: " + string(::strerror(errno));
+    return false;
+  }
+  if ( ::fstat(fd, &st) != 0 || st.st_size == 0 )   {
+    m_error = "Cannot access file or file is empty";
+    ::close(fd);
+    return false;
+  }
+  // Private, writable mapping: the in-situ terminators never reach the file
+  void* ptr = ::mmap(0, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if ( ptr == MAP_FAILED )   {
+    m_error = "Cannot map file: " + string(::strerror(errno));
+    return false;
+  }
+  ::madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+  m_buffer = (char*)ptr;
+  m_length = st.st_size;
+  m_mapped = true;
+  return parseBuffer();
+}
+
+/// Parse a memory buffer. The buffer is copied
+bool Document::parse(const char* bytes, size_t length)   {
+  release();
+  m_error.clear();
+  length = ::strnlen(bytes, length);
+  m_buffer = (char*)::malloc(length+1);
+  if ( !m_buffer ) throw bad_alloc();
+  ::memcpy(m_buffer, bytes, length);
+  m_buffer[length] = 0;
+  m_length = length;
+  return parseBuffer();
+}
+
+/// Parse the document buffer in place
+bool Document::parseBuffer()   {
+  char* begin = m_buffer;
+  if ( m_length >= 3 && 0 == ::strncmp(begin, "\xEF\xBB\xBF", 3) ) begin += 3;
+  Parser parser(this, begin, m_buffer+m_length);
+  m_errorLine = m_errorCol = 0;
+  if ( !parser.content(this) )   {
+    m_errorLine = 1;
+    m_errorCol  = 1;
+    for( const char* c = m_buffer; c < parser.where; ++c, ++m_errorCol )   {
+      if ( *c == '\n' ) { ++m_errorLine; m_errorCol = 0; }
+    }
+    m_error = parser.error;
+    return false;
+  }
+  else if ( !getDocumentElement() )   {
+    m_error = "Document has no root element";
+    return false;
+  }
+  return true;
+}
@@ -102,6 +102,46 @@ size_t dd4hep::xml::XmlString::length(const char* p)  {
   return p ? ::strlen(p) : 0;
 }
 
+#elif defined(DD4HEP_USE_FASTXML)
+#include "XML/FastXML.h"
+#include <cstring>
+#define ELEMENT_NODE_TYPE fast::Node::ELEMENT_NODE
+
+/// Union to ease castless object access with the in-situ parser
+union Xml {
+  Xml(const void* ptr) : p(ptr) {}
+  const void* p;
+  fast::Node* n;
+  fast::Node* e;
+  fast::Attr* a;
+  fast::Document* d;
+  XmlElement* xe;
+};
+
+namespace {
+  XmlElement* node_first(XmlElement* e, const Tag_t& t) {
+    return e ? _XE(_E(e)->firstChildElement(t.str().c_str())) : 0;
+  }
+  size_t node_count(XmlElement* elt, const Tag_t& t) {
+    size_t cnt = 0;
+    const char* tag = t.str().c_str();
+    for(fast::Node* e=_E(elt)->firstChildElement(tag); e; e=e->nextSiblingElement(tag)) ++cnt;
+    return cnt;
+  }
+}
+XmlChar* dd4hep::xml::XmlString::replicate(const XmlChar* c) {
+  return c ? ::strdup(c) : 0;
+}
+XmlChar* dd4hep::xml::XmlString::transcode(const char* c)    {
+  return c ? ::strdup(c) : 0;
+}
+void dd4hep::xml::XmlString::release(char** p) {
+  if(p && *p)  {::free(*p); *p=0;}
+}
+size_t dd4hep::xml::XmlString::length(const char* p)  {
+  return p ? ::strlen(p) : 0;
+}
+
 #else
 #include "xercesc/util/XMLString.hpp"
 #include "xercesc/dom/DOMElement.hpp"
@@ -287,13 +327,13 @@ long dd4hep::xml::_toLong(const XmlChar* value) {
       s.erase(idx, 6);
     while (s[0] == ' ')
       s.erase(0, 1);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(s);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << s << ": ";
-      eval.print_error();
+      eval.evaluate(s, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation of " + s);
     }
-    return (long) result;
+    return (long) result.second;
   }
   return -1;
 }
@@ -306,13 +346,13 @@ int dd4hep::xml::_toInt(const XmlChar* value) {
       s.erase(idx, 5);
     while (s[0] == ' ')
       s.erase(0, 1);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(s);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << s << ": ";
-      eval.print_error();
+      eval.evaluate(s, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation of " + s);
     }
-    return (int) result;
+    return (int) result.second;
   }
   return -1;
 }
@@ -328,14 +368,13 @@ bool dd4hep::xml::_toBool(const XmlChar* value) {
 float dd4hep::xml::_toFloat(const XmlChar* value) {
   if (value) {
     string s = _toString(value);
-    double result = eval.evaluate(s.c_str());
-
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(s);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << s << ": ";
-      eval.print_error();
+      eval.evaluate(s, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation of " + s);
     }
-    return (float) result;
+    return (float) result.second;
   }
   return 0.0;
 }
@@ -343,13 +382,13 @@ float dd4hep::xml::_toFloat(const XmlChar* value) {
 double dd4hep::xml::_toDouble(const XmlChar* value) {
   if (value) {
     string s = _toString(value);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
+    auto result = eval.evaluate(s);
+    if (result.first != XmlTools::Evaluator::OK) {
       cerr << s << ": ";
-      eval.print_error();
+      eval.evaluate(s, cerr);
       throw runtime_error("dd4hep: Severe error during expression evaluation of " + s);
     }
-    return result;
+    return result.second;
   }
   return 0.0;
 }
@@ -361,13 +400,13 @@ void dd4hep::xml::_toDictionary(const XmlChar* name, const XmlChar* value) {
     v.erase(idx, 5);
   while (v[0] == ' ')
     v.erase(0, 1);
-  double result = eval.evaluate(v.c_str());
-  if (eval.status() != XmlTools::Evaluator::OK) {
+  auto result = eval.evaluate(v);
+  if (result.first != XmlTools::Evaluator::OK) {
     cerr << v << ": ";
-    eval.print_error();
+    eval.evaluate(v, cerr);
     throw runtime_error("dd4hep: Severe error during expression evaluation of " + v);
   }
-  eval.setVariable(n.c_str(), result);
+  eval.setVariable(n.c_str(), result.second);
 }
 
 /// Helper function to populate the evaluator dictionary  \ingroup DD4HEP_XML
@@ -387,7 +426,7 @@ void dd4hep::xml::_toDictionary(const XmlChar* name, T value)   {
   _toDictionary(name, item_value);
 }
 
-#ifndef DD4HEP_USE_TINYXML
+#ifndef __TIXML__
 template void dd4hep::xml::_toDictionary(const XmlChar* name, const char* value);
 #endif
 template void dd4hep::xml::_toDictionary(const XmlChar* name, const Tag_t& value);
@@ -471,7 +510,7 @@ Tag_t dd4hep::xml::operator+(const Tag_t& a, const string& b) {
   return Tag_t(res);
 }
 
-#ifndef DD4HEP_USE_TINYXML
+#ifndef __TIXML__
 Strng_t dd4hep::xml::operator+(const Strng_t& a, const XmlChar* b) {
   string res = _toString(a.ptr()) + _toString(b);
   return Tag_t(res);
@@ -602,6 +641,8 @@ XmlElement* NodeList::next() const {
   if ( m_tag.str()=="*" )
     return m_ptr =_XE(m_ptr ? _E(m_ptr)->NextSiblingElement() : 0);
   return m_ptr = _XE(m_ptr ? _E(m_ptr)->NextSiblingElement(m_tag.str()) : 0);
+#elif defined(DD4HEP_USE_FASTXML)
+  return m_ptr = _XE(m_ptr ? _E(m_ptr)->nextSiblingElement(m_tag.str().c_str()) : 0);
 #else
   xercesc::DOMElement *elt = Xml(m_ptr).e;
   for(elt=elt->getNextElementSibling(); elt; elt=elt->getNextElementSibling()) {
@@ -619,6 +660,8 @@ XmlElement* NodeList::previous() const {
   if ( m_tag.str()=="*" )
     return m_ptr = _XE(m_ptr ? _E(m_ptr)->PreviousSiblingElement() : 0);
   return m_ptr = _XE(m_ptr ? _E(m_ptr)->PreviousSiblingElement(m_tag) : 0);
+#elif defined(DD4HEP_USE_FASTXML)
+  return m_ptr = _XE(m_ptr ? _E(m_ptr)->previousSiblingElement(m_tag.str().c_str()) : 0);
 #else
   xercesc::DOMElement *elt = Xml(m_ptr).e;
   for(elt=elt->getPreviousElementSibling(); elt; elt=elt->getPreviousElementSibling()) {
@@ -665,6 +708,12 @@ Handle_t Handle_t::clone(XmlDocument* new_doc) const {
       if ( e ) return e;
     }
     throw runtime_error("TiXml: Handle_t::clone: Invalid source handle type [No element type].");
+#elif defined(DD4HEP_USE_FASTXML)
+    if ( _N(m_node)->getNodeType() == ELEMENT_NODE_TYPE ) {
+      fast::Document* doc = new_doc ? _D(new_doc) : _N(m_node)->getOwnerDocument();
+      return _XE(_N(m_node)->clone(doc));
+    }
+    throw runtime_error("Xml: Handle_t::clone: Invalid source handle type [No element type].");
 #else
     return Elt_t(_D(new_doc)->importNode(_E(m_node), true));
 #endif
@@ -694,6 +743,9 @@ vector<Attribute> Handle_t::attributes() const {
 #ifdef DD4HEP_USE_TINYXML
     for(TiXmlAttribute* a=_E(m_node)->FirstAttribute(); a; a=a->Next())
       attrs.push_back(Attribute(a));
+#elif defined(DD4HEP_USE_FASTXML)
+    for(fast::Attr* a=_E(m_node)->getFirstAttribute(); a; a=a->next)
+      attrs.push_back(Attribute(a));
 #else
     xercesc::DOMNamedNodeMap* l = _E(m_node)->getAttributes();
     for (XmlSize_t i = 0, n = l->getLength(); i < n; ++i) {
@@ -745,6 +797,8 @@ void Handle_t::append(Handle_t e) const {
 Handle_t Handle_t::remove(Handle_t node) const {
 #ifdef DD4HEP_USE_TINYXML
   bool e = (m_node && node.ptr() ? _N(m_node)->RemoveChild(_N(node.ptr())) : false);
+#elif defined(DD4HEP_USE_FASTXML)
+  bool e = (m_node && node.ptr() ? _N(m_node)->removeChild(_N(node.ptr())) : false);
 #else
   Elt_t e = Elt_t(m_node && node.ptr() ? _N(m_node)->removeChild(_N(node.ptr())) : 0);
 #endif
@@ -766,6 +820,10 @@ void Handle_t::removeChildren(const XmlChar* tag_value) const {
 #ifdef DD4HEP_USE_TINYXML
   for(TiXmlNode* n=_E(m_node)->FirstChildElement(tag_value);n;n=_E(m_node)->FirstChildElement(tag_value))
     n->RemoveChild(n);
+#elif defined(DD4HEP_USE_FASTXML)
+  const char* tag = tag_value;
+  for(fast::Node* n=_E(m_node)->firstChildElement(tag); n; n=_E(m_node)->firstChildElement(tag))
+    _E(m_node)->removeChild(n);
 #else
   xercesc::DOMElement* e = _E(m_node);
   xercesc::DOMNodeList* l = e->getElementsByTagName(tag_value);
@@ -785,7 +843,7 @@ void Handle_t::setValue(const XmlChar* text_value) const {
 
 /// Set the element's value
 void Handle_t::setValue(const string& text_value) const {
-#ifdef DD4HEP_USE_TINYXML
+#ifdef __TIXML__
   _N(m_node)->setNodeValue(text_value.c_str());
 #else
   _N(m_node)->setNodeValue(Strng_t(text_value));
@@ -796,6 +854,8 @@ void Handle_t::setValue(const string& text_value) const {
 void Handle_t::setText(const XmlChar* text_value) const {
 #ifdef DD4HEP_USE_TINYXML
   _N(m_node)->LinkEndChild(new TiXmlText(text_value));
+#elif defined(DD4HEP_USE_FASTXML)
+  _N(m_node)->appendChild(_N(m_node)->getOwnerDocument()->createTextNode(text_value));
 #else
   _N(m_node)->setTextContent(text_value);
 #endif
@@ -805,6 +865,8 @@ void Handle_t::setText(const XmlChar* text_value) const {
 void Handle_t::setText(const string& text_value) const {
 #ifdef DD4HEP_USE_TINYXML
   _N(m_node)->LinkEndChild(new TiXmlText(text_value.c_str()));
+#elif defined(DD4HEP_USE_FASTXML)
+  _N(m_node)->appendChild(_N(m_node)->getOwnerDocument()->createTextNode(text_value.c_str()));
 #else
   _N(m_node)->setTextContent(Strng_t(text_value));
 #endif
@@ -814,6 +876,8 @@ void Handle_t::setText(const string& text_value) const {
 void Handle_t::removeAttrs() const {
 #ifdef DD4HEP_USE_TINYXML
   _E(m_node)->ClearAttributes();
+#elif defined(DD4HEP_USE_FASTXML)
+  _E(m_node)->clearAttributes();
 #else
   xercesc::DOMElement* e = _E(m_node);
   xercesc::DOMNamedNodeMap* l = e->getAttributes();
@@ -832,6 +896,12 @@ void Handle_t::setAttrs(Handle_t elt) const {
   for(TiXmlAttribute* a=e->FirstAttribute(); a; a=a->Next())
     e->SetAttribute(a->Name(),a->Value());
 }
+#elif defined(DD4HEP_USE_FASTXML)
+void Handle_t::setAttrs(Handle_t elt) const {
+  removeAttrs();
+  for(fast::Attr* a=_E(elt.ptr())->getFirstAttribute(); a; a=a->next)
+    _E(m_node)->setAttribute(a->name,a->value);
+}
 #else
 void Handle_t::setAttrs(Handle_t /* elt */) const {
   removeAttrs();
@@ -917,7 +987,7 @@ Attribute Handle_t::setAttr(const XmlChar* name, const string& val) const {
   return setAttr(name, Strng_t(val.c_str()));
 }
 
-#ifndef DD4HEP_USE_TINYXML
+#ifndef __TIXML__
 Attribute Handle_t::setAttr(const XmlChar* name, const char* v) const {
   return setAttr(name, Strng_t(v));
 }
@@ -934,6 +1004,8 @@ Attribute Handle_t::setAttr(const XmlChar* nam, const XmlChar* val) const {
   TiXmlElement* e = Xml(m_node).e;
   e->SetAttribute(nam,val);
   return Attribute(e->AttributeNode(nam));
+#elif defined(DD4HEP_USE_FASTXML)
+  return Attribute(_E(m_node)->setAttribute(nam,val));
 #else
   xercesc::DOMElement* e = _E(m_node);
   xercesc::DOMAttr* a = e->getAttributeNode(nam);
@@ -1032,6 +1104,30 @@ unsigned int Handle_t::checksum(unsigned int param, fcn_t fcn) const {
     for(TiXmlNode* c=n->FirstChild(); c; c=c->NextSibling())
       param = Handle_t((XmlElement*)c->ToElement()).checksum(param,fcn);
   }
+#elif defined(DD4HEP_USE_FASTXML)
+  fast::Node* n = Xml(m_node).n;
+  if ( n ) {
+    if ( 0 == fcn ) fcn = adler32;
+    switch (n->getNodeType()) {
+    case fast::Node::ELEMENT_NODE: {
+      map<string,string> m;
+      for(fast::Attr* a=n->getFirstAttribute(); a; a=a->next) m.insert(make_pair(a->name,a->value));
+      param = (*fcn)(param,n->value,::strlen(n->value));
+      for(const auto& i : m) {
+        param = (*fcn)(param,i.first.c_str(),i.first.length());
+        param = (*fcn)(param,i.second.c_str(),i.second.length());
+      }
+      break;
+    }
+    case fast::Node::TEXT_NODE:
+      param = (*fcn)(param,n->value,::strlen(n->value));
+      break;
+    default:
+      break;
+    }
+    for(fast::Node* c=n->first; c; c=c->next)
+      param = Handle_t(_XE(c->getNodeType() == ELEMENT_NODE_TYPE ? c : 0)).checksum(param,fcn);
+  }
 #else
   if ( 0 == fcn ) fcn = adler32;
   if ( 0 == fcn )  {
@@ -1044,6 +1140,8 @@ unsigned int Handle_t::checksum(unsigned int param, fcn_t fcn) const {
 Handle_t Document::createElt(const XmlChar* tag_value) const {
 #ifdef DD4HEP_USE_TINYXML
   return _XE(new TiXmlElement(tag_value));
+#elif defined(DD4HEP_USE_FASTXML)
+  return _XE(_D(m_doc)->createElement(tag_value));
 #else
   return _XE(_D(m_doc)->createElement(tag_value));
 #endif
@@ -1069,7 +1167,7 @@ std::string Document::uri() const   {
 DocumentHolder& DocumentHolder::assign(DOC d)   {
   if (m_doc)   {
     printout(DEBUG,"DocumentHolder","+++ Release DOM document....");
-#ifdef DD4HEP_USE_TINYXML
+#ifdef __TIXML__
     delete _D(m_doc);
 #else
     _D(m_doc)->release();
@@ -1143,7 +1241,7 @@ Handle_t Element::setChild(const XmlChar* t) const {
   return e ? Handle_t(e) : addChild(t);
 }
 
-#ifndef DD4HEP_USE_TINYXML
+#ifndef __TIXML__
 /// Add comment node to the element
 void Element::addComment(const XmlChar* text_value) const {
   _N(m_element)->appendChild(_D(document().m_doc)->createComment(text_value));
@@ -1154,6 +1252,8 @@ void Element::addComment(const XmlChar* text_value) const {
 void Element::addComment(const char* text_value) const {
 #ifdef DD4HEP_USE_TINYXML
   _N(m_element)->appendChild(new TiXmlComment(text_value));
+#elif defined(DD4HEP_USE_FASTXML)
+  _N(m_element)->appendChild(_N(m_element)->getOwnerDocument()->createComment(text_value));
 #else
   _N(m_element)->appendChild(_D(document().m_doc)->createComment(Strng_t(text_value)));
 #endif
@@ -1203,7 +1303,7 @@ void RefElement::setName(const XmlChar* new_name) {
   setAttr(_U(name), new_name);
 }
 
-#ifndef DD4HEP_USE_TINYXML
+#ifndef __TIXML__
 Collection_t::Collection_t(Handle_t element, const XmlChar* tag_value)
   : m_children(element, tag_value) {
   m_node = m_children.reset();
@@ -1273,6 +1373,8 @@ void Collection_t::operator--(int) const {
 Handle_t Document::clone(Handle_t source) const {
 #ifdef DD4HEP_USE_TINYXML
   return _XE(source.clone(0));
+#elif defined(DD4HEP_USE_FASTXML)
+  return _XE(source.clone(m_doc));
 #else
   return _XE(_D(m_doc)->importNode(_E(source.ptr()),true));
 #endif
@@ -0,0 +1,149 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_DetElementRegistryBenchmark -repeat 10
+
+   Resolve every detector element of the closed geometry by path and by key:
+   once by descending the detector element tree level by level and once
+   with the hash indexed registry. Both must return the same elements.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/DetectorTools.h"
+#include "DD4hep/DetElementRegistry.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <cerrno>
+#include <cstring>
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+
+  /// Resolve an absolute path by descending the tree (lookup without registry)
+  DetElement descend(DetElement top, const string& path)   {
+    DetElement elt = top;
+    size_t idx = path.find('/',1);
+    while ( elt.isValid() && idx != string::npos )  {
+      size_t next = path.find('/',idx+1);
+      elt = elt.child(path.substr(idx+1, next == string::npos ? string::npos : next-idx-1));
+      idx = next;
+    }
+    return elt;
+  }
+
+  /// Resolve a key by scanning the tree (lookup without registry)
+  DetElement scan(DetElement elt, unsigned int key)   {
+    if ( elt.key() == key ) return elt;
+    for( const auto& c : elt.children() )  {
+      DetElement d = scan(c.second, key);
+      if ( d.isValid() ) return d;
+    }
+    return DetElement();
+  }
+
+  /// Print a single line of the benchmark summary
+  void result(const char* what, size_t count, double seconds)  {
+    printout(ALWAYS,"RegistryBenchmark","+  %-28s %10ld lookups %10.4f seconds %10.4f us/lookup",
+             what, long(count), seconds, count>0 ? 1e6*seconds/double(count) : 0e0);
+  }
+}
+
+/// Plugin function: Benchmark of the detector element lookup
+/**
+ *  Factory: DD4hep_DetElementRegistryBenchmark
+ *
+ *  \version 1.0
+ */
+static long registry_benchmark(Detector& description, int argc, char** argv)  {
+  int  repeat = 10;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-repeat",argv[i],4) && i+1 < argc )
+      repeat = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || repeat < 1 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_DetElementRegistryBenchmark              \n"
+      "     -repeat      <number>    Number of passes over all detector elements.    \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  DetElement world = description.world();
+  const DetElementRegistry* reg = DetElementRegistry::registry(world);
+  if ( !reg )  {
+    except("RegistryBenchmark","+++ No detector element registry present. Is the geometry closed?");
+  }
+  vector<pair<string,DetElement> > elements;
+  vector<unsigned int> keys;
+  for( const auto& e : reg->paths() )  {
+    elements.emplace_back(e.first, e.second);
+    keys.emplace_back(e.second.key());
+  }
+
+  size_t num_diff = 0, num = elements.size()*repeat;
+  TTimeStamp start, stop;
+  printout(ALWAYS,"RegistryBenchmark","+=========================================================================");
+  printout(ALWAYS,"RegistryBenchmark","+  %ld detector elements registered.",long(reg->size()));
+  start = TTimeStamp();
+  for( int i=0; i<repeat; ++i )
+    for( const auto& e : elements )
+      if ( descend(world, e.first).ptr() != e.second.ptr() ) ++num_diff;
+  stop = TTimeStamp();
+  result("Path: tree descent", num, stop.AsDouble()-start.AsDouble());
+
+  start = TTimeStamp();
+  for( int i=0; i<repeat; ++i )
+    for( const auto& e : elements )
+      if ( detail::tools::findElement(description, e.first).ptr() != e.second.ptr() ) ++num_diff;
+  stop = TTimeStamp();
+  result("Path: registry", num, stop.AsDouble()-start.AsDouble());
+
+  start = TTimeStamp();
+  for( size_t i=0; i<keys.size(); ++i )
+    if ( scan(world, keys[i]).ptr() != elements[i].second.ptr() ) ++num_diff;
+  stop = TTimeStamp();
+  result("Key:  tree scan", keys.size(), stop.AsDouble()-start.AsDouble());
+
+  start = TTimeStamp();
+  for( int i=0; i<repeat; ++i )
+    for( size_t j=0; j<keys.size(); ++j )
+      if ( detail::tools::findElement(description, keys[j]).ptr() != elements[j].second.ptr() ) ++num_diff;
+  stop = TTimeStamp();
+  result("Key:  registry", num, stop.AsDouble()-start.AsDouble());
+  printout(ALWAYS,"RegistryBenchmark","+=========================================================================");
+
+  if ( num_diff > 0 )  {
+    except("RegistryBenchmark","+++ %ld lookups returned different detector elements.",long(num_diff));
+  }
+  printout(ALWAYS,"RegistryBenchmark","+  All lookups resolved identical detector elements.");
+  return 1;
+}
+
+DECLARE_APPLY(DD4hep_DetElementRegistryBenchmark,registry_benchmark)
@@ -0,0 +1,177 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_ExpressionEvaluatorBenchmark \
+   -input ${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml -threads 4 -repeat 100
+
+   All attribute values of the XML document, which can be evaluated with
+   the dictionary of the loaded geometry, are evaluated repeatedly:
+   with the uncached expression engine, with the cold and the warm cache
+   of compiled expressions and concurrently from several threads.
+   The results of all evaluations must be identical.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DDParsers/Evaluator.h"
+#include "XML/DocumentHandler.h"
+#include "XML/XMLElements.h"
+#include "XML/XMLTags.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+namespace dd4hep {
+  XmlTools::Evaluator& evaluator();
+}
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+  typedef vector<pair<string,double> > Expressions;
+
+  /// Collect all attribute values of the element tree, which evaluate successfully
+  void collect(const XmlTools::Evaluator& eval, xml::Handle_t elt, Expressions& exprs)  {
+    for( const auto a : elt.attributes() )  {
+      string val = xml::_toString(elt.attr_value(a));
+      auto   res = eval.evaluate(val);
+      if ( res.first == XmlTools::Evaluator::OK )
+        exprs.emplace_back(val, res.second);
+    }
+    for( xml::Collection_t c(elt, _U(star)); c; ++c )
+      collect(eval, c, exprs);
+  }
+
+  /// Evaluate all expressions and count the results differing from the reference
+  size_t run(const XmlTools::Evaluator& eval, const Expressions& exprs, int repeat)  {
+    size_t num_diff = 0;
+    for( int i=0; i<repeat; ++i )  {
+      for( const auto& e : exprs )  {
+        auto res = eval.evaluate(e.first);
+        if ( res.first != XmlTools::Evaluator::OK )
+          ++num_diff;
+        else if ( res.second != e.second && !(std::isnan(res.second) && std::isnan(e.second)) )
+          ++num_diff;
+      }
+    }
+    return num_diff;
+  }
+
+  /// Print a single line of the benchmark summary
+  void result(const char* what, size_t count, double seconds)  {
+    printout(ALWAYS,"EvaluatorBenchmark","+  %-28s %10ld evaluations %10.4f seconds %10.4f us/evaluation",
+             what, long(count), seconds, count>0 ? 1e6*seconds/double(count) : 0e0);
+  }
+}
+
+/// Plugin function: Benchmark of the expression evaluator
+/**
+ *  Factory: DD4hep_ExpressionEvaluatorBenchmark
+ *
+ *  \version 1.0
+ */
+static long evaluator_benchmark(Detector& /* description */, int argc, char** argv)  {
+  string input;
+  int    num_threads = 4, repeat = 100, cache_size = 10000;
+  bool   arg_error = false;
+
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) && i+1 < argc )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-threads",argv[i],4) && i+1 < argc )
+      num_threads = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-repeat",argv[i],4) && i+1 < argc )
+      repeat = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-cache",argv[i],4) && i+1 < argc )
+      cache_size = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || input.empty() || num_threads < 1 || repeat < 1 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_ExpressionEvaluatorBenchmark             \n"
+      "     -input       <string>    XML file with expressions to be evaluated.      \n"
+      "                              Constants must be known to the evaluator.       \n"
+      "     -threads     <number>    Number of concurrent threads (default: 4).      \n"
+      "     -repeat      <number>    Number of passes over all expressions.          \n"
+      "     -cache       <number>    Size of the expression cache (default: 10000).  \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  XmlTools::Evaluator& eval = dd4hep::evaluator();
+  xml::DocumentHolder doc(xml::DocumentHandler().load(input));
+  Expressions exprs;
+  collect(eval, doc.root(), exprs);
+  if ( exprs.empty() )  {
+    except("EvaluatorBenchmark","+++ No expressions found in %s.",input.c_str());
+  }
+
+  /// Reference results: uncached evaluation
+  size_t num_eval = exprs.size()*repeat, num_diff = 0;
+  TTimeStamp start, stop;
+  printout(ALWAYS,"EvaluatorBenchmark","+=========================================================================");
+  printout(ALWAYS,"EvaluatorBenchmark","+  Input: %s  %ld expressions",input.c_str(),long(exprs.size()));
+  eval.setCacheSize(0);
+  for( auto& e : exprs ) e.second = eval.evaluate(e.first).second;
+  start = TTimeStamp();
+  num_diff += run(eval, exprs, repeat);
+  stop = TTimeStamp();
+  result("Uncached engine:", num_eval, stop.AsDouble()-start.AsDouble());
+
+  eval.setCacheSize(cache_size);
+  start = TTimeStamp();
+  num_diff += run(eval, exprs, 1);
+  stop = TTimeStamp();
+  result("Compiled, cold cache:", exprs.size(), stop.AsDouble()-start.AsDouble());
+
+  start = TTimeStamp();
+  num_diff += run(eval, exprs, repeat);
+  stop = TTimeStamp();
+  result("Compiled, warm cache:", num_eval, stop.AsDouble()-start.AsDouble());
+
+  vector<size_t> diffs(num_threads, 0);
+  vector<thread> threads;
+  start = TTimeStamp();
+  for( int i=0; i<num_threads; ++i )
+    threads.emplace_back([&eval, &exprs, &diffs, repeat, i]()  { diffs[i] = run(eval, exprs, repeat); });
+  for( auto& t : threads ) t.join();
+  stop = TTimeStamp();
+  for( size_t d : diffs ) num_diff += d;
+  string what = "Compiled, " + to_string(num_threads) + " threads:";
+  result(what.c_str(), num_eval*num_threads, stop.AsDouble()-start.AsDouble());
+  printout(ALWAYS,"EvaluatorBenchmark","+=========================================================================");
+
+  if ( num_diff > 0 )  {
+    except("EvaluatorBenchmark","+++ %ld evaluations differ from the uncached result.",long(num_diff));
+  }
+  printout(ALWAYS,"EvaluatorBenchmark","+  All evaluation results identical to the uncached engine.");
+  return 1;
+}
+
+DECLARE_APPLY(DD4hep_ExpressionEvaluatorBenchmark,evaluator_benchmark)
@@ -0,0 +1,671 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hepGeometry2GDMLStream -output CLICSiD.gdml -compare -check
+
+   Contrary to DD4hepGeometry2GDML, which first builds the complete XML DOM
+   of the geometry, the GDML file is written directly from the TGeo objects:
+   One walk through the volume tree collects the pointers of all unique
+   volumes, solids, materials and elements. The sections are then streamed
+   through a large output buffer. Volumes shared by many placements are
+   written only once, positions and rotations are written inline into the
+   physvol elements. With -compare the DOM conversion is executed as well
+   and runtime and peak memory of both are printed. With -check the output
+   is read back with TGeoManager::Import and the number of volumes and
+   placements are compared with the written ones and the DOM output.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "XML/DocumentHandler.h"
+#include "LCDDConverter.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+#include "TGeoArb8.h"
+#include "TGeoBoolNode.h"
+#include "TGeoCompositeShape.h"
+#include "TGeoCone.h"
+#include "TGeoEltu.h"
+#include "TGeoHype.h"
+#include "TGeoMatrix.h"
+#include "TGeoParaboloid.h"
+#include "TGeoPara.h"
+#include "TGeoPcon.h"
+#include "TGeoPgon.h"
+#include "TGeoShapeAssembly.h"
+#include "TGeoSphere.h"
+#include "TGeoTorus.h"
+#include "TGeoTrd1.h"
+#include "TGeoTrd2.h"
+#include "TGeoTube.h"
+#include "TGeoScaledShape.h"
+#include "TGeoNode.h"
+#include "TGeoManager.h"
+#include "TClass.h"
+
+// C/C++ include files
+#include <unordered_set>
+#include <cstdarg>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+
+  /// Streaming GDML writer working directly on the TGeo objects
+  /**
+   *  Only the pointers of the unique objects are kept in memory.
+   *  Object names are built from the object name and its address
+   *  like in the LCDDConverter, hence no name tables are needed.
+   *
+   *  \version 1.0
+   */
+  class GDMLStreamWriter  {
+  public:
+    /// Unique objects in the order they must appear in the GDML file
+    vector<const TGeoElement*> elements;
+    vector<const TGeoMedium*>  media;
+    vector<const TGeoShape*>   solids;
+    vector<const TGeoVolume*>  volumes;
+    unordered_set<const void*> seen;
+    size_t num_placements = 0;
+    size_t num_bytes = 0;
+
+  private:
+    FILE* m_file = 0;
+    /// Process id of the gzip child process compressing the output
+    pid_t m_gzip = 0;
+    vector<char> m_buffer;
+    string m_name, m_ref;
+
+    /// Formatted output counting the written bytes
+    void put(const char* fmt, ...)  {
+      va_list args;
+      va_start(args, fmt);
+      int len = ::vfprintf(m_file, fmt, args);
+      va_end(args);
+      if ( len < 0 )  {
+        except("GDMLStreamWriter","+++ Failed to write GDML output: %s",::strerror(errno));
+      }
+      num_bytes += len;
+    }
+    /// Escape the XML special characters of an object name
+    const char* escape(string& buff, const char* n)  {
+      buff.clear();
+      for( ; *n; ++n )  {
+        switch(*n)  {
+        case '&':  buff += "&amp;";   break;
+        case '<':  buff += "&lt;";    break;
+        case '>':  buff += "&gt;";    break;
+        case '"':  buff += "&quot;";  break;
+        default:   buff += *n;        break;
+        }
+      }
+      return buff.c_str();
+    }
+    /// Name of an object
+    const char* name(const TNamed* obj)  {
+      return escape(m_name, obj->GetName());
+    }
+    /// Unique name of an object: <name>_<address>
+    const char* uniqueName(const TNamed* obj, string& buff)  {
+      char text[32];
+      ::snprintf(text,sizeof(text),"_%p",(const void*)obj);
+      escape(buff, obj->GetName());
+      buff += text;
+      return buff.c_str();
+    }
+    const char* solidName(const TGeoShape* shape, string& buff)    {  return uniqueName(shape, buff);   }
+    const char* volumeName(const TGeoVolume* vol, string& buff)    {  return uniqueName(vol, buff);     }
+
+    /// Collect the solid and the solids it is composed of
+    void collectSolid(const TGeoShape* shape)  {
+      if ( !shape || shape->IsA() == TGeoShapeAssembly::Class() || !seen.insert(shape).second )
+        return;
+      if ( shape->IsA() == TGeoCompositeShape::Class() ||
+           shape->IsA() == TGeoUnion::Class() ||
+           shape->IsA() == TGeoIntersection::Class() ||
+           shape->IsA() == TGeoSubtraction::Class() )  {
+        const TGeoBoolNode* boolean = ((const TGeoCompositeShape*)shape)->GetBoolNode();
+        collectSolid(boolean->GetLeftShape());
+        collectSolid(boolean->GetRightShape());
+      }
+      else if ( shape->IsA() == TGeoScaledShape::Class() )  {
+        collectSolid(((const TGeoScaledShape*)shape)->GetShape());
+      }
+      solids.push_back(shape);
+    }
+    /// Collect the material and its elements
+    void collectMedium(const TGeoMedium* medium)  {
+      if ( !medium || !seen.insert(medium).second )
+        return;
+      const TGeoMaterial* mat = medium->GetMaterial();
+      for( int i = 0, n = mat->GetNelements(); i < n; ++i )  {
+        const TGeoElement* elt = mat->GetElement(i);
+        if ( seen.insert(elt).second ) elements.push_back(elt);
+      }
+      media.push_back(medium);
+    }
+    /// Position and rotation of a matrix. Identity transformations are not written.
+    void writeTransform(const char* indent, const char* pos_tag, const char* rot_tag, const char* nam,
+                        const TGeoMatrix* matrix, bool inverse)
+    {
+      const double* tr = matrix->GetTranslation();
+      if ( tr[0] != 0e0 || tr[1] != 0e0 || tr[2] != 0e0 )  {
+        put("%s<%s name=\"%s_pos\" x=\"%.15g\" y=\"%.15g\" z=\"%.15g\" unit=\"cm\"/>\n",
+            indent, pos_tag, nam, tr[0], tr[1], tr[2]);
+      }
+      if ( matrix->IsRotation() )  {
+        TGeoHMatrix inv;
+        if ( inverse ) inv = matrix->Inverse();
+        const double* r = inverse ? inv.GetRotationMatrix() : matrix->GetRotationMatrix();
+        double cosb = std::sqrt(r[0]*r[0] + r[1]*r[1]);
+        double x, y, z;
+        if ( cosb > 0.00001 )
+          x = atan2(r[5], r[8]), y = atan2(-r[2], cosb), z = atan2(r[1], r[0]);
+        else
+          x = atan2(-r[7], r[4]), y = atan2(-r[2], cosb), z = 0e0;
+        if ( x != 0e0 || y != 0e0 || z != 0e0 )  {
+          put("%s<%s name=\"%s_rot\" x=\"%.15g\" y=\"%.15g\" z=\"%.15g\" unit=\"rad\"/>\n",
+              indent, rot_tag, nam, x, y, z);
+        }
+      }
+    }
+
+  public:
+    /// Default constructor
+    GDMLStreamWriter() = default;
+    /// Default destructor. Closes the output if an exception interrupted the writing.
+    ~GDMLStreamWriter()  {
+      if ( m_file ) ::fclose(m_file);
+      if ( m_gzip > 0 ) wait_gzip();
+    }
+    /// Collect the unique objects of the volume tree. Daughters precede their mothers.
+    void collect(const TGeoVolume* volume)  {
+      if ( !seen.insert(volume).second )
+        return;
+      const TObjArray* dau = const_cast<TGeoVolume*>(volume)->GetNodes();
+      for( Int_t i = 0, n = dau ? dau->GetEntries() : 0; i < n; ++i )
+        collect(((const TGeoNode*)dau->At(i))->GetVolume());
+      if ( !volume->IsAssembly() )  {
+        collectSolid(volume->GetShape());
+        collectMedium(volume->GetMedium());
+      }
+      volumes.push_back(volume);
+    }
+
+  private:
+    /// Wait for the gzip child process. Returns its exit status or -1.
+    int wait_gzip()  {
+      int status = 0;
+      pid_t pid;
+      do  {
+        pid = ::waitpid(m_gzip, &status, 0);
+      } while ( pid < 0 && errno == EINTR );
+      m_gzip = 0;
+      return ( pid > 0 && WIFEXITED(status) ) ? WEXITSTATUS(status) : -1;
+    }
+    /// Start gzip writing to the output file. The file name is not passed through a shell.
+    FILE* open_gzip(const string& output)  {
+      int fds[2], fd = ::open(output.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+      if ( fd < 0 )
+        return 0;
+      if ( ::pipe(fds) < 0 )  {
+        ::close(fd);
+        return 0;
+      }
+      m_gzip = ::fork();
+      if ( m_gzip == 0 )  {
+        ::dup2(fds[0], STDIN_FILENO);
+        ::dup2(fd, STDOUT_FILENO);
+        ::close(fds[0]);
+        ::close(fds[1]);
+        ::close(fd);
+        ::execlp("gzip", "gzip", "-c", (char*)0);
+        ::_exit(127);
+      }
+      ::close(fds[0]);
+      ::close(fd);
+      if ( m_gzip < 0 )  {
+        m_gzip = 0;
+        ::close(fds[1]);
+        return 0;
+      }
+      return ::fdopen(fds[1], "w");
+    }
+
+  public:
+    /// Open the output file. If compress is set the output is piped through gzip.
+    void open(const string& output, bool compress, size_t buffer_size)  {
+      m_buffer.resize(buffer_size);
+      m_file = compress ? open_gzip(output) : ::fopen(output.c_str(), "w");
+      if ( !m_file )  {
+        except("GDMLStreamWriter","+++ Failed to open GDML output %s: %s",output.c_str(),::strerror(errno));
+      }
+      ::setvbuf(m_file, &m_buffer[0], _IOFBF, m_buffer.size());
+    }
+    /// Flush and close the output
+    void close()  {
+      int ret = ::fclose(m_file);
+      m_file = 0;
+      if ( m_gzip > 0 && ret == 0 )
+        ret = wait_gzip();
+      if ( ret != 0 )  {
+        except("GDMLStreamWriter","+++ Failed to close GDML output [status:%d]",ret);
+      }
+    }
+
+    /// Write the materials section
+    void writeMaterials()  {
+      put(" <materials>\n");
+      for( const TGeoElement* elt : elements )  {
+        // Unphysical elements (Z<1 or A<1) are written as hydrogen like in the LCDDConverter
+        double A = elt->A();
+        int    Z = elt->Z();
+        put("  <element name=\"%s\" formula=\"%s\" Z=\"%d\">\n"
+            "   <atom type=\"A\" unit=\"g/mol\" value=\"%.15g\"/>\n"
+            "  </element>\n", name(elt), m_name.c_str(), Z>0 ? Z : 1, A>0.99 ? A : 1.00794);
+      }
+      for( const TGeoMedium* medium : media )  {
+        const TGeoMaterial* mat = medium->GetMaterial();
+        double d = mat->GetDensity();
+        if ( d < 1e-10 ) d = 1e-10;
+        if ( mat->IsMixture() )  {
+          const TGeoMixture* mix = (const TGeoMixture*)mat;
+          const double*     wmix = mix->GetWmixt();
+          const int*        nmix = mix->GetNmixt();
+          double sum = 0e0;
+          for( int i = 0, n = mix->GetNelements(); i < n; ++i )
+            sum += wmix[i];
+          put("  <material name=\"%s\">\n"
+              "   <D type=\"density\" unit=\"g/cm3\" value=\"%.15g\"/>\n", name(medium), d);
+          for( int i = 0, n = mix->GetNelements(); i < n; ++i )  {
+            if ( nmix )
+              put("   <composite n=\"%d\" ref=\"%s\"/>\n", nmix[i], name(mix->GetElement(i)));
+            else
+              put("   <fraction n=\"%.15g\" ref=\"%s\"/>\n", wmix[i]/sum, name(mix->GetElement(i)));
+          }
+          put("  </material>\n");
+        }
+        else if ( ::strcmp(medium->GetName(),"dummy") != 0 )  {
+          put("  <material name=\"%s\" Z=\"%.15g\">\n"
+              "   <D type=\"density\" unit=\"g/cm3\" value=\"%.15g\"/>\n"
+              "   <atom type=\"A\" unit=\"g/mol\" value=\"%.15g\"/>\n"
+              "  </material>\n", name(medium), mat->GetZ(), d, mat->GetA());
+        }
+      }
+      put(" </materials>\n");
+    }
+
+    /// Write a single solid
+    void writeSolid(const TGeoShape* shape)  {
+      TClass* isa = shape->IsA();
+      const char* nam = solidName(shape, m_ref);
+      if ( isa == TGeoBBox::Class() )  {
+        const TGeoBBox* sh = (const TGeoBBox*)shape;
+        put("  <box name=\"%s\" x=\"%.15g\" y=\"%.15g\" z=\"%.15g\" lunit=\"cm\"/>\n",
+            nam, 2*sh->GetDX(), 2*sh->GetDY(), 2*sh->GetDZ());
+      }
+      else if ( isa == TGeoTube::Class() )  {
+        const TGeoTube* sh = (const TGeoTube*)shape;
+        put("  <tube name=\"%s\" rmin=\"%.15g\" rmax=\"%.15g\" z=\"%.15g\" startphi=\"0\" deltaphi=\"360\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, sh->GetRmin(), sh->GetRmax(), 2*sh->GetDz());
+      }
+      else if ( isa == TGeoTubeSeg::Class() )  {
+        const TGeoTubeSeg* sh = (const TGeoTubeSeg*)shape;
+        put("  <tube name=\"%s\" rmin=\"%.15g\" rmax=\"%.15g\" z=\"%.15g\" startphi=\"%.15g\" deltaphi=\"%.15g\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, sh->GetRmin(), sh->GetRmax(), 2*sh->GetDz(), sh->GetPhi1(), sh->GetPhi2()-sh->GetPhi1());
+      }
+      else if ( isa == TGeoEltu::Class() )  {
+        const TGeoEltu* sh = (const TGeoEltu*)shape;
+        put("  <eltube name=\"%s\" dx=\"%.15g\" dy=\"%.15g\" dz=\"%.15g\" lunit=\"cm\"/>\n",
+            nam, sh->GetA(), sh->GetB(), sh->GetDz());
+      }
+      else if ( isa == TGeoTrd1::Class() )  {
+        const TGeoTrd1* sh = (const TGeoTrd1*)shape;
+        put("  <trd name=\"%s\" x1=\"%.15g\" x2=\"%.15g\" y1=\"%.15g\" y2=\"%.15g\" z=\"%.15g\" lunit=\"cm\"/>\n",
+            nam, 2*sh->GetDx1(), 2*sh->GetDx2(), 2*sh->GetDy(), 2*sh->GetDy(), 2*sh->GetDz());
+      }
+      else if ( isa == TGeoTrd2::Class() )  {
+        const TGeoTrd2* sh = (const TGeoTrd2*)shape;
+        put("  <trd name=\"%s\" x1=\"%.15g\" x2=\"%.15g\" y1=\"%.15g\" y2=\"%.15g\" z=\"%.15g\" lunit=\"cm\"/>\n",
+            nam, 2*sh->GetDx1(), 2*sh->GetDx2(), 2*sh->GetDy1(), 2*sh->GetDy2(), 2*sh->GetDz());
+      }
+      else if ( isa == TGeoHype::Class() )  {
+        const TGeoHype* sh = (const TGeoHype*)shape;
+        put("  <hype name=\"%s\" rmin=\"%.15g\" rmax=\"%.15g\" inst=\"%.15g\" outst=\"%.15g\" z=\"%.15g\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, sh->GetRmin(), sh->GetRmax(), sh->GetStIn(), sh->GetStOut(), 2*sh->GetDz());
+      }
+      else if ( isa == TGeoPgon::Class() || isa == TGeoPcon::Class() )  {
+        const TGeoPcon* sh = (const TGeoPcon*)shape;
+        if ( isa == TGeoPgon::Class() )
+          put("  <polyhedra name=\"%s\" startphi=\"%.15g\" deltaphi=\"%.15g\" numsides=\"%d\" aunit=\"deg\" lunit=\"cm\">\n",
+              nam, sh->GetPhi1(), sh->GetDphi(), ((const TGeoPgon*)sh)->GetNedges());
+        else
+          put("  <polycone name=\"%s\" startphi=\"%.15g\" deltaphi=\"%.15g\" aunit=\"deg\" lunit=\"cm\">\n",
+              nam, sh->GetPhi1(), sh->GetDphi());
+        for( Int_t i = 0; i < sh->GetNz(); ++i )
+          put("   <zplane z=\"%.15g\" rmin=\"%.15g\" rmax=\"%.15g\"/>\n", sh->GetZ(i), sh->GetRmin(i), sh->GetRmax(i));
+        put(isa == TGeoPgon::Class() ? "  </polyhedra>\n" : "  </polycone>\n");
+      }
+      else if ( isa == TGeoCone::Class() )  {
+        const TGeoCone* sh = (const TGeoCone*)shape;
+        put("  <cone name=\"%s\" z=\"%.15g\" rmin1=\"%.15g\" rmax1=\"%.15g\" rmin2=\"%.15g\" rmax2=\"%.15g\" startphi=\"0\" deltaphi=\"360\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, 2*sh->GetDz(), sh->GetRmin1(), sh->GetRmax1(), sh->GetRmin2(), sh->GetRmax2());
+      }
+      else if ( isa == TGeoConeSeg::Class() )  {
+        const TGeoConeSeg* sh = (const TGeoConeSeg*)shape;
+        put("  <cone name=\"%s\" z=\"%.15g\" rmin1=\"%.15g\" rmax1=\"%.15g\" rmin2=\"%.15g\" rmax2=\"%.15g\" startphi=\"%.15g\" deltaphi=\"%.15g\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, 2*sh->GetDz(), sh->GetRmin1(), sh->GetRmax1(), sh->GetRmin2(), sh->GetRmax2(),
+            sh->GetPhi1(), sh->GetPhi2()-sh->GetPhi1());
+      }
+      else if ( isa == TGeoParaboloid::Class() )  {
+        const TGeoParaboloid* sh = (const TGeoParaboloid*)shape;
+        put("  <paraboloid name=\"%s\" rlo=\"%.15g\" rhi=\"%.15g\" dz=\"%.15g\" lunit=\"cm\"/>\n",
+            nam, sh->GetRlo(), sh->GetRhi(), sh->GetDz());
+      }
+      else if ( isa == TGeoSphere::Class() )  {
+        const TGeoSphere* sh = (const TGeoSphere*)shape;
+        put("  <sphere name=\"%s\" rmin=\"%.15g\" rmax=\"%.15g\" startphi=\"%.15g\" deltaphi=\"%.15g\" starttheta=\"%.15g\" deltatheta=\"%.15g\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, sh->GetRmin(), sh->GetRmax(), sh->GetPhi1(), sh->GetPhi2()-sh->GetPhi1(),
+            sh->GetTheta1(), sh->GetTheta2()-sh->GetTheta1());
+      }
+      else if ( isa == TGeoTorus::Class() )  {
+        const TGeoTorus* sh = (const TGeoTorus*)shape;
+        put("  <torus name=\"%s\" rtor=\"%.15g\" rmin=\"%.15g\" rmax=\"%.15g\" startphi=\"%.15g\" deltaphi=\"%.15g\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, sh->GetR(), sh->GetRmin(), sh->GetRmax(), sh->GetPhi1(), sh->GetDphi());
+      }
+      else if ( isa == TGeoTrap::Class() )  {
+        const TGeoTrap* sh = (const TGeoTrap*)shape;
+        put("  <trap name=\"%s\" z=\"%.15g\" theta=\"%.15g\" phi=\"%.15g\" y1=\"%.15g\" x1=\"%.15g\" x2=\"%.15g\" alpha1=\"%.15g\""
+            " y2=\"%.15g\" x3=\"%.15g\" x4=\"%.15g\" alpha2=\"%.15g\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, 2*sh->GetDz(), sh->GetTheta(), sh->GetPhi(),
+            2*sh->GetH1(), 2*sh->GetBl1(), 2*sh->GetTl1(), sh->GetAlpha1(),
+            2*sh->GetH2(), 2*sh->GetBl2(), 2*sh->GetTl2(), sh->GetAlpha2());
+      }
+      else if ( isa == TGeoPara::Class() )  {
+        const TGeoPara* sh = (const TGeoPara*)shape;
+        put("  <para name=\"%s\" x=\"%.15g\" y=\"%.15g\" z=\"%.15g\" alpha=\"%.15g\" theta=\"%.15g\" phi=\"%.15g\" aunit=\"deg\" lunit=\"cm\"/>\n",
+            nam, 2*sh->GetX(), 2*sh->GetY(), 2*sh->GetZ(), sh->GetAlpha(), sh->GetTheta(), sh->GetPhi());
+      }
+      else if ( isa == TGeoArb8::Class() )  {
+        TGeoArb8* sh = (TGeoArb8*)shape;
+        const double* v = sh->GetVertices();
+        put("  <arb8 name=\"%s\"", nam);
+        for( int i = 0; i < 8; ++i )
+          put(" v%dx=\"%.15g\" v%dy=\"%.15g\"", i+1, v[2*i], i+1, v[2*i+1]);
+        put(" dz=\"%.15g\" lunit=\"cm\"/>\n", sh->GetDz());
+      }
+      else if ( isa == TGeoScaledShape::Class() )  {
+        const TGeoScaledShape* sh = (const TGeoScaledShape*)shape;
+        const double* scale = sh->GetScale()->GetScale();
+        put("  <scaledSolid name=\"%s\">\n"
+            "   <solidref ref=\"%s\"/>\n"
+            "   <scale name=\"%s_scale\" x=\"%.15g\" y=\"%.15g\" z=\"%.15g\"/>\n"
+            "  </scaledSolid>\n", nam, solidName(sh->GetShape(), m_name), nam, scale[0], scale[1], scale[2]);
+      }
+      else if ( isa == TGeoCompositeShape::Class() ||
+                isa == TGeoUnion::Class() ||
+                isa == TGeoIntersection::Class() ||
+                isa == TGeoSubtraction::Class() )  {
+        const TGeoBoolNode* boolean = ((const TGeoCompositeShape*)shape)->GetBoolNode();
+        TGeoBoolNode::EGeoBoolType oper = boolean->GetBooleanOperator();
+        const char* tag = oper == TGeoBoolNode::kGeoSubtraction ? "subtraction"
+          : oper == TGeoBoolNode::kGeoUnion ? "union" : "intersection";
+        string ref = nam;
+        put("  <%s name=\"%s\">\n", tag, ref.c_str());
+        put("   <first ref=\"%s\"/>\n",  solidName(boolean->GetLeftShape(), m_name));
+        put("   <second ref=\"%s\"/>\n", solidName(boolean->GetRightShape(), m_name));
+        writeTransform("   ", "position", "rotation", ref.c_str(), boolean->GetRightMatrix(), true);
+        writeTransform("   ", "firstposition", "firstrotation", (ref+"_first").c_str(), boolean->GetLeftMatrix(), true);
+        put("  </%s>\n", tag);
+      }
+      else  {
+        except("GDMLStreamWriter","+++ Failed to handle unknown solid shape: %s of type %s",
+               shape->GetName(), isa->GetName());
+      }
+    }
+
+    /// Write a logical volume with all its placements
+    void writeVolume(const TGeoVolume* volume)  {
+      string vol_name = volumeName(volume, m_ref);
+      if ( volume->IsAssembly() )  {
+        put("  <assembly name=\"%s\">\n", vol_name.c_str());
+      }
+      else  {
+        put("  <volume name=\"%s\">\n", vol_name.c_str());
+        put("   <materialref ref=\"%s\"/>\n", name(volume->GetMedium()));
+        put("   <solidref ref=\"%s\"/>\n", solidName(volume->GetShape(), m_ref));
+      }
+      const TObjArray* dau = const_cast<TGeoVolume*>(volume)->GetNodes();
+      for( Int_t i = 0, n = dau ? dau->GetEntries() : 0; i < n; ++i )  {
+        const TGeoNode* node = (const TGeoNode*)dau->At(i);
+        string node_name = escape(m_ref, node->GetName());
+        put("   <physvol name=\"%s\">\n", node_name.c_str());
+        put("    <volumeref ref=\"%s\"/>\n", volumeName(node->GetVolume(), m_ref));
+        writeTransform("    ", "position", "rotation", node_name.c_str(), node->GetMatrix(), false);
+        put("   </physvol>\n");
+        ++num_placements;
+      }
+      put(volume->IsAssembly() ? "  </assembly>\n" : "  </volume>\n");
+    }
+
+    /// Stream the GDML document of the geometry below the world volume
+    void write(const TGeoVolume* world)  {
+      put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+          "<gdml xmlns:xs=\"http://www.w3.org/2001/XMLSchema-instance\""
+          " xs:noNamespaceSchemaLocation=\"http://service-spi.web.cern.ch/service-spi/app/releases/GDML/schema/gdml.xsd\">\n");
+      put(" <define/>\n");
+      writeMaterials();
+      put(" <solids>\n");
+      for( const TGeoShape* shape : solids )
+        writeSolid(shape);
+      put(" </solids>\n");
+      put(" <structure>\n");
+      for( const TGeoVolume* volume : volumes )
+        writeVolume(volume);
+      put(" </structure>\n");
+      put(" <setup name=\"default\" version=\"1.0\">\n"
+          "  <world ref=\"%s\"/>\n"
+          " </setup>\n"
+          "</gdml>\n", volumeName(world, m_ref));
+    }
+  };
+
+  /// Resident and peak resident memory of the process in bytes from /proc/self/status
+  void process_memory(size_t& rss, size_t& peak)  {
+    char line[256];
+    long val = 0;
+    rss = peak = 0;
+    FILE* f = ::fopen("/proc/self/status","r");
+    if ( f )  {
+      while( ::fgets(line, sizeof(line), f) )  {
+        if      ( 1 == ::sscanf(line, "VmRSS: %ld kB", &val) ) rss  = size_t(val)*1024;
+        else if ( 1 == ::sscanf(line, "VmHWM: %ld kB", &val) ) peak = size_t(val)*1024;
+      }
+      ::fclose(f);
+    }
+  }
+
+  /// Reset the peak resident memory of the process (Linux >= 4.0)
+  void reset_peak_memory()  {
+    FILE* f = ::fopen("/proc/self/clear_refs","w");
+    if ( f )  {
+      ::fputs("5", f);
+      ::fclose(f);
+    }
+  }
+
+  /// Peak memory increase since the last call to reset_peak_memory()
+  size_t peak_increase(size_t rss_start)  {
+    size_t rss = 0, peak = 0;
+    process_memory(rss, peak);
+    return peak > rss_start ? peak - rss_start : 0;
+  }
+
+  /// Read a GDML file with TGeoManager::Import and count the volumes and the placements
+  /** The geometry manager of the detector description stays the current one.
+   */
+  void import_counts(const string& file, size_t& num_volumes, size_t& num_placements)  {
+    TGeoManager* mgr = gGeoManager;
+    TGeoIdentity* identity = gGeoIdentity;
+    TGeoManager* imported = TGeoManager::Import(file.c_str());
+    bool success = imported != 0;
+    num_volumes = num_placements = 0;
+    if ( success )  {
+      const TObjArray* vols = imported->GetListOfVolumes();
+      for( Int_t i = 0, n = vols->GetEntriesFast(); i < n; ++i )  {
+        const TGeoVolume* vol = (const TGeoVolume*)vols->At(i);
+        if ( !vol ) continue;
+        ++num_volumes;
+        num_placements += vol->GetNdaughters();
+      }
+      delete imported;
+    }
+    gGeoManager  = mgr;
+    gGeoIdentity = identity;
+    if ( !success )  {
+      except("GDMLStreamWriter","+++ Failed to read back GDML file %s",file.c_str());
+    }
+  }
+}
+
+/// Plugin function: Stream the geometry in GDML format to file
+/**
+ *  Factory: DD4hepGeometry2GDMLStream
+ *
+ *  \version 1.0
+ */
+static long create_gdml_stream(Detector& description, int argc, char** argv)  {
+  string output;
+  bool   compress = false, compare = false, check = false, arg_error = false;
+  long   buffer_size = 4096;
+  // -compress and -compare share their first characters: only full option names are accepted
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strcmp("-output",argv[i]) && i+1 < argc )
+      output = argv[++i];
+    else if ( 0 == ::strcmp("-buffer",argv[i]) && i+1 < argc )
+      buffer_size = ::atol(argv[++i]);
+    else if ( 0 == ::strcmp("-compress",argv[i]) )
+      compress = true;
+    else if ( 0 == ::strcmp("-compare",argv[i]) )
+      compare = true;
+    else if ( 0 == ::strcmp("-check",argv[i]) )
+      check = true;
+    else
+      arg_error = true;
+  }
+  if ( output.length() > 3 && output.substr(output.length()-3) == ".gz" )
+    compress = true;
+  if ( arg_error || output.empty() || buffer_size < 1 || (check && compress) )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hepGeometry2GDMLStream                       \n"
+      "     -output      <string>    GDML output file. Files ending with .gz are     \n"
+      "                              compressed with gzip.                           \n"
+      "     -compress                Compress the output with gzip.                  \n"
+      "     -buffer      <number>    Size of the output buffer in kB [4096]          \n"
+      "     -compare                 Convert the geometry as well with the XML DOM   \n"
+      "                              (DD4hepGeometry2GDML) and compare runtime and   \n"
+      "                              peak memory.                                    \n"
+      "     -check                   Read the uncompressed output back with ROOT and \n"
+      "                              compare the number of volumes and placements    \n"
+      "                              with the written ones and with the DOM output.  \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  size_t rss = 0, peak = 0, num_volumes = 0, num_placements = 0, num_bytes = 0;
+  TGeoVolume* world = description.worldVolume().ptr();
+  process_memory(rss, peak);
+  reset_peak_memory();
+  TTimeStamp start;
+  {
+    GDMLStreamWriter writer;
+    writer.collect(world);
+    writer.open(output, compress, buffer_size*1024);
+    writer.write(world);
+    writer.close();
+    num_volumes    = writer.volumes.size();
+    num_placements = writer.num_placements;
+    num_bytes      = writer.num_bytes;
+    printout(ALWAYS,"GDMLStreamWriter","+++ Streamed %ld volumes, %ld placements, %ld solids, %ld materials, "
+             "%ld elements to %s%s",
+             long(writer.volumes.size()), long(writer.num_placements), long(writer.solids.size()),
+             long(writer.media.size()), long(writer.elements.size()), output.c_str(),
+             compress ? " [gzip]" : "");
+  }
+  TTimeStamp stop;
+  double t_stream = stop.AsDouble()-start.AsDouble();
+  size_t m_stream = peak_increase(rss);
+  printout(ALWAYS,"GDMLStreamWriter","+  %-12s %10.3f seconds  peak memory +%10.1f MB  %12ld bytes written",
+           "Streaming:", t_stream, double(m_stream)/1024e0/1024e0, long(num_bytes));
+  string dom_output = output.substr(0, output.rfind(".gdml")) + ".dom.gdml";
+  if ( compare )  {
+    process_memory(rss, peak);
+    reset_peak_memory();
+    start = TTimeStamp();
+    {
+      PrintLevel level = setPrintLevel(WARNING);
+      detail::LCDDConverter wr(description);
+      xml::DocumentHandler docH;
+      xml_doc_t doc = wr.createGDML(description.world());
+      docH.output(doc, dom_output);
+      xml::DocumentHolder holder(doc.ptr());
+      setPrintLevel(level);
+      printout(ALWAYS,"GDMLStreamWriter","+++ DOM converter wrote %ld volumes to %s",
+               long(wr.data().volumes.size()), dom_output.c_str());
+    }
+    stop = TTimeStamp();
+    double t_dom = stop.AsDouble()-start.AsDouble();
+    size_t m_dom = peak_increase(rss);
+    printout(ALWAYS,"GDMLStreamWriter","+  %-12s %10.3f seconds  peak memory +%10.1f MB",
+             "XML DOM:", t_dom, double(m_dom)/1024e0/1024e0);
+    printout(ALWAYS,"GDMLStreamWriter","+  Streaming speedup: %.1f  memory ratio: %.1f  [%ld unique volumes]",
+             t_stream > 0e0 ? t_dom/t_stream : 0e0,
+             m_stream > 0 ? double(m_dom)/double(m_stream) : 0e0, long(num_volumes));
+  }
+  if ( check )  {
+    size_t vol_stream = 0, pl_stream = 0, vol_dom = num_volumes, pl_dom = num_placements;
+    import_counts(output, vol_stream, pl_stream);
+    if ( compare ) import_counts(dom_output, vol_dom, pl_dom);
+    printout(ALWAYS,"GDMLStreamWriter","+  Readback: streamed %ld volumes %ld placements, read %ld volumes %ld placements",
+             long(num_volumes), long(num_placements), long(vol_stream), long(pl_stream));
+    if ( compare )  {
+      printout(ALWAYS,"GDMLStreamWriter","+  Readback: DOM output %ld volumes %ld placements",
+               long(vol_dom), long(pl_dom));
+    }
+    if ( vol_stream != num_volumes || pl_stream != num_placements || vol_stream != vol_dom || pl_stream != pl_dom )  {
+      except("GDMLStreamWriter","+++ FAILED: The GDML file %s does not reproduce the geometry.",output.c_str());
+    }
+    printout(ALWAYS,"GDMLStreamWriter","+  Readback of %s identical.",output.c_str());
+  }
+  return 1;
+}
+DECLARE_APPLY(DD4hepGeometry2GDMLStream, create_gdml_stream)
@@ -106,7 +106,7 @@ void GeometryWalk::walk(DetElement e, PlacedVolume::VolIDs ids)  const   {
   PlacedVolume pv = e.placement();
   PlacedVolume::VolIDs child_ids(ids);
   print(e,pv,ids);
-  child_ids.insert(child_ids.end(),pv.volIDs().begin(),pv.volIDs().end());
+  child_ids.append(pv.volIDCodes());
   for (_C::const_iterator i=children.begin(); i!=children.end(); ++i)  {
     walk((*i).second,child_ids);
   }
@@ -0,0 +1,138 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -plugin DD4hep_InstanceCountBenchmark -threads 4 -objects 1000000
+
+   Every thread constructs and destroys <objects> instances of a counted
+   type. The instances are counted by type information (one lookup per
+   call), by the per-type counter slot and by a sharded counter slot.
+   The counters must balance and show the total number of instances.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/InstanceCount.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+
+  /// Object counted by type information
+  struct ByType     {
+    ByType()          {  InstanceCount::increment(typeid(ByType));    }
+    ~ByType()         {  InstanceCount::decrement(typeid(ByType));    }
+  };
+  /// Object counted by its per-type counter slot
+  struct BySlot     {
+    BySlot()          {  InstanceCount::increment(this);              }
+    ~BySlot()         {  InstanceCount::decrement(this);              }
+  };
+  /// Object counted by its sharded per-type counter slot
+  struct ByShard    {
+    ByShard()         {  InstanceCount::increment(this);              }
+    ~ByShard()        {  InstanceCount::decrement(this);              }
+  };
+
+  /// Construct and destroy the objects of one thread. Every 16 objects are alive at the same time
+  template <typename T> void create(long num_objects)  {
+    for( long i=0; i<num_objects; i += 16 )  {
+      T objects[16];
+      (void)objects;
+    }
+  }
+
+  /// Construct and destroy the objects of all threads. Returns the elapsed time
+  template <typename T> double run(size_t num_threads, long num_objects)  {
+    vector<thread> threads;
+    TTimeStamp start;
+    for( size_t i=0; i<num_threads; ++i )
+      threads.emplace_back(create<T>, num_objects);
+    for( auto& t : threads ) t.join();
+    TTimeStamp stop;
+    return stop.AsDouble()-start.AsDouble();
+  }
+
+  /// Check and print a single line of the benchmark summary
+  bool result(const char* what, const InstanceCount::Counter* cnt, long expected, double seconds)  {
+    printout(ALWAYS,"CountBenchmark","+  %-20s %10.4f seconds %8.2f ns/object  Total:%10lld Max:%5lld Leaking:%3lld",
+             what, seconds, expected>0 ? 1e9*seconds/double(expected) : 0e0,
+             cnt->total(), cnt->maximum(), cnt->value());
+    return cnt->total() == expected && cnt->value() == 0 && cnt->maximum() >= 16;
+  }
+}
+
+/// Plugin function: Benchmark of the instance counters
+/**
+ *  Factory: DD4hep_InstanceCountBenchmark
+ *
+ *  \version 1.0
+ */
+static long instance_count_benchmark(Detector& /* description */, int argc, char** argv)  {
+  long num_threads = 4, num_objects = 1000000;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-threads",argv[i],4) && i+1 < argc )
+      num_threads = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-objects",argv[i],4) && i+1 < argc )
+      num_objects = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || num_threads < 1 || num_objects < 16 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_InstanceCountBenchmark                   \n"
+      "     -threads     <number>    Number of threads creating objects.             \n"
+      "     -objects     <number>    Number of objects per thread (at least 16).     \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+  num_objects -= num_objects%16;
+  long expected = num_threads*num_objects;
+  bool tracing  = InstanceCount::doTrace();
+  InstanceCount::doTracing(true);
+  InstanceCount::shard<ByShard>();
+  double t_type  = run<ByType>(num_threads, num_objects);
+  double t_slot  = run<BySlot>(num_threads, num_objects);
+  double t_shard = run<ByShard>(num_threads, num_objects);
+
+  printout(ALWAYS,"CountBenchmark","+=========================================================================");
+  bool ok = result("By type information:", InstanceCount::getCounter(typeid(ByType)), expected, t_type);
+  ok = result("By counter slot:", InstanceCount::counter<BySlot>(), expected, t_slot) && ok;
+  ok = result("By sharded slot:", InstanceCount::counter<ByShard>(), expected, t_shard) && ok;
+  printout(ALWAYS,"CountBenchmark","+=========================================================================");
+  InstanceCount::doTracing(tracing);
+  if ( !ok )  {
+    except("CountBenchmark","+++ Instance counters do not balance. Expected %ld instances.", expected);
+  }
+  printout(ALWAYS,"CountBenchmark","+  All %ld instances were counted by all counters.", expected);
+  return 1;
+}
+
+DECLARE_APPLY(DD4hep_InstanceCountBenchmark,instance_count_benchmark)
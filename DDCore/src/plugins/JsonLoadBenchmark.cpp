@@ -0,0 +1,232 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -plugin DD4hep_JsonLoadBenchmark \
+   -input ${DD4hep_DIR}/examples/ClientTests/compact/MiniTel.json -scale 10000 -repeat 5
+
+   The input file is loaded <repeat> times with the in-situ JSON parser
+   and with the boost property tree. With -scale the members of the top
+   level object are replicated <scale> times into a temporary file to
+   emulate a large detector description. All loaded documents are kept
+   in memory until the end of the pass to measure the resident memory.
+   Both trees must contain the same values in the same order and all
+   numbers must be converted correctly.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "JSON/FastJSON.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <memory>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include "boost/property_tree/json_parser.hpp"
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+  typedef boost::property_tree::ptree ptree;
+  typedef json::fast::Value           Value;
+
+  /// Value count and content hash of a document tree
+  struct Signature  {
+    size_t values  = 0;
+    size_t numbers = 0;
+    size_t hash    = 0;
+    bool operator==(const Signature& s) const
+    {  return values == s.values && hash == s.hash;  }
+    void add(const string& key, const string& text)  {
+      hash = hash*31 + std::hash<string>()(key);
+      hash = hash*31 + std::hash<string>()(text);
+      ++values;
+    }
+  };
+
+  /// Signature of a property tree
+  void signature(const ptree& tree, Signature& sig)  {
+    for( const auto& c : tree )  {
+      sig.add(c.first, c.second.data());
+      signature(c.second, sig);
+    }
+  }
+
+  /// Signature of an in-situ tree. Numbers must match the conversion of their literal
+  void signature(const Value* tree, Signature& sig, size_t& num_bad)  {
+    for( const Value* c = tree->first; c; c = c->next )  {
+      sig.add(c->key, c->isContainer() ? "" : c->text);
+      if ( c->isNumber() )  {
+        if ( c->number != ::strtod(c->text, 0) ) ++num_bad;
+        ++sig.numbers;
+      }
+      signature(c, sig, num_bad);
+    }
+  }
+
+  /// Replicate the members of the top level object of a file into a new temporary file
+  string replicate(const string& input, long scale)  {
+    ifstream in(input);
+    stringstream buffer;
+    buffer << in.rdbuf();
+    string text = buffer.str();
+    size_t beg = text.find('{'), end = text.rfind('}');
+    if ( !in || beg == string::npos || end == string::npos || end < beg )  {
+      except("JsonBenchmark","+++ %s does not contain a JSON object.",input.c_str());
+    }
+    string members = text.substr(beg+1, end-beg-1);
+    char   name[] = "/tmp/DD4hep_JsonBenchmark_XXXXXX";
+    int    fd = ::mkstemp(name);
+    if ( fd < 0 )  {
+      except("JsonBenchmark","+++ Cannot create temporary file: %s",::strerror(errno));
+    }
+    ::close(fd);
+    ofstream out(name);
+    out << "{\n";
+    for( long i=0; i<scale; ++i )
+      out << members << (i+1 < scale ? ",\n" : "\n");
+    out << "}\n";
+    return name;
+  }
+
+  /// Resident memory of the process in bytes
+  size_t resident_memory()  {
+    long pages = 0, resident = 0;
+    FILE* f = ::fopen("/proc/self/statm","r");
+    if ( f )  {
+      if ( 2 != ::fscanf(f,"%ld %ld",&pages,&resident) ) resident = 0;
+      ::fclose(f);
+    }
+    return size_t(resident)*size_t(::sysconf(_SC_PAGESIZE));
+  }
+
+  /// Print a single line of the benchmark summary
+  void result(const char* what, size_t count, double seconds, size_t memory)  {
+    printout(ALWAYS,"JsonBenchmark","+  %-28s %6ld documents %10.4f seconds %10.2f ms/doc %12.1f kB/doc",
+             what, long(count), seconds, count>0 ? 1e3*seconds/double(count) : 0e0,
+             count>0 ? double(memory)/1024e0/double(count) : 0e0);
+  }
+}
+
+/// Plugin function: Benchmark of the JSON document loading
+/**
+ *  Factory: DD4hep_JsonLoadBenchmark
+ *
+ *  \version 1.0
+ */
+static long json_load_benchmark(Detector& /* description */, int argc, char** argv)  {
+  string input;
+  long scale = 1, repeat = 5;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) && i+1 < argc )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-scale",argv[i],4) && i+1 < argc )
+      scale = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-repeat",argv[i],4) && i+1 < argc )
+      repeat = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || input.empty() || scale < 1 || repeat < 1 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_JsonLoadBenchmark                        \n"
+      "     -input       <string>    JSON file to be loaded.                         \n"
+      "     -scale       <number>    Replicate the top level members <number> times. \n"
+      "     -repeat      <number>    Number of documents loaded.                     \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  string file = scale > 1 ? replicate(input, scale) : input;
+  Signature sig_ptree, sig_fast;
+  size_t num_bad = 0, arena = 0, buffer = 0;
+  double t_ptree = 0e0, t_fast = 0e0;
+  size_t m_ptree = 0, m_fast = 0;
+  TTimeStamp start, stop;
+  {
+    vector<unique_ptr<json::fast::Document> > docs;
+    size_t mem = resident_memory();
+    start = TTimeStamp();
+    for( long i=0; i<repeat; ++i )  {
+      docs.emplace_back(new json::fast::Document(file));
+      if ( !docs.back()->load(file) )  {
+        if ( scale > 1 ) ::unlink(file.c_str());
+        except("JsonBenchmark","+++ Failed to parse %s: %s [Line:%d Column:%d]",
+               input.c_str(), docs.back()->errorMessage().c_str(),
+               docs.back()->errorLine(), docs.back()->errorColumn());
+      }
+    }
+    stop = TTimeStamp();
+    size_t now = resident_memory();
+    m_fast = now > mem ? now-mem : 0;
+    t_fast = stop.AsDouble()-start.AsDouble();
+    signature(docs[0].get(), sig_fast, num_bad);
+    arena  = docs[0]->arenaSize();
+    buffer = docs[0]->bufferSize();
+  }
+  try  {
+    vector<unique_ptr<ptree> > docs;
+    size_t mem = resident_memory();
+    start = TTimeStamp();
+    for( long i=0; i<repeat; ++i )  {
+      docs.emplace_back(new ptree());
+      boost::property_tree::read_json(file, *docs.back());
+    }
+    stop = TTimeStamp();
+    size_t now = resident_memory();
+    m_ptree = now > mem ? now-mem : 0;
+    t_ptree = stop.AsDouble()-start.AsDouble();
+    signature(*docs[0], sig_ptree);
+  }
+  catch(const exception& e)  {
+    if ( scale > 1 ) ::unlink(file.c_str());
+    except("JsonBenchmark","+++ Failed to parse %s with the property tree: %s",input.c_str(),e.what());
+  }
+  if ( scale > 1 ) ::unlink(file.c_str());
+
+  printout(ALWAYS,"JsonBenchmark","+=========================================================================");
+  printout(ALWAYS,"JsonBenchmark","+  %s x %ld: %ld values %ld numbers, %.1f kB text, %.1f kB arena",
+           input.substr(input.rfind('/')+1).c_str(), scale, long(sig_fast.values), long(sig_fast.numbers),
+           double(buffer)/1024e0, double(arena)/1024e0);
+  result("In-situ parser:", repeat, t_fast, m_fast);
+  result("Boost property tree:", repeat, t_ptree, m_ptree);
+  printout(ALWAYS,"JsonBenchmark","+=========================================================================");
+  if ( !(sig_ptree == sig_fast) )  {
+    except("JsonBenchmark","+++ Property tree: %ld values, in-situ parser: %ld values or the content differs.",
+           long(sig_ptree.values), long(sig_fast.values));
+  }
+  else if ( num_bad > 0 )  {
+    except("JsonBenchmark","+++ %ld of %ld numbers were not converted correctly.",
+           long(num_bad), long(sig_fast.numbers));
+  }
+  printout(ALWAYS,"JsonBenchmark","+  Both parsers loaded identical %ld values.",long(sig_fast.values));
+  return 1;
+}
+
+DECLARE_APPLY(DD4hep_JsonLoadBenchmark,json_load_benchmark)
@@ -38,7 +38,6 @@
 
 // C/C++ include files
 #include <iostream>
-#include "boost/property_tree/json_parser.hpp"
 
 namespace {
   class Json;
@@ -0,0 +1,124 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_ParallelDetectorScanBenchmark -threads 4 -repeat 10
+
+   Scan the detector element tree sequentially with the DetectorScanner
+   and in parallel with the DetectorParallelScanner. The processor
+   collects the path and the placement path of every detector element.
+   The ordered results of both scans must be identical.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/DetectorProcessor.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <cerrno>
+#include <cstring>
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+  /// Element description collected by the processors. Only uses cached, read-only data
+  string describe(DetElement de, int level)  {
+    PlacedVolume pv = de.placement();
+    return to_string(level) + " " + de.path() + " " + (pv.isValid() ? pv.name() : "--");
+  }
+
+  /// Print a single line of the benchmark summary
+  void result(const char* what, size_t count, double seconds)  {
+    printout(ALWAYS,"ScanBenchmark","+  %-28s %10ld elements %10.4f seconds",
+             what, long(count), seconds);
+  }
+}
+
+/// Plugin function: Benchmark of the parallel detector element scan
+/**
+ *  Factory: DD4hep_ParallelDetectorScanBenchmark
+ *
+ *  \version 1.0
+ */
+static long parallel_scan_benchmark(Detector& description, int argc, char** argv)  {
+  int  num_threads = 4, repeat = 10;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-threads",argv[i],4) && i+1 < argc )
+      num_threads = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-repeat",argv[i],4) && i+1 < argc )
+      repeat = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || num_threads < 1 || repeat < 1 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_ParallelDetectorScanBenchmark            \n"
+      "     -threads     <number>    Number of threads of the parallel scan.         \n"
+      "     -repeat      <number>    Number of scans of the detector element tree.   \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  DetElement world = description.world();
+  vector<string> sequential, parallel;
+  // Fill the caches of all paths before the concurrent access
+  DetectorScanner().scan([](DetElement de, int)  { de.path(); return 1; }, world);
+
+  TTimeStamp start, stop;
+  printout(ALWAYS,"ScanBenchmark","+=========================================================================");
+  start = TTimeStamp();
+  for( int i=0; i<repeat; ++i )  {
+    sequential.clear();
+    DetectorScanner().scan([&sequential](DetElement de, int level)  {
+        sequential.emplace_back(describe(de, level));
+        return 1;
+      }, world);
+  }
+  stop = TTimeStamp();
+  result("Sequential scan:", sequential.size()*repeat, stop.AsDouble()-start.AsDouble());
+
+  DetectorParallelScanner scanner(num_threads);
+  start = TTimeStamp();
+  for( int i=0; i<repeat; ++i )  {
+    parallel = scanner.collect<string>([](DetElement de, int level, vector<string>& items)  {
+        items.emplace_back(describe(de, level));
+        return 1;
+      }, world);
+  }
+  stop = TTimeStamp();
+  string what = "Parallel scan, " + to_string(scanner.numThreads()) + " threads:";
+  result(what.c_str(), parallel.size()*repeat, stop.AsDouble()-start.AsDouble());
+  printout(ALWAYS,"ScanBenchmark","+=========================================================================");
+
+  if ( parallel != sequential )  {
+    except("ScanBenchmark","+++ Parallel scan collected %ld elements, sequential scan %ld elements "
+           "or the order differs.", long(parallel.size()), long(sequential.size()));
+  }
+  printout(ALWAYS,"ScanBenchmark","+  Parallel and sequential scan collected identical %ld elements.",
+           long(parallel.size()));
+  return 1;
+}
+
+DECLARE_APPLY(DD4hep_ParallelDetectorScanBenchmark,parallel_scan_benchmark)
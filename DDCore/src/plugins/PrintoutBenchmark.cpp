@@ -0,0 +1,188 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -plugin DD4hep_PrintoutBenchmark -threads 4 -messages 100000
+
+   Every thread issues <messages> INFO messages followed by 10 identical
+   messages, first with the synchronous and then with the asynchronous
+   printer. The messages are written to /dev/null by a printer function,
+   which checks that the messages of every thread arrive in order, that
+   none is lost and that the identical messages are coalesced.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+
+  /// Printer function target: writes to /dev/null and checks the message order
+  struct Sink  {
+    mutex        lock;
+    FILE*        output      = 0;
+    vector<long> last;
+    size_t       messages    = 0;
+    size_t       repeated    = 0;
+    size_t       dropped     = 0;
+    size_t       disordered  = 0;
+
+    void reset(size_t num_threads)  {
+      last.assign(num_threads, -1);
+      messages = repeated = dropped = disordered = 0;
+    }
+  };
+
+  size_t sink_printer(void* arg, PrintLevel lvl, const char* src, const char* text)  {
+    Sink* s = (Sink*)arg;
+    int   thread_id = 0;
+    long  number = 0;
+    lock_guard<mutex> guard(s->lock);
+    if ( 2 == ::sscanf(text, "Thread %d message %ld", &thread_id, &number) )  {
+      if ( thread_id >= 0 && size_t(thread_id) < s->last.size() )  {
+        if ( number <= s->last[thread_id] ) ++s->disordered;
+        s->last[thread_id] = number;
+      }
+      ++s->messages;
+    }
+    else if ( 1 == ::sscanf(text, "+++ Last message repeated %ld times", &number) )
+      s->repeated += number;
+    else if ( 1 == ::sscanf(text, "+++ %ld messages were dropped", &number) )
+      s->dropped += number;
+    else
+      ++s->messages;
+    return ::fprintf(s->output, "%-16s %d %s\n", src, int(lvl), text);
+  }
+
+  /// Issue the messages of one thread
+  void issue(int thread_id, long num_messages)  {
+    for( long i=0; i<num_messages; ++i )
+      printout(INFO,"PrintBenchmark","Thread %d message %ld value: %f", thread_id, i, double(i)*1.5);
+    for( int i=0; i<10; ++i )
+      printout(INFO,"PrintBenchmark","Thread %d finished", thread_id);
+  }
+
+  /// Issue the messages of all threads. Returns the time until all threads are done
+  double run(size_t num_threads, long num_messages)  {
+    vector<thread> threads;
+    TTimeStamp start;
+    for( size_t i=0; i<num_threads; ++i )
+      threads.emplace_back(issue, int(i), num_messages);
+    for( auto& t : threads ) t.join();
+    TTimeStamp stop;
+    return stop.AsDouble()-start.AsDouble();
+  }
+
+  /// Print a single line of the benchmark summary
+  void result(const char* what, size_t count, double seconds, double total)  {
+    printout(ALWAYS,"PrintBenchmark","+  %-24s %10ld messages %10.4f seconds %8.3f us/msg  written after %10.4f seconds",
+             what, long(count), seconds, count>0 ? 1e6*seconds/double(count) : 0e0, total);
+  }
+}
+
+/// Plugin function: Benchmark of the synchronous and the asynchronous printout
+/**
+ *  Factory: DD4hep_PrintoutBenchmark
+ *
+ *  \version 1.0
+ */
+static long printout_benchmark(Detector& /* description */, int argc, char** argv)  {
+  long num_threads = 4, num_messages = 100000;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-threads",argv[i],4) && i+1 < argc )
+      num_threads = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-messages",argv[i],4) && i+1 < argc )
+      num_messages = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || num_threads < 1 || num_messages < 1 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_PrintoutBenchmark                        \n"
+      "     -threads     <number>    Number of threads issuing messages.             \n"
+      "     -messages    <number>    Number of messages per thread.                  \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  Sink sink;
+  sink.output = ::fopen("/dev/null","w");
+  if ( !sink.output )  {
+    except("PrintBenchmark","+++ Cannot open /dev/null: %s",::strerror(errno));
+  }
+  size_t expected = size_t(num_threads)*size_t(num_messages+1);
+  size_t repeats  = size_t(num_threads)*9;
+  PrintLevel level = setPrintLevel(INFO);
+  setPrinter(&sink, sink_printer);
+
+  sink.reset(num_threads);
+  double t_sync = run(num_threads, num_messages);
+  Sink sync_result;
+  sync_result.messages   = sink.messages;
+  sync_result.disordered = sink.disordered;
+
+  sink.reset(num_threads);
+  // Ring buffers large enough to hold all messages of a thread: nothing is dropped
+  setAsyncPrinter(true, size_t(num_messages+10)*128);
+  TTimeStamp start;
+  double t_async = run(num_threads, num_messages);
+  flushPrinter();
+  TTimeStamp stop;
+  setAsyncPrinter(false);
+  double t_written = stop.AsDouble()-start.AsDouble();
+
+  setPrinter(0, 0);
+  setPrintLevel(level);
+  ::fclose(sink.output);
+
+  printout(ALWAYS,"PrintBenchmark","+=========================================================================");
+  result("Synchronous printer:", sync_result.messages, t_sync, t_sync);
+  result("Asynchronous printer:", sink.messages+sink.repeated, t_async, t_written);
+  printout(ALWAYS,"PrintBenchmark","+  Asynchronous printer: %ld written, %ld coalesced, %ld dropped, %ld out of order",
+           long(sink.messages), long(sink.repeated), long(sink.dropped), long(sink.disordered));
+  printout(ALWAYS,"PrintBenchmark","+=========================================================================");
+  if ( sync_result.messages != size_t(num_threads)*size_t(num_messages+10) || sync_result.disordered > 0 )  {
+    except("PrintBenchmark","+++ Synchronous printer: %ld messages, %ld out of order.",
+           long(sync_result.messages), long(sync_result.disordered));
+  }
+  if ( sink.messages != expected || sink.repeated != repeats || sink.dropped > 0 || sink.disordered > 0 )  {
+    except("PrintBenchmark","+++ Asynchronous printer: %ld of %ld messages, %ld of %ld coalesced, "
+           "%ld dropped, %ld out of order.", long(sink.messages), long(expected),
+           long(sink.repeated), long(repeats), long(sink.dropped), long(sink.disordered));
+  }
+  printout(ALWAYS,"PrintBenchmark","+  All %ld messages were written in order by both printers.",
+           long(sync_result.messages));
+  return 1;
+}
+
+DECLARE_APPLY(DD4hep_PrintoutBenchmark,printout_benchmark)
@@ -693,11 +693,11 @@ static long dump_volume_tree(Detector& description, int argc, char** argv) {
         }
         // Top level volume! have no volume ids
         if ( m_printVolIDs && ideal && ideal->GetMotherVolume() )  {
-          PlacedVolume::VolIDs vid = pv.volIDs();
+          const PlacedVolume::VolIDCodes& vid = pv.volIDCodes();
           if ( !vid.empty() )  {
             sensitive = true;
             log << " VolID: ";
-            volids.insert(volids.end(),vid.begin(),vid.end());
+            volids.append(vid);
             for( const auto& i : volids )  {
               ::snprintf(fmt, sizeof(fmt), "%s:%2d ",i.first.c_str(),i.second);
               log << fmt;
@@ -91,8 +91,9 @@ VolIDTest::VolIDTest(Detector& description, DetElement sdet, size_t depth) : m_m
   m_iddesc = description.sensitiveDetector(m_det.name()).readout().idSpec();
   //walk(m_det,VolIDs(),Chain(),0,depth);
   PlacedVolume pv  = sdet.placement();
-  VolIDs       ids = pv.volIDs();
+  VolIDs       ids;
   Chain        chain;
+  ids.append(pv.volIDCodes());
   chain.push_back(pv);
   checkVolume(sdet, pv, ids, chain);
   walkVolume(sdet, pv, ids, chain, 1, depth);
@@ -284,7 +285,7 @@ void VolIDTest::walkVolume(DetElement detector, PlacedVolume pv, VolIDs ids, con
 
       place.access(); // Test validity
       child_chain.push_back(place);
-      child_ids.insert(child_ids.end(), place.volIDs().begin(), place.volIDs().end());
+      child_ids.append(place.volIDCodes());
       //bool is_sensitive = place.volume().isSensitive();
       //if ( is_sensitive || !child_ids.empty() )  {
       checkVolume(detector, place, child_ids, child_chain);
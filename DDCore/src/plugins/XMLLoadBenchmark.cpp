@@ -0,0 +1,225 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_XMLLoadBenchmark \
+   -input ${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -input ${DD4hep_DIR}/examples/CLICSiD/compact/materials.xml -repeat 50
+
+   Every input file is loaded <repeat> times with the XML backend of the
+   DocumentHandler (TinyXML, XercesC or the in-situ parser) and with the
+   in-situ parser. All loaded documents are kept in memory until the end
+   of the pass to measure the resident memory of the document trees.
+   Both trees must contain the same elements and attributes.
+
+   The DocumentHandler backend is chosen when DD4hep is configured
+   (DD4HEP_USE_XERCESC, DD4HEP_USE_FASTXML or TinyXML by default) and only
+   one of them is compiled in. A run therefore compares the in-situ parser
+   against one backend: the comparison with TinyXML and with XercesC needs
+   one build of each. The backend is printed in the summary.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "XML/DocumentHandler.h"
+#include "XML/XMLElements.h"
+#include "XML/XMLTags.h"
+#include "XML/FastXML.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <memory>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/resource.h>
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+
+  /// Element and attribute count and content hash of a document tree
+  struct Signature  {
+    size_t elements   = 0;
+    size_t attributes = 0;
+    size_t hash       = 0;
+    bool operator==(const Signature& s) const
+    {  return elements == s.elements && attributes == s.attributes && hash == s.hash;  }
+  };
+
+  /// Combine the element tag and the attributes into the signature.
+  /** Attributes are combined independent of their order: XercesC does not preserve it. */
+  void combine(Signature& sig, const string& tag, size_t attr_hash)  {
+    sig.hash = sig.hash*31 + std::hash<string>()(tag);
+    sig.hash = sig.hash*31 + attr_hash;
+    ++sig.elements;
+  }
+
+  /// Signature of an element tree loaded with the DocumentHandler backend
+  void signature(xml::Handle_t elt, Signature& sig)  {
+    size_t attr_hash = 0;
+    for( const auto a : elt.attributes() )  {
+      attr_hash += std::hash<string>()(xml::_toString(elt.attr_name(a)) + '=' +
+                                       xml::_toString(elt.attr_value(a)));
+      ++sig.attributes;
+    }
+    combine(sig, elt.tag(), attr_hash);
+    for( xml::Collection_t c(elt, _U(star)); c; ++c )
+      signature(c, sig);
+  }
+
+  /// Signature of an element tree loaded with the in-situ parser
+  void signature(const xml::fast::Node* elt, Signature& sig)  {
+    size_t attr_hash = 0;
+    for( const xml::fast::Attr* a = elt->getFirstAttribute(); a; a = a->next )  {
+      attr_hash += std::hash<string>()(xml::_toString(a->name) + '=' + xml::_toString(a->value));
+      ++sig.attributes;
+    }
+    combine(sig, elt->getTagName(), attr_hash);
+    for( const xml::fast::Node* c = elt->firstChildElement(); c; c = c->nextSiblingElement() )
+      signature(c, sig);
+  }
+
+  /// Resident memory of the process in bytes
+  size_t resident_memory()  {
+    long pages = 0, resident = 0;
+    FILE* f = ::fopen("/proc/self/statm","r");
+    if ( f )  {
+      if ( 2 != ::fscanf(f,"%ld %ld",&pages,&resident) ) resident = 0;
+      ::fclose(f);
+    }
+    return size_t(resident)*size_t(::sysconf(_SC_PAGESIZE));
+  }
+
+  /// Print a single line of the benchmark summary
+  void result(const char* what, size_t count, double seconds, size_t memory)  {
+    printout(ALWAYS,"XMLBenchmark","+  %-28s %6ld documents %10.4f seconds %10.2f ms/doc %10.1f kB/doc",
+             what, long(count), seconds, count>0 ? 1e3*seconds/double(count) : 0e0,
+             count>0 ? double(memory)/1024e0/double(count) : 0e0);
+  }
+}
+
+/// Plugin function: Benchmark of the XML document loading
+/**
+ *  Factory: DD4hep_XMLLoadBenchmark
+ *
+ *  \version 1.0
+ */
+static long xml_load_benchmark(Detector& /* description */, int argc, char** argv)  {
+  vector<string> inputs;
+  int  repeat = 50;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) && i+1 < argc )
+      inputs.emplace_back(argv[++i]);
+    else if ( 0 == ::strncmp("-repeat",argv[i],4) && i+1 < argc )
+      repeat = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || inputs.empty() || repeat < 1 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_XMLLoadBenchmark                         \n"
+      "     -input       <string>    XML file to be loaded. May be repeated.         \n"
+      "     -repeat      <number>    Number of documents loaded per input file.      \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  size_t num_docs = inputs.size()*repeat, num_diff = 0;
+  double t_handler = 0e0, t_fast = 0e0;
+  size_t m_handler = 0, m_fast = 0;
+  TTimeStamp start, stop;
+  printout(ALWAYS,"XMLBenchmark","+=========================================================================");
+  printout(ALWAYS,"XMLBenchmark","+  DocumentHandler backend: %s",XML_IMPLEMENTATION_TYPE);
+#if defined(DD4HEP_USE_FASTXML)
+  printout(ALWAYS,"XMLBenchmark","+  The backend is the in-situ parser: no other parser is compared in this build.");
+#endif
+  PrintLevel level = setPrintLevel(WARNING);
+  for( const auto& input : inputs )  {
+    Signature sig_handler, sig_fast;
+    {
+      xml::DocumentHandler handler;
+      vector<xml::Document> docs;
+      size_t mem = resident_memory();
+      start = TTimeStamp();
+      for( int i=0; i<repeat; ++i )  {
+        docs.emplace_back(handler.load(input));
+        if ( !docs.back().ptr() )  {
+          except("XMLBenchmark","+++ Failed to load %s with the DocumentHandler.",input.c_str());
+        }
+      }
+      stop = TTimeStamp();
+      size_t now = resident_memory();
+      m_handler += now > mem ? now-mem : 0;
+      t_handler += stop.AsDouble()-start.AsDouble();
+      signature(docs[0].root(), sig_handler);
+      for( auto& d : docs )
+        xml::DocumentHolder holder(d.ptr());
+    }
+    {
+      vector<unique_ptr<xml::fast::Document> > docs;
+      size_t mem = resident_memory();
+      start = TTimeStamp();
+      for( int i=0; i<repeat; ++i )  {
+        docs.emplace_back(new xml::fast::Document(input));
+        if ( !docs.back()->load(input) )  {
+          except("XMLBenchmark","+++ Failed to parse %s: %s [Line:%d Column:%d]",
+                 input.c_str(), docs.back()->errorMessage().c_str(),
+                 docs.back()->errorLine(), docs.back()->errorColumn());
+        }
+      }
+      stop = TTimeStamp();
+      size_t now = resident_memory();
+      m_fast += now > mem ? now-mem : 0;
+      t_fast += stop.AsDouble()-start.AsDouble();
+      signature(docs[0]->getDocumentElement(), sig_fast);
+    }
+    printout(ALWAYS,"XMLBenchmark","+  %-60s %6ld elements %6ld attributes",
+             input.substr(input.rfind('/')+1).c_str(), long(sig_fast.elements), long(sig_fast.attributes));
+    if ( !(sig_handler == sig_fast) )  {
+      printout(ALWAYS,"XMLBenchmark","+  %s: DocumentHandler %ld elements %ld attributes, "
+               "in-situ parser %ld elements %ld attributes or the content differs.",
+               input.c_str(), long(sig_handler.elements), long(sig_handler.attributes),
+               long(sig_fast.elements), long(sig_fast.attributes));
+      ++num_diff;
+    }
+  }
+  setPrintLevel(level);
+  result("DocumentHandler:", num_docs, t_handler, m_handler);
+  result("In-situ parser:", num_docs, t_fast, m_fast);
+  struct rusage usage;
+  ::getrusage(RUSAGE_SELF, &usage);
+  printout(ALWAYS,"XMLBenchmark","+  Peak resident memory: %ld kB",long(usage.ru_maxrss));
+  printout(ALWAYS,"XMLBenchmark","+=========================================================================");
+
+  if ( num_diff > 0 )  {
+    except("XMLBenchmark","+++ %ld of %ld documents differ between the parsers.",
+           long(num_diff), long(inputs.size()));
+  }
+  printout(ALWAYS,"XMLBenchmark","+  All %ld documents are identical with both parsers.",long(inputs.size()));
+  return 1;
+}
+
+DECLARE_APPLY(DD4hep_XMLLoadBenchmark,xml_load_benchmark)
@@ -50,10 +50,9 @@ CartesianGridXY::~CartesianGridXY() {
 
 /// determine the position based on the cell ID
 Vector3D CartesianGridXY::position(const CellID& cID) const {
-	_decoder->setValue(cID);
 	Vector3D cellPosition;
-	cellPosition.X = binToPosition((*_decoder)[_xId].value(), _gridSizeX, _offsetX);
-	cellPosition.Y = binToPosition((*_decoder)[_yId].value(), _gridSizeY, _offsetY);
+	cellPosition.X = binToPosition((*_decoder)[_xId].value(cID), _gridSizeX, _offsetX);
+	cellPosition.Y = binToPosition((*_decoder)[_yId].value(cID), _gridSizeY, _offsetY);
 	return cellPosition;
 }
 
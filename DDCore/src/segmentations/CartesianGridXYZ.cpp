@@ -43,11 +43,10 @@ CartesianGridXYZ::~CartesianGridXYZ() {
 
 /// determine the position based on the cell ID
 Vector3D CartesianGridXYZ::position(const CellID& cID) const {
-	_decoder->setValue(cID);
 	Vector3D cellPosition;
-	cellPosition.X = binToPosition((*_decoder)[_xId].value(), _gridSizeX, _offsetX);
-	cellPosition.Y = binToPosition((*_decoder)[_yId].value(), _gridSizeY, _offsetY);
-	cellPosition.Z = binToPosition((*_decoder)[_zId].value(), _gridSizeZ, _offsetZ);
+	cellPosition.X = binToPosition((*_decoder)[_xId].value(cID), _gridSizeX, _offsetX);
+	cellPosition.Y = binToPosition((*_decoder)[_yId].value(cID), _gridSizeY, _offsetY);
+	cellPosition.Z = binToPosition((*_decoder)[_zId].value(cID), _gridSizeZ, _offsetZ);
 	return cellPosition;
 }
 
@@ -52,11 +52,10 @@ CartesianGridXZ::~CartesianGridXZ() {
 
 /// determine the position based on the cell ID
 Vector3D CartesianGridXZ::position(const CellID& cID) const {
-	_decoder->setValue(cID);
 	vector<double> localPosition(3);
 	Vector3D cellPosition;
-	cellPosition.X = binToPosition((*_decoder)[_xId].value(), _gridSizeX, _offsetX);
-	cellPosition.Z = binToPosition((*_decoder)[_zId].value(), _gridSizeZ, _offsetZ);
+	cellPosition.X = binToPosition((*_decoder)[_xId].value(cID), _gridSizeX, _offsetX);
+	cellPosition.Z = binToPosition((*_decoder)[_zId].value(cID), _gridSizeZ, _offsetZ);
 	return cellPosition;
 }
 
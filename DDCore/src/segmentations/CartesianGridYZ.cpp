@@ -51,10 +51,9 @@ CartesianGridYZ::~CartesianGridYZ() {
 
 /// determine the position based on the cell ID
 Vector3D CartesianGridYZ::position(const CellID& cID) const {
-	_decoder->setValue(cID);
 	Vector3D cellPosition;
-	cellPosition.Y = binToPosition((*_decoder)[_yId].value(), _gridSizeY, _offsetY);
-	cellPosition.Z = binToPosition((*_decoder)[_zId].value(), _gridSizeZ, _offsetZ);
+	cellPosition.Y = binToPosition((*_decoder)[_yId].value(cID), _gridSizeY, _offsetY);
+	cellPosition.Z = binToPosition((*_decoder)[_zId].value(cID), _gridSizeZ, _offsetZ);
 	return cellPosition;
 }
 
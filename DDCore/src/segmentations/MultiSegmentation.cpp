@@ -11,12 +11,18 @@
 
 using namespace std;
 
+namespace {
+  /// Maximal number of entries of the dense lookup table. Larger key ranges are scanned
+  const unsigned long MAX_LOOKUP_SIZE = 1UL << 16;
+}
+
 namespace dd4hep {
   namespace DDSegmentation {
 
     /// default constructor using an encoding string
     MultiSegmentation::MultiSegmentation(const string& cellEncoding)
-      :	Segmentation(cellEncoding), m_discriminator(0), m_debug(0)
+      :	Segmentation(cellEncoding), m_discriminator(0), m_keyMin(0),
+        m_keyMask(0), m_keyOffset(0), m_keyWidth(0), m_keySigned(false), m_debug(0)
     {
       // define type and description
       _type        = "MultiSegmentation";
@@ -27,7 +33,8 @@ namespace dd4hep {
 
     /// Default constructor used by derived classes passing an existing decoder
     MultiSegmentation::MultiSegmentation(BitField64* decode)
-      :	Segmentation(decode), m_discriminator(0), m_debug(0)
+      :	Segmentation(decode), m_discriminator(0), m_keyMin(0),
+        m_keyMask(0), m_keyOffset(0), m_keyWidth(0), m_keySigned(false), m_debug(0)
     {
       // define type and description
       _type        = "MultiSegmentation";
@@ -50,6 +57,33 @@ namespace dd4hep {
       e.key_max = key_max;
       e.segmentation = entry;
       m_segmentations.push_back(e);
+      buildLookup();
+    }
+
+    /// Rebuild the lookup table from the sub-segmentation container
+    void MultiSegmentation::buildLookup()   {
+      m_lookup.clear();
+      if ( m_segmentations.empty() ) return;
+      long kmin = m_segmentations.front().key_min, kmax = m_segmentations.front().key_max;
+      for(const Entry& e : m_segmentations)  {
+        kmin = min(kmin, e.key_min);
+        kmax = max(kmax, e.key_max);
+      }
+      // Very sparse or very wide key ranges keep the linear scan
+      // Differences are taken unsigned: the keys may span the full range of long
+      if ( kmax < kmin || (unsigned long)kmax - (unsigned long)kmin >= MAX_LOOKUP_SIZE ) return;
+      m_keyMin = kmin;
+      m_lookup.resize((unsigned long)kmax - (unsigned long)kmin + 1, 0);
+      // Overlapping ranges: the first matching entry wins as for the scan
+      for(const Entry& e : m_segmentations)  {
+        if ( e.key_max < e.key_min ) continue;
+        unsigned long first = (unsigned long)e.key_min - (unsigned long)kmin;
+        unsigned long last  = (unsigned long)e.key_max - (unsigned long)kmin;
+        for(unsigned long i = first; i <= last; ++i)  {
+          Segmentation*& s = m_lookup[i];
+          if ( !s ) s = e.segmentation;
+        }
+      }
     }
 
     /// Set the underlying decoder
@@ -58,31 +92,56 @@ namespace dd4hep {
       for(Segmentations::iterator i=m_segmentations.begin(); i != m_segmentations.end(); ++i)
         (*i).segmentation->setDecoder(newDecoder);
       m_discriminator = &((*_decoder)[m_discriminatorId]);
+      m_keyMask   = m_discriminator->mask();
+      m_keyOffset = m_discriminator->offset();
+      m_keyWidth  = m_discriminator->width();
+      m_keySigned = m_discriminator->isSigned();
     }
 
-    /// 
+    /// Access subsegmentation by cell identifier
     const Segmentation& MultiSegmentation::subsegmentation(const CellID& cID)   const  {
       if ( m_discriminator )  {
-        long seg_id = m_discriminator->value(cID);
-        for(Segmentations::const_iterator i=m_segmentations.begin(); i != m_segmentations.end(); ++i)  {
-          const Entry& e = *i; 
-          if ( e.key_min<= seg_id && e.key_max >= seg_id )   {
-            Segmentation* s = e.segmentation;
-            if ( m_debug > 0 )   {
-              cout << "MultiSegmentation: id:" << setw(4) << hex << seg_id << dec << "  " << s->name();
-              const Parameters& pars = s->parameters();
-              for(Parameters::const_iterator j=pars.begin(); j!=pars.end();++j)  {
-                cout << " " << (*j)->name() << "=" << (*j)->value();
-              }
-              cout << endl;
+        long seg_id = key(cID);
+        Segmentation* s = lookup(seg_id);
+        if ( s )  {
+          if ( m_debug > 0 )   {
+            cout << "MultiSegmentation: id:" << setw(4) << hex << seg_id << dec << "  " << s->name();
+            const Parameters& pars = s->parameters();
+            for(Parameters::const_iterator j=pars.begin(); j!=pars.end();++j)  {
+              cout << " " << (*j)->name() << "=" << (*j)->value();
             }
-            return *s;
+            cout << endl;
           }
+          return *s;
         }
       }
       throw runtime_error("MultiSegmentation: Invalid sub-segmentation identifier!");;
     }
-     
+
+    /// Access the subsegmentations of a set of cell identifiers
+    void MultiSegmentation::subsegmentations(const vector<CellID>& cIDs, vector<const Segmentation*>& segs) const  {
+      size_t num_bad = 0;
+      segs.resize(cIDs.size());
+      if ( m_discriminator )  {
+        for(size_t i=0, n=cIDs.size(); i<n; ++i)  {
+          segs[i] = lookup(key(cIDs[i]));
+          num_bad += segs[i] ? 0 : 1;
+        }
+      }
+      if ( num_bad > 0 || (!m_discriminator && !cIDs.empty()) )  {
+        throw runtime_error("MultiSegmentation: Invalid sub-segmentation identifier!");
+      }
+    }
+
+    /// determine the positions of a set of cell identifiers
+    void MultiSegmentation::positions(const vector<CellID>& cIDs, vector<Vector3D>& pos) const  {
+      vector<const Segmentation*> segs;
+      subsegmentations(cIDs, segs);
+      pos.resize(cIDs.size());
+      for(size_t i=0, n=cIDs.size(); i<n; ++i)
+        pos[i] = segs[i]->position(cIDs[i]);
+    }
+
     /// determine the position based on the cell ID
     Vector3D MultiSegmentation::position(const CellID& cID) const {
       return subsegmentation(cID).position(cID);
@@ -49,10 +49,9 @@ PolarGridRPhi::~PolarGridRPhi() {
 
 /// determine the position based on the cell ID
 Vector3D PolarGridRPhi::position(const CellID& cID) const {
-	_decoder->setValue(cID);
 	Vector3D cellPosition;
-	double R = binToPosition((*_decoder)[_rId].value(), _gridSizeR, _offsetR);
-	double phi = binToPosition((*_decoder)[_phiId].value(), _gridSizePhi, _offsetPhi);
+	double R = binToPosition((*_decoder)[_rId].value(cID), _gridSizeR, _offsetR);
+	double phi = binToPosition((*_decoder)[_phiId].value(cID), _gridSizePhi, _offsetPhi);
 	
 	cellPosition.X = R * cos(phi);
 	cellPosition.Y = R * sin(phi);
@@ -49,11 +49,10 @@ PolarGridRPhi2::~PolarGridRPhi2() {
 
 /// determine the position based on the cell ID
 Vector3D PolarGridRPhi2::position(const CellID& cID) const {
-	_decoder->setValue(cID);
 	Vector3D cellPosition;
-	const int rBin = (*_decoder)[_rId].value();
+	const int rBin = (*_decoder)[_rId].value(cID);
 	double R = binToPosition(rBin, _gridRValues, _offsetR);
-	double phi = binToPosition((*_decoder)[_phiId].value(), _gridPhiValues[rBin], _offsetPhi+_gridPhiValues[rBin]*0.5);
+	double phi = binToPosition((*_decoder)[_phiId].value(cID), _gridPhiValues[rBin], _offsetPhi+_gridPhiValues[rBin]*0.5);
 
 	if ( phi < _offsetPhi) {
 	  phi += 2*M_PI;
@@ -80,7 +80,7 @@ namespace dd4hep {
     /// Goto a specified event in the file
     virtual bool GotoEvent(long event_number)  override;
     /// Load the specified event
-    Int_t ReadEvent(Long64_t n);
+    virtual Int_t ReadEvent(Long64_t n);
 
     ClassDefOverride(DDG4EventHandler,0);
   };
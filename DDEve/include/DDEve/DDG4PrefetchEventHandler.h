@@ -0,0 +1,59 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_DDEVE_DDG4PREFETCHEVENTHANDLER_H
+#define DD4HEP_DDEVE_DDG4PREFETCHEVENTHANDLER_H
+
+// Framework include files
+#include "DDEve/DDG4EventHandler.h"
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Event I/O handler for DDG4 ROOT files, which reads and decodes events in the background
+  /* A background thread with a file handle of its own reads the events
+   * around the current event (m_prefetch events before and after) and
+   * converts the hits and particles of the enabled collections.
+   * Hit collections with more than m_maxHits hits are binned in a
+   * spatial grid: every bin becomes one hit at the energy weighted
+   * position of its hits carrying their summed deposit.
+   *
+   * Enable it with the display attributes prefetch and maxHits:
+   *   <display prefetch="3" maxHits="20000"/>
+   *
+   * \version 1.0
+   * \ingroup DD4HEP_EVE
+   */
+  class DDG4PrefetchEventHandler : public DDG4EventHandler  {
+  public:
+    class Prefetcher;
+  protected:
+    /// Background reader
+    Prefetcher* m_prefetcher;
+  public:
+    /// Standard constructor
+    DDG4PrefetchEventHandler();
+    /// Default destructor
+    virtual ~DDG4PrefetchEventHandler();
+
+    /// Call functor on hit collection
+    virtual size_t collectionLoop(const std::string& collection, DDEveHitActor& actor)  override;
+    /// Loop over collection and extract particle data
+    virtual size_t collectionLoop(const std::string& collection, DDEveParticleActor& actor)  override;
+    /// Open new data file
+    virtual bool Open(const std::string& type, const std::string& file_name)  override;
+    /// Load the specified event
+    virtual Int_t ReadEvent(Long64_t n)  override;
+
+    ClassDefOverride(DDG4PrefetchEventHandler,0);
+  };
+
+}      /* End namespace dd4hep                    */
+#endif /* DD4HEP_DDEVE_DDG4PREFETCHEVENTHANDLER_H */
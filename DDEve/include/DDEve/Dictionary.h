@@ -37,6 +37,7 @@
 
 #include "DDEve/GenericEventHandler.h"
 #include "DDEve/DDG4EventHandler.h"
+#include "DDEve/DDG4PrefetchEventHandler.h"
 
 /// Namespace for the AIDA detector description toolkit
 namespace dd4hep {
@@ -75,6 +76,7 @@ namespace dd4hep {
 #pragma link C++ class dd4hep::EventHandler;
 #pragma link C++ class dd4hep::EventConsumer;
 #pragma link C++ class dd4hep::DDG4EventHandler;
+#pragma link C++ class dd4hep::DDG4PrefetchEventHandler;
 #pragma link C++ class dd4hep::GenericEventHandler;
 #pragma link C++ class dd4hep::EventControl;
 
@@ -118,6 +118,10 @@ namespace dd4hep {
     int                  m_loadLevel;
     /// Name of the event handler plugin
     std::string          m_eventHandlerName;
+    /// Number of events prefetched before and after the current event (0: no prefetch)
+    int                  m_prefetch = 0;
+    /// Hit collections with more hits are binned when prefetching (0: no binning)
+    long                 m_maxHits  = 0;
 
   public:
     /// Standard constructor
@@ -135,6 +139,10 @@ namespace dd4hep {
     void setVisLevel(int new_level)                      { m_visLevel = new_level;    }
     /// Set Eve Geometry load level in manager (either from XML or BEFORE XML file was loaded)
     void setLoadLevel(int new_level)                     { m_loadLevel = new_level;   }
+    /// Set the number of events prefetched before and after the current event
+    void setPrefetch(int num_events)                     { m_prefetch = num_events;   }
+    /// Set the number of hits above which hit collections are binned
+    void setMaxHits(long num_hits)                       { m_maxHits = num_hits;      }
     /// Set Event Handler Plugin name
     void setEventHandlerName(std::string eventHandlerName) {m_eventHandlerName = eventHandlerName;}
     /// Get Event Handler Plugin name
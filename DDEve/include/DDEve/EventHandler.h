@@ -84,6 +84,12 @@ namespace dd4hep {
     bool m_hasFile = false;
     /// Flag to indicate that an event is loaded
     bool m_hasEvent = false;
+    /// Names of the collections to be loaded (empty: all)
+    std::set<std::string> m_collections;
+    /// Number of events prefetched before and after the current event (0: no prefetch)
+    int  m_prefetch = 0;
+    /// Hit collections with more hits are binned to a level-of-detail representation (0: never)
+    long m_maxHits = 0;
   public:
     /// Standard constructor
     EventHandler() = default;
@@ -113,6 +119,8 @@ namespace dd4hep {
     virtual bool PreviousEvent() = 0;
     /// Goto a specified event in the file
     virtual bool GotoEvent(long event_number) = 0;
+    /// Restrict the loaded collections, set the prefetch depth and the hit decimation threshold
+    virtual void configure(const std::set<std::string>& collections, int prefetch, long max_hits);
 
     ClassDef(EventHandler,0);
   };
@@ -0,0 +1,367 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework include files
+#include "DDEve/DDG4PrefetchEventHandler.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/Objects.h"
+#include "DD4hep/Factories.h"
+
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+// C/C++ include files
+#include <condition_variable>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <cstdlib>
+#include <cmath>
+
+using namespace std;
+using namespace dd4hep;
+
+ClassImp(DDG4PrefetchEventHandler)
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Background reader of the prefetching DDG4 event handler
+  /*
+   * \version 1.0
+   * \ingroup DD4HEP_EVE
+   */
+  class DDG4PrefetchEventHandler::Prefetcher  {
+  public:
+    /// Decoded event data
+    struct Event  {
+      Int_t                       nbytes = 0;
+      map<string, DDEveHits>      hits;
+      map<string, DDEveParticles> particles;
+    };
+    typedef shared_ptr<Event> EventPtr;
+    typedef vector<pair<string, EventHandler::CollectionType> > Collections;
+
+    /// Name of the data file
+    string                   fileName;
+    /// Enabled collections
+    Collections              collections;
+    /// Function pointer to interprete hits
+    HitAccessor_t            hitConverter;
+    /// Function pointer to interprete particles
+    ParticleAccessor_t       particleConverter;
+    /// Number of events prefetched before and after the target event
+    Long64_t                 depth;
+    /// Hit collections with more hits are binned
+    size_t                   maxHits;
+    /// Number of entries in the file
+    Long64_t                 numEntries;
+    /// Decoded events around the target event
+    map<Long64_t, EventPtr>  cache;
+    /// The event currently displayed
+    EventPtr                 current;
+    /// The event requested by the display
+    Long64_t                 target = -1;
+    /// Flag to stop the reader thread
+    bool                     stop = false;
+    /// Error message of the reader thread
+    string                   error;
+    /// Lock protecting the cache
+    mutex                    lock;
+    /// Condition signalled to the reader thread
+    condition_variable       work;
+    /// Condition signalled by the reader thread
+    condition_variable       done;
+    /// Reader thread
+    thread                   worker;
+
+    /// Initializing constructor: starts the reader thread
+    Prefetcher(const string& file_name, const Collections& colls, HitAccessor_t hits, ParticleAccessor_t parts,
+               Long64_t prefetch, size_t max_hits, Long64_t num_entries)
+      : fileName(file_name), collections(colls), hitConverter(hits), particleConverter(parts),
+        depth(prefetch), maxHits(max_hits), numEntries(num_entries)
+    {
+      worker = thread([this]() { this->run(); });
+    }
+    /// Default destructor: stops the reader thread
+    ~Prefetcher()  {
+      {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+      }
+      work.notify_all();
+      worker.join();
+    }
+    /// Next entry to be read: the target event first, then alternating after and before. -1 if none
+    Long64_t next()  const  {
+      if ( target < 0 ) return -1;
+      for( Long64_t d = 0; d <= depth; ++d )  {
+        if ( target+d < numEntries && cache.find(target+d) == cache.end() )
+          return target+d;
+        if ( target-d >= 0 && cache.find(target-d) == cache.end() )
+          return target-d;
+      }
+      return -1;
+    }
+    /// Bin a hit collection to at most maxHits hits
+    void decimate(DDEveHits& hits)  const;
+    /// Read and decode one event
+    EventPtr read(TTree* tree, vector<void*>& addresses, Long64_t entry)  const;
+    /// Reader thread: read the events around the target event
+    void run();
+    /// Request an event and wait until it is decoded
+    EventPtr get(Long64_t entry);
+  };
+}
+
+namespace {
+  /// Factory entry point
+  void* _create(const char*)  {
+    EventHandler* h = new DDG4PrefetchEventHandler();
+    return h;
+  }
+  /// Accumulator of a hit bin
+  struct Bin  {
+    double x = 0, y = 0, z = 0, wx = 0, wy = 0, wz = 0, deposit = 0;
+    float  maxDeposit = -1;
+    int    particle = -1;
+    size_t count = 0;
+  };
+}
+using namespace dd4hep::detail;
+DECLARE_CONSTRUCTOR(DDEve_DDG4PrefetchEventHandler,_create)
+
+/// Bin a hit collection to at most maxHits hits
+void DDG4PrefetchEventHandler::Prefetcher::decimate(DDEveHits& hits)  const   {
+  float lo[3] = { hits[0].x, hits[0].y, hits[0].z }, hi[3] = { lo[0], lo[1], lo[2] };
+  for( const DDEveHit& h : hits )  {
+    lo[0] = min(lo[0], h.x); hi[0] = max(hi[0], h.x);
+    lo[1] = min(lo[1], h.y); hi[1] = max(hi[1], h.y);
+    lo[2] = min(lo[2], h.z); hi[2] = max(hi[2], h.z);
+  }
+  size_t n = max(size_t(1), size_t(::cbrt(double(maxHits))));
+  double cell[3];
+  for( int i=0; i<3; ++i )
+    cell[i] = hi[i] > lo[i] ? (double(hi[i])-double(lo[i]))/double(n) : 1e0;
+  map<size_t, Bin> bins;
+  for( const DDEveHit& h : hits )  {
+    size_t ix = min(n-1, size_t((double(h.x)-lo[0])/cell[0]));
+    size_t iy = min(n-1, size_t((double(h.y)-lo[1])/cell[1]));
+    size_t iz = min(n-1, size_t((double(h.z)-lo[2])/cell[2]));
+    Bin& b = bins[ix + n*(iy + n*iz)];
+    double w = h.deposit > 0 ? h.deposit : 0e0;
+    b.x  += h.x;   b.y  += h.y;   b.z  += h.z;
+    b.wx += w*h.x; b.wy += w*h.y; b.wz += w*h.z;
+    b.deposit += w;
+    if ( h.deposit > b.maxDeposit )  {
+      b.maxDeposit = h.deposit;
+      b.particle = h.particle;
+    }
+    ++b.count;
+  }
+  DDEveHits binned;
+  binned.reserve(bins.size());
+  for( const auto& i : bins )  {
+    const Bin& b = i.second;
+    if ( b.deposit > 0 )
+      binned.push_back(DDEveHit(b.particle, b.wx/b.deposit, b.wy/b.deposit, b.wz/b.deposit, b.deposit));
+    else
+      binned.push_back(DDEveHit(b.particle, b.x/b.count, b.y/b.count, b.z/b.count, 0e0));
+  }
+  hits.swap(binned);
+}
+
+/// Read and decode one event
+DDG4PrefetchEventHandler::Prefetcher::EventPtr
+DDG4PrefetchEventHandler::Prefetcher::read(TTree* tree, vector<void*>& addresses, Long64_t entry)  const  {
+  typedef vector<void*> _P;
+  EventPtr evt(new Event());
+  for( size_t i=0; i < collections.size(); ++i )  {
+    const string& nam = collections[i].first;
+    TBranch* b = tree->GetBranch(nam.c_str());
+    Int_t nb = b ? b->GetEntry(entry) : -1;
+    if ( nb < 0 )  {
+      evt->nbytes = -1;
+      return evt;
+    }
+    evt->nbytes += nb;
+    const _P* data_ptr = (const _P*)addresses[i];
+    if ( !data_ptr ) continue;
+    if ( collections[i].second == EventHandler::PARTICLE_COLLECTION )  {
+      DDEveParticles& parts = evt->particles[nam];
+      DDEveParticle part;
+      parts.reserve(data_ptr->size());
+      for( void* p : *data_ptr )
+        if ( (*particleConverter)(p,&part) ) parts.push_back(part);
+    }
+    else  {
+      DDEveHits& hits = evt->hits[nam];
+      DDEveHit hit;
+      hits.reserve(data_ptr->size());
+      for( void* p : *data_ptr )
+        if ( (*hitConverter)(p,&hit) ) hits.push_back(hit);
+      if ( maxHits > 0 && hits.size() > maxHits )
+        decimate(hits);
+    }
+  }
+  return evt;
+}
+
+/// Reader thread: read the events around the target event
+void DDG4PrefetchEventHandler::Prefetcher::run()   {
+  TFile* file = TFile::Open(fileName.c_str());
+  TTree* tree = (file && !file->IsZombie()) ? (TTree*)file->Get("EVENT") : 0;
+  vector<void*> addresses(collections.size(), (void*)0);
+  if ( !tree )  {
+    lock_guard<mutex> guard(lock);
+    error = "+++ Failed to access tree EVENT in ROOT file:"+fileName;
+  }
+  else  {
+    for( size_t i=0; i < collections.size(); ++i )  {
+      TBranch* b = tree->GetBranch(collections[i].first.c_str());
+      if ( b ) b->SetAddress(&addresses[i]);
+    }
+    for(;;)  {
+      Long64_t entry = -1;
+      {
+        unique_lock<mutex> guard(lock);
+        work.wait(guard, [this,&entry]() { return stop || (entry = next()) >= 0; });
+        if ( stop ) break;
+      }
+      EventPtr evt = read(tree, addresses, entry);
+      {
+        lock_guard<mutex> guard(lock);
+        for( auto i = cache.begin(); i != cache.end(); )  {
+          if ( ::llabs(i->first - target) > depth ) i = cache.erase(i);
+          else ++i;
+        }
+        if ( ::llabs(entry - target) <= depth ) cache[entry] = evt;
+      }
+      done.notify_all();
+    }
+  }
+  if ( file )  {
+    file->Close();
+    delete file;
+  }
+  done.notify_all();
+}
+
+/// Request an event and wait until it is decoded
+DDG4PrefetchEventHandler::Prefetcher::EventPtr DDG4PrefetchEventHandler::Prefetcher::get(Long64_t entry)   {
+  unique_lock<mutex> guard(lock);
+  target = entry;
+  work.notify_all();
+  done.wait(guard, [this,entry]() { return !error.empty() || cache.find(entry) != cache.end(); });
+  if ( !error.empty() )
+    throw runtime_error(error);
+  return current = cache[entry];
+}
+
+/// Standard constructor
+DDG4PrefetchEventHandler::DDG4PrefetchEventHandler() : DDG4EventHandler(), m_prefetcher(0)  {
+  ROOT::EnableThreadSafety();
+}
+
+/// Default destructor
+DDG4PrefetchEventHandler::~DDG4PrefetchEventHandler()   {
+  deletePtr(m_prefetcher);
+}
+
+/// Call functor on hit collection
+size_t DDG4PrefetchEventHandler::collectionLoop(const std::string& collection, DDEveHitActor& actor)   {
+  if ( m_prefetcher && m_prefetcher->current )  {
+    auto i = m_prefetcher->current->hits.find(collection);
+    if ( i != m_prefetcher->current->hits.end() )  {
+      actor.setSize(i->second.size());
+      for( const DDEveHit& hit : i->second )
+        actor(hit);
+      return i->second.size();
+    }
+  }
+  return 0;
+}
+
+/// Loop over collection and extract particle data
+size_t DDG4PrefetchEventHandler::collectionLoop(const std::string& collection, DDEveParticleActor& actor)    {
+  if ( m_prefetcher && m_prefetcher->current )  {
+    auto i = m_prefetcher->current->particles.find(collection);
+    if ( i != m_prefetcher->current->particles.end() )  {
+      actor.setSize(i->second.size());
+      for( const DDEveParticle& part : i->second )
+        actor(part);
+      return i->second.size();
+    }
+  }
+  return 0;
+}
+
+/// Load the specified event
+Int_t DDG4PrefetchEventHandler::ReadEvent(Long64_t event_number)   {
+  m_data.clear();
+  m_hasEvent = false;
+  if ( hasFile() && m_prefetcher )  {
+    if ( event_number >= m_file.second->GetEntries() )  {
+      event_number = m_file.second->GetEntries()-1;
+      printout(ERROR,"DDG4EventHandler","+++ ReadEvent: Cannot read across End-of-file! Reading last event:%lld.",(long long)event_number);
+    }
+    else if ( event_number < 0 )  {
+      event_number = 0;
+      printout(ERROR,"DDG4EventHandler","+++ nextEvent: Cannot read across Start-of-file! Reading first event:%lld.",(long long)event_number);
+    }
+    m_entry = event_number;
+    Prefetcher::EventPtr evt = m_prefetcher->get(event_number);
+    if ( evt->nbytes >= 0 )   {
+      printout(INFO,"DDG4EventHandler","+++ ReadEvent: Read %d bytes of event data for entry:%lld",
+               evt->nbytes,(long long)event_number);
+      for( const auto& c : evt->hits )  {
+        Branches::const_iterator i = m_branches.find(c.first);
+        m_data[i->second.first->GetClassName()].push_back(make_pair(i->first.c_str(),c.second.size()));
+      }
+      for( const auto& c : evt->particles )  {
+        Branches::const_iterator i = m_branches.find(c.first);
+        m_data[i->second.first->GetClassName()].push_back(make_pair(i->first.c_str(),c.second.size()));
+      }
+      m_hasEvent = true;
+      return evt->nbytes;
+    }
+    printout(ERROR,"DDG4EventHandler","+++ ReadEvent: Cannot read event data for entry:%lld",(long long)event_number);
+    throw runtime_error("+++ EventHandler::readEvent: Failed to read event");
+  }
+  throw runtime_error("+++ EventHandler::readEvent: No file open!");
+}
+
+/// Open new data file
+bool DDG4PrefetchEventHandler::Open(const std::string& type, const std::string& name)   {
+  deletePtr(m_prefetcher);
+  if ( DDG4EventHandler::Open(type, name) )  {
+    Prefetcher::Collections collections;
+    for( const auto& b : m_branches )  {
+      CollectionType typ = collectionType(b.first);
+      if ( typ == NO_COLLECTION )
+        continue;
+      else if ( !m_collections.empty() && m_collections.find(b.first) == m_collections.end() )
+        continue;
+      collections.push_back(make_pair(b.first, typ));
+    }
+    printout(INFO,"DDG4EventHandler::open","+++ Prefetch %d events around the current event. Load %ld of %ld collections.",
+             m_prefetch, long(collections.size()), long(m_branches.size()));
+    m_prefetcher = new Prefetcher(name, collections, m_simhitConverter, m_particleConverter,
+                                  max(m_prefetch,0), m_maxHits > 0 ? size_t(m_maxHits) : 0,
+                                  m_file.second->GetEntries());
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,182 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   geoPluginRun -plugin DDEve_DDG4PrefetchEventHandlerTest \
+   -input CLICSiD_Events.root -prefetch 2 -maxhits 50
+
+   Reads the events of a DDG4 ROOT file in a fixed order of forward, backward
+   and random steps once with the DDG4EventHandler and once with the
+   DDG4PrefetchEventHandler. Without decimation both handlers must deliver
+   identical hits and particles. With decimation every hit collection of the
+   prefetching handler must keep the summed energy deposit and may not have
+   more hits than requested.
+
+*/
+// Framework include files
+#include "DDEve/DDG4PrefetchEventHandler.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/Factories.h"
+
+// ROOT include files
+#include "TSystem.h"
+
+// C/C++ include files
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace dd4hep;
+
+namespace {
+
+  /// Copy the hits of a collection
+  struct HitCollector : public DDEveHitActor  {
+    DDEveHits hits;
+    virtual void operator()(const DDEveHit& h)  override  {  hits.push_back(h);  }
+  };
+
+  /// Copy the particles of a collection
+  struct ParticleCollector : public DDEveParticleActor  {
+    DDEveParticles particles;
+    virtual void operator()(const DDEveParticle& p)  override  {  particles.push_back(p);  }
+  };
+
+  bool same_hit(const DDEveHit& a, const DDEveHit& b)  {
+    return a.particle == b.particle && a.x == b.x && a.y == b.y && a.z == b.z && a.deposit == b.deposit;
+  }
+
+  bool same_particle(const DDEveParticle& a, const DDEveParticle& b)  {
+    return a.id == b.id && a.parent == b.parent && a.pdgID == b.pdgID &&
+      a.vsx == b.vsx && a.vsy == b.vsy && a.vsz == b.vsz &&
+      a.vex == b.vex && a.vey == b.vey && a.vez == b.vez &&
+      a.psx == b.psx && a.psy == b.psy && a.psz == b.psz &&
+      a.energy == b.energy && a.time == b.time && a.daughters == b.daughters;
+  }
+
+  /// Compare the current event of both handlers. Returns the number of differences
+  size_t compare(EventHandler& reference, EventHandler& prefetch, long event, long max_hits)  {
+    size_t num_errors = 0;
+    for( const auto& type : reference.data() )  {
+      for( const auto& coll : type.second )  {
+        string name = coll.first;
+        EventHandler::CollectionType typ = reference.collectionType(name);
+        if ( typ == EventHandler::PARTICLE_COLLECTION )  {
+          ParticleCollector r, p;
+          reference.collectionLoop(name, r);
+          prefetch.collectionLoop(name, p);
+          if ( r.particles.size() != p.particles.size() ||
+               !equal(r.particles.begin(), r.particles.end(), p.particles.begin(), same_particle) )  {
+            printout(ERROR,"PrefetchTest","+++ Event %ld: particles of %s differ.",event,name.c_str());
+            ++num_errors;
+          }
+        }
+        else if ( typ & EventHandler::HIT_COLLECTION )  {
+          HitCollector r, p;
+          reference.collectionLoop(name, r);
+          prefetch.collectionLoop(name, p);
+          if ( max_hits <= 0 || long(r.hits.size()) <= max_hits )  {
+            if ( r.hits.size() != p.hits.size() || !equal(r.hits.begin(), r.hits.end(), p.hits.begin(), same_hit) )  {
+              printout(ERROR,"PrefetchTest","+++ Event %ld: hits of %s differ.",event,name.c_str());
+              ++num_errors;
+            }
+            continue;
+          }
+          double r_sum = 0e0, p_sum = 0e0;
+          for( const auto& h : r.hits ) r_sum += h.deposit > 0 ? h.deposit : 0e0;
+          for( const auto& h : p.hits ) p_sum += h.deposit;
+          if ( p.hits.empty() || long(p.hits.size()) > max_hits ||
+               ::fabs(r_sum-p_sum) > 1e-5*max(r_sum, 1e-30) )  {
+            printout(ERROR,"PrefetchTest","+++ Event %ld: %s binned from %ld to %ld hits [max %ld] "
+                     "deposit %g -> %g.", event, name.c_str(), long(r.hits.size()), long(p.hits.size()),
+                     max_hits, r_sum, p_sum);
+            ++num_errors;
+          }
+        }
+      }
+    }
+    return num_errors;
+  }
+
+  /// Read the events in a fixed order with both handlers and compare them
+  size_t check(const string& input, int prefetch, long max_hits, size_t& num_reads)  {
+    DDG4EventHandler         reference;
+    DDG4PrefetchEventHandler handler;
+    handler.configure(set<string>(), prefetch, max_hits);
+    if ( !reference.Open("DDG4", input) || !handler.Open("DDG4", input) )
+      except("PrefetchTest","+++ Failed to open the DDG4 event file %s",input.c_str());
+    long last = reference.numEvents()-1;
+    if ( last < 0 )
+      except("PrefetchTest","+++ The DDG4 event file %s contains no events.",input.c_str());
+    vector<long> order;
+    for( long i=0; i <= min(last, 4L); ++i ) order.push_back(i);            // Forward
+    for( long i=min(last, 4L); i >= 0; --i ) order.push_back(i);            // Backward
+    order.insert(order.end(), { last, last/2, 0, last, max(0L,last-1) });   // Jumps
+    size_t num_errors = 0;
+    for( long evt : order )  {
+      reference.GotoEvent(evt);
+      handler.GotoEvent(evt);
+      num_errors += compare(reference, handler, evt, max_hits);
+      ++num_reads;
+    }
+    return num_errors;
+  }
+}
+
+/// Compare the prefetching DDG4 event handler with the direct reader
+/**
+ *  Factory: DDEve_DDG4PrefetchEventHandlerTest
+ *
+ *  \version 1.0
+ */
+static long prefetch_event_handler_test(Detector& /* description */, int argc, char** argv)  {
+  string input;
+  int    prefetch = 2;
+  long   max_hits = 50;
+  bool   arg_error = false;
+  for(int i = 0; i < argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-prefetch",argv[i],4) )
+      prefetch = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-maxhits",argv[i],4) )
+      max_hits = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || input.empty() || prefetch <= 0 || max_hits <= 0 )  {
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DDEve_DDG4PrefetchEventHandlerTest              \n"
+      "     -input    <string>       DDG4 ROOT event file.                           \n"
+      "     -prefetch <number>       Events prefetched around the current event.     \n"
+      "     -maxhits  <number>       Decimation threshold of the second pass.        \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+  // The hit and particle converters of the DDG4 event handlers live in the DDG4 IO library
+  if ( gSystem->Load("libDDG4IO") < 0 )
+    except("PrefetchTest","+++ Failed to load the DDG4 IO library libDDG4IO.");
+
+  size_t num_reads = 0;
+  size_t num_errors = check(input, prefetch, 0, num_reads);
+  num_errors += check(input, prefetch, max_hits, num_reads);
+  if ( num_errors > 0 )
+    except("PrefetchTest","+++ %ld differences between the prefetching and the direct event handler.",
+           long(num_errors));
+  printout(ALWAYS,"PrefetchTest","+++ Prefetching event handler agrees with the direct reader: "
+           "%ld reads, prefetch %d, maximum %ld hits.", long(num_reads), prefetch, max_hits);
+  return 1;
+}
+DECLARE_APPLY(DDEve_DDG4PrefetchEventHandlerTest,prefetch_event_handler_test)
@@ -187,6 +187,14 @@ void Display::ImportConfiguration(const DisplayConfiguration& config)   {
     m_calodataConfigs[(*j).name] = *j;
   for(j=config.collections.begin(); j!=config.collections.end(); ++j)  
     m_collectionsConfigs[(*j).name] = *j;
+
+  /// Only the configured collections are loaded by the event handler
+  set<string> collections;
+  for(DataConfigurations::const_iterator k=m_calodataConfigs.begin(); k!=m_calodataConfigs.end(); ++k)
+    collections.insert((*k).second.hits);
+  for(DataConfigurations::const_iterator k=m_collectionsConfigs.begin(); k!=m_collectionsConfigs.end(); ++k)
+    collections.insert((*k).second.name);
+  m_evtHandler->configure(collections, m_prefetch, m_maxHits);
 }
 
 /// Access to calo data histograms by name as defined in the configuration
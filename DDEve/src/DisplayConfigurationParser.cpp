@@ -272,6 +272,8 @@ template <> void Converter<display>::operator()(xml_h e)  const  {
   if ( e.hasAttr(_Unicode(visLevel)) ) d->setVisLevel(e.attr<int>(_Unicode(visLevel)));
   if ( e.hasAttr(_Unicode(eventHandler)) ) d->setEventHandlerName(e.attr<std::string>(_Unicode(eventHandler)));
   if ( e.hasAttr(_Unicode(loadLevel)) ) d->setLoadLevel(e.attr<int>(_Unicode(loadLevel)));
+  if ( e.hasAttr(_Unicode(prefetch)) ) d->setPrefetch(e.attr<int>(_Unicode(prefetch)));
+  if ( e.hasAttr(_Unicode(maxHits)) ) d->setMaxHits(e.attr<long>(_Unicode(maxHits)));
 }
 
 /** Convert display configuration elements of tag type ddeve
@@ -23,6 +23,13 @@ ClassImp(EventConsumer)
 EventHandler::~EventHandler()   {
 }
 
+/// Restrict the loaded collections, set the prefetch depth and the hit decimation threshold
+void EventHandler::configure(const std::set<std::string>& collections, int prefetch, long max_hits)   {
+  m_collections = collections;
+  m_prefetch    = prefetch;
+  m_maxHits     = max_hits;
+}
+
 /// Default destructor
 EventConsumer::~EventConsumer()   {
 }
@@ -113,6 +113,9 @@ bool GenericEventHandler::Open(const string& file_type, const string& file_name)
     else if ( idx != string::npos )   {
       m_current = (EventHandler*)PluginService::Create<void*>("DDEve_LCIOEventHandler",(const char*)0);
     }
+    else if ( idr != string::npos && m_prefetch > 0 )   {
+      m_current = (EventHandler*)PluginService::Create<void*>("DDEve_DDG4PrefetchEventHandler",(const char*)0);
+    }
     else if ( idr != string::npos )   {
       m_current = (EventHandler*)PluginService::Create<void*>("DDEve_DDG4EventHandler",(const char*)0);
     }
@@ -120,6 +123,7 @@ bool GenericEventHandler::Open(const string& file_type, const string& file_name)
       throw runtime_error("Attempt to open file:"+file_name+" of unknown type:"+file_type);
     }
     if ( m_current )   {
+      m_current->configure(m_collections, m_prefetch, m_maxHits);
       if ( m_current->Open(file_type, file_name) )   {
         m_hasFile = true;
         NotifySubscribers(&EventConsumer::OnFileOpen);
@@ -117,7 +117,6 @@ TEveElement* BoxsetCreator::element() const   {
 void BoxsetCreator::operator()(const DDEveHit& hit)   {
   double ene = hit.deposit*MEV_2_GEV <= emax ? hit.deposit*MEV_2_GEV : emax;
   TVector3 scale(ene/towerH,ene/towerH,ene/towerH);
-  cout << "Hit:" << ene << " deposit:" << hit.deposit << " " << " emax:" << emax << " towerH:" << towerH << endl;
   TVector3 p(hit.x*MM_2_CM, hit.y*MM_2_CM, hit.z*MM_2_CM);
   double phi = p.Phi();
   float s1X = -0.5*(scale(0)*std::sin(phi)+scale(2)*std::cos(phi));
@@ -19,6 +19,7 @@
 #include "DD4hep/ComponentProperties.h"
 #include "DDG4/Geant4Context.h"
 #include "DDG4/Geant4Callback.h"
+#include "DDG4/Geant4Profile.h"
 
 // Geant4 forward declarations
 class G4Run;
@@ -33,6 +34,7 @@ class G4UIdirectory;
 
 // C/C++ include files
 #include <string>
+#include <vector>
 #include <cstdarg>
 
 /// Namespace for the AIDA detector description toolkit
@@ -105,6 +107,11 @@ namespace dd4hep {
       PropertyManager    m_properties;
       /// Reference count. Initial value: 1
       long               m_refCount = 1;
+      /// Profile entries of the timed callbacks (see Geant4Profile)
+      std::vector<std::pair<const char*,Geant4ProfileEntry*> > m_profiles;
+
+      /// Access the profile entry of a callback. Created on first call
+      Geant4ProfileEntry* profileEntry(const char* callback);
 
     public:
       /// Functor to update the context of a Geant4Action object
@@ -173,6 +180,28 @@ namespace dd4hep {
           }
           return 0;
         }
+        /// Invoke all actors. If profiling is enabled, accumulate the time spent in every actor
+        template <typename R, typename Q, typename A0>
+        void timed(const char* callback, R (Q::*pmf)(A0), A0 a0) {
+          if ( !Geant4Profile::enabled() )
+            (*this)(pmf, a0);
+          else
+            for (typename _V::iterator i = m_v.begin(); i != m_v.end(); ++i)  {
+              Geant4Profile::Timer timer((*i)->profile(callback));
+              ((*i)->*pmf)(a0);
+            }
+        }
+        /// Invoke all actors. If profiling is enabled, accumulate the time spent in every actor
+        template <typename R, typename Q, typename A0, typename A1>
+        void timed(const char* callback, R (Q::*pmf)(A0, A1), A0 a0, A1 a1) {
+          if ( !Geant4Profile::enabled() )
+            (*this)(pmf, a0, a1);
+          else
+            for (typename _V::iterator i = m_v.begin(); i != m_v.end(); ++i)  {
+              Geant4Profile::Timer timer((*i)->profile(callback));
+              ((*i)->*pmf)(a0, a1);
+            }
+        }
         /// NON-CONST actions
         template <typename R, typename Q> void operator()(R (Q::*pmf)()) {
           if (m_v.empty())
@@ -267,6 +296,10 @@ namespace dd4hep {
       }
       /// Set or update client for the use in a new thread fiber
       virtual void configureFiber(Geant4Context* thread_context);
+      /// Access the profile entry of a callback (0 if profiling is disabled)
+      Geant4ProfileEntry* profile(const char* callback)  {
+        return Geant4Profile::enabled() ? profileEntry(callback) : 0;
+      }
       /// Access name of the action
       const std::string& name() const {
         return m_name;
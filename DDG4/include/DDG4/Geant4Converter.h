@@ -82,6 +82,10 @@ namespace dd4hep {
       /// Convert the geometry type volume placement into the corresponding Geant4 object(s).
       virtual void* handlePlacement(const std::string& name, const TGeoNode* node) const;
       virtual void* handleAssembly(const std::string& name, const TGeoNode* node) const;
+      /// Convert replicated placements filling their mother volume to a G4PVReplica or G4PVParameterised
+      G4VPhysicalVolume* handleReplication(const std::string& name, const TGeoVolume* mother,
+                                           G4LogicalVolume* g4vol, G4LogicalVolume* g4mot,
+                                           const PlacedVolumeExtension::Parameterisation& params) const;
 
       /// Convert the geometry type field into the corresponding Geant4 object(s).
       ///virtual void* handleField(const std::string& name, Ref_t field) const;
@@ -44,6 +44,9 @@ class G4VSensitiveDetector;
 /// Namespace for the AIDA detector description toolkit
 namespace dd4hep {
 
+  // Forward declarations
+  class BitFieldValue;
+
   /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
   namespace sim {
 
@@ -72,6 +75,9 @@ namespace dd4hep {
       typedef std::vector<ImprintEntry>                       Imprints;
       typedef std::map<Volume,Imprints>                       VolumeImprintMap;
       typedef std::map<const TGeoShape*, G4VSolid*>           SolidMap;
+      /// Volume ID field and number of copies of every dimension of a replicated placement
+      typedef std::vector<std::pair<const BitFieldValue*, size_t> > ReplicaFields;
+      typedef std::map<const G4VPhysicalVolume*, ReplicaFields> ReplicaMap;
       //typedef std::map<VisAttr, G4VisAttributes*>             VisMap;
       //typedef std::map<Geant4PlacementPath, VolumeID>         Geant4PathMap;
     }
@@ -96,6 +102,8 @@ namespace dd4hep {
       std::map<VisAttr, G4VisAttributes*>                      g4Vis;
       std::map<LimitSet, G4UserLimits*>                        g4Limits;
       std::map<Geant4PlacementPath, VolumeID>                  g4Paths;
+      /// Replicated placements: the paths map to the first copy, the copy number adds the replica fields
+      Geant4GeometryMaps::ReplicaMap                           g4Replicas;
       std::map<SensitiveDetector,std::set<const TGeoVolume*> > sensitives;
       std::map<Region,           std::set<const TGeoVolume*> > regions;
       std::map<LimitSet,         std::set<const TGeoVolume*> > limits;
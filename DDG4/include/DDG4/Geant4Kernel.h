@@ -18,6 +18,8 @@
 
 // C/C++ include files
 #include <map>
+#include <atomic>
+#include <vector>
 #include <typeinfo>
 
 // Forward declarations
@@ -32,6 +34,7 @@ namespace dd4hep {
 
     // Forward declarations
     class Geant4ActionPhase;
+    class Geant4OutputAction;
 
     /// Class, which allows all Geant4Action derivatives to access the DDG4 kernel structures.
     /**
@@ -40,11 +43,13 @@ namespace dd4hep {
      *  \ingroup DD4HEP_SIMULATION
      */
     class Geant4Kernel : public Geant4ActionContainer  {
+      friend class Geant4Exec;
     public:
       typedef std::map<unsigned long, Geant4Kernel*>    Workers;
       typedef std::map<std::string, Geant4ActionPhase*> Phases;
       typedef std::map<std::string, Geant4Action*>      GlobalActions;
       typedef std::map<std::string,int>                 ClientOutputLevels;
+      typedef std::vector<Geant4OutputAction*>          ProcessOutputs;
 
     protected:
       /// Reference to the run manager
@@ -82,8 +87,20 @@ namespace dd4hep {
       //bool        m_multiThreaded;
       /// Master property: Number of execution threads in multi threaded mode.
       int         m_numThreads;
+      /// Master property: Number of forked worker processes in multi process mode.
+      int         m_numProcesses;
+      /// Multi process mode: Worker process number (-1 if the process is not a forked worker)
+      int         m_process;
+      /// Multi process mode: Number of the first event simulated by this worker process
+      long        m_processEventOffset;
+      /// Output actions, whose worker process files are merged at the end of a multi process run
+      ProcessOutputs m_processOutputs;
       /// Flag: Master instance (id<0) or worker (id >= 0)
       unsigned long      m_id, m_ident;
+      /// Master: Number of workers created so far. Numbers the workers and their control directories
+      unsigned long      m_workerCount;
+      /// Master: Key of the worker registry. Changes when a worker is removed to invalidate the thread slots
+      std::atomic<unsigned long> m_workerKey;
       /// Parent reference
       Geant4Kernel*      m_master;
       Geant4Kernel*      m_shared;
@@ -110,6 +127,21 @@ namespace dd4hep {
       //bool isMultiThreaded() const { return m_multiThreaded; }
       bool isMultiThreaded() const { return m_numThreads > 0; }
 
+      /// Multi process mode: Number of worker processes to be forked by run()
+      int numProcesses()  const      { return m_master->m_numProcesses;       }
+      /// Multi process mode: Worker process number (-1 if the process is not a forked worker)
+      int processNumber() const      { return m_master->m_process;            }
+      /// Multi process mode: Number of the first event simulated by this worker process
+      long processEventOffset() const { return m_master->m_processEventOffset; }
+      /// Multi process mode: File name used by the worker process 'process' for the output 'name'
+      static std::string processFileName(const std::string& name, int process);
+      /// Multi process mode: File name used by this process for the output 'name'. Unchanged if not forked.
+      std::string processFileName(const std::string& name) const;
+      /// Multi process mode: Register output action to merge the worker process files. Adds a reference.
+      Geant4Kernel& registerProcessOutput(Geant4OutputAction* action);
+      /// Multi process mode: Access the output actions registered for merging
+      const ProcessOutputs& processOutputs() const  { return m_master->m_processOutputs; }
+
       /// Access thread identifier
       static unsigned long int thread_self();
 
@@ -238,10 +270,15 @@ namespace dd4hep {
       virtual void loadXML(const char* fname);
 
       /** Geant4 Multi threading support */
-      /// Create identified worker instance
+      /// Create the worker instance of the calling thread
       virtual Geant4Kernel& createWorker();
       /// Access worker instance by it's identifier
+      /** The worker of the calling thread is resolved once per thread and then
+       *  served lock free from a thread local slot.
+       */
       Geant4Kernel& worker(unsigned long thread_identifier, bool create_if=false);
+      /// Remove and delete the worker instance of a thread. The worker may no longer be in use.
+      void removeWorker(unsigned long thread_identifier);
       /// Access number of workers
       int numWorkers() const;
 
@@ -277,6 +314,10 @@ namespace dd4hep {
       static int initialize(Geant4Kernel& kernel);
       /// Run the application and simulate events
       static int run(Geant4Kernel& kernel);
+      /// Run the application and simulate events in forked worker processes
+      static int runProcesses(Geant4Kernel& kernel, long num_events);
+      /// Simulate the event range of one forked worker process
+      static int runWorkerProcess(Geant4Kernel& kernel, int process, long first, long num_events);
       /// Terminate the application
       static int terminate(Geant4Kernel& kernel);
     };
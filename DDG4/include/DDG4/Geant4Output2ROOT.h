@@ -69,6 +69,8 @@ namespace dd4hep {
 
       /// Commit data at end of filling procedure
       virtual void commit(OutputContext<G4Event>& ctxt);
+      /// Multi process mode: Merge the files of the worker processes into the output
+      virtual bool mergeProcessOutput(const std::vector<std::string>& inputs);
     };
 
   }    // End namespace sim
@@ -87,6 +87,11 @@ namespace dd4hep {
       virtual void saveCollection(OutputContext<G4Event>& ctxt, G4VHitsCollection* collection);
       /// Commit data at end of filling procedure
       virtual void commit(OutputContext<G4Event>& ctxt);
+
+      /// Multi process mode: Name of the output file written by this process
+      std::string outputFileName() const;
+      /// Multi process mode: Merge the files of the worker processes into the output. Default: no merge
+      virtual bool mergeProcessOutput(const std::vector<std::string>& inputs);
     };
 
   }    // End namespace sim
@@ -0,0 +1,61 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_DDG4_GEANT4PLACEMENTPARAMETERISATION_H
+#define DD4HEP_DDG4_GEANT4PLACEMENTPARAMETERISATION_H
+
+// Geant4 include files
+#include "G4VPVParameterisation.hh"
+#include "G4RotationMatrix.hh"
+#include "G4Transform3D.hh"
+#include "G4ThreeVector.hh"
+
+// C/C++ include files
+#include <vector>
+#include <memory>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace sim {
+
+    /// Geant4 parameterisation of replicated placements (see Volume::replicate)
+    /**
+     *  The translations and rotations of all copies are computed once from
+     *  the copies of the TGeo geometry. Copies with the same rotation share
+     *  the rotation matrix. The object is read-only after construction and
+     *  may be shared by all worker threads.
+     *
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4PlacementParameterisation : public G4VPVParameterisation  {
+    protected:
+      /// Translation of every copy
+      std::vector<G4ThreeVector>     m_translations;
+      /// Frame rotation of every copy (0 if not rotated)
+      std::vector<G4RotationMatrix*> m_rotations;
+      /// Owner of the distinct rotation matrices
+      std::vector<std::unique_ptr<G4RotationMatrix> > m_matrices;
+
+    public:
+      /// Initializing constructor: transformations of the copies in copy number order
+      Geant4PlacementParameterisation(const std::vector<G4Transform3D>& copies);
+      /// Default destructor
+      virtual ~Geant4PlacementParameterisation();
+      /// Number of copies
+      size_t count()  const  {  return m_translations.size();  }
+      /// G4VPVParameterisation overload: Position the copy
+      virtual void ComputeTransformation(const G4int copy, G4VPhysicalVolume* pv)  const  override;
+    };
+  }    // End namespace sim
+}      // End namespace dd4hep
+#endif // DD4HEP_DDG4_GEANT4PLACEMENTPARAMETERISATION_H
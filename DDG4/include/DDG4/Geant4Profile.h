@@ -0,0 +1,111 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_DDG4_GEANT4PROFILE_H
+#define DD4HEP_DDG4_GEANT4PROFILE_H
+
+// C/C++ include files
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <vector>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace sim {
+
+    /// Accumulated execution time of a profiled item: an action callback or a volume
+    /**
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4ProfileEntry  {
+    public:
+      /// Item type: "action" or "volume"
+      std::string            kind;
+      /// Item group: the callback of actions, the region of volumes
+      std::string            group;
+      /// Item name: the action or volume name
+      std::string            name;
+      /// Accumulated time in nanoseconds
+      std::atomic<long long> time  {0};
+      /// Number of calls or steps
+      std::atomic<long long> calls {0};
+
+    public:
+      /// Initializing constructor
+      Geant4ProfileEntry(const std::string& k, const std::string& g, const std::string& n)
+        : kind(k), group(g), name(n) {}
+      /// Accumulate the time of one call
+      void add(long long nanoseconds)  {
+        time.fetch_add(nanoseconds, std::memory_order_relaxed);
+        calls.fetch_add(1, std::memory_order_relaxed);
+      }
+    };
+
+    /// Registry of the execution time accounting of DDG4 simulations
+    /**
+     *  While profiling is enabled the action sequences time every action
+     *  callback. Every action instance accumulates its time in entries of
+     *  its own, so threads never share an entry. Entries are owned by the
+     *  registry and outlive the actions. Reports aggregate the entries by
+     *  kind, group and name.
+     *
+     *  While profiling is disabled the sequences only check a flag.
+     *
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4Profile  {
+    public:
+      typedef std::vector<Geant4ProfileEntry*> Entries;
+
+    private:
+      /// Flag if profiling is enabled (may be toggled while worker threads run)
+      static std::atomic<bool> s_enabled;
+
+    public:
+      /// Timer accumulating the lifetime of the object to an entry (no-op if the entry is 0)
+      class Timer  {
+        Geant4ProfileEntry* m_entry;
+        long long           m_start;
+      public:
+        /// Initializing constructor: start the timer
+        Timer(Geant4ProfileEntry* e) : m_entry(e), m_start(e ? now() : 0)  {}
+        /// No copy constructor
+        Timer(const Timer& copy) = delete;
+        /// Default destructor: stop the timer
+        ~Timer()  { if ( m_entry ) m_entry->add(now()-m_start);  }
+        /// No assignment
+        Timer& operator=(const Timer& copy) = delete;
+      };
+
+      /// Check if profiling is enabled
+      static bool enabled()  {  return s_enabled.load(std::memory_order_relaxed);  }
+      /// Enable or disable profiling
+      static void enable(bool value);
+      /// Current time in nanoseconds
+      static long long now()  {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>
+          (std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+      /// Create a new entry owned by the registry
+      static Geant4ProfileEntry* entry(const std::string& kind, const std::string& group, const std::string& name);
+      /// Aggregate all entries by kind, group and name. Sorted by decreasing time, valid until the next call
+      static Entries summary();
+      /// Reset the accumulated time of all entries
+      static void reset();
+    };
+
+  }    // End namespace sim
+}      // End namespace dd4hep
+#endif // DD4HEP_DDG4_GEANT4PROFILE_H
@@ -45,6 +45,8 @@ namespace dd4hep {
 
       /// Check the validity of the information before accessing it.
       bool checkValidity() const;
+      /// Add the volume ID fields of replicated placements to the volume ID of the first copy
+      VolumeID replicaID(const G4VTouchable* touchable, VolumeID vid) const;
 
     public:
       static const VolumeID InvalidPath = VolumeID(-1LL);
@@ -69,7 +71,7 @@ namespace dd4hep {
       /// Helper: Generate placement path from touchable object
       std::vector<const G4VPhysicalVolume*>
       placementPath(const G4VTouchable* touchable, bool exception = true) const;
-      /// Access CELLID by placement path
+      /// Access CELLID by placement path. For replicated placements this is the CELLID of the first copy
       VolumeID volumeID(const std::vector<const G4VPhysicalVolume*>& path) const;
       /// Access CELLID by Geant4 touchable object
       VolumeID volumeID(const G4VTouchable* touchable) const;
@@ -157,7 +157,7 @@ void Geant4Output2LCIO::beginRun(const G4Run* )  {
   if ( 0 == m_file && !m_output.empty() )   {
     G4AutoLock protection_lock(&action_mutex);
     m_file = lcio::LCFactory::getInstance()->createLCWriter();
-    m_file->open(m_output,lcio::LCIO::WRITE_NEW);
+    m_file->open(outputFileName(),lcio::LCIO::WRITE_NEW);
   }
 }
 
@@ -0,0 +1,164 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -volmgr -input <compact-file> -plugin DD4hep_Geant4ConversionBenchmark -check
+
+   The loaded geometry is converted to Geant4. The plugin prints the time
+   and the resident memory used by the conversion together with the number
+   of Geant4 physical volumes and the number of volume copies they represent.
+   With -check the center of every sensitive volume known to the DDCore
+   volume manager is located by the Geant4 navigator and the volume ID
+   computed by the Geant4VolumeManager is compared to the DDCore one.
+
+*/
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/VolumeManager.h"
+#include "DD4hep/detail/VolumeManagerInterna.h"
+#include "DDG4/Geant4Converter.h"
+#include "DDG4/Geant4Mapping.h"
+
+// Geant4 include files
+#include "G4Navigator.hh"
+#include "G4TouchableHistory.hh"
+#include "G4GeometryManager.hh"
+#include "G4PhysicalVolumeStore.hh"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::sim;
+
+namespace {
+
+  /// Resident memory of the process in bytes
+  size_t resident_memory()  {
+    long pages = 0, resident = 0;
+    FILE* f = ::fopen("/proc/self/statm","r");
+    if ( f )  {
+      if ( 2 != ::fscanf(f,"%ld %ld",&pages,&resident) ) resident = 0;
+      ::fclose(f);
+    }
+    return size_t(resident)*size_t(::sysconf(_SC_PAGESIZE));
+  }
+
+  /// Collect the sensitive volumes of a volume manager and all its sub-managers
+  void collect(VolumeManager mgr, map<VolumeID,VolumeManagerContext*>& volumes)  {
+    detail::VolumeManagerObject* o = mgr.ptr();
+    volumes.insert(o->volumes.begin(), o->volumes.end());
+    for( const auto& m : o->managers )
+      collect(m.second, volumes);
+  }
+
+  /// Compare the volume IDs of DDCore and DDG4 at the center of every sensitive volume
+  size_t check_volume_ids(Detector& description, Geant4GeometryInfo* info, size_t& num_volumes)  {
+    map<VolumeID,VolumeManagerContext*> volumes;
+    Geant4VolumeManager g4mgr = Geant4Mapping::instance().volumeManager();
+    G4Navigator navigator;
+    size_t num_bad = 0;
+
+    collect(description.volumeManager(), volumes);
+    num_volumes = volumes.size();
+    G4GeometryManager::GetInstance()->CloseGeometry(false);
+    navigator.SetWorldVolume(info->world());
+    for( const auto& v : volumes )  {
+      TGeoHMatrix toWorld(v.second->element.nominal().worldTransformation());
+      Double_t local[3] = {0e0, 0e0, 0e0}, global[3];
+      toWorld.Multiply(&v.second->toElement());
+      toWorld.LocalToMaster(local, global);
+      G4ThreeVector pos(global[0]*CM_2_MM, global[1]*CM_2_MM, global[2]*CM_2_MM);
+      navigator.LocateGlobalPointAndSetup(pos, 0, false, false);
+      G4TouchableHistory* touchable = navigator.CreateTouchableHistory();
+      VolumeID vid = g4mgr.volumeID(touchable);
+      if ( vid != v.first )  {
+        if ( ++num_bad <= 10 )  {
+          printout(ERROR,"G4Benchmark","+++ Volume ID mismatch at (%9.3f,%9.3f,%9.3f) cm: DDCore:%016llX DDG4:%016llX",
+                   global[0], global[1], global[2], (unsigned long long)v.first, (unsigned long long)vid);
+        }
+      }
+      delete touchable;
+    }
+    G4GeometryManager::GetInstance()->OpenGeometry();
+    return num_bad;
+  }
+}
+
+/// Plugin function: Benchmark of the conversion of the geometry to Geant4
+/**
+ *  Factory: DD4hep_Geant4ConversionBenchmark
+ *
+ *  \version 1.0
+ */
+static long geant4_conversion_benchmark(Detector& description, int argc, char** argv)  {
+  bool check = false, arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-check",argv[i],4) )
+      check = true;
+    else
+      arg_error = true;
+  }
+  if ( arg_error )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_Geant4ConversionBenchmark                \n"
+      "     -check                   Compare the volume IDs of all sensitive volumes \n"
+      "                              computed by DDCore and DDG4. Requires -volmgr.  \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+  size_t mem_start = resident_memory();
+  TTimeStamp start;
+  Geant4Converter conv(description, INFO);
+  Geant4GeometryInfo* info = conv.create(description.world()).detach();
+  TTimeStamp stop;
+  size_t mem_stop = resident_memory();
+  size_t num_pv = 0, num_copies = 0;
+
+  Geant4Mapping::instance().attach(info);
+  for( const G4VPhysicalVolume* pv : *G4PhysicalVolumeStore::GetInstance() )  {
+    num_copies += pv->IsReplicated() ? size_t(pv->GetMultiplicity()) : 1;
+    ++num_pv;
+  }
+  printout(ALWAYS,"G4Benchmark","+  Geant4 conversion:    %10.4f seconds  %12.1f kB resident memory",
+           stop.AsDouble()-start.AsDouble(), double(mem_stop-mem_start)/1024e0);
+  printout(ALWAYS,"G4Benchmark","+  Physical volumes:     %10ld          %12ld volume copies",
+           long(num_pv), long(num_copies));
+  if ( check )   {
+    if ( !description.volumeManager().isValid() )   {
+      except("G4Benchmark","+++ The volume ID check requires the volume manager (-volmgr).");
+    }
+    size_t num_volumes = 0;
+    size_t num_bad = check_volume_ids(description, info, num_volumes);
+    if ( num_bad > 0 )   {
+      except("G4Benchmark","+++ FAILED: %ld of %ld sensitive volumes have different volume IDs.",
+             long(num_bad), long(num_volumes));
+    }
+    printout(ALWAYS,"G4Benchmark","+  All %ld sensitive volume IDs agree between DDCore and DDG4.",
+             long(num_volumes));
+  }
+  return 1;
+}
+DECLARE_APPLY(DD4hep_Geant4ConversionBenchmark,geant4_conversion_benchmark)
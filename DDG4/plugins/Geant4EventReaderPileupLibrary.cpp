@@ -0,0 +1,585 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+/*
+   Plugin invocation:
+   ==================
+
+   Convert a background sample once into a pile-up library:
+
+   geoPluginRun -destroy -plugin DD4hep_Geant4PileupLibrary \
+   -reader Geant4EventReaderHepMC -input minbias.hepmc -output minbias.pileup [-check] [-mean 25]
+
+   Overlay Poisson distributed numbers of background events with the
+   Geant4InputAction and the Geant4InteractionMerger (python):
+
+   gen = DDG4.GeneratorAction(kernel,"Geant4InputAction/PileupInput")
+   gen.Input      = "Geant4EventReaderPileupLibrary|minbias.pileup"
+   gen.Parameters = {"Mean": "25"}
+   gen.Mask       = 2
+
+*/
+
+// Framework include files
+#include "DD4hep/Factories.h"
+#include "DD4hep/Memory.h"
+#include "DD4hep/Plugins.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/Primitives.h"
+#include "DDG4/Factories.h"
+#include "DDG4/Geant4Random.h"
+#include "DDG4/Geant4InputAction.h"
+
+// ROOT include files
+#include "TRandom.h"
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace sim {
+
+    /// Event reader sampling background events from a memory mapped pile-up library
+    /**
+     *  The library is a binary file of pre-decoded Geant4Particle and Geant4Vertex
+     *  records, created once from any other event reader with the plugin
+     *  DD4hep_Geant4PileupLibrary. The file is mapped read-only: no parsing is
+     *  necessary and all threads and forked worker processes share the same pages.
+     *
+     *  Parameters:
+     *  - Mean: If positive, every call returns a Poisson distributed number of
+     *          randomly chosen library events merged into one interaction.
+     *          Otherwise the library event with the requested event number is returned.
+     *
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4EventReaderPileupLibrary : public Geant4EventReader  {
+    public:
+      /// Binary file header
+      struct FileHeader  {
+        char     magic[8];
+        uint32_t version;
+        uint32_t numEvents;
+        uint64_t numParticles;
+        uint64_t numVertices;
+        uint64_t numRelations;
+      };
+      /// Binary event record: particles and vertices are contiguous
+      struct EventRecord  {
+        uint64_t firstParticle;
+        uint64_t firstVertex;
+        uint32_t numParticles;
+        uint32_t numVertices;
+        /// All particle identifiers of the event are smaller than idRange
+        int32_t  idRange;
+        uint32_t spare;
+      };
+      /// Binary particle record. Parents followed by daughters in the relation table
+      struct ParticleRecord  {
+        int32_t  id, g4Parent, reason, mask, steps, secondaries, pdgID, status;
+        int32_t  colorFlow[2], charge;
+        float    spin[3];
+        uint32_t numParents, numDaughters;
+        uint64_t firstRelation;
+        double   vsx, vsy, vsz, vex, vey, vez;
+        double   psx, psy, psz, pex, pey, pez;
+        double   mass, time, properTime;
+      };
+      /// Binary vertex record. Incoming followed by outgoing particles in the relation table
+      struct VertexRecord  {
+        int32_t  mask;
+        uint32_t numIn, numOut;
+        uint32_t spare;
+        uint64_t firstRelation;
+        double   x, y, z, time;
+      };
+
+    protected:
+      /// Mapped file
+      void*                 m_data   = 0;
+      /// Size of the mapped file
+      size_t                m_length = 0;
+      /// Section pointers into the mapped file
+      const FileHeader*     m_header = 0;
+      const EventRecord*    m_events = 0;
+      const ParticleRecord* m_particles = 0;
+      const VertexRecord*   m_vertices = 0;
+      const int32_t*        m_relations = 0;
+      /// Parameter: Mean number of sampled events per interaction
+      double                m_mean = 0e0;
+
+    public:
+      /// Initializing constructor
+      explicit Geant4EventReaderPileupLibrary(const std::string& nam);
+      /// Default destructor
+      virtual ~Geant4EventReaderPileupLibrary();
+      /// Check all record ranges against the section sizes. Returns 0 or the error message
+      const char* checkRanges() const;
+      /// Number of events in the library
+      size_t numEvents() const  {  return m_header->numEvents; }
+      /// Append the library event 'evt' with identifiers shifted by 'offset'
+      void addEvent(size_t evt, int offset, Vertices& vertices, Particles& particles) const;
+      /// Read an event and fill a vector of MCParticles.
+      virtual EventReaderStatus readParticles(int event_number, Vertices& vertices, Particles& particles);
+      /// Pass parameters to the event reader object
+      virtual EventReaderStatus setParameters(std::map<std::string, std::string>& parameters);
+
+      /// Write all events of another reader to a pile-up library file. Returns number of events
+      static size_t convert(Geant4EventReader& reader, const std::string& output, size_t max_events);
+    };
+  }     /* End namespace sim   */
+}       /* End namespace dd4hep */
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::sim;
+
+namespace {
+  /// Pile-up library file identification and version
+  const char     s_magic[8] = {'D','D','G','4','P','L','I','B'};
+  const uint32_t s_version  = 1;
+}
+
+// Factory entry
+DECLARE_GEANT4_EVENT_READER(Geant4EventReaderPileupLibrary)
+
+/// Initializing constructor
+Geant4EventReaderPileupLibrary::Geant4EventReaderPileupLibrary(const string& nam)
+  : Geant4EventReader(nam)
+{
+  struct stat st;
+  int fd = ::open(nam.c_str(), O_RDONLY);
+  if ( fd < 0 || ::fstat(fd, &st) != 0 )  {
+    string err = "+++ Geant4EventReaderPileupLibrary: Failed to open input file:"+nam+
+      " Error:"+string(::strerror(errno));
+    if ( fd >= 0 ) ::close(fd);
+    throw runtime_error(err);
+  }
+  m_length = st.st_size;
+  m_data   = m_length >= sizeof(FileHeader) ? ::mmap(0, m_length, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  ::close(fd);
+  if ( m_data == MAP_FAILED )  {
+    m_data = 0;
+    throw runtime_error("+++ Geant4EventReaderPileupLibrary: Failed to map input file:"+nam);
+  }
+  const char* ptr = (const char*)m_data;
+  m_header = (const FileHeader*)ptr;
+  if ( ::memcmp(m_header->magic, s_magic, sizeof(s_magic)) != 0 || m_header->version != s_version )  {
+    ::munmap(m_data, m_length);
+    m_data = 0;
+    throw runtime_error("+++ Geant4EventReaderPileupLibrary: "+nam+" is no pile-up library of version 1.");
+  }
+  // Section sizes are checked one by one against the remaining length: the counts
+  // come from the file and the products must not overflow.
+  const uint64_t counts[] = { m_header->numEvents,   m_header->numParticles,
+                              m_header->numVertices, m_header->numRelations };
+  const size_t   sizes[]  = { sizeof(EventRecord),   sizeof(ParticleRecord),
+                              sizeof(VertexRecord),  sizeof(int32_t) };
+  size_t left = m_length - sizeof(FileHeader);
+  bool   good = true;
+  for(size_t i=0; good && i < sizeof(counts)/sizeof(counts[0]); ++i)  {
+    good  = counts[i] <= left / sizes[i];
+    left -= good ? counts[i] * sizes[i] : 0;
+  }
+  if ( !good || left != 0 )  {
+    ::munmap(m_data, m_length);
+    m_data = 0;
+    throw runtime_error("+++ Geant4EventReaderPileupLibrary: Corrupted pile-up library:"+nam+
+                        " [Section sizes do not match the file size]");
+  }
+  ptr += sizeof(FileHeader);
+  m_events    = (const EventRecord*)ptr;
+  ptr += m_header->numEvents * sizeof(EventRecord);
+  m_particles = (const ParticleRecord*)ptr;
+  ptr += m_header->numParticles * sizeof(ParticleRecord);
+  m_vertices  = (const VertexRecord*)ptr;
+  ptr += m_header->numVertices * sizeof(VertexRecord);
+  m_relations = (const int32_t*)ptr;
+  if ( const char* err = checkRanges() )  {
+    ::munmap(m_data, m_length);
+    m_data = 0;
+    throw runtime_error("+++ Geant4EventReaderPileupLibrary: Corrupted pile-up library:"+nam+" ["+err+"]");
+  }
+  m_directAccess = true;
+}
+
+/// Default destructor
+Geant4EventReaderPileupLibrary::~Geant4EventReaderPileupLibrary()    {
+  if ( m_data ) ::munmap(m_data, m_length);
+  m_data = 0;
+}
+
+/// Check all record ranges against the section sizes. Returns 0 or the error message
+const char* Geant4EventReaderPileupLibrary::checkRanges() const   {
+  const uint64_t num_particles = m_header->numParticles;
+  const uint64_t num_vertices  = m_header->numVertices;
+  const uint64_t num_relations = m_header->numRelations;
+  for(uint64_t i=0; i < m_header->numEvents; ++i)  {
+    const EventRecord& e = m_events[i];
+    if ( e.firstParticle > num_particles || e.numParticles > num_particles - e.firstParticle )
+      return "Event particle range outside the particle section";
+    if ( e.firstVertex > num_vertices || e.numVertices > num_vertices - e.firstVertex )
+      return "Event vertex range outside the vertex section";
+    if ( e.idRange < 0 )
+      return "Negative particle identifier range";
+  }
+  for(uint64_t i=0; i < num_particles; ++i)  {
+    const ParticleRecord& r = m_particles[i];
+    if ( r.firstRelation > num_relations ||
+         uint64_t(r.numParents) + r.numDaughters > num_relations - r.firstRelation )
+      return "Particle relations outside the relation section";
+  }
+  for(uint64_t i=0; i < num_vertices; ++i)  {
+    const VertexRecord& r = m_vertices[i];
+    if ( r.firstRelation > num_relations ||
+         uint64_t(r.numIn) + r.numOut > num_relations - r.firstRelation )
+      return "Vertex relations outside the relation section";
+  }
+  return 0;
+}
+
+/// Pass parameters to the event reader object
+Geant4EventReader::EventReaderStatus
+Geant4EventReaderPileupLibrary::setParameters(map<string, string>& parameters)   {
+  _getParameterValue(parameters, "Mean", m_mean, 0e0);
+  return EVENT_READER_OK;
+}
+
+/// Append the library event 'evt' with identifiers shifted by 'offset'
+void Geant4EventReaderPileupLibrary::addEvent(size_t evt, int offset, Vertices& vertices, Particles& particles) const  {
+  const EventRecord& e = m_events[evt];
+  for(uint32_t i=0; i < e.numParticles; ++i)  {
+    const ParticleRecord& r = m_particles[e.firstParticle + i];
+    const int32_t* rel = m_relations + r.firstRelation;
+    Particle* p = new Particle(r.id + offset);
+    p->g4Parent     = r.g4Parent;
+    p->reason       = r.reason;
+    p->mask         = r.mask;
+    p->steps        = r.steps;
+    p->secondaries  = r.secondaries;
+    p->pdgID        = r.pdgID;
+    p->status       = r.status;
+    p->colorFlow[0] = r.colorFlow[0];
+    p->colorFlow[1] = r.colorFlow[1];
+    p->charge       = char(r.charge);
+    std::copy(r.spin, r.spin+3, p->spin);
+    p->vsx = r.vsx;  p->vsy = r.vsy;  p->vsz = r.vsz;
+    p->vex = r.vex;  p->vey = r.vey;  p->vez = r.vez;
+    p->psx = r.psx;  p->psy = r.psy;  p->psz = r.psz;
+    p->pex = r.pex;  p->pey = r.pey;  p->pez = r.pez;
+    p->mass = r.mass;
+    p->time = r.time;
+    p->properTime = r.properTime;
+    for(uint32_t j=0; j < r.numParents; ++j)
+      p->parents.insert(p->parents.end(), rel[j] + offset);
+    for(uint32_t j=0; j < r.numDaughters; ++j)
+      p->daughters.insert(p->daughters.end(), rel[r.numParents + j] + offset);
+    particles.push_back(p);
+  }
+  for(uint32_t i=0; i < e.numVertices; ++i)  {
+    const VertexRecord& r = m_vertices[e.firstVertex + i];
+    const int32_t* rel = m_relations + r.firstRelation;
+    Vertex* v = new Vertex();
+    v->mask = r.mask;
+    v->x    = r.x;
+    v->y    = r.y;
+    v->z    = r.z;
+    v->time = r.time;
+    for(uint32_t j=0; j < r.numIn; ++j)
+      v->in.insert(v->in.end(), rel[j] + offset);
+    for(uint32_t j=0; j < r.numOut; ++j)
+      v->out.insert(v->out.end(), rel[r.numIn + j] + offset);
+    vertices.push_back(v);
+  }
+}
+
+/// Read an event and fill a vector of MCParticles.
+Geant4EventReader::EventReaderStatus
+Geant4EventReaderPileupLibrary::readParticles(int event_number, Vertices& vertices, Particles& particles)   {
+  size_t num_evt = numEvents();
+  if ( m_mean <= 0e0 )  {
+    if ( event_number < 0 || size_t(event_number) >= num_evt )
+      return EVENT_READER_IO_ERROR;
+    addEvent(event_number, 0, vertices, particles);
+    ++m_currEvent;
+    return EVENT_READER_OK;
+  }
+  if ( num_evt == 0 )  {
+    return EVENT_READER_IO_ERROR;
+  }
+  // Use the DDG4 random engine if present, so that the sampling follows the job seeds
+  Geant4Random* rndm = Geant4Random::instance(false);
+  long num = rndm ? rndm->poisson(m_mean) : long(gRandom->Poisson(m_mean));
+  int  offset = 0;
+  for(long i=0; i < num; ++i)  {
+    size_t evt = std::min(num_evt-1, size_t((rndm ? rndm->rndm() : gRandom->Rndm()) * num_evt));
+    addEvent(evt, offset, vertices, particles);
+    offset += m_events[evt].idRange;
+  }
+  ++m_currEvent;
+  return EVENT_READER_OK;
+}
+
+/// Write all events of another reader to a pile-up library file. Returns number of events
+size_t Geant4EventReaderPileupLibrary::convert(Geant4EventReader& reader, const string& output, size_t max_events)   {
+  vector<EventRecord>    events;
+  vector<ParticleRecord> particles;
+  vector<VertexRecord>   vertices;
+  vector<int32_t>        relations;
+
+  for(size_t n=0; n < max_events; ++n)  {
+    Particles parts;
+    Vertices  vtx;
+    EventReaderStatus sc = reader.readParticles(n, vtx, parts);
+    if ( sc != EVENT_READER_OK )  {
+      for_each(vtx.begin(),vtx.end(),detail::deleteObject<Vertex>);
+      for_each(parts.begin(),parts.end(),detail::deleteObject<Particle>);
+      break;
+    }
+    EventRecord e;
+    ::memset(&e, 0, sizeof(e));
+    e.firstParticle = particles.size();
+    e.firstVertex   = vertices.size();
+    e.numParticles  = parts.size();
+    e.numVertices   = vtx.size();
+    for(const Particle* p : parts)  {
+      ParticleRecord r;
+      ::memset(&r, 0, sizeof(r));
+      r.id           = p->id;
+      r.g4Parent     = p->g4Parent;
+      r.reason       = p->reason;
+      r.mask         = p->mask;
+      r.steps        = p->steps;
+      r.secondaries  = p->secondaries;
+      r.pdgID        = p->pdgID;
+      r.status       = p->status;
+      r.colorFlow[0] = p->colorFlow[0];
+      r.colorFlow[1] = p->colorFlow[1];
+      r.charge       = p->charge;
+      std::copy(p->spin, p->spin+3, r.spin);
+      r.vsx = p->vsx;  r.vsy = p->vsy;  r.vsz = p->vsz;
+      r.vex = p->vex;  r.vey = p->vey;  r.vez = p->vez;
+      r.psx = p->psx;  r.psy = p->psy;  r.psz = p->psz;
+      r.pex = p->pex;  r.pey = p->pey;  r.pez = p->pez;
+      r.mass = p->mass;
+      r.time = p->time;
+      r.properTime    = p->properTime;
+      r.numParents    = p->parents.size();
+      r.numDaughters  = p->daughters.size();
+      r.firstRelation = relations.size();
+      relations.insert(relations.end(), p->parents.begin(), p->parents.end());
+      relations.insert(relations.end(), p->daughters.begin(), p->daughters.end());
+      e.idRange = std::max(e.idRange, p->id + 1);
+      particles.push_back(r);
+    }
+    for(const Vertex* v : vtx)  {
+      VertexRecord r;
+      ::memset(&r, 0, sizeof(r));
+      r.mask   = v->mask;
+      r.x      = v->x;
+      r.y      = v->y;
+      r.z      = v->z;
+      r.time   = v->time;
+      r.numIn  = v->in.size();
+      r.numOut = v->out.size();
+      r.firstRelation = relations.size();
+      relations.insert(relations.end(), v->in.begin(), v->in.end());
+      relations.insert(relations.end(), v->out.begin(), v->out.end());
+      vertices.push_back(r);
+    }
+    events.push_back(e);
+    for_each(vtx.begin(),vtx.end(),detail::deleteObject<Vertex>);
+    for_each(parts.begin(),parts.end(),detail::deleteObject<Particle>);
+  }
+
+  FileHeader h;
+  ::memset(&h, 0, sizeof(h));
+  ::memcpy(h.magic, s_magic, sizeof(s_magic));
+  h.version      = s_version;
+  h.numEvents    = events.size();
+  h.numParticles = particles.size();
+  h.numVertices  = vertices.size();
+  h.numRelations = relations.size();
+  ofstream out(output.c_str(), ios::binary|ios::trunc);
+  out.write((const char*)&h, sizeof(h));
+  out.write((const char*)events.data(),    events.size()*sizeof(EventRecord));
+  out.write((const char*)particles.data(), particles.size()*sizeof(ParticleRecord));
+  out.write((const char*)vertices.data(),  vertices.size()*sizeof(VertexRecord));
+  out.write((const char*)relations.data(), relations.size()*sizeof(int32_t));
+  if ( !out.good() )  {
+    except("Geant4PileupLibrary","+++ Failed to write pile-up library %s: %s",output.c_str(),::strerror(errno));
+  }
+  return events.size();
+}
+
+namespace {
+
+  /// Create an event reader by type and file name
+  Geant4EventReader* createReader(const string& type, const string& input)  {
+    Geant4EventReader* rdr = PluginService::Create<Geant4EventReader*>(type, input);
+    if ( !rdr )
+      except("Geant4PileupLibrary","+++ Failed to create event reader of type %s for %s",type.c_str(),input.c_str());
+    return rdr;
+  }
+
+  /// Compare two particle lists including all relations
+  bool sameParticles(const Geant4EventReader::Particles& a, const Geant4EventReader::Particles& b)  {
+    if ( a.size() != b.size() ) return false;
+    for(size_t i=0; i < a.size(); ++i)  {
+      const Geant4Particle* p = a[i], *q = b[i];
+      if ( p->id != q->id || p->pdgID != q->pdgID || p->status != q->status || p->mass != q->mass ||
+           p->psx != q->psx || p->psy != q->psy || p->psz != q->psz ||
+           p->vsx != q->vsx || p->vsy != q->vsy || p->vsz != q->vsz || p->time != q->time ||
+           p->parents != q->parents || p->daughters != q->daughters )
+        return false;
+    }
+    return true;
+  }
+
+  /// Compare two vertex lists including all relations
+  bool sameVertices(const Geant4EventReader::Vertices& a, const Geant4EventReader::Vertices& b)  {
+    if ( a.size() != b.size() ) return false;
+    for(size_t i=0; i < a.size(); ++i)  {
+      const Geant4Vertex* v = a[i], *w = b[i];
+      if ( v->mask != w->mask || v->x != w->x || v->y != w->y || v->z != w->z ||
+           v->time != w->time || v->in != w->in || v->out != w->out )
+        return false;
+    }
+    return true;
+  }
+
+  /// Release the content of one event
+  void clearEvent(Geant4EventReader::Vertices& vertices, Geant4EventReader::Particles& particles)  {
+    for_each(vertices.begin(),vertices.end(),detail::deleteObject<Geant4Vertex>);
+    for_each(particles.begin(),particles.end(),detail::deleteObject<Geant4Particle>);
+    vertices.clear();
+    particles.clear();
+  }
+}
+
+/// Plugin to convert background events to a pile-up library
+/**
+ *  Reads all events of the input with the given event reader and writes them
+ *  as a binary pile-up library for the Geant4EventReaderPileupLibrary.
+ *  With -check the library is read back and compared event by event with the
+ *  original input, and the time to read the input and the library is printed.
+ *  With -mean the time to sample pile-up interactions is printed.
+ *
+ *  \version 1.0
+ */
+static long create_pileup_library(Detector& /* description */, int argc, char** argv)  {
+  string reader_type, input, output;
+  long   max_events = 1000000, num_samples = 1000;
+  double mean = 0e0;
+  bool   check = false, arg_error = false;
+  for(int i = 0; i < argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-reader",argv[i],4) && i+1 < argc )
+      reader_type = argv[++i];
+    else if ( 0 == ::strncmp("-input",argv[i],4) && i+1 < argc )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-output",argv[i],4) && i+1 < argc )
+      output = argv[++i];
+    else if ( 0 == ::strncmp("-events",argv[i],4) && i+1 < argc )
+      max_events = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-mean",argv[i],4) && i+1 < argc )
+      mean = ::atof(argv[++i]);
+    else if ( 0 == ::strncmp("-samples",argv[i],4) && i+1 < argc )
+      num_samples = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-check",argv[i],4) )
+      check = true;
+    else
+      arg_error = true;
+  }
+  if ( arg_error || reader_type.empty() || input.empty() || output.empty() || max_events <= 0 )   {
+    cout <<
+      "Usage: -plugin DD4hep_Geant4PileupLibrary -arg [-arg]                          \n"
+      "     -reader  <string>     Event reader type e.g. Geant4EventReaderHepMC      \n"
+      "     -input   <string>     Background input file                              \n"
+      "     -output  <string>     Pile-up library file                               \n"
+      "     -events  <number>     Maximal number of converted events [1000000]       \n"
+      "     -check                Compare the library with the input                 \n"
+      "     -mean    <number>     Time the sampling of pile-up with this mean        \n"
+      "     -samples <number>     Number of sampled interactions [1000]              \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  dd4hep_ptr<Geant4EventReader> rdr(createReader(reader_type, input));
+  TTimeStamp start;
+  size_t num_evt = Geant4EventReaderPileupLibrary::convert(*rdr, output, max_events);
+  TTimeStamp stop;
+  printout(INFO,"Geant4PileupLibrary","+++ Converted %ld events of %s to pile-up library %s in %.3f sec",
+           long(num_evt), input.c_str(), output.c_str(), stop.AsDouble()-start.AsDouble());
+
+  if ( check )   {
+    Geant4EventReader::Vertices  v1, v2;
+    Geant4EventReader::Particles p1, p2;
+    dd4hep_ptr<Geant4EventReader> orig(createReader(reader_type, input));
+    Geant4EventReaderPileupLibrary lib(output);
+    size_t num_bad = 0;
+    double t_orig = 0e0, t_lib = 0e0;
+    for(size_t n=0; n < num_evt; ++n)  {
+      TTimeStamp t0;
+      orig->readParticles(n, v1, p1);
+      TTimeStamp t1;
+      lib.readParticles(n, v2, p2);
+      TTimeStamp t2;
+      t_orig += t1.AsDouble() - t0.AsDouble();
+      t_lib  += t2.AsDouble() - t1.AsDouble();
+      if ( !sameParticles(p1, p2) || !sameVertices(v1, v2) ) ++num_bad;
+      clearEvent(v1, p1);
+      clearEvent(v2, p2);
+    }
+    printout(INFO,"Geant4PileupLibrary","+++ Read %ld events: input %.3f msec/event library %.3f msec/event speedup: %.1f",
+             long(num_evt), 1e3*t_orig/max(size_t(1),num_evt), 1e3*t_lib/max(size_t(1),num_evt),
+             t_lib > 0e0 ? t_orig/t_lib : 0e0);
+    if ( num_evt == 0 || num_bad > 0 || lib.numEvents() != num_evt )  {
+      except("Geant4PileupLibrary","+++ FAILED: %ld of %ld library events differ from the input.",
+             long(num_bad), long(num_evt));
+    }
+    printout(INFO,"Geant4PileupLibrary","+++ All %ld library events agree with the input.",long(num_evt));
+  }
+  if ( mean > 0e0 )   {
+    Geant4EventReaderPileupLibrary lib(output);
+    map<string,string> params = { {"Mean", ::to_string(mean)} };
+    lib.setParameters(params);
+    Geant4EventReader::Vertices  vtx;
+    Geant4EventReader::Particles parts;
+    size_t num_parts = 0;
+    TTimeStamp t0;
+    for(long n=0; n < num_samples; ++n)  {
+      lib.readParticles(n, vtx, parts);
+      num_parts += parts.size();
+      clearEvent(vtx, parts);
+    }
+    TTimeStamp t1;
+    printout(INFO,"Geant4PileupLibrary","+++ Sampled %ld interactions with pile-up %.1f: %.1f particles/interaction %.3f msec/interaction",
+             num_samples, mean, double(num_parts)/max(1L,num_samples),
+             1e3*(t1.AsDouble()-t0.AsDouble())/max(1L,num_samples));
+  }
+  return 1;
+}
+DECLARE_APPLY(DD4hep_Geant4PileupLibrary,create_pileup_library)
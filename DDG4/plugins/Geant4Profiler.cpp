@@ -0,0 +1,249 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework include files
+#include "DDG4/Defs.h"
+#include "DDG4/Geant4SteppingAction.h"
+
+// C/C++ include files
+#include <unordered_map>
+
+// Forward declarations
+class G4LogicalVolume;
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace sim   {
+
+    /// Execution time accounting of DDG4 simulations
+    /**
+     *  Creating the profiler enables the timing of all actions in the run,
+     *  event, tracking, stepping and sensitive detector sequences.
+     *  Added to the stepping sequence it also accumulates the time between
+     *  successive steps and the number of steps per logical volume. The
+     *  volumes are named using the Geant4GeometryInfo mapping and grouped
+     *  by their region.
+     *
+     *  At the end of the run the master instance prints the sorted table
+     *  and optionally writes the entries to the ROOT file "Output".
+     *  In multi-threaded mode create one instance in the master context
+     *  and add one to the stepping sequence of every worker.
+     *
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4Profiler : public Geant4SteppingAction  {
+    protected:
+      typedef std::unordered_map<const G4LogicalVolume*, Geant4ProfileEntry*> VolumeEntries;
+      /// Property: ROOT file name of the profile (empty: no file)
+      std::string    m_output;
+      /// Property: Flag to account the stepping time per volume
+      bool           m_volumes = true;
+      /// Property: Maximum number of table rows per item type
+      int            m_rows    = 30;
+      /// Volume entries of this instance
+      VolumeEntries  m_entries;
+      /// Names of the logical volumes from the geometry mapping
+      std::unordered_map<const G4LogicalVolume*, std::string> m_names;
+      /// Time of the last step
+      long long      m_last    = 0;
+
+      /// Create the entry of a logical volume
+      Geant4ProfileEntry* volumeEntry(const G4LogicalVolume* volume);
+      /// Write the profile to a ROOT file
+      void save(const Geant4Profile::Entries& entries)  const;
+
+    public:
+      /// Standard constructor
+      Geant4Profiler(Geant4Context* context, const std::string& name);
+      /// Default destructor
+      virtual ~Geant4Profiler();
+      /// User stepping callback
+      virtual void operator()(const G4Step* step, G4SteppingManager* mgr)  override;
+      /// Registered callback on Begin-track
+      void beginTrack(const G4Track* track);
+      /// Registered callback on End-run: print and save the profile
+      void endRun(const G4Run* run);
+    };
+  }
+}
+
+//====================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------
+//
+//====================================================================
+
+// Framework include files
+#include "DD4hep/InstanceCount.h"
+#include "DD4hep/Printout.h"
+#include "DDG4/Geant4Kernel.h"
+#include "DDG4/Geant4Mapping.h"
+#include "DDG4/Geant4RunAction.h"
+#include "DDG4/Geant4TrackingAction.h"
+
+// Geant4 include files
+#include "G4Step.hh"
+#include "G4Region.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+
+// ROOT include files
+#include "TFile.h"
+#include "TTree.h"
+
+// C/C++ include files
+#include <algorithm>
+#include <map>
+
+using namespace std;
+using namespace dd4hep::sim;
+
+#include "DDG4/Factories.h"
+DECLARE_GEANT4ACTION(Geant4Profiler)
+
+/// Standard constructor
+Geant4Profiler::Geant4Profiler(Geant4Context* ctxt, const string& nam)
+  : Geant4SteppingAction(ctxt,nam)
+{
+  declareProperty("Output",  m_output);
+  declareProperty("Volumes", m_volumes);
+  declareProperty("Rows",    m_rows);
+  runAction().callAtEnd(this,&Geant4Profiler::endRun);
+  trackingAction().callAtBegin(this,&Geant4Profiler::beginTrack);
+  Geant4Profile::enable(true);
+  InstanceCount::increment(this);
+}
+
+/// Default destructor
+Geant4Profiler::~Geant4Profiler() {
+  InstanceCount::decrement(this);
+}
+
+/// Create the entry of a logical volume
+Geant4ProfileEntry* Geant4Profiler::volumeEntry(const G4LogicalVolume* volume)   {
+  if ( m_names.empty() )  {
+    Geant4GeometryInfo* info = Geant4Mapping::instance().ptr();
+    if ( info )  {
+      for( const auto& v : info->g4Volumes )
+        m_names[v.second] = v.first.name();
+    }
+  }
+  auto i = m_names.find(volume);
+  const G4Region* region = volume->GetRegion();
+  return Geant4Profile::entry("volume",
+                              region ? string(region->GetName()) : string("(none)"),
+                              i != m_names.end() ? i->second : string(volume->GetName()));
+}
+
+/// User stepping callback
+void Geant4Profiler::operator()(const G4Step* step, G4SteppingManager*) {
+  long long now = Geant4Profile::now();
+  if ( m_volumes )  {
+    const G4VPhysicalVolume* pv = step->GetPreStepPoint()->GetPhysicalVolume();
+    if ( pv )  {
+      const G4LogicalVolume* lv = pv->GetLogicalVolume();
+      Geant4ProfileEntry*& entry = m_entries[lv];
+      if ( !entry ) entry = volumeEntry(lv);
+      entry->add(now - m_last);
+    }
+  }
+  m_last = now;
+}
+
+/// Registered callback on Begin-track
+void Geant4Profiler::beginTrack(const G4Track* /* track */)   {
+  m_last = Geant4Profile::now();
+}
+
+/// Write the profile to a ROOT file
+void Geant4Profiler::save(const Geant4Profile::Entries& entries)  const   {
+  TFile* file = TFile::Open(m_output.c_str(), "RECREATE", "DDG4 simulation profile");
+  if ( !file || file->IsZombie() )  {
+    error("+++ Failed to open profile output file: %s", m_output.c_str());
+    if ( file ) delete file;
+    return;
+  }
+  string kind, group, name;
+  string *pkind = &kind, *pgroup = &group, *pname = &name;
+  Double_t  seconds = 0;
+  Long64_t  calls = 0;
+  TTree* tree = new TTree("Profile", "DDG4 execution time per action and volume");
+  tree->Branch("kind",    &pkind);
+  tree->Branch("group",   &pgroup);
+  tree->Branch("name",    &pname);
+  tree->Branch("seconds", &seconds, "seconds/D");
+  tree->Branch("calls",   &calls,   "calls/L");
+  for( const Geant4ProfileEntry* e : entries )  {
+    kind    = e->kind;
+    group   = e->group;
+    name    = e->name;
+    seconds = 1e-9*double(e->time.load());
+    calls   = e->calls.load();
+    tree->Fill();
+  }
+  file->Write();
+  file->Close();
+  delete file;
+  info("+++ Wrote %ld profile entries to %s", long(entries.size()), m_output.c_str());
+}
+
+/// Registered callback on End-run: print and save the profile
+void Geant4Profiler::endRun(const G4Run* /* run */)   {
+  if ( !context()->kernel().isMaster() ) return;
+  Geant4Profile::Entries entries = Geant4Profile::summary();
+  map<string, pair<long long,long long> > regions;
+  const char* line = "+----------------------------------------------------------------------------------------------------------";
+  const char* fmt  = "| %12.6f %6.2f%% %12lld %10.3f  %-28s %s";
+  long long total[2] = { 0, 0 };
+
+  for( const Geant4ProfileEntry* e : entries )  {
+    total[e->kind == "action" ? 0 : 1] += e->time;
+    if ( e->kind == "volume" )  {
+      regions[e->group].first  += e->time;
+      regions[e->group].second += e->calls;
+    }
+  }
+  for( int k=0; k<2; ++k )  {
+    const char* kind = k==0 ? "action" : "volume";
+    int rows = 0;
+    if ( total[k] == 0 ) continue;
+    printout(ALWAYS,c_name(),"%s",line);
+    printout(ALWAYS,c_name(),"|   Time [s]  Fraction        %-6s  us/%-6s %-28s %s",
+           k==0 ? "Calls" : "Steps", k==0 ? "call" : "step", k==0 ? "Callback" : "Region", k==0 ? "Action" : "Volume");
+    printout(ALWAYS,c_name(),"%s",line);
+    for( const Geant4ProfileEntry* e : entries )  {
+      if ( e->kind != kind || e->calls == 0 ) continue;
+      if ( ++rows > m_rows ) break;
+      printout(ALWAYS,c_name(),fmt, 1e-9*double(e->time.load()), 100e0*double(e->time.load())/double(total[k]),
+             e->calls.load(), 1e-3*double(e->time.load())/double(e->calls.load()),
+             e->group.c_str(), e->name.c_str());
+    }
+  }
+  if ( !regions.empty() )  {
+    vector<pair<string, pair<long long,long long> > > sorted(regions.begin(), regions.end());
+    sort(sorted.begin(), sorted.end(), [](const pair<string, pair<long long,long long> >& a,
+                                          const pair<string, pair<long long,long long> >& b)
+         { return a.second.first > b.second.first; });
+    printout(ALWAYS,c_name(),"%s",line);
+    printout(ALWAYS,c_name(),"|   Time [s]  Fraction        Steps  us/step   %-28s", "Region");
+    printout(ALWAYS,c_name(),"%s",line);
+    for( const auto& r : sorted )
+      printout(ALWAYS,c_name(),fmt, 1e-9*double(r.second.first), 100e0*double(r.second.first)/double(total[1]),
+             r.second.second, r.second.second ? 1e-3*double(r.second.first)/double(r.second.second) : 0e0,
+             r.first.c_str(), "");
+  }
+  if ( !entries.empty() ) printout(ALWAYS,c_name(),"%s",line);
+  if ( !m_output.empty() ) save(entries);
+  Geant4Profile::reset();
+}
@@ -70,6 +70,15 @@ Geant4Action::~Geant4Action() {
   InstanceCount::decrement(this);
 }
 
+/// Access the profile entry of a callback. Created on first call
+Geant4ProfileEntry* Geant4Action::profileEntry(const char* callback)  {
+  for(const auto& p : m_profiles)
+    if ( p.first == callback ) return p.second;
+  Geant4ProfileEntry* entry = Geant4Profile::entry("action", callback, m_name);
+  m_profiles.push_back(make_pair(callback, entry));
+  return entry;
+}
+
 /// Implicit destruction
 long Geant4Action::addRef() {
   return ++m_refCount;
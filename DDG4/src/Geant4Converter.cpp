@@ -23,6 +23,7 @@
 #include "DDG4/Geant4Field.h"
 #include "DDG4/Geant4Converter.h"
 #include "DDG4/Geant4SensitiveDetector.h"
+#include "DDG4/Geant4PlacementParameterisation.h"
 
 // ROOT includes
 #include "TROOT.h"
@@ -81,6 +82,8 @@
 #include "G4Transform3D.hh"
 #include "G4ThreeVector.hh"
 #include "G4PVPlacement.hh"
+#include "G4PVReplica.hh"
+#include "G4PVParameterised.hh"
 #include "G4ElectroMagneticField.hh"
 #include "G4FieldManager.hh"
 #include "G4ReflectionFactory.hh"
@@ -788,6 +791,19 @@ void* Geant4Converter::handlePlacement(const string& name, const TGeoNode* node)
       }
       G4LogicalVolume* g4vol = info.g4Volumes[vol];
       G4LogicalVolume* g4mot = info.g4Volumes[mot_vol];
+      const PlacedVolumeExtension::Parameterisation* params = PlacedVolume(node).parameterisation();
+      //
+      // Replicated placements filling their mother are converted to a single
+      // G4PVReplica or G4PVParameterised shared by all copies.
+      //
+      if ( params && mot_vol && mot_vol->GetNdaughters() == Int_t(params->count()) )  {
+        const TGeoNode* first = mot_vol->GetNode(params->first);
+        g4it = info.g4Placements.find(first);
+        g4 = (g4it == info.g4Placements.end()) ? handleReplication(name, mot_vol, g4vol, g4mot, *params) : (*g4it).second;
+        info.g4Placements[first] = g4;
+        info.g4Placements[node]  = g4;
+        return g4;
+      }
       g4 = new G4PVPlacement(transform,   // no rotation
                              g4vol,     // its logical volume
                              name,      // its name
@@ -804,6 +820,67 @@ void* Geant4Converter::handlePlacement(const string& name, const TGeoNode* node)
   return g4;
 }
 
+/// Convert replicated placements filling their mother volume to a G4PVReplica or G4PVParameterised
+G4VPhysicalVolume* Geant4Converter::handleReplication(const string& name, const TGeoVolume* mother,
+                                                      G4LogicalVolume* g4vol, G4LogicalVolume* g4mot,
+                                                      const PlacedVolumeExtension::Parameterisation& params) const
+{
+  PrintLevel lvl = debugPlacements ? ALWAYS : outputLevel;
+  size_t     num = params.count();
+  const TGeoNode* first = mother->GetNode(params.first);
+  const TGeoMatrix* m0  = first->GetMatrix();
+  //
+  // G4PVReplica: boxes sliced along one cartesian axis without rotation
+  //
+  if ( params.dimensions.size() == 1 && !m0->IsRotation() &&
+       mother->GetShape()->IsA() == TGeoBBox::Class() &&
+       first->GetVolume()->GetShape()->IsA() == TGeoBBox::Class() )   {
+    const Transform3D& inc = params.dimensions[0].increment;
+    const TGeoBBox* mbox = (const TGeoBBox*)mother->GetShape();
+    const TGeoBBox* dbox = (const TGeoBBox*)first->GetVolume()->GetShape();
+    const double*   pos  = m0->GetTranslation();
+    double m_dim[3] = { mbox->GetDX(), mbox->GetDY(), mbox->GetDZ() };
+    double d_dim[3] = { dbox->GetDX(), dbox->GetDY(), dbox->GetDZ() };
+    double step[3], dxx, dxy, dxz, dyx, dyy, dyz, dzx, dzy, dzz;
+    inc.GetComponents(dxx, dxy, dxz, step[0], dyx, dyy, dyz, step[1], dzx, dzy, dzz, step[2]);
+    bool   no_rot = Rotation3D(dxx, dxy, dxz, dyx, dyy, dyz, dzx, dzy, dzz) == Rotation3D();
+    int    axis   = -1;
+    for( int i = 0; i < 3; ++i )  {
+      if ( std::fabs(step[i]) > 1e-12 ) axis = (axis < 0) ? i : 3;
+    }
+    const double tol = 1e-9;
+    bool is_replica = no_rot && axis >= 0 && axis < 3 && step[axis] > 0;
+    for( int i = 0; is_replica && i < 3; ++i )  {
+      if ( i == axis )  {
+        is_replica = std::fabs(2e0*d_dim[i] - step[i]) < tol &&
+          std::fabs(2e0*m_dim[i] - double(num)*step[i]) < tol &&
+          std::fabs(pos[i] - (step[i]/2e0 - m_dim[i])) < tol;
+        continue;
+      }
+      is_replica = std::fabs(d_dim[i] - m_dim[i]) < tol && std::fabs(pos[i]) < tol;
+    }
+    if ( is_replica )  {
+      static const EAxis axes[3] = { kXAxis, kYAxis, kZAxis };
+      printout(lvl, "Geant4Converter", "+++ Replica: %s %ld copies of %s along axis %d in mother %s",
+               name.c_str(), long(num), first->GetVolume()->GetName(), axis, mother->GetName());
+      return new G4PVReplica(name, g4vol, g4mot, axes[axis], num, step[axis]*CM_2_MM, 0e0);
+    }
+  }
+  //
+  // G4PVParameterised: any other replication
+  //
+  vector<G4Transform3D> copies;
+  copies.reserve(num);
+  for( size_t i = 0; i < num; ++i )  {
+    const TGeoMatrix* tr = mother->GetNode(params.first+i)->GetMatrix();
+    copies.push_back(MyTransform3D(tr->GetTranslation(),tr->IsRotation() ? tr->GetRotationMatrix() : s_identity_rot));
+  }
+  printout(lvl, "Geant4Converter", "+++ Parameterised: %s %ld copies of %s in mother %s",
+           name.c_str(), long(num), first->GetVolume()->GetName(), mother->GetName());
+  Geant4PlacementParameterisation* param = new Geant4PlacementParameterisation(copies);
+  return new G4PVParameterised(name, g4vol, g4mot, kUndefined, num, param, checkOverlaps);
+}
+
 /// Convert the geometry type region into the corresponding Geant4 object(s).
 void* Geant4Converter::handleRegion(Region region, const set<const TGeoVolume*>& /* volumes */) const {
   G4Region* g4 = data().g4Regions[region];
@@ -142,13 +142,13 @@ void Geant4EventActionSequence::adopt(Geant4EventAction* action) {
 
 /// Pre-track action callback
 void Geant4EventActionSequence::begin(const G4Event* event)   {
-  m_actors(&Geant4EventAction::begin, event);
+  m_actors.timed("EventAction/begin", &Geant4EventAction::begin, event);
   m_begin(event);
 }
 
 /// Post-track action callback
 void Geant4EventActionSequence::end(const G4Event* event)   {
   m_end(event);
-  m_actors(&Geant4EventAction::end, event);
+  m_actors.timed("EventAction/end", &Geant4EventAction::end, event);
   m_final(event);
 }
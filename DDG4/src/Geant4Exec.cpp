@@ -41,6 +41,7 @@
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "G4VUserActionInitialization.hh"
 #include "G4VUserDetectorConstruction.hh"
+#include "G4Event.hh"
 
 // C/C++ include files
 #include <memory>
@@ -391,6 +392,9 @@ namespace dd4hep {
 
     /// Generate primary particles
     void Geant4UserGeneratorAction::GeneratePrimaries(G4Event* event) {
+      long offset = kernel().processEventOffset();
+      // Forked worker processes simulate disjoint event ranges
+      if ( offset > 0 ) event->SetEventID(event->GetEventID() + offset);
       createClientContext(event);
       if ( m_sequence )  {
         (*m_sequence)(event);
@@ -488,8 +492,22 @@ namespace dd4hep {
 #include "DD4hep/Detector.h"
 #include "DD4hep/Plugins.h"
 #include "DDG4/Geant4DetectorConstruction.h"
+#include "DDG4/Geant4OutputAction.h"
 #include "DDG4/Geant4Kernel.h"
 
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
 using namespace std;
 using namespace dd4hep;
 using namespace dd4hep::sim;
@@ -497,6 +515,7 @@ using namespace dd4hep::sim;
 // Geant4 include files
 #include "G4RunManager.hh"
 #include "G4PhysListFactory.hh"
+#include "CLHEP/Random/Random.h"
 
 
 /// Compatibility actions for running Geant4 in single threaded mode
@@ -641,11 +660,166 @@ int Geant4Exec::run(Geant4Kernel& kernel) {
     throw runtime_error(format("Geant4Exec","++ Failed to locate UI interface %s.",value.c_str()));
   }
   long nevt = kernel.property("NumEvents").value<long>();
+  if ( kernel.numProcesses() > 1 )  {
+    int result = runProcesses(kernel, nevt);
+    kernel.executePhase("stop",0);
+    return result;
+  }
+  TTimeStamp start;
   kernel.runManager().BeamOn(nevt);
+  TTimeStamp stop;
+  double secs = stop.AsDouble() - start.AsDouble();
+  printout(INFO,"Geant4Exec","+++ Simulated %ld events with %d threads in %.2f sec: %.2f events/sec.",
+           nevt, kernel.isMultiThreaded() ? kernel.property("NumberOfThreads").value<int>() : 1,
+           secs, secs > 0e0 ? double(nevt)/secs : 0e0);
   kernel.executePhase("stop",0);
   return 1;
 }
 
+namespace {
+  /// Read a memory counter in kB from a /proc/self file. Returns -1 if not available
+  long processMemory(const char* file, const string& tag)   {
+    ifstream in(file);
+    for(string line; getline(in, line); )  {
+      if ( line.compare(0, tag.length(), tag) == 0 )
+        return ::atol(line.c_str() + tag.length());
+    }
+    return -1;
+  }
+
+  /// Seed of a worker process: SplitMix64 hash of the master seed, the process and the seed index
+  /** Consecutive processes get decorrelated seeds, unlike seed+process.
+   *  The result is positive and non-zero as required by the CLHEP engines.
+   */
+  long processSeed(long seed, int process, int index)   {
+    unsigned long long z = (unsigned long long)seed +
+      0x9E3779B97F4A7C15ULL * (unsigned long long)(2*process + index + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = (z ^ (z >> 31)) & 0x7FFFFFFFULL;
+    return z == 0 ? 1 : long(z);
+  }
+}
+
+/// Simulate the event range of one forked worker process
+int Geant4Exec::runWorkerProcess(Geant4Kernel& kernel, int process, long first, long num_events)   {
+  try  {
+    kernel.m_process = process;
+    kernel.m_processEventOffset = first;
+    // Every worker process continues with its own random sequence. The CLHEP main engine
+    // is reseeded in any case: it is also the engine of the main Geant4Random instance.
+    Geant4Random* rndm = Geant4Random::instance(false);
+    long seed = rndm ? rndm->property("Seed").value<long>() : CLHEP::HepRandom::getTheSeed();
+    long seeds[3] = { processSeed(seed, process, 0), processSeed(seed, process, 1), 0 };
+    CLHEP::HepRandom::setTheSeeds(seeds);
+    printout(DEBUG,"Geant4Exec","+++ Worker process %d: random seeds %ld %ld [master seed %ld]",
+             process, seeds[0], seeds[1], seed);
+    TTimeStamp start;
+    kernel.runManager().BeamOn(num_events);
+    TTimeStamp stop;
+    printout(INFO,"Geant4Exec","+++ Worker process %d [pid %d] simulated events %ld to %ld in %.2f sec. "
+             "RSS: %ld kB PSS: %ld kB", process, int(::getpid()), first, first+num_events-1,
+             stop.AsDouble()-start.AsDouble(), processMemory("/proc/self/status","VmRSS:"),
+             processMemory("/proc/self/smaps_rollup","Pss:"));
+    kernel.executePhase("stop",0);
+    // Terminate the kernel: the output actions close the worker process files
+    kernel.terminate();
+    return EXIT_SUCCESS;
+  }
+  catch(const exception& e)   {
+    printout(FATAL,"Geant4Exec","+++ Worker process %d: Exception while simulating:%s",process,e.what());
+  }
+  catch(...)   {
+    printout(FATAL,"Geant4Exec","+++ Worker process %d: UNKNOWN exception while simulating.",process);
+  }
+  return EXIT_FAILURE;
+}
+
+/// Run the application and simulate events in forked worker processes
+int Geant4Exec::runProcesses(Geant4Kernel& kernel, long num_events)   {
+  int num_proc = kernel.numProcesses();
+  // Every worker process must at least simulate one event to write its output
+  if ( num_events > 0 && num_proc > num_events ) num_proc = int(num_events);
+  if ( kernel.isMultiThreaded() )  {
+    throw runtime_error(format("Geant4Exec","++ Multi process mode cannot be combined "
+                               "with multi threading [%d processes].",num_proc));
+  }
+  // Geometry, physics tables and the converted geometry are built once. 
+  // The worker processes share this memory copy-on-write.
+  kernel.runManager().BeamOn(0);
+  printout(INFO,"Geant4Exec","+++ Master process [pid %d] initialized. RSS: %ld kB. "
+           "Forking %d worker processes for %ld events.", int(::getpid()),
+           processMemory("/proc/self/status","VmRSS:"), num_proc, num_events);
+
+  vector<pid_t> pids(num_proc, 0);
+  vector<long>  first(num_proc+1, 0);
+  for(int i=0; i < num_proc; ++i)
+    first[i+1] = first[i] + num_events/num_proc + (i < num_events%num_proc ? 1 : 0);
+
+  TTimeStamp start;
+  bool success = true;
+  for(int i=0; i < num_proc; ++i)   {
+    // Pending messages of the asynchronous printer would otherwise be lost or
+    // written twice. In the child the printer falls back to synchronous output.
+    flushPrinter();
+    ::fflush(stdout);
+    ::fflush(stderr);
+    pid_t pid = ::fork();
+    if ( pid == 0 )  {
+      int result = runWorkerProcess(kernel, i, first[i], first[i+1]-first[i]);
+      ::fflush(stdout);
+      ::fflush(stderr);
+      ::_exit(result);
+    }
+    else if ( pid < 0 )  {
+      printout(ERROR,"Geant4Exec","+++ Failed to fork worker process %d: %s",i,::strerror(errno));
+      success = false;
+      break;
+    }
+    pids[i] = pid;
+  }
+  for(int i=0; i < num_proc; ++i)   {
+    struct rusage usage;
+    int status = 0;
+    pid_t pid  = -1;
+    if ( pids[i] > 0 )  {
+      do  {
+        pid = ::wait4(pids[i], &status, 0, &usage);
+      } while ( pid < 0 && errno == EINTR );
+    }
+    if ( pid < 0 )  {
+      if ( pids[i] > 0 )
+        printout(ERROR,"Geant4Exec","+++ Failed to wait for worker process %d [pid %d]: %s",
+                 i, int(pids[i]), ::strerror(errno));
+      success = false;
+      continue;
+    }
+    bool ok = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    printout(ok ? INFO : ERROR,"Geant4Exec","+++ Worker process %d [pid %d] %s. Events %ld to %ld. "
+             "Max. RSS: %ld kB CPU: %.2f sec", i, int(pids[i]), ok ? "finished" : "FAILED",
+             first[i], first[i+1]-1, long(usage.ru_maxrss),
+             double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+             1e-6*double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec));
+    success &= ok;
+  }
+  TTimeStamp stop;
+  double secs = stop.AsDouble() - start.AsDouble();
+  printout(INFO,"Geant4Exec","+++ Simulated %ld events with %d processes in %.2f sec: %.2f events/sec.",
+           num_events, num_proc, secs, secs > 0e0 ? double(num_events)/secs : 0e0);
+  if ( !success )  {
+    printout(ERROR,"Geant4Exec","+++ Worker processes failed. Output files are not merged.");
+    return 0;
+  }
+  for(Geant4OutputAction* action : kernel.processOutputs())  {
+    string output = action->property("Output").value<string>();
+    vector<string> inputs;
+    for(int i=0; !output.empty() && i < num_proc; ++i)
+      inputs.push_back(Geant4Kernel::processFileName(output, i));
+    action->mergeProcessOutput(inputs);
+  }
+  return 1;
+}
+
 /// Run the simulation
 int Geant4Exec::terminate(Geant4Kernel& kernel) {
   kernel.executePhase("terminate",0);
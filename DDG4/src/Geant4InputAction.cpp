@@ -17,6 +17,7 @@
 #include "DD4hep/Plugins.h"
 #include "DDG4/Geant4Primary.h"
 #include "DDG4/Geant4Context.h"
+#include "DDG4/Geant4Kernel.h"
 #include "DDG4/Geant4InputAction.h"
 
 #include "G4Event.hh"
@@ -129,7 +130,7 @@ int Geant4InputAction::readParticles(int evt_number,
                                      Vertices& vertices,
                                      std::vector<Particle*>& particles)
 {
-  int evid = evt_number + m_firstEvent;
+  int evid = evt_number + m_firstEvent + context()->kernel().processEventOffset();
   if ( 0 == m_reader )  {
     if ( m_input.empty() )  {
       except("InputAction: No input file declared!");
@@ -193,7 +194,7 @@ void Geant4InputAction::operator()(G4Event* event)   {
 
   result = readParticles(m_currentEventNumber, vertices, primaries);
 
-  event->SetEventID(m_firstEvent + m_currentEventNumber);
+  event->SetEventID(m_firstEvent + m_currentEventNumber + context()->kernel().processEventOffset());
   ++m_currentEventNumber;
 
   if ( result != Geant4EventReader::EVENT_READER_OK )   {    // handle I/O error, but how?
@@ -21,6 +21,7 @@
 #include "DDG4/Geant4Kernel.h"
 #include "DDG4/Geant4Context.h"
 #include "DDG4/Geant4ActionPhase.h"
+#include "DDG4/Geant4OutputAction.h"
 
 // Geant4 include files
 #ifdef G4MULTITHREADED
@@ -43,7 +44,21 @@ using namespace dd4hep::sim;
 
 namespace {
   G4Mutex kernel_mutex=G4MUTEX_INITIALIZER;
+  /// Protects the worker registries of the master instances
+  G4Mutex worker_mutex=G4MUTEX_INITIALIZER;
+  /// Source of worker registry keys. Keys are never reused.
+  atomic<unsigned long> s_registry_key(0);
+  /// Worker of the current thread. Valid as long as the key matches the master's registry key
+  struct WorkerSlot  {
+    unsigned long key;
+    Geant4Kernel* worker;
+  };
+  thread_local WorkerSlot s_worker_slot = { 0, 0 };
   dd4hep::dd4hep_ptr<Geant4Kernel> s_main_instance(0);
+  void releaseOutputs(Geant4Kernel::ProcessOutputs& outputs)  {
+    for_each(outputs.begin(), outputs.end(), dd4hep::detail::releaseObject(outputs));
+    outputs.clear();
+  }
 }
 
 /// Standard constructor
@@ -76,7 +91,9 @@ Geant4ActionPhase& Geant4Kernel::PhaseSelector::operator[](const std::string& na
 /// Standard constructor
 Geant4Kernel::Geant4Kernel(Detector& description_ref)
   : Geant4ActionContainer(), m_runManager(0), m_control(0), m_trackMgr(0), m_detDesc(&description_ref), 
-    m_numThreads(0), m_id(Geant4Kernel::thread_self()), m_master(this), m_shared(0),
+    m_numThreads(0), m_numProcesses(0), m_process(-1), m_processEventOffset(0),
+    m_id(Geant4Kernel::thread_self()), m_workerCount(0), m_workerKey(++s_registry_key),
+    m_master(this), m_shared(0),
     m_threadContext(0), phase(this)
 {
   m_detDesc->addExtension < Geant4Kernel > (this);
@@ -86,6 +103,7 @@ Geant4Kernel::Geant4Kernel(Detector& description_ref)
   declareProperty("NumEvents",      m_numEvent = 10);
   declareProperty("OutputLevels",   m_clientLevels);
   declareProperty("NumberOfThreads",m_numThreads);
+  declareProperty("NumberOfProcesses",m_numProcesses);
   m_controlName = "/ddg4/";
   m_control = new G4UIdirectory(m_controlName.c_str());
   m_control->SetGuidance("Control for named Geant4 actions");
@@ -97,17 +115,18 @@ Geant4Kernel::Geant4Kernel(Detector& description_ref)
 /// Standard constructor
 Geant4Kernel::Geant4Kernel(Geant4Kernel* m, unsigned long ident)
   : Geant4ActionContainer(), m_runManager(0), m_control(0), m_trackMgr(0), m_detDesc(0),
-    m_numThreads(1), m_id(ident), m_master(m), m_shared(0),
+    m_numThreads(1), m_numProcesses(0), m_process(-1), m_processEventOffset(0),
+    m_id(ident), m_workerCount(0), m_workerKey(0), m_master(m), m_shared(0),
     m_threadContext(0), phase(this)
 {
   char text[64];
   m_detDesc           = m_master->m_detDesc;
-  m_ident          = m_master->m_workers.size();
+  m_ident          = m_master->m_workerCount;
   m_numEvent       = m_master->m_numEvent;
   declareProperty("UI",m_uiName = m_master->m_uiName);
   declareProperty("OutputLevel", m_outputLevel = m_master->m_outputLevel);
   declareProperty("OutputLevels",m_clientLevels = m_master->m_clientLevels);
-  ::snprintf(text,sizeof(text),"/ddg4.%d/",(int)(m_master->m_workers.size()));
+  ::snprintf(text,sizeof(text),"/ddg4.%d/",(int)m_ident);
   m_controlName = text;
   m_control = new G4UIdirectory(m_controlName.c_str());
   m_control->SetGuidance("Control for thread specific Geant4 actions");
@@ -122,6 +141,7 @@ Geant4Kernel::~Geant4Kernel() {
   }
   detail::destroyObjects(m_workers);
   if ( isMaster() )  {
+    releaseOutputs(m_processOutputs);
     detail::releaseObjects(m_globalFilters);
     detail::releaseObjects(m_globalActions);
   }
@@ -158,25 +178,71 @@ unsigned long int Geant4Kernel::thread_self()    {
   return thr_id;
 }
 
-/// Create identified worker instance
+/// Create the worker instance of the calling thread
 Geant4Kernel& Geant4Kernel::createWorker()   {
   if ( isMaster() )   {
     unsigned long identifier = thread_self();
-    Geant4Kernel* w = new Geant4Kernel(this, identifier);
-    m_workers[identifier] = w;
+    Geant4Kernel* w = 0;  {
+      G4AutoLock protection_lock(&worker_mutex);
+      if ( m_workers.find(identifier) != m_workers.end() )   {
+        throw runtime_error(format("Geant4Kernel", "DDG4: The thread 0x%p already owns a worker instance.",
+                                   (void*)identifier));
+      }
+      w = new Geant4Kernel(this, identifier);
+      m_workers[identifier] = w;
+      ++m_workerCount;
+      s_worker_slot.key    = m_workerKey.load(memory_order_relaxed);
+      s_worker_slot.worker = w;
+    }
     printout(INFO,"Geant4Kernel","+++ Created worker instance id=%ul",identifier);
     return *w;
   }
   throw runtime_error(format("Geant4Kernel", "DDG4: Only the master instance may create workers."));
 }
 
+/// Remove and delete the worker instance of a thread
+void Geant4Kernel::removeWorker(unsigned long identifier)   {
+  if ( isMaster() )   {
+    Geant4Kernel* w = 0;  {
+      G4AutoLock protection_lock(&worker_mutex);
+      Workers::iterator i = m_workers.find(identifier);
+      if ( i == m_workers.end() )   {
+        throw runtime_error(format("Geant4Kernel", "DDG4: The thread 0x%p owns no worker instance.",
+                                   (void*)identifier));
+      }
+      w = (*i).second;
+      m_workers.erase(i);
+      // All thread slots of this master must be resolved again
+      m_workerKey.store(++s_registry_key, memory_order_release);
+    }
+    if ( s_worker_slot.worker == w )   {
+      s_worker_slot.key    = 0;
+      s_worker_slot.worker = 0;
+    }
+    delete w;
+    return;
+  }
+  throw runtime_error(format("Geant4Kernel", "DDG4: Only the master instance may remove workers."));
+}
+
 /// Access worker instance by it's identifier
 Geant4Kernel& Geant4Kernel::worker(unsigned long identifier, bool create_if)    {
-  Workers::iterator i = m_workers.find(identifier);
-  if ( i != m_workers.end() )   {
-    return *((*i).second);
+  const WorkerSlot& slot = s_worker_slot;
+  if ( slot.key != 0 && slot.key == m_workerKey.load(memory_order_acquire) && identifier == slot.worker->m_id )  {
+    return *slot.worker;
   }
-  else if ( identifier == m_id )  {
+  else if ( isMaster() )  {
+    G4AutoLock protection_lock(&worker_mutex);
+    Workers::iterator i = m_workers.find(identifier);
+    if ( i != m_workers.end() )   {
+      if ( identifier == thread_self() )  {
+        s_worker_slot.key    = m_workerKey.load(memory_order_relaxed);
+        s_worker_slot.worker = (*i).second;
+      }
+      return *((*i).second);
+    }
+  }
+  if ( identifier == m_id )  {
     return *this;
   }
   else if ( !isMultiThreaded() )  {
@@ -193,6 +259,7 @@ Geant4Kernel& Geant4Kernel::worker(unsigned long identifier, bool create_if)
 
 /// Access number of workers
 int Geant4Kernel::numWorkers() const   {
+  G4AutoLock protection_lock(&worker_mutex);
   return m_workers.size();
 }
 
@@ -309,6 +376,7 @@ int Geant4Kernel::terminate() {
     Geant4Exec::terminate(*this);
   }
   destroyPhases();
+  releaseOutputs(m_processOutputs);
   detail::releaseObjects(m_globalFilters);
   detail::releaseObjects(m_globalActions);
   if ( ptr == this )  {
@@ -323,6 +391,35 @@ int Geant4Kernel::terminate() {
   return 1;
 }
 
+/// Multi process mode: File name used by the worker process 'process' for the output 'name'
+string Geant4Kernel::processFileName(const string& nam, int process)  {
+  if ( process < 0 || nam.empty() ) return nam;
+  char text[32];
+  size_t idx = nam.rfind('.'), slash = nam.rfind('/');
+  if ( idx == string::npos || (slash != string::npos && idx < slash) ) idx = nam.length();
+  ::snprintf(text,sizeof(text),".proc%d",process);
+  return nam.substr(0,idx) + text + nam.substr(idx);
+}
+
+/// Multi process mode: File name used by this process for the output 'name'. Unchanged if not forked.
+string Geant4Kernel::processFileName(const string& nam) const  {
+  return processFileName(nam, processNumber());
+}
+
+/// Multi process mode: Register output action to merge the worker process files. Adds a reference.
+Geant4Kernel& Geant4Kernel::registerProcessOutput(Geant4OutputAction* action)  {
+  if ( action )  {
+    ProcessOutputs& outputs = m_master->m_processOutputs;
+    if ( find(outputs.begin(), outputs.end(), action) == outputs.end() )  {
+      action->addRef();
+      outputs.push_back(action);
+    }
+    return *this;
+  }
+  throw runtime_error(format("Geant4Kernel", "DDG4: Attempt to register an invalid "
+                             "output action. [Action-Invalid]"));
+}
+
 /// Register action by name to be retrieved when setting up and connecting action objects
 /** Note: registered actions MUST be unique.
  *  However, not all actions need to registered....
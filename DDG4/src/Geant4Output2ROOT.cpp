@@ -26,6 +26,10 @@
 #include "TFile.h"
 #include "TTree.h"
 #include "TBranch.h"
+#include "TFileMerger.h"
+
+// C/C++ include files
+#include <unistd.h>
 
 using namespace dd4hep::sim;
 using namespace dd4hep;
@@ -66,11 +70,12 @@ TTree* Geant4Output2ROOT::section(const string& nam) {
 /// Callback to store the Geant4 run information
 void Geant4Output2ROOT::beginRun(const G4Run* run) {
   if (!m_file && !m_output.empty()) {
+    string fname = outputFileName();
     TDirectory::TContext ctxt(TDirectory::CurrentDirectory());
-    m_file = TFile::Open(m_output.c_str(), "RECREATE", "dd4hep Simulation data");
+    m_file = TFile::Open(fname.c_str(), "RECREATE", "dd4hep Simulation data");
     if (m_file->IsZombie()) {
       detail::deletePtr (m_file);
-      throw runtime_error("Failed to open ROOT output file:'" + m_output + "'");
+      throw runtime_error("Failed to open ROOT output file:'" + fname + "'");
     }
     m_tree = section("EVENT");
   }
@@ -190,3 +195,29 @@ void Geant4Output2ROOT::saveCollection(OutputContext<G4Event>& /* ctxt */, G4VHi
     fill(hc_nam, coll->vector_type(), &hits);
   }
 }
+
+/// Multi process mode: Merge the files of the worker processes into the output
+bool Geant4Output2ROOT::mergeProcessOutput(const vector<string>& inputs) {
+  if ( m_output.empty() || inputs.empty() )
+    return true;
+  TDirectory::TContext ctxt(TDirectory::CurrentDirectory());
+  TFileMerger merger(false);
+  if ( !merger.OutputFile(m_output.c_str(), "RECREATE") )  {
+    error("+++ Failed to open merged ROOT output file: %s", m_output.c_str());
+    return false;
+  }
+  for(const auto& f : inputs)  {
+    if ( !merger.AddFile(f.c_str(), false) )  {
+      error("+++ Failed to add worker process file %s to %s", f.c_str(), m_output.c_str());
+      return false;
+    }
+  }
+  if ( !merger.Merge() )  {
+    error("+++ Failed to merge %ld worker process files to %s", long(inputs.size()), m_output.c_str());
+    return false;
+  }
+  for(const auto& f : inputs)
+    ::unlink(f.c_str());
+  info("+++ Merged %ld worker process files to %s", long(inputs.size()), m_output.c_str());
+  return true;
+}
@@ -13,7 +13,9 @@
 
 // Framework include files
 #include "DD4hep/Printout.h"
+#include "DD4hep/Primitives.h"
 #include "DD4hep/InstanceCount.h"
+#include "DDG4/Geant4Kernel.h"
 #include "DDG4/Geant4Particle.h"
 #include "DDG4/Geant4RunAction.h"
 #include "DDG4/Geant4OutputAction.h"
@@ -35,6 +37,11 @@ Geant4OutputAction::Geant4OutputAction(Geant4Context* ctxt, const string& nam)
   declareProperty("HandleErrorsAsFatal", m_errorFatal=true);
   // Need to instantiate run action to configure fibers
   ctxt->runAction();
+  // Sequential output actions may be forked: files of the worker processes get merged
+  Geant4Kernel& krnl = ctxt->kernel();
+  if ( &krnl == &krnl.master() )  {
+    krnl.registerProcessOutput(this);
+  }
 }
 
 /// Default destructor
@@ -126,3 +133,16 @@ void Geant4OutputAction::saveEvent(OutputContext<G4Event>& /* ctxt */) {
 void Geant4OutputAction::saveCollection(OutputContext<G4Event>& /* ctxt */, G4VHitsCollection* /* collection */) {
 }
 
+
+/// Multi process mode: Name of the output file written by this process
+string Geant4OutputAction::outputFileName() const  {
+  return context()->kernel().processFileName(m_output);
+}
+
+/// Multi process mode: Merge the files of the worker processes into the output. Default: no merge
+bool Geant4OutputAction::mergeProcessOutput(const vector<string>& inputs)  {
+  for(const auto& f : inputs)
+    printout(WARNING,name(),"+++ Output of type %s cannot be merged. Worker process file: %s",
+             typeName(typeid(*this)).c_str(), f.c_str());
+  return false;
+}
@@ -0,0 +1,71 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework include files
+#include "DDG4/Geant4PlacementParameterisation.h"
+#include "DD4hep/InstanceCount.h"
+
+// Geant4 include files
+#include "G4VPhysicalVolume.hh"
+
+// C/C++ include files
+#include <map>
+#include <array>
+#include <cmath>
+
+using namespace std;
+using namespace dd4hep::sim;
+
+namespace  {
+  /// Rotation matrix elements rounded to 2^-32: equal keys for rotations equal to rounding errors
+  typedef array<long long,9> RotationKey;
+  RotationKey rotation_key(const G4RotationMatrix& r)   {
+    const double q = 4294967296e0;
+    return {{ llround(r.xx()*q), llround(r.xy()*q), llround(r.xz()*q),
+              llround(r.yx()*q), llround(r.yy()*q), llround(r.yz()*q),
+              llround(r.zx()*q), llround(r.zy()*q), llround(r.zz()*q) }};
+  }
+}
+
+/// Initializing constructor: transformations of the copies in copy number order
+Geant4PlacementParameterisation::Geant4PlacementParameterisation(const vector<G4Transform3D>& copies)
+  : G4VPVParameterisation()
+{
+  map<RotationKey,G4RotationMatrix*> distinct;
+  m_translations.reserve(copies.size());
+  m_rotations.reserve(copies.size());
+  for( const auto& t : copies )  {
+    G4RotationMatrix rot = t.getRotation().inverse();
+    m_translations.push_back(t.getTranslation());
+    if ( rot.isIdentity() )  {
+      m_rotations.push_back(0);
+      continue;
+    }
+    G4RotationMatrix*& m = distinct[rotation_key(rot)];
+    if ( !m )  {
+      m_matrices.emplace_back(new G4RotationMatrix(rot));
+      m = m_matrices.back().get();
+    }
+    m_rotations.push_back(m);
+  }
+  InstanceCount::increment(this);
+}
+
+/// Default destructor
+Geant4PlacementParameterisation::~Geant4PlacementParameterisation()   {
+  InstanceCount::decrement(this);
+}
+
+/// G4VPVParameterisation overload: Position the copy
+void Geant4PlacementParameterisation::ComputeTransformation(const G4int copy, G4VPhysicalVolume* pv)  const  {
+  pv->SetTranslation(m_translations[copy]);
+  pv->SetRotation(m_rotations[copy]);
+}
@@ -0,0 +1,83 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework include files
+#include "DDG4/Geant4Profile.h"
+
+// C/C++ include files
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <map>
+
+using namespace std;
+using namespace dd4hep::sim;
+
+namespace {
+  /// Registry lock
+  mutex s_lock;
+  /// Registry of all entries
+  vector<unique_ptr<Geant4ProfileEntry> >& registry()  {
+    static vector<unique_ptr<Geant4ProfileEntry> > s_entries;
+    return s_entries;
+  }
+  /// Aggregated entries of the last summary
+  vector<unique_ptr<Geant4ProfileEntry> >& summaries()  {
+    static vector<unique_ptr<Geant4ProfileEntry> > s_summary;
+    return s_summary;
+  }
+}
+
+/// Flag if profiling is enabled
+std::atomic<bool> Geant4Profile::s_enabled(false);
+
+/// Enable or disable profiling
+void Geant4Profile::enable(bool value)   {
+  s_enabled.store(value, std::memory_order_relaxed);
+}
+
+/// Create a new entry owned by the registry
+Geant4ProfileEntry* Geant4Profile::entry(const string& kind, const string& group, const string& name)   {
+  lock_guard<mutex> guard(s_lock);
+  registry().emplace_back(new Geant4ProfileEntry(kind, group, name));
+  return registry().back().get();
+}
+
+/// Access all entries aggregated by kind, group and name. Sorted by decreasing time
+Geant4Profile::Entries Geant4Profile::summary()   {
+  typedef tuple<string,string,string> key_t;
+  map<key_t, Geant4ProfileEntry*> aggregated;
+  Entries result;
+  lock_guard<mutex> guard(s_lock);
+  summaries().clear();
+  for( const auto& e : registry() )  {
+    Geant4ProfileEntry*& s = aggregated[key_t(e->kind, e->group, e->name)];
+    if ( !s )  {
+      summaries().emplace_back(s = new Geant4ProfileEntry(e->kind, e->group, e->name));
+      result.push_back(s);
+    }
+    s->time  += e->time.load(memory_order_relaxed);
+    s->calls += e->calls.load(memory_order_relaxed);
+  }
+  stable_sort(result.begin(), result.end(), [](const Geant4ProfileEntry* a, const Geant4ProfileEntry* b)
+              { return a->time.load() > b->time.load(); });
+  return result;
+}
+
+/// Reset the accumulated time of all entries
+void Geant4Profile::reset()   {
+  lock_guard<mutex> guard(s_lock);
+  for( const auto& e : registry() )  {
+    e->time  = 0;
+    e->calls = 0;
+  }
+}
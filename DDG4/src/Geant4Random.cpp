@@ -312,6 +312,12 @@ double Geant4Random::landau(double mean, double sigma)  {
   return gRandom->Landau(mean,sigma);
 }
 
+/// Create poisson distributed random numbers
+long Geant4Random::poisson(double mean)  {
+  if ( !m_inited ) initialize();
+  return long(gRandom->Poisson(mean));
+}
+
 /// Create tuple of randum number around a circle with radius r
 void   Geant4Random::circle(double &x, double &y, double r)  {
   if ( !m_inited ) initialize();  
@@ -142,7 +142,7 @@ void Geant4RunActionSequence::adopt(Geant4RunAction* action) {
 /// Pre-track action callback
 void Geant4RunActionSequence::begin(const G4Run* run) {
   G4AutoLock protection_lock(&sequence_mutex);
-  m_actors(&Geant4RunAction::begin, run);
+  m_actors.timed("RunAction/begin", &Geant4RunAction::begin, run);
   m_begin(run);
 }
 
@@ -150,5 +150,5 @@ void Geant4RunActionSequence::begin(const G4Run* run) {
 void Geant4RunActionSequence::end(const G4Run* run) {
   G4AutoLock protection_lock(&sequence_mutex);
   m_end(run);
-  m_actors(&Geant4RunAction::end, run);
+  m_actors.timed("RunAction/end", &Geant4RunAction::end, run);
 }
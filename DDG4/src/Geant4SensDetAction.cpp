@@ -354,6 +354,7 @@ bool Geant4SensDetActionSequence::process(G4Step* step, G4TouchableHistory* hist
   bool result = false;
   for (vector<Geant4Sensitive*>::iterator i = m_actors->begin(); i != m_actors->end(); ++i) {
     Geant4Sensitive* s = *i;
+    Geant4Profile::Timer timer(s->profile("Sensitive/process"));
     if (s->accept(step))
       result |= s->process(step, hist);
   }
@@ -373,14 +374,14 @@ void Geant4SensDetActionSequence::begin(G4HCofThisEvent* hce) {
     int id = m_detector->GetCollectionID(count);
     m_hce->AddHitsCollection(id, c);
   }
-  m_actors(&Geant4Sensitive::begin, m_hce);
+  m_actors.timed("Sensitive/begin", &Geant4Sensitive::begin, m_hce);
   m_begin (m_hce);
 }
 
 /// G4VSensitiveDetector interface: Method invoked at the end of each event.
 void Geant4SensDetActionSequence::end(G4HCofThisEvent* hce) {
   m_end(hce);
-  m_actors(&Geant4Sensitive::end, hce);
+  m_actors.timed("Sensitive/end", &Geant4Sensitive::end, hce);
   // G4HCofThisEvent must be availible until end-event. m_hce = 0;
 }
 
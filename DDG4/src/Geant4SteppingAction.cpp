@@ -113,7 +113,7 @@ Geant4SteppingAction* Geant4SteppingActionSequence::get(const string& nam) const
 
 /// Pre-track action callback
 void Geant4SteppingActionSequence::operator()(const G4Step* step, G4SteppingManager* mgr) {
-  m_actors(&Geant4SteppingAction::operator(), step, mgr);
+  m_actors.timed("SteppingAction", &Geant4SteppingAction::operator(), step, mgr);
   m_calls(step, mgr);
 }
 
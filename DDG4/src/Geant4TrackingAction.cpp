@@ -84,14 +84,14 @@ void Geant4TrackingActionSequence::adopt(Geant4TrackingAction* action) {
 /// Pre-track action callback
 void Geant4TrackingActionSequence::begin(const G4Track* track) {
   m_front(track);
-  m_actors(&Geant4TrackingAction::begin, track);
+  m_actors.timed("TrackingAction/begin", &Geant4TrackingAction::begin, track);
   m_begin(track);
 }
 
 /// Post-track action callback
 void Geant4TrackingActionSequence::end(const G4Track* track) {
   m_end(track);
-  m_actors(&Geant4TrackingAction::end, track);
+  m_actors.timed("TrackingAction/end", &Geant4TrackingAction::end, track);
   m_final(track);
 }
 
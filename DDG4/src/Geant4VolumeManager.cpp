@@ -64,7 +64,7 @@ namespace {
         if (pv.isValid()) {
           Chain chain;
           SensitiveDetector sd;
-          PlacedVolume::VolIDs ids;
+          PlacedVolume::VolIDCodes ids;
           m_entries.clear();
           chain.push_back(m_detDesc.world().placement().ptr());
           scanPhysicalVolume(pv.ptr(), ids, sd, chain);
@@ -75,13 +75,21 @@ namespace {
     }
 
     /// Scan a single physical volume and look for sensitive elements below
-    void scanPhysicalVolume(const TGeoNode* node, PlacedVolume::VolIDs ids, SensitiveDetector& sd, Chain& chain) {
+    void scanPhysicalVolume(const TGeoNode* node, PlacedVolume::VolIDCodes ids, SensitiveDetector& sd, Chain& chain) {
       PlacedVolume pv = node;
       Volume vol = pv.volume();
-      PlacedVolume::VolIDs pv_ids = pv.volIDs();
+      const PlacedVolume::VolIDCodes& pv_ids = pv.volIDCodes();
+      const PlacedVolumeExtension::Parameterisation* params = pv.parameterisation();
+
+      if ( params && node->GetNumber() != params->first )  {
+        // The copies of a G4PVReplica/G4PVParameterised share the entries of the first copy
+        PlacementMap::const_iterator g4pit = m_geo.g4Placements.find(node);
+        if ( g4pit != m_geo.g4Placements.end() && (*g4pit).second->IsReplicated() )
+          return;
+      }
 
       chain.push_back(node);
-      ids.PlacedVolume::VolIDs::Base::insert(ids.end(), pv_ids.begin(), pv_ids.end());
+      ids.insert(ids.end(), pv_ids.begin(), pv_ids.end());
       if (vol.isSensitive()) {
         sd = vol.sensitiveDetector();
         if (sd.readout().isValid()) {
@@ -103,7 +111,28 @@ namespace {
       chain.pop_back();
     }
 
-    void add_entry(SensitiveDetector sd, const TGeoNode* /* n */, const PlacedVolume::VolIDs& ids, const Chain& nodes) {
+    /// Register the volume ID fields of the replicated placements in the chain
+    void add_replicas(const IDDescriptor& iddesc, const Chain& nodes)  {
+      for( const TGeoNode* n : nodes )  {
+        const PlacedVolumeExtension::Parameterisation* params = PlacedVolume(n).parameterisation();
+        if ( params )  {
+          PlacementMap::const_iterator g4pit = m_geo.g4Placements.find(n);
+          if ( g4pit == m_geo.g4Placements.end() || !(*g4pit).second->IsReplicated() )
+            continue;
+          else if ( m_geo.g4Replicas.find((*g4pit).second) != m_geo.g4Replicas.end() )
+            continue;
+          ReplicaFields& fields = m_geo.g4Replicas[(*g4pit).second];
+          for( const auto& d : params->dimensions )  {
+            const BitFieldValue* f = 0;
+            if ( !d.field.empty() )
+              f = iddesc.field(d.field);
+            fields.push_back(make_pair(f, d.count));
+          }
+        }
+      }
+    }
+
+    void add_entry(SensitiveDetector sd, const TGeoNode* /* n */, const PlacedVolume::VolIDCodes& ids, const Chain& nodes) {
       Chain control;
       const TGeoNode* node;
       Volume vol;
@@ -111,6 +140,7 @@ namespace {
       Readout ro = sd.readout();
       IDDescriptor iddesc = ro.idSpec();
       VolumeID code = iddesc.encode(ids);
+      add_replicas(iddesc, nodes);
       Registries::const_iterator i = m_entries.find(code);
       PrintLevel print_action = VERBOSE;
       PrintLevel print_chain = VERBOSE;
@@ -234,10 +264,33 @@ VolumeID Geant4VolumeManager::volumeID(const vector<const G4VPhysicalVolume*>& p
   return NonExisting;
 }
 
+/// Add the volume ID fields of replicated placements to the volume ID of the first copy
+VolumeID Geant4VolumeManager::replicaID(const G4VTouchable* touchable, VolumeID vid) const {
+  const ReplicaMap& replicas = ptr()->g4Replicas;
+  for (int depth = 0, n = touchable->GetHistoryDepth(); depth < n; ++depth) {
+    ReplicaMap::const_iterator i = replicas.find(touchable->GetVolume(depth));
+    if (i != replicas.end()) {
+      size_t copy = touchable->GetReplicaNumber(depth);
+      for (const auto& f : (*i).second) {
+        VolumeID val = copy % f.second;
+        copy /= f.second;
+        if (f.first) {
+          int off = f.first->offset();
+          vid |= ((f.first->value(val << off) << off) & f.first->mask());
+        }
+      }
+    }
+  }
+  return vid;
+}
+
 /// Access CELLID by Geant4 touchable object
 VolumeID Geant4VolumeManager::volumeID(const G4VTouchable* touchable) const {
   Geant4TouchableHandler handler(touchable);
-  return volumeID(handler.placementPath());
+  VolumeID vid = volumeID(handler.placementPath());
+  if (vid != InvalidPath && vid != Insensitive && vid != NonExisting && !ptr()->g4Replicas.empty())
+    return replicaID(touchable, vid);
+  return vid;
 }
 
 /// Accessfully decoded volume fields  by placement path
@@ -282,5 +335,11 @@ void Geant4VolumeManager::volumeDescriptor(const vector<const G4VPhysicalVolume*
 void Geant4VolumeManager::volumeDescriptor(const G4VTouchable* touchable,
                                            VolIDDescriptor& vol_desc) const {
   volumeDescriptor(placementPath(touchable), vol_desc);
+  VolumeID vid = vol_desc.first;
+  if (vid != InvalidPath && vid != Insensitive && vid != NonExisting && !ptr()->g4Replicas.empty()) {
+    vol_desc.first = replicaID(touchable, vid);
+    for (auto& f : vol_desc.second)
+      f.second = f.first->value(vol_desc.first);
+  }
 }
 
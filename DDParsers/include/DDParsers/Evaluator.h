@@ -14,6 +14,12 @@
 #ifndef XMLTOOLS_EVALUATOR_H
 #define XMLTOOLS_EVALUATOR_H
 
+// C/C++ include files
+#include <string>
+#include <utility>
+#include <iosfwd>
+#include <cstddef>
+
 /// Namespace containing XML tools.
 namespace XmlTools {
 
@@ -30,6 +36,14 @@ namespace XmlTools {
    *   if (eval.status() != XmlTools::Evaluator::OK) eval.print_error();
    * @endcode
    *
+   * Expressions are compiled on first use and the compiled form is
+   * cached, so that repeated evaluations skip the parsing step.
+   * The const evaluate() overloads returning the status together with
+   * the result may be called concurrently from several threads.
+   * Modifications of the dictionary are serialized with respect to
+   * evaluations. The overloads relying on status() and print_error()
+   * keep per-evaluator state and are not thread safe.
+   *
    * @author Evgeni Chernyaev <Evgueni.Tcherniaev@cern.ch>
    * @ingroup evaluator
    */
@@ -85,6 +99,33 @@ namespace XmlTools {
      */
     double evaluate(const char * expression);
 
+    /**
+     * Thread safe evaluation of an arithmetic expression.
+     * The status and the error position of the evaluator are not changed.
+     *
+     * @param  expression input expression.
+     * @return pair of the status of the evaluation and its result.
+     */
+    std::pair<int,double> evaluate(const std::string& expression) const;
+
+    /**
+     * Thread safe evaluation of an arithmetic expression.
+     * If the status is an ERROR, the error message is printed to the given stream.
+     *
+     * @param  expression input expression.
+     * @param  os         output stream for error messages.
+     * @return pair of the status of the evaluation and its result.
+     */
+    std::pair<int,double> evaluate(const std::string& expression, std::ostream& os) const;
+
+    /**
+     * Sets the maximal number of compiled expressions kept in the cache.
+     * When the cache is full, it is cleared. 0 disables the cache.
+     *
+     * @param n maximal number of cached expressions.
+     */
+    void setCacheSize(std::size_t n);
+
     /**
      * Returns status of the last operation with the evaluator.
      */
@@ -12,6 +12,11 @@
 #include <ctype.h>
 #include <errno.h>
 #include <stdlib.h>     // for strtod()
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 
 // Disable some diagnostics, which we know, but need to ignore
 #if defined(__GNUC__) && !defined(__APPLE__) && !defined(__llvm__)
@@ -41,13 +46,27 @@ typedef char * pchar;
 typedef hash_map<string,Item> dic_type;
 
 namespace {
+  struct Program;
+  typedef std::shared_ptr<const Program> program_t;
+  typedef std::unordered_map<std::string,program_t> cache_type;
+
   struct Struct {
     dic_type theDictionary;
     pchar    theExpression;
     pchar    thePosition;
     int      theStatus;
     double   theResult;
+    /// Dictionary protection: shared while evaluating, exclusive while modifying
+    std::shared_timed_mutex theLock;
+    /// Cache of compiled expressions. Compilation does not depend on the dictionary.
+    cache_type theCache;
+    /// Protection of the cache
+    std::mutex theCacheLock;
+    /// Maximal number of cached expressions. 0 disables the cache.
+    size_t     theCacheSize;
   };
+  typedef std::shared_lock<std::shared_timed_mutex> read_lock_t;
+  typedef std::unique_lock<std::shared_timed_mutex> write_lock_t;
 
   union FCN {
     void* ptr;
@@ -110,14 +129,19 @@ static int variable(const string & name, double & result,
   dic_type::const_iterator iter = dictionary.find(name);
   if (iter == dictionary.end())
     return EVAL::ERROR_UNKNOWN_VARIABLE;
-  Item item = iter->second;
+  const Item& item = iter->second;
   switch (item.what) {
   case Item::VARIABLE:
     result = item.variable;
     return EVAL::OK;
   case Item::EXPRESSION: {
-    pchar exp_begin = (char *)(item.expression.c_str());
-    pchar exp_end   = exp_begin + strlen(exp_begin) - 1;
+    // operand() temporarily modifies the string: parse a private copy,
+    // the dictionary item may be evaluated concurrently by other threads.
+    const char* expression = item.expression.c_str();
+    size_t      len = strlen(expression);
+    std::vector<char> buffer(expression, expression+len+1);
+    pchar exp_begin = &buffer[0];
+    pchar exp_end   = exp_begin + len - 1;
     if (engine(exp_begin, exp_end, result, exp_end, dictionary) == EVAL::OK)
       return EVAL::OK;
     return EVAL::ERROR_CALCULATION_ERROR;
@@ -150,7 +174,7 @@ static int function(const string & name, stack<double> & par,
 
   dic_type::const_iterator iter = dictionary.find(sss[npar]+name);
   if (iter == dictionary.end()) return EVAL::ERROR_UNKNOWN_FUNCTION;
-  Item item = iter->second;
+  const Item& item = iter->second;
 
   double pp[MAX_N_PAR];
   for(int i=0; i<npar; i++) { pp[i] = par.top(); par.pop(); }
@@ -544,6 +568,467 @@ static int engine(pchar begin, pchar end, double & result,
   }
 }
 
+//---------------------------------------------------------------------------
+//
+//   C O M P I L E D   E X P R E S S I O N S
+//
+//   The compiler below follows engine() and operand() token by token,
+//   but instead of calculating the value it emits the operations in
+//   postfix order. Names of variables and functions are only resolved
+//   when the program is executed, hence a compiled expression does not
+//   depend on the content of the dictionary and can be cached.
+//   The compiler only accepts expressions, which engine() would accept
+//   as well. Whenever compilation or execution fails, the caller falls
+//   back to engine() to obtain the exact error status and position.
+//
+//---------------------------------------------------------------------------
+namespace {
+  enum { PUSH = VALUE+1, VAR, CALL };
+
+  /// Single instruction of a compiled expression
+  struct Instruction {
+    int    op;        // PUSH, VAR, CALL or the code of a binary operator
+    int    npar;      // Number of parameters for CALL
+    double value;     // Value for PUSH
+    size_t name;      // Index of the dictionary key for VAR and CALL
+  };
+
+  /// Compiled expression in postfix order
+  struct Program {
+    std::vector<Instruction> code;
+    std::vector<string>      names;   // Dictionary keys: "name" or "<npar>name"
+    size_t                   depth = 0;
+    void emit(int op, double value=0.0, int npar=0, size_t name=0)  {
+      Instruction i = { op, npar, value, name };
+      code.push_back(i);
+    }
+  };
+}
+
+static int compile_engine(pchar, pchar, pchar &, size_t, Program &);
+
+static int compile_operand(pchar begin, pchar end, pchar & endp,
+                           size_t depth, Program & prog)
+/***********************************************************************
+ *                                                                     *
+ * Function: Compiles an operand: number, variable or function call.   *
+ *           Mirrors operand().                                        *
+ *                                                                     *
+ ***********************************************************************/
+{
+  pchar pointer = begin;
+  int   EVAL_STATUS;
+  char  c;
+
+  //   G E T   N U M B E R
+
+  if (!isalpha(*pointer)) {
+    double result;
+    errno = 0;
+#ifdef _WIN32
+    if ( pointer[0] == '0' && pointer < end && (pointer[1] == 'x' || pointer[1] == 'X') )
+      result = strtol(pointer, (char **)(&pointer), 0);
+    else
+#endif
+      result = strtod(pointer, (char **)(&pointer));
+    if (errno == 0) {
+      prog.emit(PUSH, result);
+      EVAL_EXIT( EVAL::OK, --pointer );
+    }else{
+      EVAL_EXIT( EVAL::ERROR_CALCULATION_ERROR, begin );
+    }
+  }
+
+  //   G E T   N A M E
+
+  while(pointer <= end) {
+    c = *pointer;
+    if (c != '_' && !isalnum(c)) break;
+    pointer++;
+  }
+  c = *pointer;
+  *pointer = '\0';
+  string name(begin);
+  *pointer = c;
+
+  //   G E T   V A R I A B L E
+
+  SKIP_BLANKS;
+  if (c != '(') {
+    prog.names.push_back(name);
+    prog.emit(VAR, 0.0, 0, prog.names.size()-1);
+    EVAL_EXIT( EVAL::OK, --pointer );
+  }
+
+  //   G E T   F U N C T I O N
+
+  stack<pchar>  pos;                // position stack
+  int           npar = 0;           // number of parameters
+  pchar         par_begin = pointer+1, par_end;
+
+  for(;;pointer++) {
+    c = (pointer > end) ? '\0' : *pointer;
+    switch (c) {
+    case '\0':
+      EVAL_EXIT( EVAL::ERROR_UNPAIRED_PARENTHESIS, pos.top() );
+    case '(':
+      pos.push(pointer); break;
+    case ',':
+      if (pos.size() == 1) {
+        par_end = pointer-1;
+        EVAL_STATUS = compile_engine(par_begin, par_end, par_end, depth+npar, prog);
+        if (EVAL_STATUS == EVAL::WARNING_BLANK_STRING)
+        { EVAL_EXIT( EVAL::ERROR_EMPTY_PARAMETER, --par_end ); }
+        if (EVAL_STATUS != EVAL::OK)
+        { EVAL_EXIT( EVAL_STATUS, par_end ); }
+        ++npar;
+        par_begin = pointer + 1;
+      }
+      break;
+    case ')':
+      if (pos.size() > 1) {
+        pos.pop();
+        break;
+      }else{
+        par_end = pointer-1;
+        EVAL_STATUS = compile_engine(par_begin, par_end, par_end, depth+npar, prog);
+        switch (EVAL_STATUS) {
+        case EVAL::OK:
+          ++npar;
+          break;
+        case EVAL::WARNING_BLANK_STRING:
+          if (npar != 0)
+          { EVAL_EXIT( EVAL::ERROR_EMPTY_PARAMETER, --par_end ); }
+          break;
+        default:
+          EVAL_EXIT( EVAL_STATUS, par_end );
+        }
+        if (npar > MAX_N_PAR)
+        { EVAL_EXIT( EVAL::ERROR_UNKNOWN_FUNCTION, begin ); }
+        prog.names.push_back(sss[npar]+name);
+        prog.emit(CALL, 0.0, npar, prog.names.size()-1);
+        EVAL_EXIT( EVAL::OK, pointer );
+      }
+    }
+  }
+}
+
+static int compile_engine(pchar begin, pchar end, pchar & endp,
+                          size_t depth, Program & prog)
+/***********************************************************************
+ *                                                                     *
+ * Function: Compiles an arithmetic expression. Mirrors engine().      *
+ *           depth is the number of values already on the stack when   *
+ *           the code of this (sub-)expression gets executed.          *
+ *                                                                     *
+ ***********************************************************************/
+{
+  static const int SyntaxTable[17][17] = {
+    //E  (  || && == != >= >  <= <  +  -  *  /  ^  )  V - current token
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 0, 0, 0, 0, 1 },   // E - previous
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 0, 0, 0, 0, 1 },   // (   token
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // ||
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // &&
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // ==
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // !=
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // >=
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // >
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // <=
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // <
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // +
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // -
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // *
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // /
+    { 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },   // ^
+    { 3, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0 },   // )
+    { 3, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0 }    // V = {.,N,C}
+  };
+  static const int ActionTable[15][16] = {
+    //E  (  || && == != >= >  <= <  +  -  *  /  ^  ) - current operator
+    { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,-1 }, // E - top operator
+    {-1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3 }, // (   in stack
+    { 4, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 4 }, // ||
+    { 4, 1, 4, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 4 }, // &&
+    { 4, 1, 4, 4, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 4 }, // ==
+    { 4, 1, 4, 4, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 4 }, // !=
+    { 4, 1, 4, 4, 4, 4, 2, 2, 2, 2, 1, 1, 1, 1, 1, 4 }, // >=
+    { 4, 1, 4, 4, 4, 4, 2, 2, 2, 2, 1, 1, 1, 1, 1, 4 }, // >
+    { 4, 1, 4, 4, 4, 4, 2, 2, 2, 2, 1, 1, 1, 1, 1, 4 }, // <=
+    { 4, 1, 4, 4, 4, 4, 2, 2, 2, 2, 1, 1, 1, 1, 1, 4 }, // <
+    { 4, 1, 4, 4, 4, 4, 4, 4, 4, 4, 2, 2, 1, 1, 1, 4 }, // +
+    { 4, 1, 4, 4, 4, 4, 4, 4, 4, 4, 2, 2, 1, 1, 1, 4 }, // -
+    { 4, 1, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 2, 2, 1, 4 }, // *
+    { 4, 1, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 2, 2, 1, 4 }, // /
+    { 4, 1, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4 }  // ^
+  };
+
+  stack<int>    op;                      // operator stack
+  stack<pchar>  pos;                     // position stack
+  size_t        nval = 0;                // size of the value stack
+  pchar         pointer = begin;
+  int           iWhat, iCur, iPrev = 0, iTop, EVAL_STATUS;
+  char          c;
+
+#define PUSH_VALUE  if (depth + ++nval > prog.depth) prog.depth = depth + nval
+#define MAKE_VALUE(OP)                                            \
+  if (nval < 2) { EVAL_EXIT( EVAL::ERROR_SYNTAX_ERROR, pos.top() ); } \
+  prog.emit(OP); --nval
+
+  op.push(0); pos.push(pointer);         // push EOL to the stack
+  SKIP_BLANKS;
+  if (c == '\0') { EVAL_EXIT( EVAL::WARNING_BLANK_STRING, begin ); }
+  for(;;pointer++) {
+
+    //   N E X T   T O K E N
+
+    c = (pointer > end) ? '\0' : *pointer;
+    if (isspace(c)) continue;            // skip space, tab etc.
+    switch (c) {
+    case '\0': iCur = ENDL; break;
+    case '(':  iCur = LBRA; break;
+    case '|':
+      if (*(pointer+1) == '|') {
+        pointer++; iCur = OR; break;
+      }else{
+        EVAL_EXIT( EVAL::ERROR_UNEXPECTED_SYMBOL, pointer );
+      }
+    case '&':
+      if (*(pointer+1) == '&') {
+        pointer++; iCur = AND; break;
+      }else{
+        EVAL_EXIT( EVAL::ERROR_UNEXPECTED_SYMBOL, pointer );
+      }
+    case '=':
+      if (*(pointer+1) == '=') {
+        pointer++; iCur = EQ; break;
+      }else{
+        EVAL_EXIT( EVAL::ERROR_UNEXPECTED_SYMBOL, pointer );
+      }
+    case '!':
+      if (*(pointer+1) == '=') {
+        pointer++; iCur = NE; break;
+      }else{
+        EVAL_EXIT( EVAL::ERROR_UNEXPECTED_SYMBOL, pointer );
+      }
+    case '>':
+      if (*(pointer+1) == '=') { pointer++; iCur = GE; } else { iCur = GT; }
+      break;
+    case '<':
+      if (*(pointer+1) == '=') { pointer++; iCur = LE; } else { iCur = LT; }
+      break;
+    case '+':  iCur = PLUS;  break;
+    case '-':  iCur = MINUS; break;
+    case '*':
+      if (*(pointer+1) == '*') { pointer++; iCur = POW; }else{ iCur = MULT; }
+      break;
+    case '/':  iCur = DIV;  break;
+    case '^':  iCur = POW;  break;
+    case ')':  iCur = RBRA; break;
+    default:
+      if (c == '.' || isalnum(c)) {
+        iCur = VALUE; break;
+      }else{
+        EVAL_EXIT( EVAL::ERROR_UNEXPECTED_SYMBOL, pointer );
+      }
+    }
+
+    //   S Y N T A X   A N A L I S Y S
+
+    iWhat = SyntaxTable[iPrev][iCur];
+    iPrev = iCur;
+    switch (iWhat) {
+    case 0:                             // systax error
+      EVAL_EXIT( EVAL::ERROR_SYNTAX_ERROR, pointer );
+    case 1:                             // operand: number, variable, function
+      EVAL_STATUS = compile_operand(pointer, end, pointer, depth+nval, prog);
+      if (EVAL_STATUS != EVAL::OK) { EVAL_EXIT( EVAL_STATUS, pointer ); }
+      PUSH_VALUE;
+      continue;
+    case 2:                             // unary + or unary -
+      prog.emit(PUSH, 0.0);
+      PUSH_VALUE;
+      [[fallthrough]];
+    case 3: default:                    // next operator
+      break;
+    }
+
+    //   N E X T   O P E R A T O R
+
+    for(;;) {
+      if (op.size() == 0) { EVAL_EXIT( EVAL::ERROR_SYNTAX_ERROR, pointer ); }
+      iTop = op.top();
+      switch (ActionTable[iTop][iCur]) {
+      case -1:                           // syntax error
+        if (op.size() > 1) pointer = pos.top();
+        EVAL_EXIT( EVAL::ERROR_UNPAIRED_PARENTHESIS, pointer );
+      case 0:                            // last operation (assignment)
+        if (nval == 1) {
+          EVAL_EXIT( EVAL::OK, pointer );
+        }else{
+          EVAL_EXIT( EVAL::ERROR_SYNTAX_ERROR, pointer );
+        }
+      case 1:                           // push current operator in stack
+        op.push(iCur); pos.push(pointer);
+        break;
+      case 2:                           // execute top operator
+        MAKE_VALUE(iTop);               // put current operator in stack
+        op.top() = iCur; pos.top() = pointer;
+        break;
+      case 3:                           // delete '(' from stack
+        op.pop(); pos.pop();
+        break;
+      case 4: default:                  // execute top operator and
+        MAKE_VALUE(iTop);               // delete it from stack
+        op.pop(); pos.pop();            // repete with the same iCur
+        continue;
+      }
+      break;
+    }
+  }
+#undef PUSH_VALUE
+#undef MAKE_VALUE
+}
+
+static int evaluate_cached(const char *, double &, Struct *);
+
+static int execute(const Program & prog, double & result, Struct * s)
+/***********************************************************************
+ *                                                                     *
+ * Function: Executes a compiled expression. The caller must hold the  *
+ *           dictionary lock. Dictionary items are only accessed by    *
+ *           reference: the reference count of string is not atomic.   *
+ *                                                                     *
+ ***********************************************************************/
+{
+  const dic_type& dictionary = s->theDictionary;
+  double  buffer[64];
+  std::unique_ptr<double[]> heap;
+  double* val = buffer;
+  size_t  n = 0;
+  if ( prog.depth > sizeof(buffer)/sizeof(buffer[0]) )  {
+    heap.reset(new double[prog.depth]);
+    val = heap.get();
+  }
+  for( const Instruction& i : prog.code )  {
+    switch (i.op) {
+    case PUSH:
+      val[n++] = i.value;
+      break;
+    case VAR: {
+      dic_type::const_iterator iter = dictionary.find(prog.names[i.name]);
+      if (iter == dictionary.end()) return EVAL::ERROR_UNKNOWN_VARIABLE;
+      const Item& item = iter->second;
+      if (item.what == Item::VARIABLE)
+        val[n++] = item.variable;
+      else if (item.what != Item::EXPRESSION)
+        return EVAL::ERROR_CALCULATION_ERROR;
+      else if (evaluate_cached(item.expression.c_str(), val[n++], s) != EVAL::OK)
+        return EVAL::ERROR_CALCULATION_ERROR;
+      break;
+    }
+    case CALL: {
+      dic_type::const_iterator iter = dictionary.find(prog.names[i.name]);
+      if (iter == dictionary.end()) return EVAL::ERROR_UNKNOWN_FUNCTION;
+      const Item& item = iter->second;
+      if (item.function == 0) return EVAL::ERROR_CALCULATION_ERROR;
+      FCN fcn(item.function);
+      double* pp = val + n - i.npar;
+      errno = 0;
+      switch (i.npar) {
+      case 0: *pp = (*fcn.f0)(); break;
+      case 1: *pp = (*fcn.f1)(pp[0]); break;
+      case 2: *pp = (*fcn.f2)(pp[0],pp[1]); break;
+      case 3: *pp = (*fcn.f3)(pp[0],pp[1],pp[2]); break;
+      case 4: *pp = (*fcn.f4)(pp[0],pp[1],pp[2],pp[3]); break;
+      case 5: *pp = (*fcn.f5)(pp[0],pp[1],pp[2],pp[3],pp[4]); break;
+      }
+      if (errno != 0) return EVAL::ERROR_CALCULATION_ERROR;
+      n += 1 - i.npar;
+      break;
+    }
+    default: {
+      double val2 = val[--n];
+      double& val1 = val[n-1];
+      switch (i.op) {
+      case OR:    val1 = (val1 || val2) ? 1. : 0.; break;
+      case AND:   val1 = (val1 && val2) ? 1. : 0.; break;
+      case EQ:    val1 = (val1 == val2) ? 1. : 0.; break;
+      case NE:    val1 = (val1 != val2) ? 1. : 0.; break;
+      case GE:    val1 = (val1 >= val2) ? 1. : 0.; break;
+      case GT:    val1 = (val1 >  val2) ? 1. : 0.; break;
+      case LE:    val1 = (val1 <= val2) ? 1. : 0.; break;
+      case LT:    val1 = (val1 <  val2) ? 1. : 0.; break;
+      case PLUS:  val1 = val1 + val2;  break;
+      case MINUS: val1 = val1 - val2;  break;
+      case MULT:  val1 = val1 * val2;  break;
+      case DIV:
+        if (val2 == 0.0) return EVAL::ERROR_CALCULATION_ERROR;
+        val1 = val1 / val2;
+        break;
+      case POW:
+        errno = 0;
+        val1 = pow(val1,val2);
+        if (errno != 0) return EVAL::ERROR_CALCULATION_ERROR;
+        break;
+      default:
+        return EVAL::ERROR_CALCULATION_ERROR;
+      }
+      break;
+    }
+    }
+  }
+  result = val[0];
+  return EVAL::OK;
+}
+
+static program_t compile(const char * expression, Struct * s)
+/***********************************************************************
+ *                                                                     *
+ * Function: Access the compiled form of an expression. Expressions    *
+ *           are compiled on first use and kept in the cache. If the   *
+ *           compiler rejects the expression, 0 is returned (and       *
+ *           cached as well).                                          *
+ *                                                                     *
+ ***********************************************************************/
+{
+  std::string key(expression);
+  {
+    std::lock_guard<std::mutex> lock(s->theCacheLock);
+    cache_type::const_iterator i = s->theCache.find(key);
+    if (i != s->theCache.end()) return i->second;
+  }
+  std::shared_ptr<Program> prog(new Program);
+  std::vector<char> buffer(key.begin(), key.end());
+  buffer.push_back('\0');
+  pchar begin = &buffer[0], endp = begin;
+  if (compile_engine(begin, begin+key.length()-1, endp, 0, *prog) != EVAL::OK)
+    prog.reset();
+  std::lock_guard<std::mutex> lock(s->theCacheLock);
+  if (s->theCache.size() >= s->theCacheSize) s->theCache.clear();
+  s->theCache.emplace(key, prog);
+  return prog;
+}
+
+static int evaluate_cached(const char * expression, double & result, Struct * s)
+/***********************************************************************
+ *                                                                     *
+ * Function: Evaluates an expression using the cache of compiled       *
+ *           expressions. Expressions, which are not cached or which   *
+ *           fail are evaluated by engine() on a private copy of the   *
+ *           expression. The caller must hold the dictionary lock.     *
+ *                                                                     *
+ ***********************************************************************/
+{
+  if (s->theCacheSize > 0) {
+    program_t prog = compile(expression, s);
+    if (prog && execute(*prog, result, s) == EVAL::OK) return EVAL::OK;
+  }
+  size_t len = strlen(expression);
+  std::vector<char> buffer(expression, expression+len+1);
+  pchar begin = &buffer[0], endp = begin;
+  return engine(begin, begin+len-1, result, endp, s->theDictionary);
+}
+
 //---------------------------------------------------------------------------
 static void setItem(const char * prefix, const char * name,
                     const Item & item, Struct * s) {
@@ -588,6 +1073,40 @@ static void setItem(const char * prefix, const char * name,
   }
 }
 
+//---------------------------------------------------------------------------
+static void print_error_status(std::ostream& os, int status, const char* position) {
+  static const char prefix[] = "Evaluator : ";
+  const char* opt = (position ? position : "");
+  switch (status) {
+  case EVAL::ERROR_NOT_A_NAME:
+    os << prefix << "invalid name : " << opt << std::endl;
+    return;
+  case EVAL::ERROR_SYNTAX_ERROR:
+    os << prefix << "systax error"         << std::endl;
+    return;
+  case EVAL::ERROR_UNPAIRED_PARENTHESIS:
+    os << prefix << "unpaired parenthesis" << std::endl;
+    return;
+  case EVAL::ERROR_UNEXPECTED_SYMBOL:
+    os << prefix << "unexpected symbol : " << opt << std::endl;
+    return;
+  case EVAL::ERROR_UNKNOWN_VARIABLE:
+    os << prefix << "unknown variable : " << opt << std::endl;
+    return;
+  case EVAL::ERROR_UNKNOWN_FUNCTION:
+    os << prefix << "unknown function : " << opt << std::endl;
+    return;
+  case EVAL::ERROR_EMPTY_PARAMETER:
+    os << prefix << "empty parameter in function call: " << opt << std::endl;
+    return;
+  case EVAL::ERROR_CALCULATION_ERROR:
+    os << prefix << "calculation error"    << std::endl;
+    return;
+  default:
+    return;
+  }
+}
+
 //---------------------------------------------------------------------------
 namespace XmlTools {
 
@@ -599,6 +1118,7 @@ namespace XmlTools {
     s->thePosition   = 0;
     s->theStatus     = OK;
     s->theResult     = 0.0;
+    s->theCacheSize  = 10000;
   }
 
   //---------------------------------------------------------------------------
@@ -620,8 +1140,17 @@ namespace XmlTools {
     s->theStatus     = WARNING_BLANK_STRING;
     s->theResult     = 0.0;
     if (expression != 0) {
+      read_lock_t lock(s->theLock);
       s->theExpression = new char[strlen(expression)+1];
       strcpy(s->theExpression, expression);
+      if (s->theCacheSize > 0) {
+        program_t prog = compile(expression, s);
+        if (prog && execute(*prog, s->theResult, s) == OK) {
+          s->theStatus = OK;
+          return s->theResult;
+        }
+        s->theResult = 0.0;
+      }
       s->theStatus = engine(s->theExpression,
                             s->theExpression+strlen(expression)-1,
                             s->theResult,
@@ -631,6 +1160,47 @@ namespace XmlTools {
     return s->theResult;
   }
 
+  //---------------------------------------------------------------------------
+  std::pair<int,double> Evaluator::evaluate(const std::string& expression) const {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    double result = 0.0;
+    read_lock_t lock(s->theLock);
+    int status = evaluate_cached(expression.c_str(), result, s);
+    return std::make_pair(status, status == OK ? result : 0.0);
+  }
+
+  //---------------------------------------------------------------------------
+  std::pair<int,double> Evaluator::evaluate(const std::string& expression, std::ostream& os) const {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    double result = 0.0;
+    read_lock_t lock(s->theLock);
+    if (s->theCacheSize > 0) {
+      program_t prog = compile(expression.c_str(), s);
+      if (prog && execute(*prog, result, s) == OK)
+        return std::make_pair(int(OK), result);
+      result = 0.0;
+    }
+    // Failed (or not cached): re-evaluate on a private copy to locate the error
+    std::vector<char> buffer(expression.begin(), expression.end());
+    buffer.push_back('\0');
+    pchar begin = &buffer[0], endp = 0;
+    int status = engine(begin, begin+expression.length()-1, result, endp, s->theDictionary);
+    if (status != OK) {
+      print_error_status(os, status, endp);
+      result = 0.0;
+    }
+    return std::make_pair(status, result);
+  }
+
+  //---------------------------------------------------------------------------
+  void Evaluator::setCacheSize(std::size_t n) {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
+    std::lock_guard<std::mutex> cache_lock(s->theCacheLock);
+    s->theCacheSize = n;
+    s->theCache.clear();
+  }
+
   //---------------------------------------------------------------------------
   int Evaluator::status() const {
     return (reinterpret_cast<Struct*>(p))->theStatus;
@@ -643,42 +1213,14 @@ namespace XmlTools {
 
   //---------------------------------------------------------------------------
   void Evaluator::print_error() const {
-    char prefix[] = "Evaluator : ";
     Struct * s = reinterpret_cast<Struct*>(p);
-    const char* opt = (s->thePosition ? s->thePosition : "");
-    switch (s->theStatus) {
-    case ERROR_NOT_A_NAME:
-      std::cerr << prefix << "invalid name : " << opt << std::endl;
-      return;
-    case ERROR_SYNTAX_ERROR:
-      std::cerr << prefix << "systax error"         << std::endl;
-      return;
-    case ERROR_UNPAIRED_PARENTHESIS:
-      std::cerr << prefix << "unpaired parenthesis" << std::endl;
-      return;
-    case ERROR_UNEXPECTED_SYMBOL:
-      std::cerr << prefix << "unexpected symbol : " << opt << std::endl;
-      return;
-    case ERROR_UNKNOWN_VARIABLE:
-      std::cerr << prefix << "unknown variable : " << opt << std::endl;
-      return;
-    case ERROR_UNKNOWN_FUNCTION:
-      std::cerr << prefix << "unknown function : " << opt << std::endl;
-      return;
-    case ERROR_EMPTY_PARAMETER:
-      std::cerr << prefix << "empty parameter in function call: " << opt << std::endl;
-      return;
-    case ERROR_CALCULATION_ERROR:
-      std::cerr << prefix << "calculation error"    << std::endl;
-      return;
-    default:
-      return;
-    }
+    print_error_status(std::cerr, s->theStatus, s->thePosition);
   }
 
   //---------------------------------------------------------------------------
   void Evaluator::setEnviron(const char* name, const char* value)  {
     Struct* s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     string prefix = "${";
     string item_name = prefix + string(name) + string("}");
     dic_type::iterator iter = (s->theDictionary).find(item_name);
@@ -703,6 +1245,7 @@ namespace XmlTools {
   //---------------------------------------------------------------------------
   const char* Evaluator::getEnviron(const char* name)  {
     Struct* s = reinterpret_cast<Struct*>(p);
+    read_lock_t lock(s->theLock);
     string item_name = name;
     //std::cout << " ++++++++++++++++++++++++++++ Try to resolve env:" << name << std::endl;
     dic_type::iterator iter = (s->theDictionary).find(item_name);
@@ -724,41 +1267,61 @@ namespace XmlTools {
   }
 
   //---------------------------------------------------------------------------
-  void Evaluator::setVariable(const char * name, double value)
-  { setItem("", name, Item(value), reinterpret_cast<Struct*>(p)); }
+  // The dictionary lock must also cover the destruction of the temporary item:
+  // its string shares the (not atomic) reference count with the dictionary entry.
+  void Evaluator::setVariable(const char * name, double value)  {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
+    setItem("", name, Item(value), s);
+  }
 
-  void Evaluator::setVariable(const char * name, const char * expression)
-  { setItem("", name, Item(expression), reinterpret_cast<Struct*>(p)); }
+  void Evaluator::setVariable(const char * name, const char * expression)  {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
+    setItem("", name, Item(expression), s);
+  }
 
   //---------------------------------------------------------------------------
   void Evaluator::setFunction(const char * name,double (*fun)())   {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     FCN fcn(fun);
-    setItem("0", name, Item(fcn.ptr), reinterpret_cast<Struct*>(p));
+    setItem("0", name, Item(fcn.ptr), s);
   }
 
   void Evaluator::setFunction(const char * name,double (*fun)(double))   {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     FCN fcn(fun);
-    setItem("1", name, Item(fcn.ptr), reinterpret_cast<Struct*>(p));
+    setItem("1", name, Item(fcn.ptr), s);
   }
 
   void Evaluator::setFunction(const char * name, double (*fun)(double,double))  {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     FCN fcn(fun);
-    setItem("2", name, Item(fcn.ptr), reinterpret_cast<Struct*>(p));
+    setItem("2", name, Item(fcn.ptr), s);
   }
 
   void Evaluator::setFunction(const char * name, double (*fun)(double,double,double))  {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     FCN fcn(fun);
-    setItem("3", name, Item(fcn.ptr), reinterpret_cast<Struct*>(p));
+    setItem("3", name, Item(fcn.ptr), s);
   }
 
   void Evaluator::setFunction(const char * name, double (*fun)(double,double,double,double)) {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     FCN fcn(fun);
-    setItem("4", name, Item(fcn.ptr), reinterpret_cast<Struct*>(p));
+    setItem("4", name, Item(fcn.ptr), s);
   }
 
   void Evaluator::setFunction(const char * name, double (*fun)(double,double,double,double,double))  {
+    Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     FCN fcn(fun);
-    setItem("5", name, Item(fcn.ptr), reinterpret_cast<Struct*>(p));
+    setItem("5", name, Item(fcn.ptr), s);
   }
 
   //---------------------------------------------------------------------------
@@ -767,6 +1330,7 @@ namespace XmlTools {
     const char * pointer; int n; REMOVE_BLANKS;
     if (n == 0) return false;
     Struct * s = reinterpret_cast<Struct*>(p);
+    read_lock_t lock(s->theLock);
     return
       ((s->theDictionary).find(string(pointer,n)) == (s->theDictionary).end()) ?
       false : true;
@@ -779,6 +1343,7 @@ namespace XmlTools {
     const char * pointer; int n; REMOVE_BLANKS;
     if (n == 0) return false;
     Struct * s = reinterpret_cast<Struct*>(p);
+    read_lock_t lock(s->theLock);
     return ((s->theDictionary).find(sss[npar]+string(pointer,n)) ==
             (s->theDictionary).end()) ? false : true;
   }
@@ -789,6 +1354,7 @@ namespace XmlTools {
     const char * pointer; int n; REMOVE_BLANKS;
     if (n == 0) return;
     Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     (s->theDictionary).erase(string(pointer,n));
   }
 
@@ -799,12 +1365,14 @@ namespace XmlTools {
     const char * pointer; int n; REMOVE_BLANKS;
     if (n == 0) return;
     Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     (s->theDictionary).erase(sss[npar]+string(pointer,n));
   }
 
   //---------------------------------------------------------------------------
   void Evaluator::clear() {
     Struct * s = reinterpret_cast<Struct*>(p);
+    write_lock_t lock(s->theLock);
     s->theDictionary.clear();
     s->theExpression = 0;
     s->thePosition   = 0;
@@ -53,39 +53,36 @@ namespace {
 }
 
 namespace dd4hep {
+  /// Access to the default evaluator. Initialization is thread safe.
   XmlTools::Evaluator& evaluator() {
-    static XmlTools::Evaluator* e = 0;
-    if ( !e )   {
+    static XmlTools::Evaluator* e = []()  {
       static XmlTools::Evaluator ev;
       _init(ev);
       _tgeoUnits(ev);
-      e = &ev;
-    }
+      return &ev;
+    }();
     return *e;
   }
 
   /// Access to G4 evaluator. Note: Uses Geant4 units!
   XmlTools::Evaluator& g4Evaluator()   {
-    static XmlTools::Evaluator* e = 0;
-    if ( !e )   {
+    static XmlTools::Evaluator* e = []()  {
       static XmlTools::Evaluator ev;
       _init(ev);
       _g4Units(ev);
-      e = &ev;
-    }
+      return &ev;
+    }();
     return *e;
   }
 
   /// Access to G4 evaluator. Note: Uses cgs units!
   XmlTools::Evaluator& cgsEvaluator()   {
-    static XmlTools::Evaluator* e = 0;
-    if ( !e )   {
+    static XmlTools::Evaluator* e = []()  {
       static XmlTools::Evaluator ev;
       _init(ev);
       _cgsUnits(ev);
-      e = &ev;
-    }
+      return &ev;
+    }();
     return *e;
   }
 }
-
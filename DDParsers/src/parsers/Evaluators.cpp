@@ -44,22 +44,22 @@ namespace dd4hep {  namespace Parsers {
     }
 
     template <> double evaluate_string<double>(const std::string& value)   {
-      double result = eval.evaluate(value.c_str());
-      if (eval.status() != XmlTools::Evaluator::OK) {
+      auto result = eval.evaluate(value);
+      if (result.first != XmlTools::Evaluator::OK) {
         std::cerr << value << ": ";
-        eval.print_error();
+        eval.evaluate(value, std::cerr);
         throw std::runtime_error("dd4hep::Properties: Severe error during expression evaluation of " + value);
       }
-      return result;
+      return result.second;
     }
     template <> float evaluate_string<float>(const std::string& value)   {
-      double result = eval.evaluate(value.c_str());
-      if (eval.status() != XmlTools::Evaluator::OK) {
+      auto result = eval.evaluate(value);
+      if (result.first != XmlTools::Evaluator::OK) {
         std::cerr << value << ": ";
-        eval.print_error();
+        eval.evaluate(value, std::cerr);
         throw std::runtime_error("dd4hep::Properties: Severe error during expression evaluation of " + value);
       }
-      return (float) result;
+      return (float) result.second;
     }
   }
 }
@@ -8,7 +8,10 @@
 #include "DDSegmentation/Segmentation.h"
 
 #include <set>
+#include <map>
 #include <string>
+#include <vector>
+#include <unordered_map>
 
 
 namespace dd4hep {
@@ -20,6 +23,15 @@ namespace dd4hep {
     /** Utility for position to cellID and cellID to position conversions.
      *  (Correctly re-implements some of the functionality of the deprecated IDDecoder).
      *
+     *  After a call to enableCaching() the readout and segmentation are cached per subdetector system ID
+     *  and the nominal transformation of every sensitive volume context is kept as flattened 3x4 matrix,
+     *  so that positionNominal() only needs the context lookup in the VolumeManager.
+     *  In this mode the cellID->position conversions (including the batch call positions())
+     *  can be used concurrently from several threads, provided the segmentation's position() is reentrant
+     *  (as for the Cartesian and polar grids).
+     *  The inverse conversion cellID(Position) uses the TGeoNavigator of the calling thread, i.e.
+     *  it is thread-safe if TGeoManager::SetMaxThreads() has been called.
+     *
      * @author F.Gaede, DESY
      * @date May 2017
      */
@@ -46,6 +58,25 @@ namespace dd4hep {
        */
       Position positionNominal(const CellID& cellID) const;
       
+      /** Fill the nominal global positions for the given cellIDs into result - equivalent to calling
+       *  positionNominal() for each cellID.
+       */
+      void positions(const CellID* cellIDs, size_t count, Position* result) const;
+
+      /** Return the nominal global positions for the given cellIDs.
+       *  @see positions(const CellID*, size_t, Position*)
+       */
+      std::vector<Position> positions(const std::vector<CellID>& cellIDs) const;
+
+      /** Cache readout and segmentation per subdetector system ID and the flattened nominal transformations
+       *  of all sensitive volume contexts known to the VolumeManager.
+       *  Must not be called concurrently with any conversion.
+       */
+      void enableCaching() ;
+
+      /// True if enableCaching() has been called
+      bool isCaching() const { return _useCache ; }
+
       /** Return the global position for a given cellID of a sensitive volume.
        *  Alignment corrections are applied (TO BE DONE).
        *  If no sensitive volume is found, (0,0,0) is returned.
@@ -102,9 +133,25 @@ namespace dd4hep {
     std::vector<double> cellDimensions(const CellID& cell) const ;
 
     protected:
+
+      /// Cached conversion data of one sensitive volume context
+      struct CachedContext {
+        /// Flattened 3x4 local to global transformation: rotation rows and translation
+        double matrix[12] ;
+        /// The segmentation of the context's readout
+        const DDSegmentation::Segmentation* segmentation ;
+      } ;
+
+      /// Access the cached data of a context - returns 0 if caching is disabled or the context is unknown
+      const CachedContext* cachedContext(const VolumeManagerContext* context) const ;
+
       VolumeManager _volumeManager{} ;
       const Detector* _description ;
 
+      bool _useCache = false ;
+      std::unordered_map<const VolumeManagerContext*, CachedContext> _contextCache{} ;
+      std::map<VolumeID, Readout> _readoutCache{} ;
+
     };
 
   } /* namespace rec */
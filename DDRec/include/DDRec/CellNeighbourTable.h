@@ -0,0 +1,107 @@
+#ifndef rec_CellNeighbourTable_H_
+#define rec_CellNeighbourTable_H_
+
+#include "DD4hep/Detector.h"
+#include "DDSegmentation/Segmentation.h"
+
+#include <string>
+#include <vector>
+
+namespace dd4hep {
+  namespace rec {
+
+    /** Precomputed cell adjacency graph of a readout, e.g. for calorimeter clustering.
+     *  The cells of all sensitive volumes of the readout are enumerated once through the
+     *  VolumeManager and the segmentation: starting from seed cells inside every volume, the
+     *  segmentation neighbours are followed as long as the cell center lies inside the volume's shape
+     *  (the segmentation positions are taken as local coordinates of the sensitive volume).
+     *  Two cells are neighbours if the segmentation says so (within one volume) or, if they belong to
+     *  different volumes, if their global cell centers are closer than the given distance.
+     *  This connects cells across module, layer and tile boundaries.
+     *
+     *  The graph is stored in compressed sparse row format: the sorted cell IDs, the offsets of
+     *  the neighbour lists and the neighbour cell IDs. A neighbour query is a binary search and
+     *  returns a range pointing into the table, i.e. it does not allocate memory and may be
+     *  used concurrently from several threads.
+     *
+     *  The table can be written to and read back from a binary file, so that it is computed
+     *  only once for a given geometry.
+     *
+     * @version $Id:$
+     */
+    class CellNeighbourTable {
+
+    public:
+
+      typedef DDSegmentation::CellID CellID ;
+
+      /// Contiguous range of neighbour cell IDs inside the table
+      class Range {
+      public:
+        Range( const CellID* b=0, const CellID* e=0 ) : _begin( b ), _end( e ) {}
+        const CellID* begin() const { return _begin ; }
+        const CellID* end()   const { return _end ; }
+        size_t size()         const { return _end - _begin ; }
+        bool empty()          const { return _end == _begin ; }
+        CellID operator[]( size_t i ) const { return _begin[i] ; }
+      private:
+        const CellID* _begin ;
+        const CellID* _end ;
+      } ;
+
+      /// Default c'tor - empty table, use build() or readFile()
+      CellNeighbourTable() ;
+
+      ~CellNeighbourTable() ;
+
+      /** Build the table for all sensitive volumes of the given readout. Cells of different
+       *  volumes with centers closer than maxDistance are neighbours (no cross-boundary neighbours
+       *  if maxDistance<=0). At most maxCellsPerVolume cells are enumerated per volume.
+       *  Throws std::runtime_error if the readout does not exist or a volume has more cells.
+       */
+      void build( Detector& description, const std::string& readout, double maxDistance,
+                  size_t maxCellsPerVolume=1000000 ) ;
+
+      /// Write the table to a binary file - throws std::runtime_error on failure
+      void writeFile( const std::string& fileName ) const ;
+
+      /// Read the table from a binary file written by writeFile() - throws std::runtime_error on failure
+      void readFile( const std::string& fileName ) ;
+
+      /// Number of cells in the table
+      size_t numCells() const { return _cells.size() ; }
+
+      /// Total number of (directed) neighbour relations
+      size_t numNeighbours() const { return _neighbours.size() ; }
+
+      /// All cells of the table in increasing order
+      const std::vector<CellID>& cells() const { return _cells ; }
+
+      /// True if the cell is part of the table
+      bool contains( CellID cell ) const ;
+
+      /// The neighbours of a cell - empty if the cell is not part of the table
+      Range neighbours( CellID cell ) const ;
+
+      /// The neighbours of the i-th cell of cells()
+      Range neighboursAt( size_t i ) const {
+        return Range( _neighbours.data() + _offsets[i], _neighbours.data() + _offsets[i+1] ) ;
+      }
+
+      /// Check if two cells are neighbours
+      bool isNeighbour( CellID cell, CellID other ) const ;
+
+    protected:
+
+      /// The sorted cell IDs
+      std::vector<CellID>   _cells ;
+      /// Neighbours of _cells[i] are _neighbours[_offsets[i]] to _neighbours[_offsets[i+1]-1]
+      std::vector<unsigned> _offsets ;
+      /// The neighbour lists, each sorted
+      std::vector<CellID>   _neighbours ;
+    };
+
+  } /* namespace rec */
+} /* namespace dd4hep */
+
+#endif // rec_CellNeighbourTable_H_
@@ -0,0 +1,114 @@
+#ifndef rec_MaterialGrid_H_
+#define rec_MaterialGrid_H_
+
+#include "DDRec/Vector3D.h"
+#include "DDRec/Material.h"
+#include "DDRec/MaterialManager.h"
+
+#include <string>
+#include <vector>
+
+namespace dd4hep {
+  namespace rec {
+
+    /** Precomputed volumetric material map for fast material queries.
+     *  The region between lower() and upper() is divided into a regular grid of cells.
+     *  Every cell holds the volume averaged material properties (density, rho/A, rho*Z/A,
+     *  1/X0 and 1/lambda) sampled once from the geometry with the MaterialManager.
+     *  Queries between two points walk the cells crossed by the straight line
+     *  (3D DDA) and do not touch TGeo at all: the cost per query is proportional
+     *  to the number of cells crossed, i.e. constant for segments short compared to the cell size.
+     *
+     *  The result is an approximation: the error on the integrated X0 of a segment is bounded by the
+     *  material variation within the cells crossed, i.e. material boundaries are smeared over
+     *  at most one cell size - @see cellSize(). Use MaterialManager::materialsBetween() where the exact
+     *  material sequence is needed.
+     *
+     *  The grid can be written to and read back from a binary file, so that it is computed
+     *  only once for a given geometry.
+     *
+     * @version $Id:$
+     */
+    class MaterialGrid {
+
+    public:
+
+      /// Volume averaged material properties of one grid cell, given per unit path length
+      struct Cell {
+        float rho ;
+        float rho_over_A ;
+        float rho_Z_over_A ;
+        float inv_x0 ;
+        float inv_lambda ;
+      } ;
+
+      /// Default c'tor - empty grid, use readFile() or initialize()
+      MaterialGrid() ;
+
+      /// Instantiate an (empty) grid with nx*ny*nz cells between lower and upper
+      MaterialGrid( const Vector3D& lower, const Vector3D& upper, unsigned nx, unsigned ny, unsigned nz ) ;
+
+      ~MaterialGrid() ;
+
+      /// (Re-)define the grid dimensions - all cells are reset to vacuum
+      void initialize( const Vector3D& lower, const Vector3D& upper, unsigned nx, unsigned ny, unsigned nz ) ;
+
+      /** Fill all cells from the geometry by sampling samplesPerAxis^3 points per cell
+       *  with MaterialManager::materialAt(). Points outside of the world volume count as vacuum.
+       */
+      void build( MaterialManager& matMgr, unsigned samplesPerAxis=2 ) ;
+
+      /// Write the grid to a binary file - throws std::runtime_error on failure
+      void writeFile( const std::string& fileName ) const ;
+
+      /// Read the grid from a binary file written by writeFile() - throws std::runtime_error on failure
+      void readFile( const std::string& fileName ) ;
+
+      /** Averaged material between the two points - same averaging as in
+       *  MaterialManager::createAveragedMaterial(). Path length outside of the grid counts as vacuum.
+       */
+      MaterialData averagedMaterialBetween( const Vector3D& p0, const Vector3D& p1 ) const ;
+
+      /// Integrated number of radiation lengths on the straight line between p0 and p1
+      double radiationLengthsBetween( const Vector3D& p0, const Vector3D& p1 ) const ;
+
+      /// Integrated number of interaction lengths on the straight line between p0 and p1
+      double interactionLengthsBetween( const Vector3D& p0, const Vector3D& p1 ) const ;
+
+      /// The cell containing pos - throws std::out_of_range if pos is outside of the grid
+      const Cell& cellAt( const Vector3D& pos ) const ;
+
+      /// True if pos lies within the grid
+      bool contains( const Vector3D& pos ) const ;
+
+      /// Lower corner of the grid
+      const Vector3D& lower() const { return _lower ; }
+
+      /// Upper corner of the grid
+      const Vector3D& upper() const { return _upper ; }
+
+      /// Dimension of a single cell - the spatial resolution of the material description
+      const Vector3D& cellSize() const { return _size ; }
+
+      /// Total number of cells
+      size_t numCells() const { return _cells.size() ; }
+
+    protected :
+
+      /** Integrate the per length cell quantities along the line between p0 and p1.
+       *  sums: [ l, rho*l, rho*l/A, rho*l*Z/A, l/X0, l/lambda ]
+       */
+      void integrate( const Vector3D& p0, const Vector3D& p1, double sums[6] ) const ;
+
+      /// Linear cell index
+      size_t index( unsigned i, unsigned j, unsigned k ) const { return ( size_t(k) * _n[1] + j ) * _n[0] + i ; }
+
+      Vector3D _lower, _upper, _size ;
+      unsigned _n[3] ;
+      std::vector<Cell> _cells ;
+    };
+
+  } /* namespace rec */
+} /* namespace dd4hep */
+
+#endif // rec_MaterialGrid_H_
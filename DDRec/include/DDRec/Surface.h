@@ -509,6 +509,8 @@ namespace dd4hep {
      */
     class Surface:  public ISurface {
       
+      friend class SurfaceBatch ;
+
     protected:
       
       DetElement _det ;
@@ -608,6 +610,12 @@ namespace dd4hep {
        */
       virtual std::vector< std::pair< Vector3D, Vector3D> > getLines(unsigned nMax=100) ;
 
+      /** Axis aligned bounding box of the surface in global coordinates - computed from the
+       *  bounding box of the volume the surface is attached to, i.e. it contains the surface 
+       *  including its inner and outer thicknesses (as long as these are inside the volume).
+       */
+      virtual void globalBoundingBox( Vector3D& lower, Vector3D& upper ) const ;
+
     protected:
       void initialize() ;
 
@@ -0,0 +1,128 @@
+#ifndef rec_SurfaceBatch_H_
+#define rec_SurfaceBatch_H_
+
+#include "DDRec/ISurface.h"
+#include "DDRec/Vector3D.h"
+
+#include <vector>
+
+namespace dd4hep {
+  namespace rec {
+
+    /** Packed representation of a set of surfaces for the evaluation of distance(), insideBounds()
+     *  and globalToLocal() in batches: many points for one surface or one point for all surfaces.
+     *
+     *  Planar surfaces on box shaped volumes and cylindrical surfaces on tubes (the vast majority
+     *  of tracking surfaces) are stored column wise (structure of arrays): the world to local
+     *  transformation, the local origin and normal, the precomputed projection vectors of
+     *  globalToLocal() and the bounds of the volume's shape. The kernels are plain loops over
+     *  these columns without virtual calls, which the compiler can vectorize.
+     *  All other surfaces (cones, other shapes, user defined surface implementations) are
+     *  evaluated through the ISurface interface. The results are identical to those of the
+     *  ISurface methods.
+     *
+     *  The surfaces are reordered: planes first, then cylinders, then all others. Results of the
+     *  one point queries are indexed in this order, see surface(i). The surfaces are not owned.
+     *
+     * @version $Id$
+     */
+    class SurfaceBatch {
+
+    public:
+
+      /// Kind of a surface in the batch
+      enum Kind { Plane = 0 , Cylinder = 1 , Generic = 2 } ;
+
+      /// Pack all given surfaces
+      SurfaceBatch( const std::vector<ISurface*>& surfaces ) ;
+
+      /// Pack all surfaces of the given map
+      template <typename MAP> static SurfaceBatch fromMap( const MAP& m ) {
+        std::vector<ISurface*> surfaces ;
+        surfaces.reserve( m.size() ) ;
+        for( typename MAP::const_iterator it = m.begin() ; it != m.end() ; ++it ) surfaces.push_back( it->second ) ;
+        return SurfaceBatch( surfaces ) ;
+      }
+
+      /// Default destructor
+      ~SurfaceBatch() ;
+
+      /// Number of surfaces in the batch
+      size_t size() const { return _surfaces.size() ; }
+
+      /// Number of packed planar surfaces - these are surface(0) ... surface(numPlanes()-1)
+      size_t numPlanes() const { return _nPlanes ; }
+
+      /// Number of packed cylindrical surfaces - these follow the planes
+      size_t numCylinders() const { return _nCylinders ; }
+
+      /// The i-th surface of the batch
+      const ISurface* surface( size_t i ) const { return _surfaces[i] ; }
+
+      /// The kind of the i-th surface of the batch
+      Kind kind( size_t i ) const {
+        return i < _nPlanes ? Plane : ( i < _nPlanes + _nCylinders ? Cylinder : Generic ) ;
+      }
+
+      //==== many points for one surface: the points are given as arrays x[n], y[n], z[n] ====
+
+      /// Distance of the n points to surface(i)
+      void distance( size_t i, size_t n, const double* x, const double* y, const double* z,
+                     double* dist ) const ;
+
+      /// insideBounds() of surface(i) for the n points - inside[k] is 0 or 1
+      void insideBounds( size_t i, size_t n, const double* x, const double* y, const double* z,
+                         unsigned char* inside, double epsilon=1.e-4 ) const ;
+
+      /// Local coordinates (u,v) of the n points on surface(i)
+      void globalToLocal( size_t i, size_t n, const double* x, const double* y, const double* z,
+                          double* u, double* v ) const ;
+
+      //==== one point for all surfaces: the results are arrays of size() entries ====
+
+      /// Distance of the point to all surfaces
+      void distance( const Vector3D& point, double* dist ) const ;
+
+      /// insideBounds() of all surfaces for the point - inside[i] is 0 or 1
+      void insideBounds( const Vector3D& point, unsigned char* inside, double epsilon=1.e-4 ) const ;
+
+      /// Local coordinates (u,v) of the point on all surfaces
+      void globalToLocal( const Vector3D& point, double* u, double* v ) const ;
+
+    protected:
+
+      /// Columns of the packed planes and cylinders
+      enum Column {
+        // world to local rotation (TGeoHMatrix order) and translation
+        R0, R1, R2, R3, R4, R5, R6, R7, R8, TX, TY, TZ,
+        // planes: local origin and normal, global origin and projection vectors of globalToLocal
+        OX, OY, OZ, NX, NY, NZ, GX, GY, GZ, UX, UY, UZ, VX, VY, VZ,
+        // planes: box origin and half lengths
+        BX, BY, BZ, DX, DY, DZ,
+        // cylinders: radius, phi and z of the local origin, tube bounds
+        RADIUS, PHI0, Z0, RMIN2, RMAX2, HALFZ,
+        NCOLUMNS
+      } ;
+
+      /// Pointer to the first element of a column
+      const double* col( Column c ) const { return _columns[c].data() ; }
+
+      /// World to local rotation and translation of the i-th surface (zero if it is not packed)
+      void frame( size_t i, double r[9], double t[3] ) const ;
+
+      /// Plane or Cylinder if the surface can be packed, Generic otherwise
+      static Kind classify( const ISurface* surf ) ;
+
+      /// Append the packed parameters of a plane or a cylinder
+      void pack( const ISurface* surf, Kind k ) ;
+
+      std::vector<const ISurface*> _surfaces ;
+      std::vector<double>          _columns[NCOLUMNS] ;
+      size_t                       _nPlanes ;
+      size_t                       _nCylinders ;
+    };
+
+  } /* namespace rec */
+} /* namespace dd4hep */
+
+#endif // rec_SurfaceBatch_H_
@@ -0,0 +1,110 @@
+#ifndef rec_SurfaceIndex_H_
+#define rec_SurfaceIndex_H_
+
+#include "DDRec/ISurface.h"
+#include "DDRec/Vector3D.h"
+
+#include <vector>
+
+namespace dd4hep {
+  namespace rec {
+
+    /** Spatial index over a set of surfaces for position based surface lookup.
+     *  The surfaces' global bounding boxes are organised in a bounding volume hierarchy
+     *  (median split along the longest axis). Nodes and surface entries (pointer + bounding box)
+     *  are stored in contiguous arrays in depth first order, so that a traversal touches
+     *  memory mostly sequentially. The surfaces themselves are not owned by the index
+     *  and not copied: the bounds checks of volume surfaces need the shape of their volume.
+     *
+     *  Bounding boxes are taken from Surface::globalBoundingBox() - for other implementations
+     *  of ISurface the origin is used, enlarged by the surface lengths along u and v.
+     *
+     * @version $Id$
+     */
+    class SurfaceIndex {
+
+    public:
+
+      /// Result of a ray intersection query
+      struct Intersection {
+        /// The intersected surface
+        const ISurface* surface ;
+        /// Path length along the (unit) direction from the ray origin to the intersection
+        double          pathLength ;
+        /// Global intersection point
+        Vector3D        point ;
+      } ;
+
+      /// Build the index for all given surfaces
+      SurfaceIndex( const std::vector<ISurface*>& surfaces ) ;
+
+      /// Build the index for all surfaces of the given map
+      template <typename MAP> static SurfaceIndex fromMap( const MAP& m ) {
+        std::vector<ISurface*> surfaces ;
+        surfaces.reserve( m.size() ) ;
+        for( typename MAP::const_iterator it = m.begin() ; it != m.end() ; ++it ) surfaces.push_back( it->second ) ;
+        return SurfaceIndex( surfaces ) ;
+      }
+
+      /// Default destructor
+      ~SurfaceIndex() ;
+
+      /// Number of indexed surfaces
+      size_t size() const { return _entries.size() ; }
+
+      /** The surface closest to the given point, i.e. the one with the smallest |distance(point)|
+       *  where the point projected onto the surface is inside its bounds. Only surfaces closer
+       *  than maxDistance are considered. Returns 0 if no surface is found.
+       */
+      const ISurface* nearest( const Vector3D& point, double maxDistance, double* dist=0 ) const ;
+
+      /** All surfaces with |distance(point)| < maxDistance where the point projected onto the
+       *  surface is inside its bounds. The result is appended to the given vector (not sorted).
+       */
+      void surfacesNear( const Vector3D& point, double maxDistance, std::vector<const ISurface*>& result ) const ;
+
+      /** All surfaces intersected by the straight line starting at origin along direction
+       *  up to the given path length. The intersections are appended to the result and
+       *  sorted by path length. Planes and cylinders are intersected analytically,
+       *  other surfaces by bisection of every sign change of the signed distance
+       *  found in a coarse scan of 8 steps (two crossings within one step are not resolved).
+       */
+      void intersect( const Vector3D& origin, const Vector3D& direction, double maxPathLength,
+                      std::vector<Intersection>& result ) const ;
+
+    protected:
+
+      /// Packed surface entry: bounding box and surface
+      struct Entry {
+        double lower[3] ;
+        double upper[3] ;
+        const ISurface* surface ;
+      } ;
+
+      /// BVH node - leaves hold count>0 entries starting at offset,
+      /// inner nodes have count==0, the left child at the next index and the right child at offset
+      struct Node {
+        double lower[3] ;
+        double upper[3] ;
+        unsigned offset ;
+        unsigned count ;
+      } ;
+
+      /// Recursively build the hierarchy over _entries[begin,end)
+      unsigned build( unsigned begin, unsigned end ) ;
+
+      /// Check a single candidate surface for the nearest/near queries
+      bool accept( const ISurface* surf, const Vector3D& point, double maxDistance, double& dist ) const ;
+
+      /// Intersect the line with a single surface within [t0,t1] - returns the number of intersections added
+      unsigned intersectSurface( const ISurface* surf, const Vector3D& origin, const Vector3D& direction,
+                                 double t0, double t1, std::vector<Intersection>& result ) const ;
+
+      std::vector<Entry> _entries ;
+      std::vector<Node>  _nodes ;
+    };
+
+  } /* namespace rec */
+} /* namespace dd4hep */
+
+#endif // rec_SurfaceIndex_H_
@@ -2,9 +2,11 @@
 #define rec_SurfaceManager_H_
 
 #include "DDRec/ISurface.h"
+#include "DDRec/SurfaceIndex.h"
 #include "DD4hep/Detector.h"
 #include <string>
 #include <map>
+#include <mutex>
 
 namespace dd4hep {
   namespace rec {
@@ -23,6 +25,7 @@ namespace dd4hep {
     class SurfaceManager {
 
       typedef std::map< std::string,  SurfaceMap > SurfaceMapsMap ;
+      typedef std::map< std::string,  SurfaceIndex > SurfaceIndexMap ;
 
     public:
       /// The constructor
@@ -46,6 +49,12 @@ namespace dd4hep {
        */
       const SurfaceMap* map( const std::string name ) const ;
 
+      /** Get the spatial index over all surfaces of the map with the given name for
+       *  queries by position, e.g. index("tracker")->nearest( pos, maxDist ).
+       *  The index is built on the first call for the map. Returns 0 if no map exists.
+       *  @see SurfaceIndex
+       */
+      const SurfaceIndex* index( const std::string name ) const ;
       
       ///create a string with all available maps and their size (number of surfaces)
       std::string toString() const ;
@@ -57,6 +66,10 @@ namespace dd4hep {
       void initialize(Detector& theDetector) ;
 
       SurfaceMapsMap _map ;
+      /// spatial indices of the maps requested so far
+      mutable SurfaceIndexMap _index ;
+      /// protection of the lazily filled _index
+      mutable std::mutex _indexLock ;
     };
 
   } /* namespace rec */
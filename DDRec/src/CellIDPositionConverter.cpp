@@ -5,12 +5,98 @@
 #include "DD4hep/detail/VolumeManagerInterna.h"
 
 #include "TGeoManager.h"
+#include "TGeoNavigator.h"
 
 namespace dd4hep {
   namespace rec {
 
     using std::set;
 
+    namespace {
+
+      /// A context together with the volume manager section owning it
+      typedef std::pair<const VolumeManagerContext*, const detail::VolumeManagerObject*> OwnedContext ;
+
+      /// Collect the contexts of a volume manager and all its sub-managers.
+      /// The owner is the closest (sub-)manager with a system field - only the sub-managers set it.
+      void collectContexts( const detail::VolumeManagerObject* o, const detail::VolumeManagerObject* owner,
+			    std::vector<OwnedContext>& contexts ) {
+	if( o->system ) owner = o ;
+	for( const auto& v : o->volumes )
+	  contexts.push_back( std::make_pair( v.second, owner ) ) ;
+	for( const auto& m : o->managers )
+	  collectContexts( m.second.ptr(), owner, contexts ) ;
+      }
+
+      /// The navigator of the calling thread
+      TGeoNavigator* threadNavigator( TGeoManager* mgr ) {
+	TGeoNavigator* nav = mgr->GetCurrentNavigator() ;
+	if( nav == nullptr ) nav = mgr->AddNavigator() ;
+	return nav ;
+      }
+    }
+
+    void CellIDPositionConverter::enableCaching() {
+
+      _contextCache.clear() ;
+      _readoutCache.clear() ;
+
+      const detail::VolumeManagerObject* top = _volumeManager.ptr() ;
+
+      std::vector<OwnedContext> contexts ;
+      collectContexts( top, nullptr, contexts ) ;
+
+      for( const OwnedContext& owned : contexts ) {
+
+	const VolumeManagerContext* context = owned.first ;
+	DetElement det = context->element ;
+
+	// readout and segmentation are cached per system ID of the owning subdetector section.
+	// Contexts outside any subdetector section look up their readout individually.
+	Readout r ;
+	if( owned.second ) {
+	  VolumeID sysID = owned.second->sysID ;
+	  auto ir = _readoutCache.find( sysID ) ;
+	  if( ir == _readoutCache.end() )
+	    ir = _readoutCache.insert( std::make_pair( sysID, findReadout( det ) ) ).first ;
+	  r = ir->second ;
+	} else {
+	  r = findReadout( det ) ;
+	}
+	if( ! r.isValid() )
+	  continue ;
+
+	// combined transformation sensitive volume -> DetElement -> world
+	TGeoHMatrix m( det.nominal().worldTransformation() ) ;
+	m.Multiply( &context->toElement() ) ;
+
+	const Double_t* rot = m.GetRotationMatrix() ;
+	const Double_t* tr  = m.GetTranslation() ;
+
+	CachedContext& c = _contextCache[ context ] ;
+	for( unsigned i=0 ; i<3 ; ++i ){
+	  c.matrix[ 4*i + 0 ] = rot[ 3*i + 0 ] ;
+	  c.matrix[ 4*i + 1 ] = rot[ 3*i + 1 ] ;
+	  c.matrix[ 4*i + 2 ] = rot[ 3*i + 2 ] ;
+	  c.matrix[ 4*i + 3 ] = tr[ i ] ;
+	}
+	c.segmentation = r.segmentation().segmentation() ;
+      }
+
+      _useCache = true ;
+    }
+
+    const CellIDPositionConverter::CachedContext*
+    CellIDPositionConverter::cachedContext(const VolumeManagerContext* context) const {
+
+      if( ! _useCache )
+	return nullptr ;
+
+      auto it = _contextCache.find( context ) ;
+
+      return ( it != _contextCache.end() ? &it->second : nullptr ) ;
+    }
+
     const VolumeManagerContext*
     CellIDPositionConverter::findContext(const CellID& cellID) const {
       return _volumeManager.lookupContext( cellID ) ;
@@ -33,6 +119,18 @@ namespace dd4hep {
       if( context == NULL)
 	return Position() ;
 
+      const CachedContext* cached = cachedContext( context ) ;
+
+      if( cached ) {
+
+	DDSegmentation::Vector3D lp = cached->segmentation->position( cell ) ;
+	const double* m = cached->matrix ;
+
+	return Position( m[0] * lp.X + m[1] * lp.Y + m[ 2] * lp.Z + m[ 3] ,
+			 m[4] * lp.X + m[5] * lp.Y + m[ 6] * lp.Z + m[ 7] ,
+			 m[8] * lp.X + m[9] * lp.Y + m[10] * lp.Z + m[11] ) ;
+      }
+
       DetElement det = context->element ;
       
 
@@ -69,6 +167,22 @@ namespace dd4hep {
       return Position(g[0], g[1], g[2]);
     }
 
+    void CellIDPositionConverter::positions(const CellID* cellIDs, size_t count, Position* result) const {
+
+      for( size_t i=0 ; i<count ; ++i )
+	result[i] = positionNominal( cellIDs[i] ) ;
+    }
+
+    std::vector<Position> CellIDPositionConverter::positions(const std::vector<CellID>& cellIDs) const {
+
+      std::vector<Position> result( cellIDs.size() ) ;
+
+      if( ! cellIDs.empty() )
+	positions( &cellIDs[0], cellIDs.size(), &result[0] ) ;
+
+      return result ;
+    }
+
 
 
 
@@ -77,12 +191,15 @@ namespace dd4hep {
       CellID result(0) ;
       
       TGeoManager *geoManager = _description->world().volume()->GetGeoManager() ;
+
+      // use the navigator of this thread - the global one is not thread-safe
+      TGeoNavigator* nav = threadNavigator( geoManager ) ;
       
-      PlacedVolume pv = geoManager->FindNode( global.x() , global.y() , global.z() ) ;
+      PlacedVolume pv = nav->FindNode( global.x() , global.y() , global.z() ) ;
       
       if(  pv.isValid() && pv.volume().isSensitive() ) {
 
-	TGeoHMatrix*  m = geoManager->GetCurrentMatrix() ;
+	const TGeoHMatrix*  m = nav->GetCurrentMatrix() ;
       
 	double g[3], l[3] ;
 	global.GetCoordinates( g ) ;
@@ -92,19 +209,16 @@ namespace dd4hep {
 	Readout r = sd.readout() ;
 	
 	// collect all volIDs for the current path
-	PlacedVolume::VolIDs volIDs ;
-	volIDs.insert( std::end(volIDs), std::begin(pv.volIDs()), std::end(pv.volIDs())) ;
-
-	TGeoPhysicalNode pN( geoManager->GetPath() ) ; 
-	
-	unsigned motherCount = 0 ;
+	PlacedVolume::VolIDCodes volIDs ;
+	volIDs.insert( std::end(volIDs), std::begin(pv.volIDCodes()), std::end(pv.volIDCodes())) ;
 
-	while( pN.GetMother( motherCount ) != NULL   ){
+	// mothers up to (but excluding) the world volume, which has no volIDs
+	for( int up = 1, level = nav->GetLevel() ; up < level ; ++up ) {
 
-	    PlacedVolume mPv = pN.GetMother( motherCount++ ) ;
+	    PlacedVolume mPv = nav->GetMother( up ) ;
 	    
-	    if( mPv.isValid() &&  pN.GetMother( motherCount ) != NULL )  // world has no volIDs
-	      volIDs.insert( std::end(volIDs), std::begin(mPv.volIDs()), std::end(mPv.volIDs())) ;
+	    if( mPv.isValid() )
+	      volIDs.insert( std::end(volIDs), std::begin(mPv.volIDCodes()), std::end(mPv.volIDCodes())) ;
 	}
 	
 	VolumeID volIDPVs = r.idSpec().encode( volIDs ) ;
@@ -244,7 +358,7 @@ namespace dd4hep {
       if( pv.volume().solid()->Contains( l ) ) {
 	
 	// copy the volIDs
-	volIDs.insert( std::end(volIDs), std::begin(pv.volIDs()), std::end(pv.volIDs()));
+	volIDs.append( pv.volIDCodes() ) ;
 	
 	int ndau = pv->GetNdaughters() ;
 
@@ -268,7 +382,7 @@ namespace dd4hep {
 
 	  if( pvDau.volume().solid()->Contains( locPos ) ) { // point is contained in daughter node
 	    result = pvDau ;
-	    volIDs.insert( std::end(volIDs), std::begin(pvDau.volIDs()), std::end(pvDau.volIDs()) );
+	    volIDs.append( pvDau.volIDCodes() ) ;
 	    break ;
 	  }
 	}
@@ -330,6 +444,8 @@ namespace dd4hep {
     std::vector<double> CellIDPositionConverter::cellDimensions(const CellID& cell) const {
       auto context = findContext( cell ) ;
       if( context == nullptr ) return { };
+      const CachedContext* cached = cachedContext( context ) ;
+      if( cached ) return cached->segmentation->cellDimensions( cell ) ;
       dd4hep::Readout r  = findReadout( context->element ) ;
       dd4hep::Segmentation seg = r.segmentation() ;
       return seg.cellDimensions( cell );
@@ -0,0 +1,342 @@
+#include "DDRec/CellNeighbourTable.h"
+
+#include "DD4hep/Readout.h"
+#include "DD4hep/VolumeManager.h"
+#include "DD4hep/detail/VolumeManagerInterna.h"
+
+#include "TGeoBBox.h"
+#include "TGeoMatrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace dd4hep {
+  namespace rec {
+
+    namespace {
+      /// Magic word and version at the beginning of the binary file
+      const char     NEIGHBOURTABLE_MAGIC[8] = { 'D','D','4','C','N','T','A','B' } ;
+      const unsigned NEIGHBOURTABLE_VERSION  = 1 ;
+
+      /// Seed points per axis sampled in the bounding box of every volume
+      const int NUM_SEEDS = 5 ;
+
+      /// Collect the contexts of a volume manager and all its sub-managers
+      void collectContexts( const detail::VolumeManagerObject* o, std::vector<const VolumeManagerContext*>& contexts ) {
+        for( const auto& v : o->volumes )
+          contexts.push_back( v.second ) ;
+        for( const auto& m : o->managers )
+          collectContexts( m.second.ptr(), contexts ) ;
+      }
+
+      /// Cell found during the enumeration
+      struct CellEntry {
+        CellID   id ;
+        double   pos[3] ;
+        unsigned volume ;
+      } ;
+
+      /// Key of the spatial hash bucket of a position
+      struct BucketKey {
+        long long i, j, k ;
+        bool operator==( const BucketKey& o ) const { return i == o.i && j == o.j && k == o.k ; }
+      } ;
+      struct BucketHash {
+        size_t operator()( const BucketKey& b ) const {
+          return size_t( b.i * 73856093LL ) ^ size_t( b.j * 19349663LL ) ^ size_t( b.k * 83492791LL ) ;
+        }
+      } ;
+    }
+
+    CellNeighbourTable::CellNeighbourTable() : _cells(), _offsets( 1, 0 ), _neighbours() {
+    }
+
+    CellNeighbourTable::~CellNeighbourTable(){
+    }
+
+    void CellNeighbourTable::build( Detector& description, const std::string& readoutName, double maxDistance,
+                                    size_t maxCellsPerVolume ) {
+
+      Readout readout = description.readout( readoutName ) ;
+      if( ! readout.isValid() )
+        throw std::runtime_error( "CellNeighbourTable::build: unknown readout " + readoutName ) ;
+
+      const DDSegmentation::Segmentation* seg = readout.segmentation().isValid() ? readout.segmentation().segmentation() : 0 ;
+      VolumeManager volMgr = VolumeManager::getVolumeManager( description ) ;
+
+      std::vector<const VolumeManagerContext*> contexts ;
+      collectContexts( volMgr.ptr(), contexts ) ;
+
+      std::vector<CellEntry> entries ;
+      std::vector<std::pair<unsigned,unsigned> > edges ;
+      unsigned numVolumes = 0 ;
+
+      for( const VolumeManagerContext* context : contexts ) {
+
+        PlacedVolume pv = context->volumePlacement() ;
+        SensitiveDetector sd = pv.volume().sensitiveDetector() ;
+        if( ! sd.isValid() || sd.readout() != readout )
+          continue ;
+
+        TGeoHMatrix toWorld( context->element.nominal().worldTransformation() ) ;
+        toWorld.Multiply( &context->toElement() ) ;
+
+        const TGeoShape* shape = pv.volume()->GetShape() ;
+        const unsigned   vol   = numVolumes++ ;
+        const size_t     first = entries.size() ;
+        VolumeID         vid   = context->identifier ;
+
+        // ---- enumerate the cells: flood fill from seeds over the segmentation neighbours
+        std::unordered_map<CellID,unsigned> index ;
+        std::deque<CellID> todo ;
+        bool truncated = false ;
+
+        auto accept = [&]( CellID cell, bool checkInside ) {
+          if( index.find( cell ) != index.end() )
+            return ;
+          double local[3] = { 0., 0., 0. } ;
+          if( seg ) {
+            DDSegmentation::Vector3D lp = seg->position( cell ) ;
+            local[0] = lp.X ;  local[1] = lp.Y ;  local[2] = lp.Z ;
+          }
+          if( checkInside && ! shape->Contains( local ) )
+            return ;
+          if( index.size() >= maxCellsPerVolume ) {
+            truncated = true ;
+            return ;
+          }
+          CellEntry e ;
+          e.id = cell ;
+          e.volume = vol ;
+          toWorld.LocalToMaster( local, e.pos ) ;
+          index[ cell ] = entries.size() ;
+          entries.push_back( e ) ;
+          todo.push_back( cell ) ;
+        } ;
+
+        if( ! seg ) {
+          accept( vid, false ) ;
+          todo.clear() ;
+        } else {
+          const TGeoBBox* box = (const TGeoBBox*) shape ;
+          const double* o = box->GetOrigin() ;
+          const double  d[3] = { box->GetDX(), box->GetDY(), box->GetDZ() } ;
+          for( int i=0 ; i<NUM_SEEDS ; ++i ) for( int j=0 ; j<NUM_SEEDS ; ++j ) for( int k=0 ; k<NUM_SEEDS ; ++k ) {
+            double local[3] = { o[0] + d[0] * ( 2.*(i+0.5)/NUM_SEEDS - 1. ),
+                                o[1] + d[1] * ( 2.*(j+0.5)/NUM_SEEDS - 1. ),
+                                o[2] + d[2] * ( 2.*(k+0.5)/NUM_SEEDS - 1. ) } ;
+            if( ! shape->Contains( local ) )
+              continue ;
+            double global[3] ;
+            toWorld.LocalToMaster( local, global ) ;
+            accept( seg->cellID( DDSegmentation::Vector3D( local[0], local[1], local[2] ),
+                                 DDSegmentation::Vector3D( global[0], global[1], global[2] ), vid ), true ) ;
+          }
+        }
+
+        std::set<CellID> nbs ;
+        while( ! todo.empty() ) {
+          CellID cell = todo.front() ;
+          todo.pop_front() ;
+          nbs.clear() ;
+          seg->neighbours( cell, nbs ) ;
+          for( CellID n : nbs ) {
+            try {
+              accept( n, true ) ;
+            } catch( const std::exception& ) {
+              // index out of range of the segmentation: not a cell
+            }
+          }
+        }
+
+        // an incomplete volume would silently miss neighbour relations
+        if( truncated ) {
+          std::stringstream err ;
+          err << "CellNeighbourTable::build: volume " << pv.name() << " of " << context->element.path()
+              << " has more than " << maxCellsPerVolume << " cells - increase maxCellsPerVolume" ;
+          throw std::runtime_error( err.str() ) ;
+        }
+
+        // ---- neighbours within the volume as given by the segmentation
+        if( seg ) {
+          for( size_t i=first ; i<entries.size() ; ++i ) {
+            nbs.clear() ;
+            seg->neighbours( entries[i].id, nbs ) ;
+            for( CellID n : nbs ) {
+              auto it = index.find( n ) ;
+              if( it != index.end() )
+                edges.push_back( std::make_pair( unsigned(i), it->second ) ) ;
+            }
+          }
+        }
+      }
+
+      // ---- neighbours across volume boundaries by proximity of the cell centers
+      if( maxDistance > 0. ) {
+
+        std::unordered_map<BucketKey,std::vector<unsigned>,BucketHash> buckets ;
+        auto keyOf = [maxDistance]( const double* p ) {
+          BucketKey k = { (long long) std::floor( p[0] / maxDistance ),
+                          (long long) std::floor( p[1] / maxDistance ),
+                          (long long) std::floor( p[2] / maxDistance ) } ;
+          return k ;
+        } ;
+        for( size_t i=0 ; i<entries.size() ; ++i )
+          buckets[ keyOf( entries[i].pos ) ].push_back( i ) ;
+
+        const double dist2 = maxDistance * maxDistance ;
+        for( size_t i=0 ; i<entries.size() ; ++i ) {
+          const CellEntry& e = entries[i] ;
+          BucketKey k = keyOf( e.pos ) ;
+          for( long long di=-1 ; di<=1 ; ++di ) for( long long dj=-1 ; dj<=1 ; ++dj ) for( long long dk=-1 ; dk<=1 ; ++dk ) {
+            BucketKey b = { k.i+di, k.j+dj, k.k+dk } ;
+            auto it = buckets.find( b ) ;
+            if( it == buckets.end() )
+              continue ;
+            for( unsigned j : it->second ) {
+              const CellEntry& o = entries[j] ;
+              if( o.volume == e.volume )
+                continue ;
+              double dx = o.pos[0]-e.pos[0], dy = o.pos[1]-e.pos[1], dz = o.pos[2]-e.pos[2] ;
+              if( dx*dx + dy*dy + dz*dz <= dist2 )
+                edges.push_back( std::make_pair( unsigned(i), j ) ) ;
+            }
+          }
+        }
+      }
+
+      // ---- compressed sparse rows sorted by cell ID, symmetric and without duplicates
+      std::vector<unsigned> order( entries.size() ) ;
+      for( size_t i=0 ; i<order.size() ; ++i ) order[i] = i ;
+      std::sort( order.begin(), order.end(), [&entries]( unsigned a, unsigned b ) { return entries[a].id < entries[b].id ; } ) ;
+
+      size_t numEdges = edges.size() ;
+      edges.reserve( 2*numEdges ) ;
+      for( size_t i=0 ; i<numEdges ; ++i )
+        edges.push_back( std::make_pair( edges[i].second, edges[i].first ) ) ;
+      std::vector<std::pair<CellID,CellID> > ids ;
+      ids.reserve( edges.size() ) ;
+      for( const auto& e : edges )
+        if( entries[e.first].id != entries[e.second].id )
+          ids.push_back( std::make_pair( entries[e.first].id, entries[e.second].id ) ) ;
+      std::sort( ids.begin(), ids.end() ) ;
+      ids.erase( std::unique( ids.begin(), ids.end() ), ids.end() ) ;
+
+      _cells.clear() ;
+      _cells.reserve( entries.size() ) ;
+      for( unsigned i : order )
+        if( _cells.empty() || _cells.back() != entries[i].id )
+          _cells.push_back( entries[i].id ) ;
+
+      _offsets.assign( _cells.size()+1, 0 ) ;
+      _neighbours.resize( ids.size() ) ;
+      size_t row = 0 ;
+      for( size_t i=0 ; i<ids.size() ; ++i ) {
+        while( _cells[row] != ids[i].first ) _offsets[ ++row ] = i ;
+        _neighbours[i] = ids[i].second ;
+      }
+      while( row < _cells.size() ) _offsets[ ++row ] = ids.size() ;
+    }
+
+    void CellNeighbourTable::writeFile( const std::string& fileName ) const {
+
+      std::ofstream out( fileName.c_str() , std::ios::binary | std::ios::trunc ) ;
+
+      if( !out.good() )
+        throw std::runtime_error( "CellNeighbourTable::writeFile: cannot open file " + fileName ) ;
+
+      unsigned long long n[2] = { _cells.size(), _neighbours.size() } ;
+
+      out.write( NEIGHBOURTABLE_MAGIC, sizeof(NEIGHBOURTABLE_MAGIC) ) ;
+      out.write( (const char*) &NEIGHBOURTABLE_VERSION, sizeof(NEIGHBOURTABLE_VERSION) ) ;
+      out.write( (const char*) n, sizeof(n) ) ;
+      out.write( (const char*) _cells.data(), _cells.size() * sizeof(CellID) ) ;
+      out.write( (const char*) _offsets.data(), _offsets.size() * sizeof(unsigned) ) ;
+      out.write( (const char*) _neighbours.data(), _neighbours.size() * sizeof(CellID) ) ;
+
+      if( !out.good() )
+        throw std::runtime_error( "CellNeighbourTable::writeFile: failed to write file " + fileName ) ;
+    }
+
+    void CellNeighbourTable::readFile( const std::string& fileName ) {
+
+      std::ifstream in( fileName.c_str() , std::ios::binary ) ;
+
+      if( !in.good() )
+        throw std::runtime_error( "CellNeighbourTable::readFile: cannot open file " + fileName ) ;
+
+      char     magic[8] ;
+      unsigned version = 0 ;
+      unsigned long long n[2] ;
+
+      in.read( magic, sizeof(magic) ) ;
+      in.read( (char*) &version, sizeof(version) ) ;
+
+      if( !in.good() || std::memcmp( magic, NEIGHBOURTABLE_MAGIC, sizeof(magic) ) != 0 || version != NEIGHBOURTABLE_VERSION )
+        throw std::runtime_error( "CellNeighbourTable::readFile: not a cell neighbour table file (or wrong version): " + fileName ) ;
+
+      in.read( (char*) n, sizeof(n) ) ;
+
+      if( !in.good() )
+        throw std::runtime_error( "CellNeighbourTable::readFile: truncated header in file " + fileName ) ;
+
+      // validate the sizes against the size of the file before allocating the table
+      std::streampos header = in.tellg() ;
+      in.seekg( 0, std::ios::end ) ;
+      std::streamoff dataSize = in.tellg() - header ;
+      in.seekg( header ) ;
+
+      const unsigned long long rowSize = sizeof(CellID) + sizeof(unsigned) ;
+      if( !in.good() || dataSize < 0 || n[0] > (unsigned long long) dataSize / rowSize || n[1] > std::numeric_limits<unsigned>::max()
+          || (unsigned long long) dataSize != n[0] * rowSize + sizeof(unsigned) + n[1] * sizeof(CellID) )
+        throw std::runtime_error( "CellNeighbourTable::readFile: table data does not match the table sizes in file " + fileName ) ;
+
+      _cells.resize( n[0] ) ;
+      _offsets.resize( n[0]+1 ) ;
+      _neighbours.resize( n[1] ) ;
+      in.read( (char*) _cells.data(), _cells.size() * sizeof(CellID) ) ;
+      in.read( (char*) _offsets.data(), _offsets.size() * sizeof(unsigned) ) ;
+      in.read( (char*) _neighbours.data(), _neighbours.size() * sizeof(CellID) ) ;
+
+      if( !in.good() )
+        throw std::runtime_error( "CellNeighbourTable::readFile: truncated table data in file " + fileName ) ;
+
+      // the lookup needs sorted cells and rows inside the neighbour array
+      bool valid = _offsets.front() == 0 && _offsets.back() == n[1] ;
+      for( size_t i=0 ; valid && i<_cells.size() ; ++i )
+        valid = _offsets[i] <= _offsets[i+1] && ( i == 0 || _cells[i-1] < _cells[i] ) ;
+
+      if( !valid ) {
+        _cells.clear() ;
+        _offsets.assign( 1, 0 ) ;
+        _neighbours.clear() ;
+        throw std::runtime_error( "CellNeighbourTable::readFile: inconsistent table data in file " + fileName ) ;
+      }
+    }
+
+    bool CellNeighbourTable::contains( CellID cell ) const {
+      return std::binary_search( _cells.begin(), _cells.end(), cell ) ;
+    }
+
+    CellNeighbourTable::Range CellNeighbourTable::neighbours( CellID cell ) const {
+      std::vector<CellID>::const_iterator it = std::lower_bound( _cells.begin(), _cells.end(), cell ) ;
+      if( it == _cells.end() || *it != cell )
+        return Range() ;
+      return neighboursAt( it - _cells.begin() ) ;
+    }
+
+    bool CellNeighbourTable::isNeighbour( CellID cell, CellID other ) const {
+      Range r = neighbours( cell ) ;
+      return std::binary_search( r.begin(), r.end(), other ) ;
+    }
+
+  } /* namespace rec */
+} /* namespace dd4hep */
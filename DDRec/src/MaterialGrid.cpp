@@ -0,0 +1,306 @@
+#include "DDRec/MaterialGrid.h"
+
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+
+namespace dd4hep {
+  namespace rec {
+
+    namespace {
+      /// Magic word and version at the beginning of the binary file
+      const char     MATERIALGRID_MAGIC[8] = { 'D','D','4','M','G','R','I','D' } ;
+      const unsigned MATERIALGRID_VERSION  = 1 ;
+    }
+
+    MaterialGrid::MaterialGrid() : _lower(), _upper(), _size(), _cells() {
+      _n[0] = _n[1] = _n[2] = 0 ;
+    }
+
+    MaterialGrid::MaterialGrid( const Vector3D& lower, const Vector3D& upper, unsigned nx, unsigned ny, unsigned nz ) {
+      initialize( lower, upper, nx, ny, nz ) ;
+    }
+
+    MaterialGrid::~MaterialGrid(){
+    }
+
+    void MaterialGrid::initialize( const Vector3D& lower, const Vector3D& upper, unsigned nx, unsigned ny, unsigned nz ) {
+
+      if( nx == 0 || ny == 0 || nz == 0 )
+        throw std::runtime_error( "MaterialGrid::initialize: number of cells must be positive in all dimensions" ) ;
+
+      _lower = lower ;
+      _upper = upper ;
+      _n[0] = nx ;  _n[1] = ny ;  _n[2] = nz ;
+
+      for( unsigned a=0 ; a<3 ; ++a ){
+        if( !( _upper[a] > _lower[a] ) ) {
+          std::stringstream err ;
+          err << " MaterialGrid::initialize: invalid grid extent: " << _lower << " - " << _upper ;
+          throw std::runtime_error( err.str() ) ;
+        }
+        _size[a] = ( _upper[a] - _lower[a] ) / _n[a] ;
+      }
+
+      Cell vacuum ;
+      std::memset( &vacuum, 0, sizeof(Cell) ) ;
+      _cells.assign( size_t(nx) * ny * nz , vacuum ) ;
+    }
+
+    void MaterialGrid::build( MaterialManager& matMgr, unsigned samplesPerAxis ) {
+
+      if( samplesPerAxis == 0 ) samplesPerAxis = 1 ;
+
+      const double norm = 1. / ( samplesPerAxis * samplesPerAxis * samplesPerAxis ) ;
+
+      for( unsigned k=0 ; k<_n[2] ; ++k ){
+        for( unsigned j=0 ; j<_n[1] ; ++j ){
+          for( unsigned i=0 ; i<_n[0] ; ++i ){
+
+            double sum[5] = { 0., 0., 0., 0., 0. } ;
+
+            for( unsigned sk=0 ; sk<samplesPerAxis ; ++sk ){
+              for( unsigned sj=0 ; sj<samplesPerAxis ; ++sj ){
+                for( unsigned si=0 ; si<samplesPerAxis ; ++si ){
+
+                  Vector3D pos( _lower[0] + ( i + ( si + 0.5 ) / samplesPerAxis ) * _size[0] ,
+                                _lower[1] + ( j + ( sj + 0.5 ) / samplesPerAxis ) * _size[1] ,
+                                _lower[2] + ( k + ( sk + 0.5 ) / samplesPerAxis ) * _size[2] ) ;
+                  try {
+                    const Material& mat = matMgr.materialAt( pos ) ;
+                    double rho    = mat.density() ;
+                    double A      = mat.A() ;
+                    double x      = mat.radLength() ;
+                    double lambda = mat.intLength() ;
+                    sum[0] += rho ;
+                    if( A > 0. ) {
+                      sum[1] += rho / A ;
+                      sum[2] += rho * mat.Z() / A ;
+                    }
+                    if( x > 0. )      sum[3] += 1. / x ;
+                    if( lambda > 0. ) sum[4] += 1. / lambda ;
+                  }
+                  catch( const std::exception& ) {
+                    // outside of the world volume: vacuum
+                  }
+                }
+              }
+            }
+            Cell& c = _cells[ index( i, j, k ) ] ;
+            c.rho          = sum[0] * norm ;
+            c.rho_over_A   = sum[1] * norm ;
+            c.rho_Z_over_A = sum[2] * norm ;
+            c.inv_x0       = sum[3] * norm ;
+            c.inv_lambda   = sum[4] * norm ;
+          }
+        }
+      }
+    }
+
+    void MaterialGrid::writeFile( const std::string& fileName ) const {
+
+      std::ofstream out( fileName.c_str() , std::ios::binary | std::ios::trunc ) ;
+
+      if( !out.good() )
+        throw std::runtime_error( "MaterialGrid::writeFile: cannot open file " + fileName ) ;
+
+      double bounds[6] = { _lower[0], _lower[1], _lower[2], _upper[0], _upper[1], _upper[2] } ;
+
+      out.write( MATERIALGRID_MAGIC, sizeof(MATERIALGRID_MAGIC) ) ;
+      out.write( (const char*) &MATERIALGRID_VERSION, sizeof(MATERIALGRID_VERSION) ) ;
+      out.write( (const char*) _n, sizeof(_n) ) ;
+      out.write( (const char*) bounds, sizeof(bounds) ) ;
+      out.write( (const char*) &_cells[0], _cells.size() * sizeof(Cell) ) ;
+
+      if( !out.good() )
+        throw std::runtime_error( "MaterialGrid::writeFile: failed to write file " + fileName ) ;
+    }
+
+    void MaterialGrid::readFile( const std::string& fileName ) {
+
+      std::ifstream in( fileName.c_str() , std::ios::binary ) ;
+
+      if( !in.good() )
+        throw std::runtime_error( "MaterialGrid::readFile: cannot open file " + fileName ) ;
+
+      char     magic[8] ;
+      unsigned version = 0 ;
+      unsigned n[3] ;
+      double   bounds[6] ;
+
+      in.read( magic, sizeof(magic) ) ;
+      in.read( (char*) &version, sizeof(version) ) ;
+
+      if( !in.good() || std::memcmp( magic, MATERIALGRID_MAGIC, sizeof(magic) ) != 0 || version != MATERIALGRID_VERSION )
+        throw std::runtime_error( "MaterialGrid::readFile: not a material grid file (or wrong version): " + fileName ) ;
+
+      in.read( (char*) n, sizeof(n) ) ;
+      in.read( (char*) bounds, sizeof(bounds) ) ;
+
+      if( !in.good() )
+        throw std::runtime_error( "MaterialGrid::readFile: truncated header in file " + fileName ) ;
+
+      // validate the dimensions against overflow and the size of the file before allocating the cells
+      size_t numCells = 1 ;
+      for( unsigned a=0 ; a<3 ; ++a ){
+        if( n[a] == 0 || numCells > std::numeric_limits<size_t>::max() / sizeof(Cell) / n[a] )
+          throw std::runtime_error( "MaterialGrid::readFile: invalid grid dimensions in file " + fileName ) ;
+        numCells *= n[a] ;
+      }
+
+      std::streampos header = in.tellg() ;
+      in.seekg( 0, std::ios::end ) ;
+      std::streamoff dataSize = in.tellg() - header ;
+      in.seekg( header ) ;
+
+      if( !in.good() || dataSize < 0 || size_t( dataSize ) != numCells * sizeof(Cell) )
+        throw std::runtime_error( "MaterialGrid::readFile: cell data does not match the grid dimensions in file " + fileName ) ;
+
+      initialize( Vector3D( bounds[0], bounds[1], bounds[2] ), Vector3D( bounds[3], bounds[4], bounds[5] ), n[0], n[1], n[2] ) ;
+
+      in.read( (char*) &_cells[0], _cells.size() * sizeof(Cell) ) ;
+
+      if( !in.good() )
+        throw std::runtime_error( "MaterialGrid::readFile: truncated cell data in file " + fileName ) ;
+    }
+
+    bool MaterialGrid::contains( const Vector3D& pos ) const {
+      return ( pos[0] >= _lower[0] && pos[0] < _upper[0] &&
+               pos[1] >= _lower[1] && pos[1] < _upper[1] &&
+               pos[2] >= _lower[2] && pos[2] < _upper[2] ) ;
+    }
+
+    const MaterialGrid::Cell& MaterialGrid::cellAt( const Vector3D& pos ) const {
+
+      if( _cells.empty() || !contains( pos ) ) {
+        std::stringstream err ;
+        err << " MaterialGrid::cellAt: position outside of material grid: " << pos ;
+        throw std::out_of_range( err.str() ) ;
+      }
+      unsigned idx[3] ;
+      for( unsigned a=0 ; a<3 ; ++a ){
+        idx[a] = unsigned( ( pos[a] - _lower[a] ) / _size[a] ) ;
+        if( idx[a] >= _n[a] ) idx[a] = _n[a] - 1 ;
+      }
+      return _cells[ index( idx[0], idx[1], idx[2] ) ] ;
+    }
+
+    void MaterialGrid::integrate( const Vector3D& p0, const Vector3D& p1, double sums[6] ) const {
+
+      for( unsigned a=0 ; a<6 ; ++a ) sums[a] = 0. ;
+
+      const Vector3D d = p1 - p0 ;
+      const double   L = d.r() ;
+
+      sums[0] = L ;
+
+      if( _cells.empty() || L <= 0. ) return ;
+
+      // clip the segment (parametrised with t in [0,1]) to the grid box
+      double tmin = 0. , tmax = 1. ;
+      for( unsigned a=0 ; a<3 ; ++a ){
+        if( std::fabs( d[a] ) < std::numeric_limits<double>::min() ) {
+          if( p0[a] < _lower[a] || p0[a] >= _upper[a] ) return ;
+          continue ;
+        }
+        double t0 = ( _lower[a] - p0[a] ) / d[a] ;
+        double t1 = ( _upper[a] - p0[a] ) / d[a] ;
+        if( t0 > t1 ) std::swap( t0, t1 ) ;
+        if( t0 > tmin ) tmin = t0 ;
+        if( t1 < tmax ) tmax = t1 ;
+      }
+      if( tmin >= tmax ) return ;
+
+      // 3D DDA through the cells crossed by the segment
+      int    idx[3], step[3] ;
+      double tNext[3], tDelta[3] ;
+
+      for( unsigned a=0 ; a<3 ; ++a ){
+        double x = p0[a] + tmin * d[a] ;
+        idx[a] = int( std::floor( ( x - _lower[a] ) / _size[a] ) ) ;
+        if( idx[a] < 0 ) idx[a] = 0 ;
+        if( idx[a] >= int(_n[a]) ) idx[a] = _n[a] - 1 ;
+
+        if( d[a] > 0. ) {
+          step[a]   = 1 ;
+          tDelta[a] = _size[a] / d[a] ;
+          tNext[a]  = ( _lower[a] + ( idx[a] + 1 ) * _size[a] - p0[a] ) / d[a] ;
+        } else if( d[a] < 0. ) {
+          step[a]   = -1 ;
+          tDelta[a] = - _size[a] / d[a] ;
+          tNext[a]  = ( _lower[a] + idx[a] * _size[a] - p0[a] ) / d[a] ;
+        } else {
+          step[a]   = 0 ;
+          tDelta[a] = std::numeric_limits<double>::max() ;
+          tNext[a]  = std::numeric_limits<double>::max() ;
+        }
+      }
+
+      double t = tmin ;
+      while( t < tmax ) {
+
+        unsigned a = ( tNext[0] < tNext[1] ) ? ( tNext[0] < tNext[2] ? 0 : 2 ) : ( tNext[1] < tNext[2] ? 1 : 2 ) ;
+
+        double tEnd = ( tNext[a] < tmax ? tNext[a] : tmax ) ;
+        double l    = ( tEnd - t ) * L ;
+
+        const Cell& c = _cells[ index( idx[0], idx[1], idx[2] ) ] ;
+        sums[1] += c.rho          * l ;
+        sums[2] += c.rho_over_A   * l ;
+        sums[3] += c.rho_Z_over_A * l ;
+        sums[4] += c.inv_x0       * l ;
+        sums[5] += c.inv_lambda   * l ;
+
+        t = tEnd ;
+        idx[a] += step[a] ;
+        if( idx[a] < 0 || idx[a] >= int(_n[a]) ) break ;
+        tNext[a] += tDelta[a] ;
+      }
+    }
+
+    MaterialData MaterialGrid::averagedMaterialBetween( const Vector3D& p0, const Vector3D& p1 ) const {
+
+      double sums[6] ;
+
+      if( p0 == p1 ) {
+        // degenerate segment: properties of the cell at p0 (if any)
+        integrate( p0, p0 + Vector3D( 1.e-6 * _size[0], 0., 0. ), sums ) ;
+      } else {
+        integrate( p0, p1, sums ) ;
+      }
+
+      const double sum_l                 = sums[0] ;
+      const double sum_rho_l             = sums[1] ;
+      const double sum_rho_l_over_A      = sums[2] ;
+      const double sum_rho_l_Z_over_A    = sums[3] ;
+      const double sum_l_over_x          = sums[4] ;
+      const double sum_l_over_lambda     = sums[5] ;
+
+      const double huge = std::numeric_limits<double>::max() ;
+
+      double rho     =  sum_l > 0.              ? sum_rho_l / sum_l                        : 0. ;
+      double A       =  sum_rho_l_over_A > 0.   ? sum_rho_l / sum_rho_l_over_A             : 0. ;
+      double Z       =  sum_rho_l_over_A > 0.   ? sum_rho_l_Z_over_A / sum_rho_l_over_A    : 0. ;
+      double x       =  sum_l_over_x > 0.       ? sum_l / sum_l_over_x                     : huge ;
+      double lambda  =  sum_l_over_lambda > 0.  ? sum_l / sum_l_over_lambda                : huge ;
+
+      return MaterialData( "MaterialGrid_average" , Z, A, rho, x, lambda ) ;
+    }
+
+    double MaterialGrid::radiationLengthsBetween( const Vector3D& p0, const Vector3D& p1 ) const {
+      double sums[6] ;
+      integrate( p0, p1, sums ) ;
+      return sums[4] ;
+    }
+
+    double MaterialGrid::interactionLengthsBetween( const Vector3D& p0, const Vector3D& p1 ) const {
+      double sums[6] ;
+      integrate( p0, p1, sums ) ;
+      return sums[5] ;
+    }
+
+  } /* namespace rec */
+} /* namespace dd4hep */
@@ -699,6 +699,44 @@ namespace dd4hep {
       return _volSurf.insideBounds( localPoint , epsilon) ;
     }
 
+    void Surface::globalBoundingBox( Vector3D& lower, Vector3D& upper ) const {
+
+      const TGeoBBox* box = dynamic_cast<const TGeoBBox*>( volume()->GetShape() ) ;
+
+      std::vector< Vector3D > points ;
+
+      if( box ) {
+        // the eight corners of the volume's bounding box 
+        const double* bo = box->GetOrigin() ;
+        const double d[3] = { box->GetDX(), box->GetDY(), box->GetDZ() } ;
+        points.reserve( 8 ) ;
+        for( unsigned i=0 ; i<8 ; ++i ){
+          Vector3D lc( bo[0] + ( i & 1 ? d[0] : -d[0] ) , 
+                       bo[1] + ( i & 2 ? d[1] : -d[1] ) ,
+                       bo[2] + ( i & 4 ? d[2] : -d[2] ) ) ;
+          Vector3D gc ;
+          _wtM->LocalToMaster( lc , gc.array() ) ;
+          points.push_back( gc ) ;
+        }
+      } else {
+        // fall back to the drawing lines of the surface
+        std::vector< std::pair< Vector3D, Vector3D> > lines = const_cast<Surface*>( this )->getLines() ;
+        for( unsigned i=0,n=lines.size() ; i<n ; ++i ){
+          points.push_back( lines[i].first ) ;
+          points.push_back( lines[i].second ) ;
+        }
+        if( points.empty() ) points.push_back( _o ) ;
+      }
+
+      lower = upper = points[0] ;
+      for( unsigned i=1,n=points.size() ; i<n ; ++i ){
+        for( unsigned a=0 ; a<3 ; ++a ){
+          if( points[i][a] < lower[a] ) lower[a] = points[i][a] ;
+          if( points[i][a] > upper[a] ) upper[a] = points[i][a] ;
+        }
+      }
+    }
+
     void Surface::initialize() {
       
       // first we need to find the right volume for the local surface in the DetElement's volumes
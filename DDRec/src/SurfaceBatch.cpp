@@ -0,0 +1,349 @@
+#include "DDRec/SurfaceBatch.h"
+#include "DDRec/Surface.h"
+
+#include "TGeoBBox.h"
+#include "TGeoTube.h"
+#include "TGeoMatrix.h"
+
+#include <cmath>
+#include <typeinfo>
+
+namespace dd4hep {
+  namespace rec {
+
+    namespace {
+
+      /// Wrap an angle difference into [-pi,pi] like VolCylinderImpl::globalToLocal
+      inline double wrapPhi( double phi ){
+        while( phi < -M_PI ) phi += 2.*M_PI ;
+        while( phi >  M_PI ) phi -= 2.*M_PI ;
+        return phi ;
+      }
+
+      /// World to local transformation of one surface
+      struct Frame {
+        double r[9] ;
+        double t[3] ;
+      } ;
+
+      /// World to local written out like TGeoHMatrix::MasterToLocal, so that the results
+      /// of the kernels agree with those of the Surface methods
+      inline void toLocal( const Frame& f, double x, double y, double z, double& lx, double& ly, double& lz ){
+        const double mt0 = x - f.t[0], mt1 = y - f.t[1], mt2 = z - f.t[2] ;
+        lx = mt0*f.r[0] + mt1*f.r[3] + mt2*f.r[6] ;
+        ly = mt0*f.r[1] + mt1*f.r[4] + mt2*f.r[7] ;
+        lz = mt0*f.r[2] + mt1*f.r[5] + mt2*f.r[8] ;
+      }
+
+      /// The same for the i-th entry of the rotation and translation columns r[0..8], t[0..2]
+      inline void toLocal( const double* const r[9], const double* const t[3], size_t i,
+                           double x, double y, double z, double& lx, double& ly, double& lz ){
+        const double mt0 = x - t[0][i], mt1 = y - t[1][i], mt2 = z - t[2][i] ;
+        lx = mt0*r[0][i] + mt1*r[3][i] + mt2*r[6][i] ;
+        ly = mt0*r[1][i] + mt1*r[4][i] + mt2*r[7][i] ;
+        lz = mt0*r[2][i] + mt1*r[5][i] + mt2*r[8][i] ;
+      }
+    }
+
+    SurfaceBatch::SurfaceBatch( const std::vector<ISurface*>& surfaces ) : _nPlanes(0), _nCylinders(0) {
+
+      std::vector<const ISurface*> planes, cylinders, others ;
+
+      for( ISurface* s : surfaces ){
+        switch( classify( s ) ){
+        case Plane:    planes.push_back( s ) ;    break ;
+        case Cylinder: cylinders.push_back( s ) ; break ;
+        default:       others.push_back( s ) ;    break ;
+        }
+      }
+
+      for( unsigned c=0 ; c<NCOLUMNS ; ++c ) _columns[c].reserve( planes.size() + cylinders.size() ) ;
+      _surfaces.reserve( surfaces.size() ) ;
+
+      for( const ISurface* s : planes )    pack( s, Plane ) ;
+      for( const ISurface* s : cylinders ) pack( s, Cylinder ) ;
+      _surfaces.insert( _surfaces.end(), others.begin(), others.end() ) ;
+
+      _nPlanes    = planes.size() ;
+      _nCylinders = cylinders.size() ;
+    }
+
+    SurfaceBatch::~SurfaceBatch(){
+    }
+
+    SurfaceBatch::Kind SurfaceBatch::classify( const ISurface* s ){
+
+      // only the exact implementations whose methods are reproduced by the kernels are packed
+      const Surface* surf = dynamic_cast<const Surface*>( s ) ;
+      if( !surf || !surf->_wtM || surf->_wtM->IsScale() )
+        return Generic ;
+
+      const VolSurfaceBase* vs = surf->_volSurf.ptr() ;
+      if( !vs || !vs->volume().isValid() )
+        return Generic ;
+
+      const TGeoShape* shape = vs->volume()->GetShape() ;
+      if( !shape )
+        return Generic ;
+
+      if( typeid( *surf ) == typeid( Surface ) && typeid( *vs ) == typeid( VolPlaneImpl ) &&
+          shape->IsA() == TGeoBBox::Class() )
+        return Plane ;
+
+      if( typeid( *surf ) == typeid( CylinderSurface ) && typeid( *vs ) == typeid( VolCylinderImpl ) &&
+          shape->IsA() == TGeoTube::Class() )
+        return Cylinder ;
+
+      return Generic ;
+    }
+
+    void SurfaceBatch::pack( const ISurface* s, Kind k ){
+
+      const Surface* surf = static_cast<const Surface*>( s ) ;
+      const VolSurface& vs = surf->_volSurf ;
+      const double* r = surf->_wtM->GetRotationMatrix() ;
+      const double* t = surf->_wtM->GetTranslation() ;
+
+      std::vector<double>* c = _columns ;
+      for( unsigned i=0 ; i<9 ; ++i ) c[R0+i].push_back( r[i] ) ;
+      c[TX].push_back( t[0] ) ;  c[TY].push_back( t[1] ) ;  c[TZ].push_back( t[2] ) ;
+
+      // planes: see VolPlaneImpl::distance and Surface::globalToLocal
+      Vector3D o, n, go, up, vp ;
+      double bo[3] = { 0., 0., 0. }, bd[3] = { 0., 0., 0. } ;
+      if( k == Plane ){
+        o  = vs.origin() ;
+        n  = vs.normal() ;
+        go = surf->origin() ;
+        Vector3D u_val = surf->u(), v_val = surf->v() ;
+        double uv = u_val * v_val ;
+        Vector3D uprime = ( u_val - uv * v_val ).unit() ;
+        Vector3D vprime = ( v_val - uv * u_val ).unit() ;
+        up = ( 1. / ( u_val * uprime ) ) * uprime ;
+        vp = ( 1. / ( v_val * vprime ) ) * vprime ;
+        const TGeoBBox* box = static_cast<const TGeoBBox*>( surf->volume()->GetShape() ) ;
+        const double* org = box->GetOrigin() ;
+        bo[0] = org[0] ;  bo[1] = org[1] ;  bo[2] = org[2] ;
+        bd[0] = box->GetDX() ;  bd[1] = box->GetDY() ;  bd[2] = box->GetDZ() ;
+      }
+      c[OX].push_back( o.x() ) ;   c[OY].push_back( o.y() ) ;   c[OZ].push_back( o.z() ) ;
+      c[NX].push_back( n.x() ) ;   c[NY].push_back( n.y() ) ;   c[NZ].push_back( n.z() ) ;
+      c[GX].push_back( go.x() ) ;  c[GY].push_back( go.y() ) ;  c[GZ].push_back( go.z() ) ;
+      c[UX].push_back( up.x() ) ;  c[UY].push_back( up.y() ) ;  c[UZ].push_back( up.z() ) ;
+      c[VX].push_back( vp.x() ) ;  c[VY].push_back( vp.y() ) ;  c[VZ].push_back( vp.z() ) ;
+      c[BX].push_back( bo[0] ) ;   c[BY].push_back( bo[1] ) ;   c[BZ].push_back( bo[2] ) ;
+      c[DX].push_back( bd[0] ) ;   c[DY].push_back( bd[1] ) ;   c[DZ].push_back( bd[2] ) ;
+
+      // cylinders: see VolCylinderImpl::distance and VolCylinderImpl::globalToLocal
+      double radius = 0., phi0 = 0., z0 = 0., rmin = 0., rmax = 0., dz = 0. ;
+      if( k == Cylinder ){
+        radius = vs.origin().rho() ;
+        phi0   = vs.origin().phi() ;
+        z0     = vs.origin().z() ;
+        const TGeoTube* tube = static_cast<const TGeoTube*>( surf->volume()->GetShape() ) ;
+        rmin = tube->GetRmin() ;  rmax = tube->GetRmax() ;  dz = tube->GetDz() ;
+      }
+      c[RADIUS].push_back( radius ) ;
+      c[PHI0].push_back( phi0 ) ;
+      c[Z0].push_back( z0 ) ;
+      c[RMIN2].push_back( rmin * rmin ) ;
+      c[RMAX2].push_back( rmax * rmax ) ;
+      c[HALFZ].push_back( dz ) ;
+
+      _surfaces.push_back( s ) ;
+    }
+
+    void SurfaceBatch::frame( size_t i, double r[9], double t[3] ) const {
+      const bool packed = i < _nPlanes + _nCylinders ;
+      for( unsigned j=0 ; j<9 ; ++j ) r[j] = packed ? _columns[R0+j][i] : 0. ;
+      for( unsigned j=0 ; j<3 ; ++j ) t[j] = packed ? _columns[TX+j][i] : 0. ;
+    }
+
+    //==== many points for one surface ====
+
+    void SurfaceBatch::distance( size_t i, size_t n, const double* x, const double* y, const double* z,
+                                 double* dist ) const {
+      Frame f ;
+      frame( i, f.r, f.t ) ;
+      double lx, ly, lz ;
+
+      switch( kind( i ) ){
+      case Plane: {
+        const double ox = col(OX)[i], oy = col(OY)[i], oz = col(OZ)[i] ;
+        const double nx = col(NX)[i], ny = col(NY)[i], nz = col(NZ)[i] ;
+        for( size_t k=0 ; k<n ; ++k ){
+          toLocal( f, x[k], y[k], z[k], lx, ly, lz ) ;
+          dist[k] = ( lx - ox ) * nx + ( ly - oy ) * ny + ( lz - oz ) * nz ;
+        }
+        break ;
+      }
+      case Cylinder: {
+        const double radius = col(RADIUS)[i] ;
+        for( size_t k=0 ; k<n ; ++k ){
+          toLocal( f, x[k], y[k], z[k], lx, ly, lz ) ;
+          dist[k] = std::sqrt( lx*lx + ly*ly ) - radius ;
+        }
+        break ;
+      }
+      default: {
+        const ISurface* surf = _surfaces[i] ;
+        for( size_t k=0 ; k<n ; ++k ) dist[k] = surf->distance( Vector3D( x[k], y[k], z[k] ) ) ;
+        break ;
+      }
+      }
+    }
+
+    void SurfaceBatch::insideBounds( size_t i, size_t n, const double* x, const double* y, const double* z,
+                                     unsigned char* inside, double epsilon ) const {
+      Frame f ;
+      frame( i, f.r, f.t ) ;
+      double lx, ly, lz ;
+
+      switch( kind( i ) ){
+      case Plane: {
+        const double ox = col(OX)[i], oy = col(OY)[i], oz = col(OZ)[i] ;
+        const double nx = col(NX)[i], ny = col(NY)[i], nz = col(NZ)[i] ;
+        const double bx = col(BX)[i], by = col(BY)[i], bz = col(BZ)[i] ;
+        const double dx = col(DX)[i], dy = col(DY)[i], dz = col(DZ)[i] ;
+        for( size_t k=0 ; k<n ; ++k ){
+          toLocal( f, x[k], y[k], z[k], lx, ly, lz ) ;
+          const double d = ( lx - ox ) * nx + ( ly - oy ) * ny + ( lz - oz ) * nz ;
+          inside[k] = ( std::abs( d ) < epsilon ) & ( std::abs( lx - bx ) <= dx ) &
+            ( std::abs( ly - by ) <= dy ) & ( std::abs( lz - bz ) <= dz ) ;
+        }
+        break ;
+      }
+      case Cylinder: {
+        const double radius = col(RADIUS)[i], rmin2 = col(RMIN2)[i], rmax2 = col(RMAX2)[i], dz = col(HALFZ)[i] ;
+        for( size_t k=0 ; k<n ; ++k ){
+          toLocal( f, x[k], y[k], z[k], lx, ly, lz ) ;
+          const double r2 = lx*lx + ly*ly ;
+          inside[k] = ( std::abs( std::sqrt( r2 ) - radius ) < epsilon ) & ( std::abs( lz ) <= dz ) &
+            ( r2 >= rmin2 ) & ( r2 <= rmax2 ) ;
+        }
+        break ;
+      }
+      default: {
+        const ISurface* surf = _surfaces[i] ;
+        for( size_t k=0 ; k<n ; ++k ) inside[k] = surf->insideBounds( Vector3D( x[k], y[k], z[k] ), epsilon ) ;
+        break ;
+      }
+      }
+    }
+
+    void SurfaceBatch::globalToLocal( size_t i, size_t n, const double* x, const double* y, const double* z,
+                                      double* u, double* v ) const {
+      Frame f ;
+      frame( i, f.r, f.t ) ;
+      double lx, ly, lz ;
+
+      switch( kind( i ) ){
+      case Plane: {
+        const double gx = col(GX)[i], gy = col(GY)[i], gz = col(GZ)[i] ;
+        const double ux = col(UX)[i], uy = col(UY)[i], uz = col(UZ)[i] ;
+        const double vx = col(VX)[i], vy = col(VY)[i], vz = col(VZ)[i] ;
+        for( size_t k=0 ; k<n ; ++k ){
+          const double px = x[k] - gx, py = y[k] - gy, pz = z[k] - gz ;
+          u[k] = px * ux + py * uy + pz * uz ;
+          v[k] = px * vx + py * vy + pz * vz ;
+        }
+        break ;
+      }
+      case Cylinder: {
+        const double radius = col(RADIUS)[i], phi0 = col(PHI0)[i], z0 = col(Z0)[i] ;
+        for( size_t k=0 ; k<n ; ++k ){
+          toLocal( f, x[k], y[k], z[k], lx, ly, lz ) ;
+          const double phi = ( lx == 0.0 && ly == 0.0 ? 0.0 : std::atan2( ly, lx ) ) ;
+          u[k] = radius * wrapPhi( phi - phi0 ) ;
+          v[k] = lz - z0 ;
+        }
+        break ;
+      }
+      default: {
+        const ISurface* surf = _surfaces[i] ;
+        for( size_t k=0 ; k<n ; ++k ){
+          Vector2D l = surf->globalToLocal( Vector3D( x[k], y[k], z[k] ) ) ;
+          u[k] = l.u() ;
+          v[k] = l.v() ;
+        }
+        break ;
+      }
+      }
+    }
+
+    //==== one point for all surfaces ====
+
+    void SurfaceBatch::distance( const Vector3D& point, double* dist ) const {
+      const double* const r[9] = { col(R0), col(R1), col(R2), col(R3), col(R4), col(R5), col(R6), col(R7), col(R8) } ;
+      const double* const t[3] = { col(TX), col(TY), col(TZ) } ;
+      const double x = point.x(), y = point.y(), z = point.z() ;
+      double lx, ly, lz ;
+
+      const double *ox = col(OX), *oy = col(OY), *oz = col(OZ), *nx = col(NX), *ny = col(NY), *nz = col(NZ) ;
+      for( size_t i=0 ; i<_nPlanes ; ++i ){
+        toLocal( r, t, i, x, y, z, lx, ly, lz ) ;
+        dist[i] = ( lx - ox[i] ) * nx[i] + ( ly - oy[i] ) * ny[i] + ( lz - oz[i] ) * nz[i] ;
+      }
+      const double* radius = col(RADIUS) ;
+      for( size_t i=_nPlanes, e=_nPlanes+_nCylinders ; i<e ; ++i ){
+        toLocal( r, t, i, x, y, z, lx, ly, lz ) ;
+        dist[i] = std::sqrt( lx*lx + ly*ly ) - radius[i] ;
+      }
+      for( size_t i=_nPlanes+_nCylinders, e=_surfaces.size() ; i<e ; ++i )
+        dist[i] = _surfaces[i]->distance( point ) ;
+    }
+
+    void SurfaceBatch::insideBounds( const Vector3D& point, unsigned char* inside, double epsilon ) const {
+      const double* const r[9] = { col(R0), col(R1), col(R2), col(R3), col(R4), col(R5), col(R6), col(R7), col(R8) } ;
+      const double* const t[3] = { col(TX), col(TY), col(TZ) } ;
+      const double x = point.x(), y = point.y(), z = point.z() ;
+      double lx, ly, lz ;
+
+      const double *ox = col(OX), *oy = col(OY), *oz = col(OZ), *nx = col(NX), *ny = col(NY), *nz = col(NZ) ;
+      const double *bx = col(BX), *by = col(BY), *bz = col(BZ), *dx = col(DX), *dy = col(DY), *dz = col(DZ) ;
+      for( size_t i=0 ; i<_nPlanes ; ++i ){
+        toLocal( r, t, i, x, y, z, lx, ly, lz ) ;
+        const double d = ( lx - ox[i] ) * nx[i] + ( ly - oy[i] ) * ny[i] + ( lz - oz[i] ) * nz[i] ;
+        inside[i] = ( std::abs( d ) < epsilon ) & ( std::abs( lx - bx[i] ) <= dx[i] ) &
+          ( std::abs( ly - by[i] ) <= dy[i] ) & ( std::abs( lz - bz[i] ) <= dz[i] ) ;
+      }
+      const double *radius = col(RADIUS), *rmin2 = col(RMIN2), *rmax2 = col(RMAX2), *halfz = col(HALFZ) ;
+      for( size_t i=_nPlanes, e=_nPlanes+_nCylinders ; i<e ; ++i ){
+        toLocal( r, t, i, x, y, z, lx, ly, lz ) ;
+        const double r2 = lx*lx + ly*ly ;
+        inside[i] = ( std::abs( std::sqrt( r2 ) - radius[i] ) < epsilon ) & ( std::abs( lz ) <= halfz[i] ) &
+          ( r2 >= rmin2[i] ) & ( r2 <= rmax2[i] ) ;
+      }
+      for( size_t i=_nPlanes+_nCylinders, e=_surfaces.size() ; i<e ; ++i )
+        inside[i] = _surfaces[i]->insideBounds( point, epsilon ) ;
+    }
+
+    void SurfaceBatch::globalToLocal( const Vector3D& point, double* u, double* v ) const {
+      const double* const r[9] = { col(R0), col(R1), col(R2), col(R3), col(R4), col(R5), col(R6), col(R7), col(R8) } ;
+      const double* const t[3] = { col(TX), col(TY), col(TZ) } ;
+      const double x = point.x(), y = point.y(), z = point.z() ;
+      double lx, ly, lz ;
+
+      const double *gx = col(GX), *gy = col(GY), *gz = col(GZ) ;
+      const double *ux = col(UX), *uy = col(UY), *uz = col(UZ), *vx = col(VX), *vy = col(VY), *vz = col(VZ) ;
+      for( size_t i=0 ; i<_nPlanes ; ++i ){
+        const double px = x - gx[i], py = y - gy[i], pz = z - gz[i] ;
+        u[i] = px * ux[i] + py * uy[i] + pz * uz[i] ;
+        v[i] = px * vx[i] + py * vy[i] + pz * vz[i] ;
+      }
+      const double *radius = col(RADIUS), *phi0 = col(PHI0), *z0 = col(Z0) ;
+      for( size_t i=_nPlanes, e=_nPlanes+_nCylinders ; i<e ; ++i ){
+        toLocal( r, t, i, x, y, z, lx, ly, lz ) ;
+        const double phi = ( lx == 0.0 && ly == 0.0 ? 0.0 : std::atan2( ly, lx ) ) ;
+        u[i] = radius[i] * wrapPhi( phi - phi0[i] ) ;
+        v[i] = lz - z0[i] ;
+      }
+      for( size_t i=_nPlanes+_nCylinders, e=_surfaces.size() ; i<e ; ++i ){
+        Vector2D l = _surfaces[i]->globalToLocal( point ) ;
+        u[i] = l.u() ;
+        v[i] = l.v() ;
+      }
+    }
+
+  } /* namespace rec */
+} /* namespace dd4hep */
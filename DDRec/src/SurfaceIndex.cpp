@@ -0,0 +1,384 @@
+#include "DDRec/SurfaceIndex.h"
+#include "DDRec/Surface.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <vector>
+
+namespace dd4hep {
+  namespace rec {
+
+    namespace {
+
+      /// Maximum number of surfaces in a leaf node
+      const unsigned LEAF_SIZE = 4 ;
+
+      /// Traversal stack of node indices. Median splits keep the tree balanced, so the
+      /// fixed storage suffices in practice - deeper trees continue on the heap.
+      class NodeStack {
+        enum { FIXED_SIZE = 128 } ;
+        unsigned  _fixed[ FIXED_SIZE ] ;
+        std::vector<unsigned> _heap ;
+        unsigned* _data ;
+        unsigned  _size ;
+        unsigned  _capacity ;
+      public:
+        NodeStack() : _data( _fixed ), _size( 0 ), _capacity( FIXED_SIZE ) {}
+        NodeStack( const NodeStack& ) = delete ;
+        NodeStack& operator=( const NodeStack& ) = delete ;
+        bool empty() const { return _size == 0 ; }
+        unsigned pop() { return _data[ --_size ] ; }
+        void push( unsigned idx ) {
+          if( _size == _capacity ) {
+            if( _data == _fixed ) _heap.assign( _fixed, _fixed + _size ) ;
+            _capacity *= 2 ;
+            _heap.resize( _capacity ) ;
+            _data = &_heap[0] ;
+          }
+          _data[ _size++ ] = idx ;
+        }
+      } ;
+
+      /// Squared distance of a point to an axis aligned box (0 if inside)
+      template <typename T> inline double boxDistance2( const T& b, const Vector3D& p ) {
+        double d2 = 0. ;
+        for( unsigned a=0 ; a<3 ; ++a ){
+          double d = 0. ;
+          if( p[a] < b.lower[a] )      d = b.lower[a] - p[a] ;
+          else if( p[a] > b.upper[a] ) d = p[a] - b.upper[a] ;
+          d2 += d * d ;
+        }
+        return d2 ;
+      }
+
+      /// Slab test of the line o + t*d against a box, clipping [t0,t1]
+      template <typename T> inline bool boxClip( const T& b, const Vector3D& o, const double invD[3], double& t0, double& t1 ) {
+        for( unsigned a=0 ; a<3 ; ++a ){
+          double tl = ( b.lower[a] - o[a] ) * invD[a] ;
+          double th = ( b.upper[a] - o[a] ) * invD[a] ;
+          if( tl > th ) std::swap( tl, th ) ;
+          if( tl > t0 ) t0 = tl ;
+          if( th < t1 ) t1 = th ;
+          if( t0 > t1 ) return false ;
+        }
+        return true ;
+      }
+
+      /// Compare surface entries along one axis by the center of their bounding boxes
+      template <typename T> struct CenterLess {
+        unsigned axis ;
+        CenterLess( unsigned a ) : axis( a ) {}
+        bool operator()( const T& l, const T& r ) const {
+          return ( l.lower[axis] + l.upper[axis] ) < ( r.lower[axis] + r.upper[axis] ) ;
+        }
+      } ;
+
+      /// Sort intersections by path length
+      struct PathLess {
+        bool operator()( const SurfaceIndex::Intersection& l, const SurfaceIndex::Intersection& r ) const {
+          return l.pathLength < r.pathLength ;
+        }
+      } ;
+    }
+
+    SurfaceIndex::SurfaceIndex( const std::vector<ISurface*>& surfaces ) {
+
+      _entries.reserve( surfaces.size() ) ;
+
+      for( unsigned i=0,n=surfaces.size() ; i<n ; ++i ){
+
+        const ISurface* surf = surfaces[i] ;
+        Vector3D lo, hi ;
+
+        const Surface* s = dynamic_cast<const Surface*>( surf ) ;
+
+        if( s ) {
+          s->globalBoundingBox( lo, hi ) ;
+        } else {
+          double r = 0.5 * std::sqrt( surf->length_along_u() * surf->length_along_u() +
+                                      surf->length_along_v() * surf->length_along_v() ) ;
+          r += std::max( surf->innerThickness(), surf->outerThickness() ) ;
+          lo = surf->origin() - Vector3D( r, r, r ) ;
+          hi = surf->origin() + Vector3D( r, r, r ) ;
+        }
+        Entry e ;
+        for( unsigned a=0 ; a<3 ; ++a ){
+          e.lower[a] = lo[a] ;
+          e.upper[a] = hi[a] ;
+        }
+        e.surface = surf ;
+        _entries.push_back( e ) ;
+      }
+
+      if( !_entries.empty() ) {
+        _nodes.reserve( 2 * _entries.size() / LEAF_SIZE + 1 ) ;
+        build( 0, _entries.size() ) ;
+      }
+    }
+
+    SurfaceIndex::~SurfaceIndex(){
+    }
+
+    unsigned SurfaceIndex::build( unsigned begin, unsigned end ) {
+
+      unsigned idx = _nodes.size() ;
+      _nodes.push_back( Node() ) ;
+
+      Node node ;
+      double clo[3], chi[3] ;
+      for( unsigned a=0 ; a<3 ; ++a ){
+        node.lower[a] =  std::numeric_limits<double>::max() ;
+        node.upper[a] = -std::numeric_limits<double>::max() ;
+        clo[a] =  std::numeric_limits<double>::max() ;
+        chi[a] = -std::numeric_limits<double>::max() ;
+      }
+      for( unsigned i=begin ; i<end ; ++i ){
+        const Entry& e = _entries[i] ;
+        for( unsigned a=0 ; a<3 ; ++a ){
+          node.lower[a] = std::min( node.lower[a], e.lower[a] ) ;
+          node.upper[a] = std::max( node.upper[a], e.upper[a] ) ;
+          double c = 0.5 * ( e.lower[a] + e.upper[a] ) ;
+          clo[a] = std::min( clo[a], c ) ;
+          chi[a] = std::max( chi[a], c ) ;
+        }
+      }
+
+      if( end - begin <= LEAF_SIZE ) {
+        node.offset = begin ;
+        node.count  = end - begin ;
+        _nodes[idx] = node ;
+        return idx ;
+      }
+
+      // median split along the axis with the largest spread of the box centers
+      unsigned axis = 0 ;
+      for( unsigned a=1 ; a<3 ; ++a )
+        if( chi[a] - clo[a] > chi[axis] - clo[axis] ) axis = a ;
+
+      unsigned mid = ( begin + end ) / 2 ;
+      std::nth_element( _entries.begin() + begin, _entries.begin() + mid, _entries.begin() + end, CenterLess<Entry>( axis ) ) ;
+
+      build( begin, mid ) ;
+      node.offset = build( mid, end ) ;
+      node.count  = 0 ;
+      _nodes[idx] = node ;
+      return idx ;
+    }
+
+    bool SurfaceIndex::accept( const ISurface* surf, const Vector3D& point, double maxDistance, double& dist ) const {
+
+      double d = surf->distance( point ) ;
+
+      if( std::fabs( d ) >= maxDistance ) return false ;
+
+      Vector3D projected = point - d * surf->normal( point ) ;
+
+      if( !surf->insideBounds( projected ) ) return false ;
+
+      dist = d ;
+      return true ;
+    }
+
+    const ISurface* SurfaceIndex::nearest( const Vector3D& point, double maxDistance, double* dist ) const {
+
+      const ISurface* best = 0 ;
+      double bestDist = maxDistance ;
+
+      if( _nodes.empty() ) return best ;
+
+      NodeStack stack ;
+      stack.push( 0 ) ;
+
+      while( !stack.empty() ) {
+
+        const Node& node = _nodes[ stack.pop() ] ;
+
+        if( boxDistance2( node, point ) >= bestDist * bestDist ) continue ;
+
+        if( node.count > 0 ) {
+          for( unsigned i=node.offset, n=node.offset+node.count ; i<n ; ++i ){
+            const Entry& e = _entries[i] ;
+            if( boxDistance2( e, point ) >= bestDist * bestDist ) continue ;
+            double d ;
+            if( accept( e.surface, point, bestDist, d ) ) {
+              best = e.surface ;
+              bestDist = std::fabs( d ) ;
+            }
+          }
+          continue ;
+        }
+
+        // visit the closer child first
+        unsigned left  = ( &node - &_nodes[0] ) + 1 ;
+        unsigned right = node.offset ;
+        if( boxDistance2( _nodes[left], point ) < boxDistance2( _nodes[right], point ) ) {
+          stack.push( right ) ;
+          stack.push( left ) ;
+        } else {
+          stack.push( left ) ;
+          stack.push( right ) ;
+        }
+      }
+
+      if( best && dist ) *dist = bestDist ;
+      return best ;
+    }
+
+    void SurfaceIndex::surfacesNear( const Vector3D& point, double maxDistance, std::vector<const ISurface*>& result ) const {
+
+      if( _nodes.empty() ) return ;
+
+      const double max2 = maxDistance * maxDistance ;
+
+      NodeStack stack ;
+      stack.push( 0 ) ;
+
+      while( !stack.empty() ) {
+
+        unsigned idx = stack.pop() ;
+        const Node& node = _nodes[ idx ] ;
+
+        if( boxDistance2( node, point ) >= max2 ) continue ;
+
+        if( node.count > 0 ) {
+          for( unsigned i=node.offset, n=node.offset+node.count ; i<n ; ++i ){
+            const Entry& e = _entries[i] ;
+            double d ;
+            if( boxDistance2( e, point ) < max2 && accept( e.surface, point, maxDistance, d ) )
+              result.push_back( e.surface ) ;
+          }
+          continue ;
+        }
+        stack.push( node.offset ) ;
+        stack.push( idx + 1 ) ;
+      }
+    }
+
+    void SurfaceIndex::intersect( const Vector3D& origin, const Vector3D& direction, double maxPathLength,
+                                  std::vector<Intersection>& result ) const {
+
+      if( _nodes.empty() ) return ;
+
+      const Vector3D d = direction.unit() ;
+      double invD[3] ;
+      for( unsigned a=0 ; a<3 ; ++a )
+        invD[a] = ( d[a] != 0. ? 1. / d[a] : std::numeric_limits<double>::max() ) ;
+
+      size_t first = result.size() ;
+
+      NodeStack stack ;
+      stack.push( 0 ) ;
+
+      while( !stack.empty() ) {
+
+        unsigned idx = stack.pop() ;
+        const Node& node = _nodes[ idx ] ;
+
+        double t0 = 0., t1 = maxPathLength ;
+        if( !boxClip( node, origin, invD, t0, t1 ) ) continue ;
+
+        if( node.count > 0 ) {
+          for( unsigned i=node.offset, n=node.offset+node.count ; i<n ; ++i ){
+            const Entry& e = _entries[i] ;
+            double s0 = 0., s1 = maxPathLength ;
+            if( boxClip( e, origin, invD, s0, s1 ) )
+              intersectSurface( e.surface, origin, d, s0, s1, result ) ;
+          }
+          continue ;
+        }
+        stack.push( node.offset ) ;
+        stack.push( idx + 1 ) ;
+      }
+
+      std::sort( result.begin() + first, result.end(), PathLess() ) ;
+    }
+
+    unsigned SurfaceIndex::intersectSurface( const ISurface* surf, const Vector3D& o, const Vector3D& d,
+                                             double t0, double t1, std::vector<Intersection>& result ) const {
+
+      const double eps = 1e-6 ;
+      t0 -= eps ;
+      t1 += eps ;
+
+      std::vector<double> candidates ;
+      const SurfaceType& type = surf->type() ;
+
+      if( type.isPlane() ) {
+
+        // the signed distance is linear along the line
+        double dn = surf->normal() * d ;
+        if( std::fabs( dn ) < std::numeric_limits<double>::epsilon() ) return 0 ;
+        candidates.push_back( - surf->distance( o ) / dn ) ;
+
+      } else if( type.isCylinder() && !type.isCone() && dynamic_cast<const ICylinder*>( surf ) ) {
+
+        const ICylinder* cyl = dynamic_cast<const ICylinder*>( surf ) ;
+        Vector3D c    = cyl->center() ;
+        Vector3D axis = surf->v( surf->origin() ).unit() ;
+        double   r    = cyl->radius() ;
+
+        // components perpendicular to the cylinder axis
+        Vector3D oc  = o - c ;
+        Vector3D op  = oc - ( oc * axis ) * axis ;
+        Vector3D dp  = d  - ( d  * axis ) * axis ;
+
+        double A = dp * dp ;
+        double B = 2. * ( op * dp ) ;
+        double C = op * op - r * r ;
+        double D = B * B - 4. * A * C ;
+
+        if( A < std::numeric_limits<double>::epsilon() || D < 0. ) return 0 ;
+
+        double sq = std::sqrt( D ) ;
+        candidates.push_back( ( -B - sq ) / ( 2. * A ) ) ;
+        candidates.push_back( ( -B + sq ) / ( 2. * A ) ) ;
+
+      } else {
+
+        // generic surface: bracket every sign change of the signed distance and bisect it.
+        // All intervals are scanned, so an earlier crossing is not hidden by a later one.
+        const unsigned nSteps = 8 ;
+        double ta = t0 ;
+        double fa = surf->distance( o + ta * d ) ;
+        for( unsigned i=1 ; i<=nSteps ; ++i ){
+          double tb = t0 + ( t1 - t0 ) * i / nSteps ;
+          double fb = surf->distance( o + tb * d ) ;
+          if( fa == 0. ) {
+            candidates.push_back( ta ) ;
+          } else if( ( fa < 0. && fb > 0. ) || ( fa > 0. && fb < 0. ) ) {
+            double lo = ta, hi = tb, flo = fa ;
+            for( unsigned it=0 ; it<50 && hi - lo > eps ; ++it ){
+              double tm = 0.5 * ( lo + hi ) ;
+              double fm = surf->distance( o + tm * d ) ;
+              if( ( flo <= 0. && fm <= 0. ) || ( flo >= 0. && fm >= 0. ) ) { lo = tm ; flo = fm ; }
+              else hi = tm ;
+            }
+            candidates.push_back( 0.5 * ( lo + hi ) ) ;
+          }
+          ta = tb ;
+          fa = fb ;
+        }
+        if( fa == 0. )
+          candidates.push_back( ta ) ;
+      }
+
+      unsigned nHits = 0 ;
+      for( unsigned i=0,n=candidates.size() ; i<n ; ++i ){
+        double t = candidates[i] ;
+        if( t < t0 || t > t1 || t < 0. ) continue ;
+        Vector3D p = o + t * d ;
+        if( surf->insideBounds( p ) ) {
+          Intersection hit ;
+          hit.surface    = surf ;
+          hit.pathLength = t ;
+          hit.point      = p ;
+          result.push_back( hit ) ;
+          ++nHits ;
+        }
+      }
+      return nHits ;
+    }
+
+  } /* namespace rec */
+} /* namespace dd4hep */
@@ -40,6 +40,28 @@ namespace dd4hep {
       return 0 ;
     }
 
+    const SurfaceIndex* SurfaceManager::index( const std::string name ) const {
+
+      std::lock_guard<std::mutex> lock( _indexLock ) ;
+
+      SurfaceIndexMap::const_iterator it = _index.find( name ) ;
+
+      if( it != _index.end() ){
+
+	return & it->second ;
+      }
+
+      // build the spatial index on first use only - most clients never query most maps
+      SurfaceMapsMap::const_iterator mi = _map.find( name ) ;
+
+      if( mi != _map.end() ){
+
+	return & _index.insert( std::make_pair( name , SurfaceIndex::fromMap( mi->second ) ) ).first->second ;
+      }
+
+      return 0 ;
+    }
+
     void SurfaceManager::initialize(Detector& description) {
       
       const std::vector<std::string>& types = description.detectorTypes() ;
@@ -0,0 +1,143 @@
+/*
+   Plugin invocation:
+   ==================
+
+   Compare the cached and the uncached cellID -> position conversion for the sensitive volumes
+   of all subdetectors:
+
+   geoPluginRun -volmgr -destroy -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_CellIDPositionConverterCacheTest -points 5
+
+*/
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/VolumeManager.h"
+#include "DD4hep/detail/VolumeManagerInterna.h"
+
+#include "DDRec/CellIDPositionConverter.h"
+
+#include "TGeoBBox.h"
+#include "TGeoMatrix.h"
+#include "TRandom3.h"
+
+#include <set>
+#include <map>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+
+namespace dd4hep{
+  namespace rec{
+
+    namespace {
+
+      /// Collect the sensitive volumes of a volume manager and all its sub-managers
+      void collectVolumes( const detail::VolumeManagerObject* o, std::map<VolumeID,VolumeManagerContext*>& volumes ){
+        volumes.insert( o->volumes.begin(), o->volumes.end() ) ;
+        for( const auto& m : o->managers )
+          collectVolumes( m.second.ptr(), volumes ) ;
+      }
+    }
+
+    /**
+    \addtogroup SurfacePlugin
+    @{
+    \package CellIDPositionConverterCacheTest
+
+    *  \brief Plugin comparing the cached against the uncached CellIDPositionConverter.
+    *
+    *  Random points in the bounding boxes of the sensitive volumes of every subdetector are
+    *  converted to cellIDs with the segmentation of the subdetector's readout. The nominal
+    *  positions of these cells must agree with and without enableCaching(). This requires
+    *  that the cached readout of every subdetector is its own readout.
+    @}
+    *
+    *  @version $Id: $
+    */
+    static long testCellIDPositionConverterCache(Detector& description, int argc, char** argv) {
+
+      long   num_points = 5 ;
+      double tolerance  = 1e-9 ;
+      bool   arg_error  = false ;
+
+      for(int i=0; i<argc && argv[i]; ++i)  {
+        if ( 0 == ::strncmp("-points",argv[i],4) && i+1 < argc )
+          num_points = ::atol(argv[++i]) ;
+        else if ( 0 == ::strncmp("-tolerance",argv[i],4) && i+1 < argc )
+          tolerance = ::atof(argv[++i]) ;
+        else
+          arg_error = true ;
+      }
+      if ( arg_error || num_points <= 0 || tolerance < 0. )   {
+        std::cout <<
+          "Usage: -plugin DD4hep_CellIDPositionConverterCacheTest -arg [-arg]            \n"
+          "     -points    <number>      Random points per sensitive volume [5]          \n"
+          "     -tolerance <number>      Accepted position difference in cm [1e-9]       \n"
+          "\tArguments given: " << arguments(argc,argv) << std::endl << std::flush ;
+        ::exit(EINVAL) ;
+      }
+
+      VolumeManager volmgr = VolumeManager::getVolumeManager( description ) ;
+      std::vector<CellID> cells ;
+      std::set<std::string> readouts ;
+      TRandom3 rndm( 12345 ) ;
+
+      for( const auto& m : volmgr.ptr()->managers ) {
+        DetElement        det = m.second.detector() ;
+        SensitiveDetector sd  = description.sensitiveDetector( det.name() ) ;
+        if ( !sd.isValid() || !sd.readout().isValid() || !sd.readout().segmentation().isValid() )
+          continue ;
+        Segmentation seg = sd.readout().segmentation() ;
+        std::map<VolumeID,VolumeManagerContext*> volumes ;
+        collectVolumes( m.second.ptr(), volumes ) ;
+        size_t num_cells = cells.size() ;
+        for( const auto& v : volumes ) {
+          PlacedVolume pv  = volmgr.lookupVolumePlacement( v.first ) ;
+          TGeoBBox*    box = dynamic_cast<TGeoBBox*>( pv.volume()->GetShape() ) ;
+          if ( !box ) continue ;
+          TGeoHMatrix toWorld( v.second->element.nominal().worldTransformation() ) ;
+          toWorld.Multiply( &v.second->toElement() ) ;
+          const Double_t* o = box->GetOrigin() ;
+          for( long k=0; k<num_points; ++k ) {
+            Double_t l[3] = { o[0] + 0.99*box->GetDX()*rndm.Uniform(-1.,1.),
+                              o[1] + 0.99*box->GetDY()*rndm.Uniform(-1.,1.),
+                              o[2] + 0.99*box->GetDZ()*rndm.Uniform(-1.,1.) }, g[3] ;
+            toWorld.LocalToMaster( l, g ) ;
+            cells.push_back( seg.cellID( Position(l[0],l[1],l[2]), Position(g[0],g[1],g[2]), v.first ) ) ;
+          }
+        }
+        if ( cells.size() > num_cells ) readouts.insert( sd.readout().name() ) ;
+      }
+      if ( readouts.size() < 2 ) {
+        except("CellIDPositionConverter","+++ The cache test requires at least two subdetectors with "
+               "different readouts. Found %ld.", long(readouts.size()) ) ;
+      }
+
+      CellIDPositionConverter uncached( description ) ;
+      CellIDPositionConverter cached( description ) ;
+      cached.enableCaching() ;
+
+      std::vector<Position> expected = uncached.positions( cells ) ;
+      std::vector<Position> result   = cached.positions( cells ) ;
+      size_t num_bad = 0 ;
+      for( size_t i=0; i<cells.size(); ++i ) {
+        if ( (expected[i] - result[i]).R() > tolerance ) {
+          if ( ++num_bad <= 10 )
+            printout(ERROR,"CellIDPositionConverter","+++ cellID 0x%016llX: uncached (%g,%g,%g) cached (%g,%g,%g)",
+                     (unsigned long long)cells[i], expected[i].X(), expected[i].Y(), expected[i].Z(),
+                     result[i].X(), result[i].Y(), result[i].Z() ) ;
+        }
+      }
+      if ( num_bad > 0 ) {
+        except("CellIDPositionConverter","+++ FAILED: %ld of %ld cached positions differ.",
+               long(num_bad), long(cells.size()) ) ;
+      }
+      printout(ALWAYS,"CellIDPositionConverter","+++ Cached positions of %ld cells in %ld readouts identical.",
+               long(cells.size()), long(readouts.size()) ) ;
+      return 1 ;
+    }
+  }
+}
+DECLARE_APPLY( DD4hep_CellIDPositionConverterCacheTest, dd4hep::rec::testCellIDPositionConverterCache )
@@ -0,0 +1,219 @@
+/*
+   Plugin invocation:
+   ==================
+
+   Build the cell neighbour table of a readout once and store it to a file:
+
+   geoPluginRun -volmgr -input file:${DD4hep_DIR}/examples/ClientTests/compact/NeighbourCalorimeter.xml \
+   -plugin DD4hep_CreateCellNeighbourTable -readout CalorimeterHits -distance 1.01 -output neighbours.bin
+
+   Compare the table against the on-the-fly neighbour search of the segmentation:
+
+   geoPluginRun -volmgr -input file:${DD4hep_DIR}/examples/ClientTests/compact/NeighbourCalorimeter.xml \
+   -plugin DD4hep_CellNeighbourTableBenchmark -readout CalorimeterHits -distance 1.01
+
+*/
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/Readout.h"
+
+#include "DDRec/CellNeighbourTable.h"
+
+#include "TTimeStamp.h"
+
+#include <set>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <unistd.h>
+
+namespace dd4hep{
+  namespace rec{
+
+    namespace {
+
+      /// Parse table construction arguments shared by both plugins
+      bool tableArgs( int argc, char** argv, int& i, std::string& readout, double& distance, long& max_cells ){
+        if ( 0 == ::strncmp("-readout",argv[i],4) && i+1 < argc )
+          readout = argv[++i] ;
+        else if ( 0 == ::strncmp("-distance",argv[i],4) && i+1 < argc )
+          distance = ::atof(argv[++i]) ;
+        else if ( 0 == ::strncmp("-maxcells",argv[i],4) && i+1 < argc )
+          max_cells = ::atol(argv[++i]) ;
+        else
+          return false ;
+        return true ;
+      }
+    }
+
+    /**
+    \addtogroup SurfacePlugin
+    @{
+    \package CellNeighbourTable
+
+    *  \brief Plugin that builds the CellNeighbourTable of a readout and writes it to a binary file.
+    *
+    @}
+    *
+    *  @version $Id: $
+    */
+    static long createCellNeighbourTable(Detector& description, int argc, char** argv) {
+
+      std::string readout, output ;
+      double distance = 0. ;
+      long   max_cells = 1000000 ;
+      bool   arg_error = false ;
+
+      for(int i=0; i<argc && argv[i]; ++i)  {
+        if ( tableArgs( argc, argv, i, readout, distance, max_cells ) )
+          continue ;
+        else if ( 0 == ::strncmp("-output",argv[i],4) && i+1 < argc )
+          output = argv[++i] ;
+        else
+          arg_error = true ;
+      }
+      if ( arg_error || readout.empty() || output.empty() || max_cells <= 0 )   {
+        std::cout <<
+          "Usage: -plugin DD4hep_CreateCellNeighbourTable -arg [-arg]                    \n"
+          "     -readout  <string>       Readout name of the sensitive volumes           \n"
+          "     -output   <string>       Output file of the neighbour table              \n"
+          "     -distance <number>       Maximal distance of cross-boundary neighbours [0]\n"
+          "     -maxcells <number>       Maximal number of cells per volume [1000000]    \n"
+          "\tArguments given: " << arguments(argc,argv) << std::endl << std::flush ;
+        ::exit(EINVAL) ;
+      }
+
+      CellNeighbourTable table ;
+
+      TTimeStamp start ;
+      table.build( description, readout, distance, max_cells ) ;
+      TTimeStamp stop ;
+      table.writeFile( output ) ;
+
+      printout(INFO,"CellNeighbourTable","+++ Built neighbour table of %ld cells with %ld neighbours in %.2f sec -> %s",
+               long(table.numCells()), long(table.numNeighbours()), stop.AsDouble()-start.AsDouble(), output.c_str() ) ;
+      return 1 ;
+    }
+
+    /**
+    \addtogroup SurfacePlugin
+    @{
+    \package CellNeighbourTableBenchmark
+
+    *  \brief Plugin comparing the CellNeighbourTable against Segmentation::neighbours.
+    *
+    *  The neighbours of every cell of the table are computed with the segmentation into a std::set
+    *  and taken from the table. All segmentation neighbours which are cells of the table must be
+    *  contained in the table and every relation of the table must be symmetric.
+    *  The table is written to a temporary file and read back, which must reproduce it.
+    @}
+    *
+    *  @version $Id: $
+    */
+    static long benchmarkCellNeighbourTable(Detector& description, int argc, char** argv) {
+
+      std::string readout, input ;
+      double distance = 0. ;
+      long   max_cells = 1000000 ;
+      bool   arg_error = false ;
+
+      for(int i=0; i<argc && argv[i]; ++i)  {
+        if ( tableArgs( argc, argv, i, readout, distance, max_cells ) )
+          continue ;
+        else if ( 0 == ::strncmp("-table",argv[i],4) && i+1 < argc )
+          input = argv[++i] ;
+        else
+          arg_error = true ;
+      }
+      if ( arg_error || readout.empty() || max_cells <= 0 )   {
+        std::cout <<
+          "Usage: -plugin DD4hep_CellNeighbourTableBenchmark -arg [-arg]                 \n"
+          "     -readout  <string>       Readout name of the sensitive volumes           \n"
+          "     -table    <string>       Neighbour table file. If absent it is built     \n"
+          "     -distance <number>       Maximal distance of cross-boundary neighbours [0]\n"
+          "     -maxcells <number>       Maximal number of cells per volume [1000000]    \n"
+          "\tArguments given: " << arguments(argc,argv) << std::endl << std::flush ;
+        ::exit(EINVAL) ;
+      }
+
+      CellNeighbourTable table ;
+      TTimeStamp start_build ;
+      if ( input.empty() )
+        table.build( description, readout, distance, max_cells ) ;
+      else
+        table.readFile( input ) ;
+      TTimeStamp stop_build ;
+
+      const DDSegmentation::Segmentation* seg = description.readout( readout ).segmentation().segmentation() ;
+      const std::vector<CellID>& cells = table.cells() ;
+      size_t num_seg = 0, num_table = 0, num_bad = 0 ;
+
+      // On-the-fly: one std::set per cell as done by the clustering today
+      TTimeStamp start_seg ;
+      for ( CellID cell : cells ) {
+        std::set<CellID> nbs ;
+        if ( seg ) seg->neighbours( cell, nbs ) ;
+        num_seg += nbs.size() ;
+      }
+      TTimeStamp stop_seg ;
+
+      TTimeStamp start_table ;
+      for ( CellID cell : cells ) {
+        CellNeighbourTable::Range nbs = table.neighbours( cell ) ;
+        num_table += nbs.size() ;
+      }
+      TTimeStamp stop_table ;
+
+      // Consistency: segmentation neighbours are contained and relations are symmetric
+      for ( CellID cell : cells ) {
+        std::set<CellID> nbs ;
+        if ( seg ) seg->neighbours( cell, nbs ) ;
+        for ( CellID n : nbs ) {
+          if ( table.contains( n ) && !table.isNeighbour( cell, n ) ) ++num_bad ;
+        }
+        for ( CellID n : table.neighbours( cell ) ) {
+          if ( !table.isNeighbour( n, cell ) ) ++num_bad ;
+        }
+      }
+
+      // Persistency: write and read back
+      char name[] = "/tmp/DD4hep_CellNeighbourTable_XXXXXX" ;
+      int  fd = ::mkstemp( name ) ;
+      if ( fd < 0 )
+        except("CellNeighbourTable","+++ Cannot create temporary file: %s",::strerror(errno)) ;
+      ::close( fd ) ;
+      CellNeighbourTable copy ;
+      table.writeFile( name ) ;
+      copy.readFile( name ) ;
+      ::unlink( name ) ;
+      bool same = copy.cells() == table.cells() && copy.numNeighbours() == table.numNeighbours() ;
+      for ( size_t i=0 ; same && i<cells.size() ; ++i ) {
+        CellNeighbourTable::Range a = table.neighboursAt( i ), b = copy.neighboursAt( i ) ;
+        same = a.size() == b.size() && std::equal( a.begin(), a.end(), b.begin() ) ;
+      }
+
+      double t_build = stop_build.AsDouble() - start_build.AsDouble() ;
+      double t_seg   = stop_seg.AsDouble()   - start_seg.AsDouble() ;
+      double t_table = stop_table.AsDouble() - start_table.AsDouble() ;
+      size_t n = cells.empty() ? 1 : cells.size() ;
+
+      printout(INFO,"CellNeighbourTable","+======= Neighbour table benchmark: readout %s  %ld cells  %ld neighbours  %s in %.3f sec ====",
+               readout.c_str(), long(cells.size()), long(table.numNeighbours()), input.empty() ? "built" : "read", t_build ) ;
+      printout(INFO,"CellNeighbourTable","+  %-14s %10.3f sec  %12.3f usec/query  %8.2f neighbours/cell",
+               "Segmentation:", t_seg, 1e6 * t_seg / n, double(num_seg) / n ) ;
+      printout(INFO,"CellNeighbourTable","+  %-14s %10.3f sec  %12.3f usec/query  %8.2f neighbours/cell   speedup: %8.1f",
+               "Table:", t_table, 1e6 * t_table / n, double(num_table) / n, t_table > 0. ? t_seg / t_table : 0. ) ;
+      if ( cells.empty() || num_bad > 0 || !same ) {
+        except("CellNeighbourTable","+++ FAILED: %ld cells, %ld inconsistent neighbour relations, file copy %s.",
+               long(cells.size()), long(num_bad), same ? "identical" : "DIFFERENT" ) ;
+      }
+      return 1 ;
+    }
+  }
+}
+
+DECLARE_APPLY( DD4hep_CreateCellNeighbourTable,    dd4hep::rec::createCellNeighbourTable )
+DECLARE_APPLY( DD4hep_CellNeighbourTableBenchmark, dd4hep::rec::benchmarkCellNeighbourTable )
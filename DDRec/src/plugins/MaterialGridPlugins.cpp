@@ -0,0 +1,256 @@
+/*
+   Plugin invocation:
+   ==================
+
+   Build the material grid of a geometry once and store it to a file:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_CreateMaterialGrid -output grid.bin -bins 200 200 400
+
+   Compare accuracy and speed of the grid against the full TGeo navigation:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_MaterialGridBenchmark -grid grid.bin -segments 100000 -length 1.0
+
+*/
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+
+#include "DDRec/MaterialGrid.h"
+#include "DDRec/MaterialManager.h"
+
+#include "TGeoBBox.h"
+#include "TStatistic.h"
+#include "TTimeStamp.h"
+#include "TRandom3.h"
+
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+
+namespace dd4hep{
+  namespace rec{
+
+    namespace {
+
+      /// Grid extent: the bounding box of the world volume (unless given)
+      void worldExtent( Detector& description, Vector3D& lower, Vector3D& upper ){
+        TGeoBBox* box = (TGeoBBox*) description.world().volume()->GetShape() ;
+        const double* o = box->GetOrigin() ;
+        lower = Vector3D( o[0] - box->GetDX(), o[1] - box->GetDY(), o[2] - box->GetDZ() ) ;
+        upper = Vector3D( o[0] + box->GetDX(), o[1] + box->GetDY(), o[2] + box->GetDZ() ) ;
+      }
+
+      /// Parse grid construction arguments shared by both plugins
+      bool gridArgs( int argc, char** argv, int& i, Vector3D& lower, Vector3D& upper, unsigned n[3], unsigned& samples ){
+        if ( 0 == ::strncmp("-bins",argv[i],4) && i+3 < argc ) {
+          n[0] = ::atol(argv[++i]) ;  n[1] = ::atol(argv[++i]) ;  n[2] = ::atol(argv[++i]) ;
+        }
+        else if ( 0 == ::strncmp("-lower",argv[i],4) && i+3 < argc ) {
+          lower = Vector3D( ::atof(argv[i+1]), ::atof(argv[i+2]), ::atof(argv[i+3]) ) ;  i += 3 ;
+        }
+        else if ( 0 == ::strncmp("-upper",argv[i],4) && i+3 < argc ) {
+          upper = Vector3D( ::atof(argv[i+1]), ::atof(argv[i+2]), ::atof(argv[i+3]) ) ;  i += 3 ;
+        }
+        else if ( 0 == ::strncmp("-samples",argv[i],4) && i+1 < argc ) {
+          samples = ::atol(argv[++i]) ;
+        }
+        else {
+          return false ;
+        }
+        return true ;
+      }
+    }
+
+    /**
+    \addtogroup SurfacePlugin
+    @{
+    \package MaterialGrid
+
+    *  \brief Plugin that builds a MaterialGrid from the geometry and writes it to a binary file.
+    *
+    @}
+    *
+    *  @version $Id: $
+    */
+    static long createMaterialGrid(Detector& description, int argc, char** argv) {
+
+      std::string output ;
+      Vector3D lower, upper ;
+      unsigned n[3] = { 100, 100, 100 } ;
+      unsigned samples = 2 ;
+      bool arg_error = false ;
+
+      worldExtent( description, lower, upper ) ;
+
+      for(int i=0; i<argc && argv[i]; ++i)  {
+        if ( gridArgs( argc, argv, i, lower, upper, n, samples ) )
+          continue ;
+        else if ( 0 == ::strncmp("-output",argv[i],4) && i+1 < argc )
+          output = argv[++i] ;
+        else
+          arg_error = true ;
+      }
+      if ( arg_error || output.empty() )   {
+        std::cout <<
+          "Usage: -plugin DD4hep_CreateMaterialGrid -arg [-arg]                          \n"
+          "     -output  <string>        Output file of the material grid                \n"
+          "     -bins    <nx> <ny> <nz>  Number of grid cells per axis     [100 100 100] \n"
+          "     -lower   <x> <y> <z>     Lower grid corner                 [world box]   \n"
+          "     -upper   <x> <y> <z>     Upper grid corner                 [world box]   \n"
+          "     -samples <number>        Material samples per cell and axis [2]          \n"
+          "\tArguments given: " << arguments(argc,argv) << std::endl << std::flush ;
+        ::exit(EINVAL) ;
+      }
+
+      MaterialManager matMgr( description.world().volume() ) ;
+      MaterialGrid    grid( lower, upper, n[0], n[1], n[2] ) ;
+
+      TTimeStamp start ;
+      grid.build( matMgr, samples ) ;
+      TTimeStamp stop ;
+      grid.writeFile( output ) ;
+
+      printout(INFO,"MaterialGrid","+++ Built material grid of %ld cells (%u x %u x %u, cell size %.3f x %.3f x %.3f) in %.2f sec -> %s",
+               grid.numCells(), n[0], n[1], n[2], grid.cellSize()[0], grid.cellSize()[1], grid.cellSize()[2],
+               stop.AsDouble()-start.AsDouble(), output.c_str() ) ;
+      return 1 ;
+    }
+
+    /**
+    \addtogroup SurfacePlugin
+    @{
+    \package MaterialGridBenchmark
+
+    *  \brief Plugin comparing accuracy and speed of MaterialGrid queries against MaterialManager.
+    *
+    *  Random straight segments of fixed length are placed inside the grid. For each segment
+    *  the integrated radiation length is computed with the full TGeo navigation
+    *  (MaterialManager::materialsBetween + createAveragedMaterial) and with the material grid.
+    @}
+    *
+    *  @version $Id: $
+    */
+    static long benchmarkMaterialGrid(Detector& description, int argc, char** argv) {
+
+      std::string input ;
+      Vector3D lower, upper ;
+      unsigned n[3] = { 100, 100, 100 } ;
+      unsigned samples = 2 ;
+      long     num_segments = 10000 ;
+      double   length = 1.0 ;
+      bool     arg_error = false ;
+
+      worldExtent( description, lower, upper ) ;
+
+      for(int i=0; i<argc && argv[i]; ++i)  {
+        if ( gridArgs( argc, argv, i, lower, upper, n, samples ) )
+          continue ;
+        else if ( 0 == ::strncmp("-grid",argv[i],4) && i+1 < argc )
+          input = argv[++i] ;
+        else if ( 0 == ::strncmp("-segments",argv[i],4) && i+1 < argc )
+          num_segments = ::atol(argv[++i]) ;
+        else if ( 0 == ::strncmp("-length",argv[i],4) && i+1 < argc )
+          length = ::atof(argv[++i]) ;
+        else
+          arg_error = true ;
+      }
+      if ( arg_error || num_segments <= 0 || length <= 0. )   {
+        std::cout <<
+          "Usage: -plugin DD4hep_MaterialGridBenchmark -arg [-arg]                       \n"
+          "     -grid     <string>       Material grid file. If absent the grid is built \n"
+          "     -bins     <nx> <ny> <nz> Number of grid cells per axis    [100 100 100]  \n"
+          "     -lower    <x> <y> <z>    Lower grid corner                [world box]    \n"
+          "     -upper    <x> <y> <z>    Upper grid corner                [world box]    \n"
+          "     -samples  <number>       Material samples per cell and axis [2]          \n"
+          "     -segments <number>       Number of random segments         [10000]       \n"
+          "     -length   <number>       Segment length                    [1.0]         \n"
+          "\tArguments given: " << arguments(argc,argv) << std::endl << std::flush ;
+        ::exit(EINVAL) ;
+      }
+
+      MaterialManager matMgr( description.world().volume() ) ;
+      MaterialGrid    grid ;
+
+      if ( input.empty() ) {
+        grid.initialize( lower, upper, n[0], n[1], n[2] ) ;
+        grid.build( matMgr, samples ) ;
+      }
+      else {
+        grid.readFile( input ) ;
+      }
+
+      // Generate the segments up-front to not time the random generator.
+      // Segments must lie inside the grid: give up if they hardly ever fit.
+      TRandom3 random ;
+      std::vector<std::pair<Vector3D,Vector3D> > segments ;
+      segments.reserve( num_segments ) ;
+      const Vector3D& lo = grid.lower() ;
+      const Vector3D& hi = grid.upper() ;
+      const long max_attempts = 1000 * num_segments ;
+      if ( length >= ( hi - lo ).r() ) {
+        except("MaterialGrid","+++ Segments of length %g do not fit into the grid [diagonal: %g]",
+               length, ( hi - lo ).r() ) ;
+      }
+      for ( long attempts = 0 ; long(segments.size()) < num_segments ; ++attempts ) {
+        if ( attempts >= max_attempts ) {
+          except("MaterialGrid","+++ Only %ld of %ld random segments of length %g fit into the grid. "
+                 "Use a smaller -length.", long(segments.size()), num_segments, length ) ;
+        }
+        double x, y, z ;
+        random.Sphere( x, y, z, length ) ;
+        Vector3D p0( random.Uniform(lo[0],hi[0]), random.Uniform(lo[1],hi[1]), random.Uniform(lo[2],hi[2]) ) ;
+        Vector3D p1 = p0 + Vector3D( x, y, z ) ;
+        if ( grid.contains( p1 ) )
+          segments.push_back( std::make_pair( p0, p1 ) ) ;
+      }
+
+      std::vector<double> x0_full( segments.size() ), x0_grid( segments.size() ) ;
+
+      TTimeStamp start_full ;
+      for ( size_t i=0 ; i<segments.size() ; ++i ) {
+        const MaterialVec& materials = matMgr.materialsBetween( segments[i].first, segments[i].second ) ;
+        MaterialData avg = matMgr.createAveragedMaterial( materials ) ;
+        x0_full[i] = length / avg.radiationLength() ;
+      }
+      TTimeStamp stop_full ;
+
+      TTimeStamp start_grid ;
+      for ( size_t i=0 ; i<segments.size() ; ++i ) {
+        MaterialData avg = grid.averagedMaterialBetween( segments[i].first, segments[i].second ) ;
+        x0_grid[i] = length / avg.radiationLength() ;
+      }
+      TTimeStamp stop_grid ;
+
+      TStatistic abs_err("AbsErr[X0]"), rel_err("RelErr") ;
+      double max_abs_err = 0. ;
+      for ( size_t i=0 ; i<segments.size() ; ++i ) {
+        double d = std::fabs( x0_grid[i] - x0_full[i] ) ;
+        abs_err.Fill( d ) ;
+        if ( x0_full[i] > 1e-6 ) rel_err.Fill( d / x0_full[i] ) ;
+        if ( d > max_abs_err ) max_abs_err = d ;
+      }
+
+      double t_full = stop_full.AsDouble() - start_full.AsDouble() ;
+      double t_grid = stop_grid.AsDouble() - start_grid.AsDouble() ;
+
+      printout(INFO,"MaterialGrid","+======= Material grid benchmark: %ld segments of length %g  cell size %.3f x %.3f x %.3f ====",
+               long(segments.size()), length, grid.cellSize()[0], grid.cellSize()[1], grid.cellSize()[2] ) ;
+      printout(INFO,"MaterialGrid","+  %-14s %10.3f sec  %12.3f usec/query",
+               "Navigation:", t_full, 1e6 * t_full / segments.size() ) ;
+      printout(INFO,"MaterialGrid","+  %-14s %10.3f sec  %12.3f usec/query   speedup: %8.1f",
+               "MaterialGrid:", t_grid, 1e6 * t_grid / segments.size(), t_grid > 0. ? t_full / t_grid : 0. ) ;
+      printout(INFO,"MaterialGrid","+  %-14s %11.5g +- %11.4g  RMS = %11.5g  max = %11.5g",
+               abs_err.GetName(), abs_err.GetMean(), abs_err.GetMeanErr(), abs_err.GetRMS(), max_abs_err ) ;
+      printout(INFO,"MaterialGrid","+  %-14s %11.5g +- %11.4g  RMS = %11.5g  N = %lld",
+               rel_err.GetName(), rel_err.GetMean(), rel_err.GetMeanErr(), rel_err.GetRMS(), rel_err.GetN() ) ;
+      printout(INFO,"MaterialGrid","+==========================================================================");
+      return 1 ;
+    }
+  }
+}
+
+DECLARE_APPLY( DD4hep_CreateMaterialGrid,    dd4hep::rec::createMaterialGrid )
+DECLARE_APPLY( DD4hep_MaterialGridBenchmark, dd4hep::rec::benchmarkMaterialGrid )
@@ -0,0 +1,220 @@
+/*
+   Plugin invocation:
+   ==================
+
+   Compare the packed surface batch kernels against the ISurface interface:
+
+   geoPluginRun -input file:${DD4hep_DIR}/examples/SimpleDetector/compact/Simple_ILD.xml \
+   -plugin DD4hep_SurfaceBatchBenchmark -map world -points 200 -repeat 10
+
+*/
+#include "DD4hep/Detector.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+
+#include "DDRec/SurfaceBatch.h"
+#include "DDRec/SurfaceManager.h"
+
+#include "TTimeStamp.h"
+#include "TRandom3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+
+namespace dd4hep{
+  namespace rec{
+
+    namespace {
+
+      /// Print one line of the benchmark summary
+      void result( const char* what, size_t calls, double t_virtual, double t_batch ){
+        printout(INFO,"SurfaceBatch","+  %-34s %10ld calls  virtual: %8.4f sec  batch: %8.4f sec  %8.2f Mcalls/sec   speedup: %6.1f",
+                 what, long(calls), t_virtual, t_batch, t_batch > 0. ? 1e-6 * calls / t_batch : 0.,
+                 t_batch > 0. ? t_virtual / t_batch : 0. ) ;
+      }
+
+      /// Compare two numbers within a relative tolerance
+      bool same( double a, double b ){
+        return std::abs( a - b ) <= 1e-9 * ( 1. + std::abs( a ) ) ;
+      }
+    }
+
+    /**
+    \addtogroup SurfacePlugin
+    @{
+    \package SurfaceBatchBenchmark
+
+    *  \brief Plugin comparing results and throughput of the SurfaceBatch kernels against the ISurface interface.
+    *
+    *  For every surface of the map random points close to the surface are generated
+    *  (partly outside the bounds and the distance tolerance). distance(), insideBounds() and
+    *  globalToLocal() are evaluated for many points per surface and for one point and all surfaces,
+    *  through the virtual ISurface interface and with the batch kernels. All results must agree.
+    @}
+    *
+    *  @version $Id: $
+    */
+    static long benchmarkSurfaceBatch(Detector& description, int argc, char** argv) {
+
+      std::string mapName = "world" ;
+      long   num_points = 200 ;
+      long   repeat = 10 ;
+      double epsilon = 1.e-4 ;
+      bool   arg_error = false ;
+
+      for(int i=0; i<argc && argv[i]; ++i)  {
+        if ( 0 == ::strncmp("-map",argv[i],4) && i+1 < argc )
+          mapName = argv[++i] ;
+        else if ( 0 == ::strncmp("-points",argv[i],4) && i+1 < argc )
+          num_points = ::atol(argv[++i]) ;
+        else if ( 0 == ::strncmp("-repeat",argv[i],4) && i+1 < argc )
+          repeat = ::atol(argv[++i]) ;
+        else
+          arg_error = true ;
+      }
+      if ( arg_error || num_points <= 0 || repeat <= 0 )   {
+        std::cout <<
+          "Usage: -plugin DD4hep_SurfaceBatchBenchmark -arg [-arg]                       \n"
+          "     -map     <string>        Name of the surface map               [world]   \n"
+          "     -points  <number>        Random points per surface             [200]     \n"
+          "     -repeat  <number>        Repetitions of each timed loop        [10]      \n"
+          "\tArguments given: " << arguments(argc,argv) << std::endl << std::flush ;
+        ::exit(EINVAL) ;
+      }
+
+      SurfaceManager surfMgr( description ) ;
+      const SurfaceMap* surfMap = surfMgr.map( mapName ) ;
+      if ( !surfMap || surfMap->empty() )
+        except("SurfaceBatch","+++ No surfaces found in the surface map '%s'.",mapName.c_str()) ;
+
+      TTimeStamp start_pack ;
+      SurfaceBatch batch = SurfaceBatch::fromMap( *surfMap ) ;
+      TTimeStamp stop_pack ;
+
+      // Random points around each surface in batch order: x,y,z[i*np+k] is the k-th point of surface(i)
+      const size_t ns = batch.size(), np = num_points ;
+      std::vector<double> x( ns*np ), y( ns*np ), z( ns*np ) ;
+      TRandom3 rndm( 12345 ) ;
+      for ( size_t i=0 ; i<ns ; ++i ) {
+        const ISurface* surf = batch.surface( i ) ;
+        double lu = std::max( 0.6 * surf->length_along_u(), 1. ) ;
+        double lv = std::max( 0.6 * surf->length_along_v(), 1. ) ;
+        for ( size_t k=0 ; k<np ; ++k ) {
+          Vector3D p = surf->localToGlobal( Vector2D( rndm.Uniform( -lu, lu ), rndm.Uniform( -lv, lv ) ) ) ;
+          p = p + rndm.Uniform( -2.*epsilon, 2.*epsilon ) * surf->normal( p ) ;
+          x[i*np+k] = p.x() ;  y[i*np+k] = p.y() ;  z[i*np+k] = p.z() ;
+        }
+      }
+
+      std::vector<double> d_virt( ns*np ), d_batch( ns*np ), u_virt( ns*np ), v_virt( ns*np ), u_batch( ns*np ), v_batch( ns*np ) ;
+      std::vector<unsigned char> in_virt( ns*np ), in_batch( ns*np ) ;
+      size_t num_bad = 0, num_inside = 0 ;
+
+      /// An insideBounds() difference is only accepted for points at the distance tolerance
+      auto inside_ok = [&]( bool a, bool b, double d ){
+        return a == b || std::abs( std::abs( d ) - epsilon ) < 1e-9 ;
+      } ;
+
+      printout(INFO,"SurfaceBatch","+======= Surface batch benchmark: map %s  %ld surfaces: %ld planes  %ld cylinders  %ld generic  packed in %.4f sec ====",
+               mapName.c_str(), long(ns), long(batch.numPlanes()), long(batch.numCylinders()),
+               long(ns - batch.numPlanes() - batch.numCylinders()), stop_pack.AsDouble()-start_pack.AsDouble() ) ;
+
+      //==== many points for one surface ====
+      TTimeStamp t0 ;
+      for ( long r=0 ; r<repeat ; ++r )
+        for ( size_t i=0 ; i<ns ; ++i ) {
+          const ISurface* surf = batch.surface( i ) ;
+          for ( size_t k=i*np ; k<(i+1)*np ; ++k ) d_virt[k] = surf->distance( Vector3D( x[k], y[k], z[k] ) ) ;
+        }
+      TTimeStamp t1 ;
+      for ( long r=0 ; r<repeat ; ++r )
+        for ( size_t i=0 ; i<ns ; ++i )
+          batch.distance( i, np, &x[i*np], &y[i*np], &z[i*np], &d_batch[i*np] ) ;
+      TTimeStamp t2 ;
+      result( "distance     [points x surface]:", repeat*ns*np, t1.AsDouble()-t0.AsDouble(), t2.AsDouble()-t1.AsDouble() ) ;
+
+      t0 = TTimeStamp() ;
+      for ( long r=0 ; r<repeat ; ++r )
+        for ( size_t i=0 ; i<ns ; ++i ) {
+          const ISurface* surf = batch.surface( i ) ;
+          for ( size_t k=i*np ; k<(i+1)*np ; ++k ) in_virt[k] = surf->insideBounds( Vector3D( x[k], y[k], z[k] ), epsilon ) ;
+        }
+      t1 = TTimeStamp() ;
+      for ( long r=0 ; r<repeat ; ++r )
+        for ( size_t i=0 ; i<ns ; ++i )
+          batch.insideBounds( i, np, &x[i*np], &y[i*np], &z[i*np], &in_batch[i*np], epsilon ) ;
+      t2 = TTimeStamp() ;
+      result( "insideBounds [points x surface]:", repeat*ns*np, t1.AsDouble()-t0.AsDouble(), t2.AsDouble()-t1.AsDouble() ) ;
+
+      t0 = TTimeStamp() ;
+      for ( long r=0 ; r<repeat ; ++r )
+        for ( size_t i=0 ; i<ns ; ++i ) {
+          const ISurface* surf = batch.surface( i ) ;
+          for ( size_t k=i*np ; k<(i+1)*np ; ++k ) {
+            Vector2D l = surf->globalToLocal( Vector3D( x[k], y[k], z[k] ) ) ;
+            u_virt[k] = l.u() ;  v_virt[k] = l.v() ;
+          }
+        }
+      t1 = TTimeStamp() ;
+      for ( long r=0 ; r<repeat ; ++r )
+        for ( size_t i=0 ; i<ns ; ++i )
+          batch.globalToLocal( i, np, &x[i*np], &y[i*np], &z[i*np], &u_batch[i*np], &v_batch[i*np] ) ;
+      t2 = TTimeStamp() ;
+      result( "globalToLocal[points x surface]:", repeat*ns*np, t1.AsDouble()-t0.AsDouble(), t2.AsDouble()-t1.AsDouble() ) ;
+
+      for ( size_t k=0 ; k<ns*np ; ++k ) {
+        num_inside += in_virt[k] ;
+        if ( !same( d_virt[k], d_batch[k] ) || !same( u_virt[k], u_batch[k] ) || !same( v_virt[k], v_batch[k] ) ||
+             !inside_ok( in_virt[k], in_batch[k], d_virt[k] ) )
+          ++num_bad ;
+      }
+
+      //==== one point for all surfaces: the first point of every surface against all surfaces ====
+      std::vector<double> dv( ns ), db( ns ), uv( ns ), vv( ns ), ub( ns ), vb( ns ) ;
+      std::vector<unsigned char> iv( ns ), ib( ns ) ;
+      double t_virt[3] = { 0., 0., 0. }, t_batch[3] = { 0., 0., 0. } ;
+      for ( size_t p=0 ; p<ns ; ++p ) {
+        const Vector3D point( x[p*np], y[p*np], z[p*np] ) ;
+        TTimeStamp s0 ;
+        for ( size_t i=0 ; i<ns ; ++i ) dv[i] = batch.surface( i )->distance( point ) ;
+        TTimeStamp s1 ;
+        batch.distance( point, &db[0] ) ;
+        TTimeStamp s2 ;
+        for ( size_t i=0 ; i<ns ; ++i ) iv[i] = batch.surface( i )->insideBounds( point, epsilon ) ;
+        TTimeStamp s3 ;
+        batch.insideBounds( point, &ib[0], epsilon ) ;
+        TTimeStamp s4 ;
+        for ( size_t i=0 ; i<ns ; ++i ) {
+          Vector2D l = batch.surface( i )->globalToLocal( point ) ;
+          uv[i] = l.u() ;  vv[i] = l.v() ;
+        }
+        TTimeStamp s5 ;
+        batch.globalToLocal( point, &ub[0], &vb[0] ) ;
+        TTimeStamp s6 ;
+        t_virt[0]  += s1.AsDouble()-s0.AsDouble() ;  t_batch[0] += s2.AsDouble()-s1.AsDouble() ;
+        t_virt[1]  += s3.AsDouble()-s2.AsDouble() ;  t_batch[1] += s4.AsDouble()-s3.AsDouble() ;
+        t_virt[2]  += s5.AsDouble()-s4.AsDouble() ;  t_batch[2] += s6.AsDouble()-s5.AsDouble() ;
+        for ( size_t i=0 ; i<ns ; ++i ) {
+          if ( !same( dv[i], db[i] ) || !same( uv[i], ub[i] ) || !same( vv[i], vb[i] ) || !inside_ok( iv[i], ib[i], dv[i] ) )
+            ++num_bad ;
+        }
+      }
+      result( "distance     [point x surfaces]:", ns*ns, t_virt[0], t_batch[0] ) ;
+      result( "insideBounds [point x surfaces]:", ns*ns, t_virt[1], t_batch[1] ) ;
+      result( "globalToLocal[point x surfaces]:", ns*ns, t_virt[2], t_batch[2] ) ;
+
+      if ( num_bad > 0 || num_inside == 0 ) {
+        except("SurfaceBatch","+++ FAILED: %ld results of the batch kernels differ from the ISurface interface, %ld of %ld points inside bounds.",
+               long(num_bad), long(num_inside), long(ns*np) ) ;
+      }
+      printout(INFO,"SurfaceBatch","+++ All batch results agree with the ISurface interface [%ld of %ld points inside bounds].",
+               long(num_inside), long(ns*np) ) ;
+      return 1 ;
+    }
+  }
+}
+
+DECLARE_APPLY( DD4hep_SurfaceBatchBenchmark, dd4hep::rec::benchmarkSurfaceBatch )
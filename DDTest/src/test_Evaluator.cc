@@ -0,0 +1,103 @@
+#include "DD4hep/DDTest.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <exception>
+
+#include "DDParsers/Evaluator.h"
+
+static dd4hep::DDTest test( "Evaluator" ) ;
+
+namespace {
+
+  /// One expression together with its expected value
+  struct Check {
+    const char* expression ;
+    double      expected ;
+  };
+
+  /// Results of the concurrent evaluations
+  struct Result {
+    std::atomic<long> evaluations ;
+    std::atomic<long> bad_values ;
+    std::atomic<long> ready ;
+    Result() : evaluations(0), bad_values(0), ready(0) {}
+  };
+
+  /// Body of one thread: evaluate all checks repeatedly while all other threads do the same.
+  /// The variables b, c and d are expressions, which are parsed at every evaluation.
+  void run_evaluations( const XmlTools::Evaluator* eval, const std::vector<Check>* checks,
+                        Result* res, long num_threads, long num_loops ){
+    ++res->ready ;
+    while ( res->ready.load() < num_threads )
+      std::this_thread::yield() ;
+    for( long i=0 ; i<num_loops ; ++i ){
+      for( const Check& c : *checks ){
+        std::pair<int,double> r = eval->evaluate( c.expression ) ;
+        ++res->evaluations ;
+        if ( r.first != XmlTools::Evaluator::OK || std::fabs( r.second - c.expected ) > 1e-9 )
+          ++res->bad_values ;
+      }
+    }
+  }
+
+  /// Run num_threads concurrent threads on the evaluator and check the results
+  void run_threads( const XmlTools::Evaluator& eval, const std::vector<Check>& checks,
+                    long num_threads, long num_loops, const std::string& tag ){
+    Result res ;
+    std::vector<std::thread> threads ;
+    for( long t=0 ; t<num_threads ; ++t )
+      threads.emplace_back( run_evaluations, &eval, &checks, &res, num_threads, num_loops ) ;
+    for( auto& t : threads )
+      t.join() ;
+
+    std::stringstream s ;
+    s << tag << ": " << res.evaluations.load() << " evaluations in " << num_threads << " threads" ;
+    test.log( s.str() ) ;
+    test( res.evaluations.load(), long( num_threads*num_loops*checks.size() ), tag+": number of evaluations" ) ;
+    test( res.bad_values.load(), 0L, tag+": all values correct" ) ;
+  }
+}
+
+//=============================================================================
+
+int main(int argc, char** argv ){
+
+  long num_threads = argc > 1 ? ::atol( argv[1] ) : 16 ;
+  long num_loops   = argc > 2 ? ::atol( argv[2] ) : 2000 ;
+
+  try{
+    XmlTools::Evaluator eval ;
+    eval.setStdMath() ;
+    eval.setVariable( "a", 2. ) ;
+    eval.setVariable( "b", "a*3+1" ) ;
+    eval.setVariable( "c", "b*b-a" ) ;
+    eval.setVariable( "d", "sqrt(c+b)+max(a,b)" ) ;
+
+    const double a = 2., b = a*3+1, c = b*b-a, d = std::sqrt(c+b)+7. ;
+    std::vector<Check> checks = {
+      { "b",             b },
+      { "c",             c },
+      { "d",             d },
+      { "c*b-d",         c*b-d },
+      { "pow(b,2)-c",    b*b-c },
+      { "(c+a)/(b*b)",   1. }
+    } ;
+
+    // Expressions evaluated by the compiled programs
+    run_threads( eval, checks, num_threads, num_loops, "compiled" ) ;
+
+    // Without cache every evaluation goes through the parsing engine
+    eval.setCacheSize( 0 ) ;
+    run_threads( eval, checks, num_threads, num_loops, "uncached" ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() ) ;
+    test.error( "exception occurred" ) ;
+  }
+  return 0;
+}
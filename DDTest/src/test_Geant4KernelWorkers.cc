@@ -0,0 +1,121 @@
+#include "DD4hep/DDTest.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
+
+#include "DD4hep/Detector.h"
+#include "DD4hep/Printout.h"
+#include "DDG4/Geant4Kernel.h"
+
+using dd4hep::sim::Geant4Kernel;
+
+static dd4hep::DDTest test( "Geant4KernelWorkers" ) ;
+
+namespace {
+
+  /// Results of one round of worker threads
+  struct RoundResult {
+    std::atomic<long> created ;
+    std::atomic<long> bad_lookups ;
+    std::atomic<long> bad_removals ;
+    std::atomic<long> errors ;
+    std::atomic<long> ready ;
+    RoundResult() : created(0), bad_lookups(0), bad_removals(0), errors(0), ready(0) {}
+  };
+
+  /// Body of one worker thread: create the worker, look it up repeatedly while all
+  /// other threads do the same, then tear it down again
+  void run_worker( Geant4Kernel* master, RoundResult* res, long num_threads, long num_lookups ){
+    try{
+      unsigned long self = Geant4Kernel::thread_self() ;
+      Geant4Kernel& w = master->worker( self, true ) ;
+      ++res->created ;
+      if ( &w == master || &w.master() != master )
+        ++res->bad_lookups ;
+
+      // Maximize the contention: all threads start the lookups together
+      ++res->ready ;
+      while ( res->ready.load() < num_threads )
+        std::this_thread::yield() ;
+
+      for( long i=0 ; i<num_lookups ; ++i ){
+        if ( &master->worker( self ) != &w )
+          ++res->bad_lookups ;
+        if ( &master->worker( self, true ) != &w )
+          ++res->bad_lookups ;
+      }
+      master->removeWorker( self ) ;
+      try{
+        master->worker( self ) ;
+        ++res->bad_removals ;   // The removed worker may no longer be found
+      }
+      catch( const std::exception& ){
+      }
+    }
+    catch( const std::exception& e ){
+      std::cout << " worker thread: " << e.what() << std::endl ;
+      ++res->errors ;
+    }
+  }
+}
+
+//=============================================================================
+
+int main(int argc, char** argv ){
+
+  long num_rounds  = argc > 1 ? ::atol( argv[1] ) : 10 ;
+  long num_threads = argc > 2 ? ::atol( argv[2] ) : 64 ;
+  long num_lookups = 1000 ;
+
+  try{
+    dd4hep::setPrintLevel( dd4hep::WARNING ) ;
+    Geant4Kernel& master = Geant4Kernel::instance( dd4hep::Detector::getInstance() ) ;
+    master.property( "NumberOfThreads" ).set<int>( num_threads ) ;
+
+    for( long r=0 ; r<num_rounds ; ++r ){
+      RoundResult res ;
+      std::vector<std::thread> threads ;
+      threads.reserve( num_threads ) ;
+      for( long t=0 ; t<num_threads ; ++t )
+        threads.push_back( std::thread( run_worker, &master, &res, num_threads, num_lookups ) ) ;
+      for( std::thread& t : threads )
+        t.join() ;
+
+      std::stringstream s ;
+      s << " round " << r << ": " ;
+      test( res.errors.load() , 0L , s.str() + "no exceptions in the worker threads" ) ;
+      test( res.created.load() , num_threads , s.str() + "one worker created per thread" ) ;
+      test( res.bad_lookups.load() , 0L , s.str() + "every lookup returns the worker of the calling thread" ) ;
+      test( res.bad_removals.load() , 0L , s.str() + "removed workers are no longer accessible" ) ;
+      test( master.numWorkers() , 0 , s.str() + "all workers torn down" ) ;
+    }
+
+    // The main thread may own a worker as well
+    Geant4Kernel& w = master.createWorker() ;
+    test( &master.worker( Geant4Kernel::thread_self() ) == &w , " worker of the main thread is found" ) ;
+    bool duplicate_rejected = false ;
+    try{
+      master.createWorker() ;
+    }
+    catch( const std::exception& ){
+      duplicate_rejected = true ;
+    }
+    test( duplicate_rejected , " a second worker for the same thread is rejected" ) ;
+    master.removeWorker( Geant4Kernel::thread_self() ) ;
+    test( master.numWorkers() , 0 , " worker of the main thread torn down" ) ;
+
+    delete &master ;
+
+  } catch( std::exception &e ){
+
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+  return 0;
+}
+
+//=============================================================================
@@ -0,0 +1,98 @@
+#include "DD4hep/DDTest.h"
+
+#include <iostream>
+#include <sstream>
+#include <exception>
+#include <cstdio>
+
+#include "DD4hep/Volumes.h"
+
+#include "TFile.h"
+
+using namespace dd4hep ;
+
+static DDTest test( "PlacedVolumeStreamer" ) ;
+
+namespace {
+
+  /// Compare the IDs of an extension against the expected IDs. Accesses only the compact codes.
+  void check_ids( const PlacedVolumeExtension& ext, const PlacedVolumeExtension::VolIDs& expected,
+                  const std::string& tag ){
+    test( ext.codes.size(), expected.size(), tag+": number of volume IDs" ) ;
+    for( size_t i=0 ; i<expected.size() && i<ext.codes.size() ; ++i ){
+      test( PlacedVolumeExtension::fieldName( ext.codes[i].first ), expected[i].first, tag+": field name" ) ;
+      test( ext.codes[i].second, expected[i].second, tag+": field value" ) ;
+    }
+    test( ext.view.load() == nullptr, true, tag+": no string view created" ) ;
+  }
+
+  /// Read the extension stored under the key "placement"
+  PlacedVolumeExtension* read_extension( const std::string& file_name, const std::string& tag ){
+    TFile* f = TFile::Open( file_name.c_str(), "READ" ) ;
+    PlacedVolumeExtension* ext = 0 ;
+    if ( f && !f->IsZombie() )
+      ext = (PlacedVolumeExtension*)f->GetObjectChecked( "placement", PlacedVolumeExtension::Class() ) ;
+    test( ext != nullptr, true, tag+": object read from "+file_name ) ;
+    delete f ;
+    return ext ;
+  }
+}
+
+//=============================================================================
+
+int main(int argc, char** argv ){
+
+  // Reference file written by a release with class version 1 (DDTest/scripts/writePlacedVolumeV1.C)
+  std::string v1_file   = argc > 1 ? argv[1] : "" ;
+  std::string file_name = "test_PlacedVolumeStreamer.root" ;
+
+  try{
+    // Must match the IDs written by writePlacedVolumeV1.C
+    PlacedVolumeExtension::VolIDs volids ;
+    volids.insert( "system", 5 ) ;
+    volids.insert( "side",  -1 ) ;
+    volids.insert( "layer", 17 ) ;
+    volids.insert( "module", 0x7fff ) ;
+
+    PlacedVolumeExtension current ;
+    for( const auto& i : volids ) current.addID( i.first, i.second ) ;
+    PlacedVolumeExtension* source = &current ;
+
+    // ----- read the version 1 reference file
+    PlacedVolumeExtension* v1 = 0 ;
+    if ( !v1_file.empty() ){
+      v1 = read_extension( v1_file, "version 1" ) ;
+      if ( v1 ){
+        check_ids( *v1, volids, "version 1" ) ;
+        source = v1 ;
+      }
+    } else {
+      test.log( "No version 1 reference file given: only the current version is checked." ) ;
+    }
+
+    // ----- write as the current version and read it back
+    TFile* f = TFile::Open( file_name.c_str(), "RECREATE" ) ;
+    if ( !f || f->IsZombie() ){
+      test.error( "cannot create file "+file_name ) ;
+      return 0 ;
+    }
+    f->WriteObjectAny( source, PlacedVolumeExtension::Class(), "placement" ) ;
+    f->Close() ;
+    delete f ;
+    test( source->view.load() == nullptr, true, "version 2: writing creates no string view" ) ;
+
+    PlacedVolumeExtension* v2 = read_extension( file_name, "version 2" ) ;
+    if ( v2 ){
+      check_ids( *v2, volids, "version 2" ) ;
+      test( v2->ids().str(), volids.str(), "version 2: string view" ) ;
+      delete v2 ;
+    }
+    delete v1 ;
+    std::remove( file_name.c_str() ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() ) ;
+    test.error( "exception occurred" ) ;
+  }
+  return 0;
+}
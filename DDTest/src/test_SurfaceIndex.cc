@@ -0,0 +1,266 @@
+#include "DD4hep/DDTest.h"
+
+#include "DDRec/SurfaceIndex.h"
+
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <random>
+#include <memory>
+#include <vector>
+#include <cmath>
+
+using namespace dd4hep ;
+using namespace dd4hep::rec ;
+
+static DDTest test( "SurfaceIndex" ) ;
+
+namespace {
+
+  /// Material of the test surfaces
+  class TestMaterial : public IMaterial {
+  public:
+    std::string name() const { return "vacuum" ; }
+    double A() const { return 0. ; }
+    double Z() const { return 0. ; }
+    double density() const { return 0. ; }
+    double radiationLength() const { return 0. ; }
+    double interactionLength() const { return 0. ; }
+  } ;
+  TestMaterial s_material ;
+
+  /// Common part of the test surfaces: origin, extent and materials
+  class TestSurface : public ISurface {
+  protected:
+    SurfaceType _type ;
+    long64      _id ;
+    Vector3D    _o ;
+    double      _lu, _lv ;
+  public:
+    TestSurface( const SurfaceType& t, long64 i, const Vector3D& o, double lu, double lv )
+      : _type( t ), _id( i ), _o( o ), _lu( lu ), _lv( lv ) {}
+    const SurfaceType& type() const { return _type ; }
+    long64 id() const { return _id ; }
+    Vector2D globalToLocal( const Vector3D& ) const { return Vector2D() ; }
+    Vector3D localToGlobal( const Vector2D& ) const { return _o ; }
+    const Vector3D& origin() const { return _o ; }
+    const IMaterial& innerMaterial() const { return s_material ; }
+    const IMaterial& outerMaterial() const { return s_material ; }
+    double innerThickness() const { return 0.01 ; }
+    double outerThickness() const { return 0.01 ; }
+    double length_along_u() const { return _lu ; }
+    double length_along_v() const { return _lv ; }
+    /// Analytic intersections of the line o + t*d (unit d) with the unbounded surface
+    virtual std::vector<double> roots( const Vector3D& o, const Vector3D& d ) const = 0 ;
+  } ;
+
+  /// Square patch with half size h
+  class TestPlane : public TestSurface {
+    Vector3D _u, _v, _n ;
+    double   _h ;
+  public:
+    TestPlane( long64 i, const Vector3D& o, const Vector3D& n, double h )
+      : TestSurface( SurfaceType( SurfaceType::Plane ), i, o, 2.*h, 2.*h ), _n( n.unit() ), _h( h ) {
+      Vector3D a = std::fabs( _n.x() ) < 0.9 ? Vector3D( 1., 0., 0. ) : Vector3D( 0., 1., 0. ) ;
+      _u = _n.cross( a ).unit() ;
+      _v = _n.cross( _u ) ;
+    }
+    Vector3D u( const Vector3D& ) const { return _u ; }
+    Vector3D v( const Vector3D& ) const { return _v ; }
+    Vector3D normal( const Vector3D& ) const { return _n ; }
+    double distance( const Vector3D& p ) const { return ( p - _o ) * _n ; }
+    bool insideBounds( const Vector3D& p, double eps ) const {
+      return std::fabs( distance( p ) ) < eps && std::fabs( ( p - _o ) * _u ) < _h && std::fabs( ( p - _o ) * _v ) < _h ;
+    }
+    std::vector<double> roots( const Vector3D& o, const Vector3D& d ) const {
+      std::vector<double> r ;
+      if( std::fabs( d * _n ) > 1e-12 ) r.push_back( - distance( o ) / ( d * _n ) ) ;
+      return r ;
+    }
+  } ;
+
+  /// Roots of |o + t*d - c|^2 = R^2 with the components along the axis removed (axis 0: sphere)
+  std::vector<double> radialRoots( const Vector3D& o, const Vector3D& d, const Vector3D& c, const Vector3D* axis, double R ) {
+    Vector3D oc = o - c, dp = d ;
+    if( axis ) {
+      oc = oc - ( oc * *axis ) * *axis ;
+      dp = dp - ( dp * *axis ) * *axis ;
+    }
+    std::vector<double> r ;
+    double A = dp * dp, B = 2. * ( oc * dp ), C = oc * oc - R * R, D = B * B - 4. * A * C ;
+    if( A > 1e-12 && D >= 0. ) {
+      r.push_back( ( -B - std::sqrt( D ) ) / ( 2. * A ) ) ;
+      r.push_back( ( -B + std::sqrt( D ) ) / ( 2. * A ) ) ;
+    }
+    return r ;
+  }
+
+  /// Cylinder along z with radius R and half length h around its center (the origin)
+  class TestCylinder : public TestSurface, public ICylinder {
+    double _r, _h ;
+    Vector3D radial( const Vector3D& p ) const { return Vector3D( p.x() - _o.x(), p.y() - _o.y(), 0. ) ; }
+  public:
+    TestCylinder( long64 i, const Vector3D& c, double R, double h )
+      : TestSurface( SurfaceType( SurfaceType::Cylinder ), i, c, 2.*R, 2.*h ), _r( R ), _h( h ) {}
+    double radius() const { return _r ; }
+    Vector3D center() const { return _o ; }
+    Vector3D u( const Vector3D& p ) const { return Vector3D( 0., 0., 1. ).cross( normal( p ) ) ; }
+    Vector3D v( const Vector3D& ) const { return Vector3D( 0., 0., 1. ) ; }
+    Vector3D normal( const Vector3D& p ) const { return radial( p ).unit() ; }
+    double distance( const Vector3D& p ) const { return radial( p ).r() - _r ; }
+    bool insideBounds( const Vector3D& p, double eps ) const {
+      return std::fabs( distance( p ) ) < eps && std::fabs( p.z() - _o.z() ) < _h ;
+    }
+    std::vector<double> roots( const Vector3D& o, const Vector3D& d ) const {
+      Vector3D axis( 0., 0., 1. ) ;
+      return radialRoots( o, d, _o, &axis, _r ) ;
+    }
+  } ;
+
+  /// Sphere: neither plane nor cylinder, hence intersected by bisection in the index
+  class TestSphere : public TestSurface {
+    double _r ;
+  public:
+    TestSphere( long64 i, const Vector3D& c, double R )
+      : TestSurface( SurfaceType(), i, c, 2.*R, 2.*R ), _r( R ) {}
+    Vector3D u( const Vector3D& p ) const { return Vector3D( 0., 0., 1. ).cross( normal( p ) ) ; }
+    Vector3D v( const Vector3D& p ) const { return normal( p ).cross( u( p ) ) ; }
+    Vector3D normal( const Vector3D& p ) const { return ( p - _o ).unit() ; }
+    double distance( const Vector3D& p ) const { return ( p - _o ).r() - _r ; }
+    bool insideBounds( const Vector3D& p, double eps ) const { return std::fabs( distance( p ) ) < eps ; }
+    std::vector<double> roots( const Vector3D& o, const Vector3D& d ) const {
+      return radialRoots( o, d, _o, 0, _r ) ;
+    }
+  } ;
+
+  typedef std::vector<std::unique_ptr<TestSurface> > Surfaces ;
+
+  /// Brute force version of the acceptance of nearest() and surfacesNear()
+  bool bruteAccept( const ISurface* s, const Vector3D& p, double maxDistance, double& dist ) {
+    double d = s->distance( p ) ;
+    if( std::fabs( d ) >= maxDistance || !s->insideBounds( p - d * s->normal( p ) ) ) return false ;
+    dist = std::fabs( d ) ;
+    return true ;
+  }
+
+  /// Compare nearest() and surfacesNear() at random points against loops over all surfaces
+  void checkNear( const SurfaceIndex& index, const Surfaces& surfaces, std::mt19937& gen,
+                  long numPoints, double maxDistance, const std::string& tag ) {
+    std::uniform_real_distribution<double> pos( -110., 110. ) ;
+    long badNearest = 0, badNear = 0, found = 0 ;
+    for( long k=0 ; k<numPoints ; ++k ) {
+      Vector3D p( pos( gen ), pos( gen ), pos( gen ) ) ;
+      std::vector<const ISurface*> expected, result ;
+      double best = maxDistance, d ;
+      for( const auto& s : surfaces ) {
+        if( bruteAccept( s.get(), p, maxDistance, d ) ) {
+          expected.push_back( s.get() ) ;
+          best = std::min( best, d ) ;
+        }
+      }
+      double dist = -1. ;
+      const ISurface* n = index.nearest( p, maxDistance, &dist ) ;
+      if( expected.empty() ? n != 0 : ( n == 0 || std::fabs( dist - best ) > 1e-12 ) )
+        ++badNearest ;
+      index.surfacesNear( p, maxDistance, result ) ;
+      std::sort( expected.begin(), expected.end() ) ;
+      std::sort( result.begin(), result.end() ) ;
+      if( result != expected ) ++badNear ;
+      found += expected.size() ;
+    }
+    std::stringstream s ;
+    s << tag << ": " << numPoints << " points within " << maxDistance << " of " << found << " surfaces" ;
+    test.log( s.str() ) ;
+    test( badNearest, 0L, tag+": nearest() agrees with the brute force search" ) ;
+    test( badNear,    0L, tag+": surfacesNear() agrees with the brute force search" ) ;
+  }
+
+  /// Compare intersect() along the given rays against loops over all surfaces
+  void checkIntersect( const SurfaceIndex& index, const Surfaces& surfaces,
+                       const std::vector<std::pair<Vector3D,Vector3D> >& rays, double maxPath,
+                       const std::string& tag ) {
+    long bad = 0, found = 0 ;
+    for( const auto& ray : rays ) {
+      const Vector3D& o = ray.first ;
+      Vector3D d = ray.second.unit() ;
+      std::vector<std::pair<double,const ISurface*> > expected ;
+      for( const auto& s : surfaces ) {
+        for( double t : s->roots( o, d ) )
+          if( t >= 0. && t <= maxPath && s->insideBounds( o + t * d ) )
+            expected.push_back( std::make_pair( t, s.get() ) ) ;
+      }
+      std::sort( expected.begin(), expected.end() ) ;
+      std::vector<SurfaceIndex::Intersection> result ;
+      index.intersect( o, ray.second, maxPath, result ) ;
+      bool same = result.size() == expected.size() ;
+      for( size_t i=0 ; same && i<result.size() ; ++i )
+        same = result[i].surface == expected[i].second && std::fabs( result[i].pathLength - expected[i].first ) < 1e-4 ;
+      if( !same ) ++bad ;
+      found += expected.size() ;
+    }
+    std::stringstream s ;
+    s << tag << ": " << rays.size() << " rays with " << found << " intersections" ;
+    test.log( s.str() ) ;
+    test( bad, 0L, tag+": intersect() agrees with the brute force search" ) ;
+  }
+}
+
+//=============================================================================
+
+int main(int argc, char** argv ){
+
+  long numQueries = argc > 1 ? ::atol( argv[1] ) : 2000 ;
+
+  try{
+    std::mt19937 gen( 4711 ) ;
+    std::uniform_real_distribution<double> pos( -100., 100. ), unit( -1., 1. ) ;
+
+    // ----- planes and cylinders at random: intersected analytically by the index
+    Surfaces surfaces ;
+    std::vector<ISurface*> pointers ;
+    for( long i=0 ; i<400 ; ++i ) {
+      Vector3D o( pos( gen ), pos( gen ), pos( gen ) ) ;
+      if( i % 4 == 0 )
+        surfaces.emplace_back( new TestCylinder( i, o, 2. + 9. * ( unit( gen ) + 1. ), 5. + 12. * ( unit( gen ) + 1. ) ) ) ;
+      else
+        surfaces.emplace_back( new TestPlane( i, o, Vector3D( unit( gen ), unit( gen ), unit( gen ) ), 2. + 4. * ( unit( gen ) + 1. ) ) ) ;
+      pointers.push_back( surfaces.back().get() ) ;
+    }
+    SurfaceIndex index( pointers ) ;
+    test( index.size(), pointers.size(), "planes and cylinders: all surfaces indexed" ) ;
+
+    checkNear( index, surfaces, gen, numQueries, 5.,  "planes and cylinders" ) ;
+    checkNear( index, surfaces, gen, numQueries, 30., "planes and cylinders" ) ;
+
+    std::vector<std::pair<Vector3D,Vector3D> > rays ;
+    for( long i=0 ; i<numQueries ; ++i )
+      rays.push_back( std::make_pair( Vector3D( pos( gen ), pos( gen ), pos( gen ) ),
+                                      Vector3D( unit( gen ), unit( gen ), unit( gen ) ) ) ) ;
+    checkIntersect( index, surfaces, rays, 300., "planes and cylinders" ) ;
+
+    // ----- spheres along the z axis: generic surfaces bisected by the index.
+    // The rays pass close to the centers, so both crossings of every sphere are
+    // further apart than the step of the coarse scan and must both be found.
+    Surfaces spheres ;
+    std::vector<ISurface*> spherePointers ;
+    for( long i=0 ; i<7 ; ++i ) {
+      spheres.emplace_back( new TestSphere( i, Vector3D( 0.2*unit( gen ), 0.2*unit( gen ), -90. + 30. * i ), 9. + unit( gen ) ) ) ;
+      spherePointers.push_back( spheres.back().get() ) ;
+    }
+    SurfaceIndex sphereIndex( spherePointers ) ;
+
+    checkNear( sphereIndex, spheres, gen, numQueries, 40., "spheres" ) ;
+
+    rays.clear() ;
+    for( long i=0 ; i<numQueries ; ++i )
+      rays.push_back( std::make_pair( Vector3D( unit( gen ), unit( gen ), -120. ),
+                                      Vector3D( 0.005*unit( gen ), 0.005*unit( gen ), 1. ) ) ) ;
+    checkIntersect( sphereIndex, spheres, rays, 300., "spheres" ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() ) ;
+    test.error( "exception occurred" ) ;
+  }
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include "DD4hep/DDTest.h"
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+#include "DDSegmentation/BitField64.h"
+#include "DDSegmentation/CartesianGridXY.h"
+#include "DDSegmentation/MultiSegmentation.h"
+
+using namespace std ;
+using namespace dd4hep ;
+using namespace DDSegmentation ;
+
+// this should be the first line in your test
+static DDTest test( "multiSegmentation" ) ;
+
+//=============================================================================
+
+int main(int /* argc */, char** /* argv */ ){
+
+  try{
+
+    // ----- write your tests in here -------------------------------------
+
+    test.log( "test MultiSegmentation lookup" );
+
+    const int num_layers = 40 ;
+    BitField64 bf("system:8,layer:-8,x:16:-16,y:-16") ;
+    MultiSegmentation seg(&bf) ;
+    seg.parameter("key")->setValue("layer") ;
+
+    // one sub-segmentation per block of 4 layers: grid size 1+block
+    for( int k=0 ; k<num_layers/4 ; ++k ){
+      CartesianGridXY* sub = new CartesianGridXY(&bf) ;
+      sub->setGridSizeX( 1.0 + k ) ;
+      sub->setGridSizeY( 1.0 + k ) ;
+      seg.addSubsegmentation( 4*k - num_layers/2, 4*k - num_layers/2 + 3, sub ) ;
+    }
+    seg.setDecoder( &bf ) ;
+
+    vector<CellID> ids ;
+    for( int layer=-num_layers/2 ; layer<num_layers/2 ; ++layer ){
+      for( int x=-5 ; x<5 ; ++x ){
+        bf.reset() ;
+        bf["system"] = 1 ;
+        bf["layer"]  = layer ;
+        bf["x"]      = x ;
+        bf["y"]      = -x ;
+        ids.push_back( bf.getValue() ) ;
+      }
+    }
+
+    bool ok = true ;
+    for( CellID id : ids ){
+      long layer = bf["layer"].value( id ) ;
+      double size = 1.0 + (layer + num_layers/2)/4 ;
+      Vector3D pos = seg.position( id ) ;
+      ok = ok && fabs( pos.X - size*bf["x"].value(id) ) < 1e-9 && fabs( pos.Y - size*bf["y"].value(id) ) < 1e-9 ;
+      ok = ok && fabs( seg.cellDimensions( id )[0] - size ) < 1e-9 ;
+    }
+    test( ok , " sub-segmentation selected by signed discriminator " ) ;
+
+    vector<Vector3D> positions ;
+    seg.positions( ids, positions ) ;
+    ok = positions.size() == ids.size() ;
+    for( size_t i=0 ; ok && i<ids.size() ; ++i ){
+      Vector3D pos = seg.position( ids[i] ) ;
+      ok = pos.X == positions[i].X && pos.Y == positions[i].Y && pos.Z == positions[i].Z ;
+    }
+    test( ok , " batch positions agree with single positions " ) ;
+
+    // concurrent decoding: the shared decoder must not be touched
+    vector<int> results( 4, 0 ) ;
+    vector<thread> threads ;
+    for( size_t t=0 ; t<results.size() ; ++t ){
+      threads.emplace_back( [&seg,&ids,&positions,&results,t](){
+          int good = 1 ;
+          for( int n=0 ; n<100 ; ++n ){
+            for( size_t i=0 ; i<ids.size() ; ++i ){
+              Vector3D pos = seg.position( ids[i] ) ;
+              good &= ( pos.X == positions[i].X && pos.Y == positions[i].Y ) ;
+            }
+          }
+          results[t] = good ;
+        } ) ;
+    }
+    for( auto& t : threads ) t.join() ;
+    test( results[0] && results[1] && results[2] && results[3] , " concurrent positions agree with single positions " ) ;
+
+    bool thrown = false ;
+    bf.reset() ;
+    bf["layer"] = num_layers/2 + 3 ;
+    try{
+      seg.position( bf.getValue() ) ;
+    } catch( exception& ){
+      thrown = true ;
+    }
+    test( thrown , " unknown discriminator value throws " ) ;
+
+    // ---------------------------------------------------------------------
+
+  } catch( exception &e ){
+    //} catch( ... ){
+
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
+
+//=============================================================================
@@ -78,6 +78,10 @@ int main_wrapper(int argc, char** argv ){
 
   CellIDPositionConverter idposConv( description )  ;
 
+  // converter with cached readouts and transformations - must give identical positions
+  CellIDPositionConverter idposConvCached( description )  ;
+  idposConvCached.enableCaching() ;
+
   
   //---------------------------------------------------------------------
   //    open lcio file with SimCalorimeterHits
@@ -177,6 +181,13 @@ int main_wrapper(int argc, char** argv ){
 	else
 	  tMap[ colNames[icol] ].position.failed++ ;
 
+	Position pointFromCache = idposConvCached.position( id ) ;
+	std::stringstream sst2 ;
+	sst2 << " cached position ( " << pointFromCache << " ) - ( " << pointFromDecoder << " )  - detElement: "
+	     << det.name() ;
+
+	test( dist(pointFromCache, pointFromDecoder) < 1e-9 , true  , sst2.str()  ) ;
+
       }
     }
     
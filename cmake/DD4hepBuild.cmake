@@ -257,6 +257,8 @@ function ( dd4hep_print_options )
   dd4hep_print ( "|  CMAKE_MODULE_PATH:  ${CMAKE_MODULE_PATH}                                     " )
   dd4hep_print ( "|  DD4HEP_USE_XERCESC: ${DD4HEP_USE_XERCESC}                                    " )
   dd4hep_print ( "|  XERCESC_ROOT_DIR:   ${XERCESC_ROOT_DIR}                                      " )
+  dd4hep_print ( "|  DD4HEP_USE_FASTXML: ${DD4HEP_USE_FASTXML}                                    " )
+  dd4hep_print ( "|  DD4HEP_USE_FASTJSON:${DD4HEP_USE_FASTJSON}                                   " )
   dd4hep_print ( "|  DD4HEP_USE_LCIO:    ${DD4HEP_USE_LCIO}                                       " )
   dd4hep_print ( "|  LCIO_DIR:           ${LCIO_DIR}                                              " )
   dd4hep_print ( "|  DD4HEP_USE_GEANT4:  ${DD4HEP_USE_GEANT4}                                     " )
@@ -287,6 +289,8 @@ function( dd4hep_print_cmake_options )
   dd4hep_print ( "|  DD4HEP_USE_XERCESC Enable 'Detector Builders' based on XercesC   OFF     |")
   dd4hep_print ( "|                     Requires XERCESC_ROOT_DIR to be set                   |")
   dd4hep_print ( "|                     or XercesC in CMAKE_MODULE_PATH                       |")
+  dd4hep_print ( "|  DD4HEP_USE_FASTXML Use the in-situ XML parser instead of TinyXML OFF     |")
+  dd4hep_print ( "|  DD4HEP_USE_FASTJSON Use the in-situ JSON parser instead of boost OFF     |")
   dd4hep_print ( "|  DD4HEP_USE_GEANT4  Enable the simulation part based on Geant4    OFF     |")
   dd4hep_print ( "|                     Requires Geant_DIR to be set                          |")
   dd4hep_print ( "|                     or Geant4 in CMAKE_MODULE_PATH                        |")
@@ -3,8 +3,14 @@ if(DD4HEP_USE_XERCESC)
   add_definitions(-DDD4HEP_USE_XERCESC)
   include_directories(SYSTEM ${XERCESC_INCLUDE_DIRS})
   set(XML_LIBRARIES ${XERCESC_LIBRARIES})
+elseif(DD4HEP_USE_FASTXML)
+  add_definitions(-DDD4HEP_USE_FASTXML)
+  set(XML_LIBRARIES)
 else()
   set ( DD4HEP_USE_XERCESC OFF )
   add_definitions(-DDD4HEP_USE_TINYXML)
   set(XML_LIBRARIES)
 endif()
+if(DD4HEP_USE_FASTJSON)
+  add_definitions(-DDD4HEP_USE_FASTJSON)
+endif()
@@ -0,0 +1,138 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -volmgr -destroy -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_Benchmark_Geant4VolumeID -repeat 10 -output benchmarks.json
+
+   The geometry is converted to Geant4. For the center of every sensitive volume
+   known to the volume manager a touchable is created with the Geant4 navigator.
+   Then Geant4VolumeManager::volumeID is timed for all touchables. The volume IDs
+   must agree with the volume IDs of the DDCore volume manager.
+
+*/
+// Framework include files
+#include "Benchmark.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/VolumeManager.h"
+#include "DD4hep/detail/VolumeManagerInterna.h"
+#include "DDG4/Geant4Converter.h"
+#include "DDG4/Geant4Mapping.h"
+
+// Geant4 include files
+#include "G4Navigator.hh"
+#include "G4TouchableHistory.hh"
+#include "G4GeometryManager.hh"
+
+// ROOT include files
+#include "TGeoMatrix.h"
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <iostream>
+#include <vector>
+#include <map>
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::sim;
+using namespace dd4hep::benchmarks;
+
+namespace {
+
+  /// Collect the sensitive volumes of a volume manager and all its sub-managers
+  void collect(VolumeManager mgr, map<VolumeID,VolumeManagerContext*>& volumes)  {
+    detail::VolumeManagerObject* o = mgr.ptr();
+    volumes.insert(o->volumes.begin(), o->volumes.end());
+    for( const auto& m : o->managers )
+      collect(m.second, volumes);
+  }
+}
+
+/// Plugin function: Benchmark of the volume ID computation from Geant4 touchables
+/**
+ *  Factory: DD4hep_Benchmark_Geant4VolumeID
+ *
+ *  \version 1.0
+ */
+static long benchmark_geant4_volume_id(Detector& description, int argc, char** argv)  {
+  Benchmark bench(description, "Geant4VolumeID", 10);
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( !bench.option(i, argc, argv) )
+      arg_error = true;
+  }
+  if ( arg_error || bench.repeat <= 0 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_Benchmark_Geant4VolumeID                 \n"
+      << Benchmark::usage() <<
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+  map<VolumeID,VolumeManagerContext*> volumes;
+  collect(VolumeManager::getVolumeManager(description), volumes);
+
+  TTimeStamp start;
+  Geant4Converter conv(description, WARNING);
+  Geant4GeometryInfo* info = conv.create(description.world()).detach();
+  TTimeStamp stop;
+  Geant4Mapping::instance().attach(info);
+  bench.record("geant4.convert", 1, stop.AsDouble()-start.AsDouble(),
+               Benchmark::checksum((unsigned long long)volumes.size()));
+
+  vector<G4TouchableHistory*> touchables;
+  vector<VolumeID> expected;
+  G4Navigator navigator;
+  G4GeometryManager::GetInstance()->CloseGeometry(false);
+  navigator.SetWorldVolume(info->world());
+  for( const auto& v : volumes )  {
+    TGeoHMatrix toWorld(v.second->element.nominal().worldTransformation());
+    Double_t local[3] = {0e0, 0e0, 0e0}, global[3];
+    toWorld.Multiply(&v.second->toElement());
+    toWorld.LocalToMaster(local, global);
+    G4ThreeVector pos(global[0]*CM_2_MM, global[1]*CM_2_MM, global[2]*CM_2_MM);
+    navigator.LocateGlobalPointAndSetup(pos, 0, false, false);
+    touchables.push_back(navigator.CreateTouchableHistory());
+    expected.push_back(v.first);
+  }
+
+  Geant4VolumeManager g4mgr = Geant4Mapping::instance().volumeManager();
+  vector<VolumeID> ids(touchables.size());
+  start = TTimeStamp();
+  for( long r=0; r<bench.repeat; ++r )  {
+    for( size_t k=0; k<touchables.size(); ++k )
+      ids[k] = g4mgr.volumeID(touchables[k]);
+  }
+  stop = TTimeStamp();
+  G4GeometryManager::GetInstance()->OpenGeometry();
+
+  unsigned long long check = 0;
+  size_t num_bad = 0;
+  for( size_t k=0; k<ids.size(); ++k )  {
+    check = 31*check + (unsigned long long)ids[k];
+    if ( ids[k] != expected[k] ) ++num_bad;
+    delete touchables[k];
+  }
+  if ( num_bad > 0 )   {
+    except(bench.name.c_str(),"+++ FAILED: %ld of %ld sensitive volumes have different volume IDs.",
+           long(num_bad), long(ids.size()));
+  }
+  bench.record("geant4volumemanager.volumeID", bench.repeat*ids.size(), stop.AsDouble()-start.AsDouble(),
+               Benchmark::checksum(check));
+  return 1;
+}
+DECLARE_APPLY(DD4hep_Benchmark_Geant4VolumeID,benchmark_geant4_volume_id)
@@ -0,0 +1,128 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+#ifndef DD4HEP_BENCHMARKS_BENCHMARK_H
+#define DD4HEP_BENCHMARKS_BENCHMARK_H
+
+// Framework include files
+#include "DD4hep/Detector.h"
+#include "DD4hep/Printout.h"
+
+// C/C++ include files
+#include <string>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the benchmarks of the DD4hep hot paths
+  namespace benchmarks {
+
+    /// Common options and result output of the benchmark plugins
+    /**
+     *  Every result is printed and appended as one JSON object per line to the
+     *  output file given with -output:
+     *
+     *  {"tag":"v01-07","geometry":"clic_sid_cdr","benchmark":"segmentation.cellID",
+     *   "calls":123456,"seconds":0.0123,"ns_per_call":99.6,"checksum":"0x0123456789abcdef"}
+     *
+     *  The tag defaults to the DD4hep version. The checksum is computed from the
+     *  benchmark results: identical checksums of two runs show, that both versions
+     *  computed the same values. Results of different versions are compared with
+     *  the script compareBenchmarks.py.
+     *
+     *  \version 1.0
+     */
+    class Benchmark  {
+    public:
+      /// Name of the benchmark plugin
+      std::string name;
+      /// Option -output: File receiving the results as JSON lines. Results are appended.
+      std::string output;
+      /// Option -tag: Label of the results
+      std::string tag;
+      /// Name of the geometry from the compact header
+      std::string geometry;
+      /// Option -repeat: Repetitions of each timed loop
+      long        repeat;
+
+    public:
+      /// Initializing constructor
+      Benchmark(Detector& description, const std::string& nam, long rep=1)
+        : name(nam), tag(versionString()), geometry("unknown"), repeat(rep)
+      {
+        Header hdr = description.header();
+        if ( hdr.isValid() && !hdr.name().empty() ) geometry = hdr.name();
+      }
+      /// Handle the common options. Returns false if argv[i] is not a common option.
+      bool option(int& i, int argc, char** argv)   {
+        if ( 0 == ::strncmp("-output",argv[i],4) && i+1 < argc )
+          output = argv[++i];
+        else if ( 0 == ::strncmp("-tag",argv[i],4) && i+1 < argc )
+          tag = argv[++i];
+        else if ( 0 == ::strncmp("-repeat",argv[i],4) && i+1 < argc )
+          repeat = ::atol(argv[++i]);
+        else
+          return false;
+        return true;
+      }
+      /// Help text of the common options
+      static const char* usage()   {
+        return
+          "     -output  <string>        Append the results as JSON lines to this file   \n"
+          "     -tag     <string>        Label of the results    [DD4hep version]        \n"
+          "     -repeat  <number>        Repetitions of each timed loop                  \n";
+      }
+      /// Format an integer checksum
+      static std::string checksum(unsigned long long value)   {
+        char text[32];
+        ::snprintf(text,sizeof(text),"0x%016llx",value);
+        return text;
+      }
+      /// Format a floating point checksum
+      static std::string checksum(double value)   {
+        char text[32];
+        ::snprintf(text,sizeof(text),"%.9e",value);
+        return text;
+      }
+      /// Print one result and append it to the output file
+      void record(const std::string& benchmark, size_t calls, double seconds, const std::string& check)  const  {
+        double ns = calls > 0 ? 1e9*seconds/double(calls) : 0e0;
+        printout(ALWAYS,name.c_str(),"+  %-34s %12ld calls %10.4f sec %12.1f ns/call  checksum: %s",
+                 benchmark.c_str(), long(calls), seconds, ns, check.c_str());
+        if ( !output.empty() )   {
+          FILE* f = ::fopen(output.c_str(),"a");
+          if ( !f )   {
+            except(name.c_str(),"+++ Cannot open the benchmark output file %s [%s]",
+                   output.c_str(), ::strerror(errno));
+          }
+          ::fprintf(f,"{\"tag\":\"%s\",\"geometry\":\"%s\",\"benchmark\":\"%s\",\"calls\":%ld,"
+                    "\"seconds\":%.6e,\"ns_per_call\":%.4f,\"checksum\":\"%s\"}\n",
+                    escape(tag).c_str(), escape(geometry).c_str(), escape(benchmark).c_str(),
+                    long(calls), seconds, ns, check.c_str());
+          ::fclose(f);
+        }
+      }
+      /// Escape a string for the JSON output
+      static std::string escape(const std::string& s)   {
+        std::string r;
+        for( char c : s )  {
+          if ( c == '"' || c == '\\' ) r += '\\';
+          if ( (unsigned char)c >= 0x20 ) r += c;
+        }
+        return r;
+      }
+    };
+  }       /* End namespace benchmarks                 */
+}         /* End namespace dd4hep                     */
+#endif    /* DD4HEP_BENCHMARKS_BENCHMARK_H            */
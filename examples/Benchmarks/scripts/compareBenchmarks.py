@@ -0,0 +1,77 @@
+#!/bin/python
+#==========================================================================
+#  AIDA Detector description implementation
+#--------------------------------------------------------------------------
+# Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+# All rights reserved.
+#
+# For the licensing terms see $DD4hepINSTALL/LICENSE.
+# For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+#
+#==========================================================================
+#
+#  Compare two sets of benchmark results written by the DD4hep_Benchmark_* plugins.
+#
+#  python compareBenchmarks.py --reference=v01-06.json --current=v01-07.json --tolerance=0.1
+#
+#  The files contain one JSON object per line. If a benchmark appears several
+#  times in a file the last entry is used. Exit code 1 if --fail is given and the
+#  time per call of any benchmark grew by more than the tolerance.
+#
+import sys, json, errno, optparse
+
+parser = optparse.OptionParser()
+parser.formatter.width = 132
+parser.description = "Compare DD4hep benchmark results of two versions."
+parser.add_option("-r", "--reference", dest="reference", default=None,
+                  help="Benchmark results of the reference version",
+                  metavar="<FILE>")
+parser.add_option("-c", "--current", dest="current", default=None,
+                  help="Benchmark results of the current version",
+                  metavar="<FILE>")
+parser.add_option("-t", "--tolerance", dest="tolerance", default=0.1,
+                  help="Accepted relative increase of the time per call (default:0.1)",
+                  metavar="<double number>")
+parser.add_option("-f", "--fail", action="store_true", dest="fail", default=False,
+                  help="Exit with an error if a benchmark regressed")
+
+(opts, args) = parser.parse_args()
+
+if opts.reference is None or opts.current is None:
+  print(parser.format_help())
+  sys.exit(errno.EINVAL)
+
+def load(file_name):
+  results = {}
+  with open(file_name) as f:
+    for line in f:
+      line = line.strip()
+      if line:
+        r = json.loads(line)
+        results[(r['geometry'],r['benchmark'])] = r
+  return results
+
+reference = load(opts.reference)
+current   = load(opts.current)
+tolerance = float(opts.tolerance)
+regressions = 0
+
+print('+++ %-16s %-36s %14s %14s %8s  %s'%('Geometry','Benchmark','Ref [ns/call]','Cur [ns/call]','Ratio','Checksum'))
+for key in sorted(set(reference.keys()) | set(current.keys())):
+  ref = reference.get(key)
+  cur = current.get(key)
+  if ref is None or cur is None:
+    print('+++ %-16s %-36s %s'%(key[0],key[1],'only in '+('current' if ref is None else 'reference')))
+    continue
+  ratio  = cur['ns_per_call']/ref['ns_per_call'] if ref['ns_per_call'] > 0 else 0.0
+  status = 'same' if ref['checksum'] == cur['checksum'] else 'DIFFERENT'
+  flag   = ''
+  if ratio > 1.0 + tolerance:
+    flag = '  <== SLOWER'
+    regressions = regressions + 1
+  print('+++ %-16s %-36s %14.1f %14.1f %8.3f  %s%s'%(key[0],key[1],ref['ns_per_call'],cur['ns_per_call'],ratio,status,flag))
+
+print('+++ %d benchmarks slower by more than %.0f%% (%s -> %s)'%(regressions,100.0*tolerance,opts.reference,opts.current))
+if opts.fail and regressions > 0:
+  sys.exit(1)
+sys.exit(0)
@@ -0,0 +1,171 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -destroy -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_Benchmark_Conditions -iovs 5 -repeat 2 -output benchmarks.json
+
+   Every detector element gets an alignment delta in each IOV. Then for every IOV
+   a conditions slice is prepared and the alignments are computed from the deltas.
+   The number of calls are the number of prepared conditions and the number of
+   computed alignments respectively.
+
+*/
+// Framework include files
+#include "Benchmark.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Conditions.h"
+#include "DD4hep/AlignmentData.h"
+#include "DD4hep/DetectorProcessor.h"
+#include "DD4hep/AlignmentsProcessor.h"
+#include "DD4hep/AlignmentsCalculator.h"
+#include "DDCond/ConditionsSlice.h"
+#include "DDCond/ConditionsManager.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <iostream>
+#include <memory>
+#include <map>
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::benchmarks;
+using cond::ConditionsPool;
+using cond::ConditionsSlice;
+using cond::ConditionsContent;
+using cond::ConditionsManager;
+using align::AlignmentsCalculator;
+
+namespace {
+
+  /// Register an alignment delta for every detector element except the world
+  class DeltaCreator  {
+  public:
+    ConditionsManager manager;
+    ConditionsPool&   pool;
+    int               iov;
+    DeltaCreator(ConditionsManager m, ConditionsPool& p, int i) : manager(m), pool(p), iov(i) {}
+    /// Callback to process a single detector element
+    int operator()(DetElement de, int)  const  {
+      if ( de.ptr() == de.world().ptr() ) return 0;
+      Condition cond(de.path()+"#"+align::Keys::deltaName,align::Keys::deltaName);
+      Delta&    delta = cond.bind<Delta>();
+      cond->hash = ConditionKey(de.key(),align::Keys::deltaKey).hash;
+      cond->setFlag(Condition::ACTIVE|Condition::ALIGNMENT_DELTA);
+      delta.translation.SetZ(1e-3*double(iov+1));
+      delta.rotation = RotationZYX(1e-4*iov,0e0,0e0);
+      delta.flags |= Delta::HAVE_TRANSLATION|Delta::HAVE_ROTATION;
+      if ( !manager.registerUnlocked(pool, cond) )   {
+        except("Conditions","+++ Failed to register condition %s.",cond.name());
+      }
+      return 1;
+    }
+  };
+}
+
+/// Plugin function: Benchmark of the conditions slice preparation and the alignment computation
+/**
+ *  Factory: DD4hep_Benchmark_Conditions
+ *
+ *  \version 1.0
+ */
+static long benchmark_conditions(Detector& description, int argc, char** argv)  {
+  Benchmark bench(description, "Conditions", 2);
+  int  num_iov = 5;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( bench.option(i, argc, argv) )
+      continue;
+    else if ( 0 == ::strncmp("-iovs",argv[i],4) && i+1 < argc )
+      num_iov = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || num_iov <= 0 || bench.repeat <= 0 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_Benchmark_Conditions                     \n"
+      "     -iovs    <number>        Number of IOVs with alignment deltas    [5]     \n"
+      << Benchmark::usage() <<
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  /******************** Initialize the conditions manager *****************/
+  description.apply("DD4hep_ConditionsManagerInstaller",0,(char**)0);
+  ConditionsManager manager = ConditionsManager::from(description);
+  manager["PoolType"]       = "DD4hep_ConditionsLinearPool";
+  manager["UserPoolType"]   = "DD4hep_ConditionsMapUserPool";
+  manager["UpdatePoolType"] = "DD4hep_ConditionsLinearUpdatePool";
+  manager.initialize();
+  const IOVType* iov_typ = manager.registerIOVType(0,"run").second;
+  if ( 0 == iov_typ )   {
+    except(bench.name.c_str(),"+++ Unknown IOV type supplied.");
+  }
+  /******************** Populate the conditions store *********************/
+  size_t num_deltas = 0;
+  for( int i=0; i<num_iov; ++i )  {
+    IOV iov(iov_typ, IOV::Key(1+i*10,(i+1)*10));
+    ConditionsPool* iov_pool = manager.registerIOV(*iov.iovType, iov.key());
+    num_deltas = DetectorScanner().scan(DeltaCreator(manager, *iov_pool, i), description.world());
+  }
+  shared_ptr<ConditionsContent> content(new ConditionsContent());
+  cond::fill_content(manager, *content, *iov_typ);
+
+  printout(INFO,bench.name,"+++ Registered %ld alignment deltas in %d IOVs.", long(num_deltas), num_iov);
+
+  /******************** Timed: prepare slices and compute alignments ******/
+  //  The deltas of each IOV are collected from its own slice between the
+  //  two timed regions.
+  double t_prepare = 0e0, t_compute = 0e0, sum = 0e0;
+  size_t num_prepared = 0, num_computed = 0;
+  for( long r=0; r<bench.repeat; ++r )  {
+    sum = 0e0;
+    for( int i=0; i<num_iov; ++i )  {
+      shared_ptr<ConditionsSlice> slice(new ConditionsSlice(manager, content));
+      AlignmentsCalculator calculator;
+      TTimeStamp start;
+      ConditionsManager::Result cres = manager.prepare(IOV(iov_typ,1+i*10), *slice);
+      TTimeStamp prepared;
+      map<DetElement, Delta> deltas;
+      DetectorScanner(align::deltaCollector(*slice, deltas), description.world());
+      TTimeStamp collected;
+      AlignmentsCalculator::Result ares = calculator.compute(deltas, *slice);
+      TTimeStamp computed;
+      if ( cres.missing > 0 || ares.missing > 0 )   {
+        except(bench.name.c_str(),"+++ Missing conditions: %ld  missing alignments: %ld",
+               long(cres.missing), long(ares.missing));
+      }
+      t_prepare    += prepared.AsDouble() - start.AsDouble();
+      t_compute    += computed.AsDouble() - collected.AsDouble();
+      num_prepared += cres.total();
+      num_computed += ares.computed;
+      for( const auto& d : deltas )  {
+        Alignment a = slice->get(d.first, align::Keys::alignmentKey);
+        const Double_t* t = a.worldTransformation().GetTranslation();
+        sum += t[0] + t[1] + t[2];
+      }
+    }
+  }
+  bench.record("conditions.prepare", num_prepared, t_prepare,
+               Benchmark::checksum((unsigned long long)(num_prepared/bench.repeat)));
+  bench.record("alignments.compute", num_computed, t_compute, Benchmark::checksum(sum));
+  return 1;
+}
+DECLARE_APPLY(DD4hep_Benchmark_Conditions,benchmark_conditions)
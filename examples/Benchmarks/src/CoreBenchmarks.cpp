@@ -0,0 +1,235 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   These plugins behave like main programs.
+   Invoke the plugins with something like this:
+
+   geoPluginRun -destroy \
+   -plugin DD4hep_Benchmark_CompactLoad -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+                                        -output benchmarks.json \
+   -plugin DD4hep_Benchmark_Readout -points 10 -repeat 10 -output benchmarks.json
+
+   DD4hep_Benchmark_CompactLoad loads the compact description and populates the
+   volume manager. The geometry must not be loaded before (no -input of geoPluginRun).
+   DD4hep_Benchmark_Readout times the segmentation cellID/position computations and
+   VolumeManager::lookupContext for random points in all sensitive volumes.
+
+*/
+// Framework include files
+#include "Benchmark.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/Readout.h"
+#include "DD4hep/Segmentations.h"
+#include "DD4hep/VolumeManager.h"
+#include "DD4hep/detail/VolumeManagerInterna.h"
+
+// ROOT include files
+#include "TGeoBBox.h"
+#include "TGeoMatrix.h"
+#include "TTimeStamp.h"
+#include "TRandom3.h"
+
+// C/C++ include files
+#include <iostream>
+#include <vector>
+#include <map>
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::benchmarks;
+
+namespace {
+
+  /// Collect the sensitive volumes of a volume manager and all its sub-managers
+  void collect(VolumeManager mgr, map<VolumeID,VolumeManagerContext*>& volumes)  {
+    detail::VolumeManagerObject* o = mgr.ptr();
+    volumes.insert(o->volumes.begin(), o->volumes.end());
+    for( const auto& m : o->managers )
+      collect(m.second, volumes);
+  }
+
+  /// Count the detector elements of a tree
+  size_t count_elements(DetElement de)  {
+    size_t count = 1;
+    for( const auto& c : de.children() )
+      count += count_elements(c.second);
+    return count;
+  }
+}
+
+/// Plugin function: Benchmark of loading the compact description and of the volume manager population
+/**
+ *  Factory: DD4hep_Benchmark_CompactLoad
+ *
+ *  \version 1.0
+ */
+static long benchmark_compact_load(Detector& description, int argc, char** argv)  {
+  Benchmark bench(description, "CompactLoad");
+  vector<string> inputs;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( bench.option(i, argc, argv) )
+      continue;
+    else if ( 0 == ::strncmp("-input",argv[i],4) && i+1 < argc )
+      inputs.push_back(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || inputs.empty() )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_Benchmark_CompactLoad                    \n"
+      "     -input   <string>        Compact file to be loaded. May be repeated.     \n"
+      << Benchmark::usage() <<
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+  if ( description.volumeManager().isValid() )   {
+    except(bench.name.c_str(),"+++ The volume manager already exists. Do not use -volmgr.");
+  }
+  TTimeStamp start;
+  for( const auto& input : inputs )
+    description.fromXML(input);
+  TTimeStamp loaded;
+  VolumeManager mgr = VolumeManager::getVolumeManager(description);
+  TTimeStamp populated;
+
+  map<VolumeID,VolumeManagerContext*> volumes;
+  collect(mgr, volumes);
+  Header hdr = description.header();
+  if ( hdr.isValid() && !hdr.name().empty() ) bench.geometry = hdr.name();
+  bench.record("compact.load", 1, loaded.AsDouble()-start.AsDouble(),
+               Benchmark::checksum((unsigned long long)count_elements(description.world())));
+  bench.record("volumemanager.populate", 1, populated.AsDouble()-loaded.AsDouble(),
+               Benchmark::checksum((unsigned long long)volumes.size()));
+  return 1;
+}
+DECLARE_APPLY(DD4hep_Benchmark_CompactLoad,benchmark_compact_load)
+
+/// Plugin function: Benchmark of the segmentations and of the volume manager lookup
+/**
+ *  Factory: DD4hep_Benchmark_Readout
+ *
+ *  Random points are generated within the bounding boxes of all sensitive
+ *  volumes known to the volume manager. For these points the cell IDs are computed
+ *  with the segmentation of the subdetector's readout, the cell positions are
+ *  computed back from the cell IDs and the volume manager contexts are looked up
+ *  by the cell IDs.
+ *
+ *  \version 1.0
+ */
+static long benchmark_readout(Detector& description, int argc, char** argv)  {
+  Benchmark bench(description, "Readout", 10);
+  long num_points = 10;
+  bool arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( bench.option(i, argc, argv) )
+      continue;
+    else if ( 0 == ::strncmp("-points",argv[i],4) && i+1 < argc )
+      num_points = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || num_points <= 0 || bench.repeat <= 0 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_Benchmark_Readout                        \n"
+      "     -points  <number>        Random points per sensitive volume      [10]    \n"
+      << Benchmark::usage() <<
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  VolumeManager volmgr = VolumeManager::getVolumeManager(description);
+  vector<Segmentation> segmentations;
+  vector<Position>     local, global;
+  vector<VolumeID>     volume_ids;
+  TRandom3 rndm(12345);
+
+  for( const auto& m : volmgr.ptr()->managers )  {
+    DetElement        det = m.second.detector();
+    SensitiveDetector sd  = description.sensitiveDetector(det.name());
+    if ( !sd.isValid() || !sd.readout().isValid() || !sd.readout().segmentation().isValid() )
+      continue;
+    Segmentation seg = sd.readout().segmentation();
+    map<VolumeID,VolumeManagerContext*> volumes;
+    collect(m.second, volumes);
+    for( const auto& v : volumes )  {
+      PlacedVolume pv  = volmgr.lookupVolumePlacement(v.first);
+      TGeoBBox*    box = dynamic_cast<TGeoBBox*>(pv.volume()->GetShape());
+      if ( !box ) continue;
+      TGeoHMatrix toWorld(v.second->element.nominal().worldTransformation());
+      toWorld.Multiply(&v.second->toElement());
+      const Double_t* o = box->GetOrigin();
+      for( long k=0; k<num_points; ++k )  {
+        Double_t l[3] = { o[0] + 0.99*box->GetDX()*rndm.Uniform(-1e0,1e0),
+                          o[1] + 0.99*box->GetDY()*rndm.Uniform(-1e0,1e0),
+                          o[2] + 0.99*box->GetDZ()*rndm.Uniform(-1e0,1e0) }, g[3];
+        toWorld.LocalToMaster(l, g);
+        segmentations.push_back(seg);
+        local.push_back(Position(l[0],l[1],l[2]));
+        global.push_back(Position(g[0],g[1],g[2]));
+        volume_ids.push_back(v.first);
+      }
+    }
+  }
+  const size_t num_samples = volume_ids.size();
+  if ( 0 == num_samples )   {
+    except(bench.name.c_str(),"+++ No sensitive volumes with a segmentation found.");
+  }
+  printout(INFO,bench.name,"+++ Sampled %ld points in %ld sensitive volumes.",
+           long(num_samples), long(num_samples/num_points));
+
+  vector<CellID> cell_ids(num_samples);
+  unsigned long long check = 0;
+  TTimeStamp start;
+  for( long r=0; r<bench.repeat; ++r )  {
+    for( size_t k=0; k<num_samples; ++k )
+      cell_ids[k] = segmentations[k].cellID(local[k], global[k], volume_ids[k]);
+  }
+  TTimeStamp stop;
+  for( size_t k=0; k<num_samples; ++k )
+    check = 31*check + (unsigned long long)cell_ids[k];
+  bench.record("segmentation.cellID", bench.repeat*num_samples, stop.AsDouble()-start.AsDouble(),
+               Benchmark::checksum(check));
+
+  vector<Position> positions(num_samples);
+  start = TTimeStamp();
+  for( long r=0; r<bench.repeat; ++r )  {
+    for( size_t k=0; k<num_samples; ++k )
+      positions[k] = segmentations[k].position(cell_ids[k]);
+  }
+  stop = TTimeStamp();
+  double sum = 0e0;
+  for( const auto& p : positions )
+    sum += p.X() + p.Y() + p.Z();
+  bench.record("segmentation.position", bench.repeat*num_samples, stop.AsDouble()-start.AsDouble(),
+               Benchmark::checksum(sum));
+
+  vector<VolumeManagerContext*> contexts(num_samples);
+  start = TTimeStamp();
+  for( long r=0; r<bench.repeat; ++r )  {
+    for( size_t k=0; k<num_samples; ++k )
+      contexts[k] = volmgr.lookupContext(cell_ids[k]);
+  }
+  stop = TTimeStamp();
+  check = 0;
+  for( const auto* c : contexts )
+    check = 31*check + (unsigned long long)c->identifier;
+  bench.record("volumemanager.lookupContext", bench.repeat*num_samples, stop.AsDouble()-start.AsDouble(),
+               Benchmark::checksum(check));
+  return 1;
+}
+DECLARE_APPLY(DD4hep_Benchmark_Readout,benchmark_readout)
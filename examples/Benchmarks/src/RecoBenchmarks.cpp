@@ -0,0 +1,104 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -destroy -input file:${DD4hep_DIR}/examples/CLICSiD/compact/compact.xml \
+   -plugin DD4hep_Benchmark_MaterialsBetween -rays 1000 -length 200 -output benchmarks.json
+
+   Times MaterialManager::materialsBetween for straight segments starting at the
+   origin in random directions.
+
+*/
+// Framework include files
+#include "Benchmark.h"
+#include "DD4hep/Factories.h"
+#include "DDRec/MaterialManager.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+#include "TRandom3.h"
+
+// C/C++ include files
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::benchmarks;
+
+/// Plugin function: Benchmark of the material scan between two points
+/**
+ *  Factory: DD4hep_Benchmark_MaterialsBetween
+ *
+ *  \version 1.0
+ */
+static long benchmark_materials_between(Detector& description, int argc, char** argv)  {
+  Benchmark bench(description, "MaterialsBetween", 1);
+  long   num_rays = 1000;
+  double length   = 200e0;
+  bool   arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( bench.option(i, argc, argv) )
+      continue;
+    else if ( 0 == ::strncmp("-rays",argv[i],4) && i+1 < argc )
+      num_rays = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-length",argv[i],4) && i+1 < argc )
+      length = ::atof(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || num_rays < 2 || length <= 0e0 || bench.repeat <= 0 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_Benchmark_MaterialsBetween               \n"
+      "     -rays    <number>        Number of random segments               [1000]  \n"
+      "     -length  <number>        Length of the segments in cm            [200]   \n"
+      << Benchmark::usage() <<
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  // Consecutive segments differ: the result cache of the material manager is never hit.
+  vector<rec::Vector3D> ends;
+  TRandom3 rndm(12345);
+  for( long i=0; i<num_rays; ++i )  {
+    double x, y, z;
+    rndm.Sphere(x, y, z, length);
+    ends.push_back(rec::Vector3D(x, y, z));
+  }
+  rec::MaterialManager manager(description.world().volume());
+  const rec::Vector3D origin(0e0, 0e0, 0e0);
+  double thickness = 0e0;
+  size_t num_materials = 0;
+  TTimeStamp start;
+  for( long r=0; r<bench.repeat; ++r )  {
+    thickness = 0e0;
+    num_materials = 0;
+    for( const auto& end : ends )  {
+      const rec::MaterialVec& materials = manager.materialsBetween(origin, end);
+      for( const auto& m : materials )
+        thickness += m.second;
+      num_materials += materials.size();
+    }
+  }
+  TTimeStamp stop;
+  printout(INFO,bench.name,"+++ %ld segments crossed %ld material layers.",
+           long(num_rays), long(num_materials));
+  bench.record("materialmanager.materialsBetween", bench.repeat*num_rays, stop.AsDouble()-start.AsDouble(),
+               Benchmark::checksum(thickness));
+  return 1;
+}
+DECLARE_APPLY(DD4hep_Benchmark_MaterialsBetween,benchmark_materials_between)
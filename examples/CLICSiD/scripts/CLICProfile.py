@@ -0,0 +1,38 @@
+"""
+
+   Subtest using CLICSid showing the usage of the execution time profiler.
+   The profiler times all actions and accumulates the stepping time
+   per volume and region. The table is printed at the end of the run.
+
+   @version 1.0
+
+"""
+def run():
+  import CLICSid, DDG4, SystemOfUnits
+
+  sid = CLICSid.CLICSid()
+  geant4 = sid.geant4
+  kernel = sid.kernel
+  sid.loadGeometry()
+  geant4.setupCshUI(ui=None)
+  sid.setupField(quiet=True)
+  gun = geant4.setupGun("Gun",
+                        particle='pi-',
+                        energy=10*SystemOfUnits.GeV,
+                        multiplicity=1,
+                        isotrop=True )
+  prof = DDG4.SteppingAction(kernel,'Geant4Profiler/Profiler')
+  prof.Rows = 20
+  kernel.steppingAction().adopt(prof)
+
+  sid.setupDetectors()
+  sid.setupPhysics('QGSP_BERT')
+  sid.test_config()
+  kernel.NumEvents = 5
+  kernel.run()
+  kernel.terminate()
+  print 'End of run. Terminating .......'
+  print 'TEST_PASSED'
+
+if __name__ == "__main__":
+  run()
@@ -11,6 +11,32 @@ from SystemOfUnits import *
    \version 1.0
 
 """
+def checkProcessOutput(file_name, num_events):
+  """
+     Check the merged output of the worker processes: every event must be present
+     once and the events of different worker processes must differ.
+  """
+  import ROOT
+  f = ROOT.TFile.Open(file_name)
+  if not f or f.IsZombie():
+    print '+++ Multi-process check FAILED: cannot open merged file %s'%(file_name,)
+    return False
+  tree = f.Get('EVENT')
+  entries = tree.GetEntries() if tree else 0
+  signatures = set()
+  for i in xrange(entries):
+    tree.GetEntry(i)
+    particles = tree.MCParticles
+    signature = (particles.size(),)+tuple(sorted([round(p.psx*p.psx+p.psy*p.psy+p.psz*p.psz,6) for p in particles]))
+    signatures.add(signature)
+  f.Close()
+  if entries != num_events or len(signatures) != num_events:
+    print '+++ Multi-process check FAILED: %s has %d events with %d distinct contents. Expected %d.'%\
+        (file_name, entries, len(signatures), num_events)
+    return False
+  print '+++ Multi-process check: %s has %d events with distinct contents.'%(file_name, entries)
+  return True
+
 def run():
   batch = False
   kernel = DDG4.Kernel()
@@ -27,6 +53,8 @@ def run():
       batch = True
     elif sys.argv[i]=='batch':
       batch = True
+    elif sys.argv[i]=='-processes':
+      kernel.NumberOfProcesses = int(sys.argv[i+1])
 
   kernel.loadGeometry(geometry)
   geant4 = DDG4.Geant4(kernel)
@@ -37,7 +65,8 @@ def run():
   # Configure field
   field = geant4.setupTrackingField(prt=True)
   # Configure I/O
-  evt_root = geant4.setupROOTOutput('RootOutput','Multi_coll_'+time.strftime('%Y-%m-%d_%H-%M'),mc_truth=True)
+  output = 'Multi_coll_'+time.strftime('%Y-%m-%d_%H-%M')+'.root'
+  evt_root = geant4.setupROOTOutput('RootOutput',output,mc_truth=True)
   # Setup particle gun
   geant4.setupGun("Gun",particle='pi-',energy=10*GeV,multiplicity=1)
 
@@ -56,7 +85,11 @@ def run():
   phys.enableUI()
   phys.dump()
   # and run
+  num_processes = int(kernel.NumberOfProcesses)
+  num_events    = int(kernel.NumEvents)
   geant4.execute()
+  if num_processes > 1:
+    checkProcessOutput(output, num_events)
 
 if __name__ == "__main__":
   run()
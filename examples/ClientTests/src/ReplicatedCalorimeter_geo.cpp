@@ -0,0 +1,86 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+
+// Framework includes
+#include "DD4hep/DetFactoryHelper.h"
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::detail;
+
+/// Highly granular sampling calorimeter block built from replicated placements
+/**
+ *  The layers fill the envelope along z. Every layer consists of an absorber
+ *  and an active slice, which is divided into a grid of cells.
+ *  With replicate="false" the same geometry is built copy by copy using
+ *  ordinary placements to compare memory usage and startup time.
+ */
+static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector sens)  {
+  xml_det_t x_det     = e;
+  xml_dim_t x_dim     = x_det.dimensions();
+  xml_comp_t x_abs    = x_det.child(_Unicode(absorber));
+  xml_comp_t x_act    = x_det.child(_U(slice));
+  bool      replicas  = x_det.hasAttr(_Unicode(replicate)) ? x_det.attr<bool>(_Unicode(replicate)) : true;
+  int       nlayers   = x_dim.attr<int>(_U(layers));
+  int       ncells    = x_dim.attr<int>(_Unicode(cells));
+  double    dx        = x_dim.x()/2.0;
+  double    dy        = x_dim.y()/2.0;
+  double    abs_dz    = x_abs.thickness()/2.0;
+  double    act_dz    = x_act.thickness()/2.0;
+  double    lay_dz    = abs_dz + act_dz;
+  double    cell_dx   = dx/double(ncells);
+  double    cell_dy   = dy/double(ncells);
+  DetElement d_det(x_det.nameStr(),x_det.id());
+
+  sens.setType("calorimeter");
+  Volume env_vol(x_det.nameStr()+"_envelope",Box(dx,dy,nlayers*lay_dz),description.air());
+  Volume lay_vol(x_det.nameStr()+"_layer",Box(dx,dy,lay_dz),description.air());
+  Volume abs_vol(x_det.nameStr()+"_absorber",Box(dx,dy,abs_dz),description.material(x_abs.materialStr()));
+  Volume act_vol(x_det.nameStr()+"_active",Box(dx,dy,act_dz),description.material(x_act.materialStr()));
+  Volume cell_vol(x_det.nameStr()+"_cell",Box(cell_dx,cell_dy,act_dz),description.material(x_act.materialStr()));
+
+  env_vol.setAttributes(description,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
+  lay_vol.setVisAttributes(description.invisible());
+  abs_vol.setVisAttributes(description,x_abs.visStr());
+  act_vol.setVisAttributes(description.invisible());
+  cell_vol.setAttributes(description,x_act.regionStr(),x_act.limitsStr(),x_act.visStr());
+  cell_vol.setSensitiveDetector(sens);
+
+  lay_vol.placeVolume(abs_vol,Position(0,0,-lay_dz+abs_dz));
+  lay_vol.placeVolume(act_vol,Position(0,0, lay_dz-act_dz));
+
+  Position cell0(-dx+cell_dx,-dy+cell_dy,0), layer0(0,0,-(nlayers-1)*lay_dz);
+  if ( replicas )   {
+    act_vol.replicateGrid(cell_vol,Transform3D(cell0),
+                          ncells,Position(2*cell_dx,0,0),"x",
+                          ncells,Position(0,2*cell_dy,0),"y");
+    env_vol.replicate(lay_vol,Transform3D(layer0),nlayers,Transform3D(Position(0,0,2*lay_dz)),"layer");
+  }
+  else   {
+    for( int j=0; j<ncells; ++j )  {
+      for( int i=0; i<ncells; ++i )  {
+        PlacedVolume pv = act_vol.placeVolume(cell_vol,cell0+Position(2*i*cell_dx,2*j*cell_dy,0));
+        pv.addPhysVolID("x",i).addPhysVolID("y",j);
+      }
+    }
+    for( int k=0; k<nlayers; ++k )
+      env_vol.placeVolume(lay_vol,layer0+Position(0,0,2*k*lay_dz)).addPhysVolID("layer",k);
+  }
+  printout(INFO,x_det.nameStr(),"+++ Built %d layers with %dx%d cells using %s.",
+           nlayers, ncells, ncells, replicas ? "replicated placements" : "single placements");
+
+  PlacedVolume env_plv = description.pickMotherVolume(d_det).placeVolume(env_vol);
+  env_plv.addPhysVolID("system",x_det.id());
+  d_det.setPlacement(env_plv);
+  return d_det;
+}
+
+DECLARE_DETELEMENT(ReplicatedCalorimeter,create_detector)
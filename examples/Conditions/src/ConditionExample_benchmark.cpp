@@ -0,0 +1,302 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -volmgr -destroy -plugin DD4hep_ConditionExample_benchmark \
+   -input file:${DD4hep_DIR}/examples/AlignDet/compact/Telescope.xml \
+   -output Conditions -iovs 10
+
+   Populate the conditions store for a set of IOVs and save it with
+   all persistency mechanisms: ROOT object streaming (ConditionsRootPersistency
+   and ConditionsTreePersistency) and the columnar repository.
+   Then clear the conditions store and measure the time to restore it
+   from each of the files. The columnar repository is restored twice:
+   once completely and once lazily through the conditions loader
+   while preparing the conditions slices of all IOVs.
+   Finally copies of the column repository with corrupted column and
+   data ranges must be rejected when opened.
+
+*/
+// Framework include files
+#include "ConditionExampleObjects.h"
+#include "DDCond/ConditionsManager.h"
+#include "DDCond/ConditionsIOVPool.h"
+#include "DDCond/ConditionsDataLoader.h"
+#include "DDCond/ConditionsRootPersistency.h"
+#include "DDCond/ConditionsTreePersistency.h"
+#include "DDCond/ConditionsColumnRepository.h"
+#include "DD4hep/Factories.h"
+
+// ROOT include files
+#include "TTimeStamp.h"
+
+// C/C++ include files
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+using namespace dd4hep;
+using namespace dd4hep::ConditionExamples;
+
+namespace {
+  typedef map<pair<Condition::key_type,IOV::Key>,string> Snapshot;
+
+  /// Extract the payloads of all conditions of the conditions store
+  size_t snapshot(ConditionsManager manager, const IOVType* iov_typ, Snapshot& snap)  {
+    snap.clear();
+    for( const auto& p : manager.iovPool(*iov_typ)->elements )  {
+      RangeConditions entries;
+      p.second->select_all(entries);
+      for( Condition c : entries )
+        snap[make_pair(c.key(),p.first)] = c->data.str();
+    }
+    return snap.size();
+  }
+
+  /// Print a single line of the benchmark summary
+  void result(const char* what, size_t count, double seconds, size_t bytes)  {
+    printout(ALWAYS,"Benchmark","+  %-28s %8ld conditions %10.4f seconds %12ld bytes",
+             what, long(count), seconds, long(bytes));
+  }
+
+  /// Write a copy of the column repository with a corrupted header or row and try to open it
+  bool rejected(const string& fname, const string& data)  {
+    FILE* f = ::fopen(fname.c_str(),"wb");
+    if ( !f || ::fwrite(data.data(), 1, data.length(), f) != data.length() )  {
+      if ( f ) ::fclose(f);
+      except("Benchmark","+++ Failed to write %s",fname.c_str());
+    }
+    ::fclose(f);
+    PrintLevel level = setPrintLevel(FATAL);  // The errors are expected
+    try  {
+      cond::ConditionsColumnRepository repository(fname);
+    }
+    catch(const exception&)  {
+      setPrintLevel(level);
+      return true;
+    }
+    setPrintLevel(level);
+    return false;
+  }
+
+  /// Access the file size
+  size_t file_size(const string& fname)  {
+    FILE* f = ::fopen(fname.c_str(),"rb");
+    if ( f )  {
+      ::fseek(f, 0, SEEK_END);
+      long len = ::ftell(f);
+      ::fclose(f);
+      return len;
+    }
+    return 0;
+  }
+}
+
+/// Plugin function: Condition program example
+/**
+ *  Factory: DD4hep_ConditionExample_benchmark
+ *
+ *  \version 1.0
+ */
+static int condition_example (Detector& description, int argc, char** argv)  {
+  string input, output = "Conditions";
+  int    num_iov = 10;
+  bool   arg_error = false;
+
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-output",argv[i],4) )
+      output = argv[++i];
+    else if ( 0 == ::strncmp("-iovs",argv[i],4) )
+      num_iov = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || input.empty() || output.empty() )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_ConditionExample_benchmark               \n"
+      "     -input       <string>    Geometry file                                   \n"
+      "     -output      <string>    Prefix of the conditions output files           \n"
+      "     -iovs        <number>    Number of parallel IOV slots for processing.    \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  // First we load the geometry
+  description.fromXML(input);
+
+  /******************** Initialize the conditions manager *****************/
+  // Same as installManager(), but missing conditions are read from the columnar repository
+  description.apply("DD4hep_ConditionsManagerInstaller",0,(char**)0);
+  ConditionsManager manager = ConditionsManager::from(description);
+  manager["PoolType"]       = "DD4hep_ConditionsLinearPool";
+  manager["UserPoolType"]   = "DD4hep_ConditionsMapUserPool";
+  manager["UpdatePoolType"] = "DD4hep_ConditionsLinearUpdatePool";
+  manager["LoaderType"]     = "column";
+  manager.initialize();
+  const IOVType* iov_typ = manager.registerIOVType(0,"run").second;
+  if ( 0 == iov_typ )
+    except("ConditionsPrepare","++ Unknown IOV type supplied.");
+
+  shared_ptr<ConditionsContent> content(new ConditionsContent());
+  shared_ptr<ConditionsSlice>   slice(new ConditionsSlice(manager,content));
+  Scanner(ConditionsKeys(*content,INFO),description.world());
+  Scanner(ConditionsDependencyCreator(*content,DEBUG),description.world());
+
+  /******************** Populate the conditions store *********************/
+  for(int i=0; i<num_iov; ++i)  {
+    IOV iov(iov_typ, IOV::Key(1+i*10,(i+1)*10));
+    ConditionsPool* iov_pool = manager.registerIOV(*iov.iovType, iov.key());
+    Scanner(ConditionsCreator(*slice, *iov_pool, DEBUG),description.world(),0,true);
+  }
+  Snapshot reference, restored;
+  size_t   num_cond = snapshot(manager, iov_typ, reference);
+
+  /******************** Save the conditions store *************************/
+  const char* pool_name = "ConditionsIOVPool No 1";
+  string root_file = output+".root", tree_file = output+"_tree.root", column_file = output+".dd4col";
+  TTimeStamp start, stop;
+  printout(ALWAYS,"Benchmark","+=========================================================================");
+  {
+    start = TTimeStamp();
+    unique_ptr<cond::ConditionsRootPersistency> persist(new cond::ConditionsRootPersistency("DD4hep Conditions"));
+    size_t count = persist->add(pool_name,*manager.iovPool(*iov_typ));
+    persist->save(root_file.c_str());
+    stop = TTimeStamp();
+    result("Save ROOT persistency:", count, stop.AsDouble()-start.AsDouble(), file_size(root_file));
+  }
+  {
+    start = TTimeStamp();
+    unique_ptr<cond::ConditionsTreePersistency> persist(new cond::ConditionsTreePersistency("DD4hep Conditions"));
+    size_t count = persist->add(pool_name,*manager.iovPool(*iov_typ));
+    persist->save(tree_file.c_str());
+    stop = TTimeStamp();
+    result("Save tree persistency:", count, stop.AsDouble()-start.AsDouble(), file_size(tree_file));
+  }
+  {
+    start = TTimeStamp();
+    size_t count = cond::ConditionsColumnRepository::save(manager, column_file);
+    stop = TTimeStamp();
+    result("Save column repository:", count, stop.AsDouble()-start.AsDouble(), file_size(column_file));
+  }
+
+  /******************** Restore the conditions store **********************/
+  {
+    manager.clear();
+    start = TTimeStamp();
+    auto   persist = cond::ConditionsRootPersistency::load(root_file.c_str(),"DD4hep Conditions");
+    size_t count   = persist->importIOVPool(pool_name,"run",manager);
+    stop = TTimeStamp();
+    result("Load ROOT persistency:", count, stop.AsDouble()-start.AsDouble(), file_size(root_file));
+  }
+  {
+    manager.clear();
+    start = TTimeStamp();
+    auto   persist = cond::ConditionsTreePersistency::load(tree_file.c_str(),"DD4hep Conditions");
+    size_t count   = persist->importIOVPool(pool_name,"run",manager);
+    stop = TTimeStamp();
+    result("Load tree persistency:", count, stop.AsDouble()-start.AsDouble(), file_size(tree_file));
+  }
+  {
+    manager.clear();
+    start = TTimeStamp();
+    cond::ConditionsColumnRepository repository(column_file);
+    size_t count = repository.import(manager);
+    stop = TTimeStamp();
+    result("Load column repository:", count, stop.AsDouble()-start.AsDouble(), file_size(column_file));
+    snapshot(manager, iov_typ, restored);
+  }
+  {
+    manager.clear();
+    start = TTimeStamp();
+    size_t count = 0;
+    manager.loader()->addSource(column_file);
+    for(int i=0; i<num_iov; ++i)  {
+      IOV req_iov(iov_typ,i*10+5);
+      ConditionsManager::Result r = manager.prepare(req_iov,*slice);
+      count += r.loaded;
+    }
+    stop = TTimeStamp();
+    result("Lazy load + prepare column:", count, stop.AsDouble()-start.AsDouble(), file_size(column_file));
+  }
+  printout(ALWAYS,"Benchmark","+=========================================================================");
+
+  size_t num_diff = 0;
+  for( const auto& r : reference )  {
+    auto i = restored.find(r.first);
+    if ( i == restored.end() || i->second != r.second )  {
+      printout(ERROR,"Benchmark","+++ Condition %016llX [%ld,%ld] differs after restore: '%s' <> '%s'",
+               r.first.first, r.first.second.first, r.first.second.second,
+               r.second.c_str(), i == restored.end() ? "(missing)" : i->second.c_str());
+      ++num_diff;
+    }
+  }
+  if ( num_diff > 0 || restored.size() != num_cond )  {
+    except("Benchmark","+++ %ld of %ld conditions differ after restoring the column repository.",
+           long(num_diff), long(num_cond));
+  }
+  printout(ALWAYS,"Benchmark","+  All %ld conditions identical after restoring the column repository.",long(num_cond));
+
+  /******************** Reject corrupted column repositories ***************/
+  {
+    typedef cond::ConditionsColumnRepository::Header  Header;
+    typedef cond::ConditionsColumnRepository::DataRef DataRef;
+    string data(file_size(column_file), 0);
+    FILE*  f = ::fopen(column_file.c_str(),"rb");
+    if ( !f || ::fread(&data[0], 1, data.length(), f) != data.length() )  {
+      if ( f ) ::fclose(f);
+      except("Benchmark","+++ Failed to read %s",column_file.c_str());
+    }
+    ::fclose(f);
+    const Header& hdr = *(const Header*)data.data();
+    vector<pair<const char*,string> > corrupted;
+    auto corrupt = [&](const char* what, uint64_t offset, uint64_t value)  {
+      string copy = data;
+      ::memcpy(&copy[offset], &value, sizeof(value));
+      corrupted.push_back(make_pair(what, copy));
+    };
+    corrupt("Payload column at the end of the file", offsetof(Header,payloads), hdr.fileSize);
+    corrupt("Key column beyond the end of the file", offsetof(Header,keys),     hdr.fileSize-8);
+    corrupt("Misaligned IOV lower bound column",     offsetof(Header,iovLower), hdr.iovLower+1);
+    corrupt("Row count overflowing the columns",     offsetof(Header,numRows),  ~uint64_t(0)/8+2);
+    corrupt("String heap after the payload heap",    offsetof(Header,strings),  hdr.blobs+8);
+    corrupt("Name outside the string heap",          hdr.names+offsetof(DataRef,offset), hdr.blobs);
+    corrupt("Payload length overflowing the heap",   hdr.payloads+offsetof(DataRef,length), ~uint64_t(0));
+    size_t num_accepted = 0;
+    string corrupt_file = column_file+".corrupted";
+    for( const auto& c : corrupted )  {
+      if ( !rejected(corrupt_file, c.second) )  {
+        printout(ERROR,"Benchmark","+++ Corrupted column repository accepted: %s",c.first);
+        ++num_accepted;
+      }
+    }
+    ::remove(corrupt_file.c_str());
+    if ( num_accepted > 0 )  {
+      except("Benchmark","+++ %ld of %ld corrupted column repositories accepted.",
+             long(num_accepted), long(corrupted.size()));
+    }
+    printout(ALWAYS,"Benchmark","+  All %ld corrupted column repositories rejected.",long(corrupted.size()));
+  }
+  printout(ALWAYS,"Benchmark","+=========================================================================");
+  // All done.
+  return 1;
+}
+
+// first argument is the type from the xml file
+DECLARE_APPLY(DD4hep_ConditionExample_benchmark,condition_example)